@@ -0,0 +1,45 @@
+#ifndef _COMPOSITOR_H
+#define _COMPOSITOR_H
+
+#ifdef ESP_PLATFORM
+#include "esp_system.h"
+#else
+#include <stdbool.h>
+#include <stdint.h>
+#endif
+
+// 最多图层数
+#define COMPOSITOR_MAX_LAYERS       8
+// 一次合成最多记录的损坏区域数，超出后与增长最小的区域合并
+#define COMPOSITOR_MAX_DAMAGE       8
+
+// 矩形区域
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+} sLayerRect;
+
+// 图层绘制回调：只需绘制 pClip 内的内容（显存已按 pClip 裁剪）
+typedef void (*tLayerDrawFunc)(const sLayerRect* pClip, void* pArg);
+
+// 添加图层，z 越大越靠上；opaque 表示图层完全覆盖自己的矩形。返回图层号，失败返回 -1
+int8_t compositor_AddLayer(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t z, bool opaque, tLayerDrawFunc draw, void* pArg);
+
+// 显示/隐藏图层（状态改变时该图层区域需要重新合成）
+void compositor_SetVisible(int8_t layer, bool visible);
+
+// 图层内容改变，下次合成时重绘该图层区域
+void compositor_Invalidate(int8_t layer);
+
+// 指定区域需要重新合成
+void compositor_InvalidateRect(int16_t x, int16_t y, int16_t w, int16_t h);
+
+// 整屏需要重新合成（屏幕被合成器以外的代码改写之后调用）
+void compositor_InvalidateAll(void);
+
+// 把损坏区域内的可见图层按 z 顺序重绘到显存，返回是否绘制了内容
+bool compositor_Compose(void);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef _DISPBACKEND_H
+#define _DISPBACKEND_H
+
+#ifdef ESP_PLATFORM
+#include "esp_system.h"
+#else
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+// 显示后端：dispcolor 的所有绘图最终都调用当前后端
+// 不支持的功能填 NULL（例如无帧缓冲的直接显示模式没有 update / getPixel / getRowData）
+typedef struct {
+    const char* name;
+
+    void (*init)(void);
+    void (*displayOff)(void);
+    void (*setBrightness)(uint16_t Value);
+    uint16_t (*getWidth)(void);
+    uint16_t (*getHeight)(void);
+
+    void (*drawPixel)(int16_t x, int16_t y, uint16_t color);
+    void (*fillRect)(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void (*drawHLine)(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void (*writeSpan)(int16_t x, int16_t y, const uint16_t* pColors, int16_t len, bool mirror);
+    void (*blitRect)(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pSrc, int16_t stride, bool mirror);
+    void (*setClip)(int16_t x, int16_t y, int16_t w, int16_t h);
+    void (*resetClip)(void);
+
+    // 可选的高级图元，NULL 时 dispcolor 用上面的基本图元绘制（流式模式把它们整条记录进显示列表）
+    void (*drawLine)(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+    int16_t (*drawString)(int16_t X, int16_t Y, uint8_t FontID, const uint8_t* Str, uint16_t TextColor, uint16_t BgColor, uint8_t TransparentBg); // 只用于单行字符串，返回下一个字符的X坐标
+    void (*drawImageLut)(int16_t x, int16_t y, int16_t w, int16_t h, const int16_t* pValues, int16_t valueMin, const uint16_t* pLut, uint16_t lutSize, bool mirror);
+    void (*darkenRect)(int16_t x, int16_t y, int16_t w, int16_t h);
+    // 可选：调用者将改写或释放传给 drawImageLut 的内存（流式模式删除引用它的图元）
+    void (*releaseBuffer)(const void* pBuff, size_t size);
+
+    void (*update)(void); // 只刷新被修改过的区域
+    void (*updateFull)(void); // 刷新整屏
+    void (*updateRect)(int16_t x, int16_t y, int16_t w, int16_t h);
+
+    uint16_t (*getPixel)(int16_t x, int16_t y);
+    void (*getRowData)(uint16_t row, uint16_t* pBuff);
+    bool (*getScreenData)(uint16_t* pBuff); // 返回 false 表示得不到完整的屏幕内容（流式模式有丢失区域时）
+} tDispBackend;
+
+#ifdef ESP_PLATFORM
+// ST7789 液晶（SPI）
+extern const tDispBackend dispbackend_st7789;
+#endif
+
+// 内存帧缓冲（主机上运行界面、基准测试和图像比对）
+extern const tDispBackend dispbackend_hostfb;
+
+// 选择显示后端，需在 dispcolor_Init 之前调用（默认：ESP 平台为 ST7789，其他平台为内存帧缓冲）
+void dispcolor_SetBackend(const tDispBackend* pNewBackend);
+
+// 返回当前显示后端
+const tDispBackend* dispcolor_GetBackend(void);
+
+#endif
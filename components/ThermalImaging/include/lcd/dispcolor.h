@@ -10,6 +10,7 @@
 #define _DISPCOLOR_H
 
 #include "font.h"
+#include <stddef.h>
 
 
 #define RGB565(r, g, b)         (((r & 0xF8) << 8) | ((g & 0xFC) << 3) | ((b & 0xF8) >> 3))
@@ -70,12 +71,30 @@ void dispcolor_SetBrightness(uint16_t Value);
 void dispcolor_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
 //程序颜色显示的 1 个像素
 void dispcolor_DrawPixel(int16_t X, int16_t Y, uint16_t color);
+//该过程绘制一条水平线
+void dispcolor_DrawHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+//该过程写入一段水平像素，mirror 为 true 时 pColors[0] 写到最右侧
+void dispcolor_WriteSpan(int16_t x, int16_t y, const uint16_t *pColors, int16_t len, bool mirror);
+//该过程把内存中的矩形图像复制到屏幕
+void dispcolor_BlitRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t *pSrc, int16_t stride, bool mirror);
+//该过程按颜色查找表把数值图像转换成颜色写到屏幕（pLut[value - valueMin]）
+void dispcolor_DrawImageLut(int16_t x, int16_t y, int16_t w, int16_t h, const int16_t *pValues, int16_t valueMin, const uint16_t *pLut, uint16_t lutSize, bool mirror);
+//改写或释放传给 dispcolor_DrawImageLut 的内存之前调用该过程（流式模式的显示列表只保存指针）
+void dispcolor_ReleaseBuffer(const void *pBuff, size_t size);
+//该过程设置裁剪矩形，之后的绘图只写入该区域
+void dispcolor_SetClip(int16_t x, int16_t y, int16_t w, int16_t h);
+//该过程取消裁剪
+void dispcolor_ResetClip(void);
 //该过程返回像素的颜色
 uint16_t dispcolor_GetPixel(int16_t x, int16_t y);
 //该过程用颜色绘制屏幕
 void dispcolor_FillScreen(uint16_t color);
-//该过程从帧缓冲区更新显示
+//该过程从帧缓冲区更新显示（只发送被修改过的区域）
 void dispcolor_Update(void);
+//该过程从帧缓冲区更新整个显示
+void dispcolor_UpdateFull(void);
+//该过程从帧缓冲区更新指定矩形区域
+void dispcolor_UpdateRect(int16_t x, int16_t y, int16_t w, int16_t h);
 //例程在显示器上画一条直线
 void dispcolor_DrawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
 //例程在显示器上绘制一个矩形
@@ -100,8 +119,8 @@ int16_t dispcolor_getStrWidth(uint8_t FontID, char *Str);
 int16_t dispcolor_getFormatStrWidth(uint8_t FontID, const char *args, ...);
 //该过程将屏幕上图像的亮度降低 ~ 2 倍
 void dispcolor_screenDark(void);
-// 复制显存数据到指定内存
-void dispcolor_getScreenData(uint16_t *pBuff);
+// 复制显存数据到指定内存，得不到完整的屏幕内容时返回 false
+bool dispcolor_getScreenData(uint16_t *pBuff);
 // 复制一行显存数据到指定内存（节省内存版本）
 void dispcolor_getRowData(uint16_t row, uint16_t *pBuff);
 
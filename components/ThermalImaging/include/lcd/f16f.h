@@ -9,7 +9,12 @@
 #ifndef _F16F_H
 #define _F16F_H
 
+#ifdef ESP_PLATFORM
 #include "esp_system.h"
+#else
+#include <stdbool.h>
+#include <stdint.h>
+#endif
 
 
 // 等宽字体，6x8 像素
@@ -23,4 +28,7 @@
 // 该函数返回一个指向 Char 子表的指针
 uint8_t *f10x16f_GetCharTable(uint8_t Char);
 
+// 压缩表版本（f16f_rle.c，由 tools/fontgen.py 生成）
+uint8_t *f10x16f_rle_GetCharTable(uint8_t Char);
+
 #endif
@@ -9,7 +9,12 @@
 #ifndef _F32F_H
 #define _F32F_H
 
+#ifdef ESP_PLATFORM
 #include "esp_system.h"
+#else
+#include <stdbool.h>
+#include <stdint.h>
+#endif
 
 
 //字体成比例，高度32 
@@ -9,7 +9,12 @@
 #ifndef _FONTS_H
 #define _FONTS_H
 
+#ifdef ESP_PLATFORM
 #include "esp_system.h"
+#else
+#include <stdbool.h>
+#include <stdint.h>
+#endif
 
 
 // 字体ID列表
@@ -278,6 +283,46 @@
 #define	XXXXXXXX	0xff
 
 
+// 字体存储格式
+#define FONT_STORAGE_RAW 0 // 原始点阵表（覆盖完整 cp1251）
+#define FONT_STORAGE_RLE 1 // 压缩表（tools/fontgen.py 生成，只含界面用到的 ASCII 和度数符号），按需解码
+#ifndef FONT_STORAGE
+#define FONT_STORAGE FONT_STORAGE_RLE
+#endif
+
+// 压缩字形的编码方式
+#define FONT_RLE_BITS 0 // 墨迹框内按位紧凑存放，高位在前
+#define FONT_RLE_RUNS 1 // 背景/前景交替的半字节游程，15 表示继续累加
+
+// 压缩字形索引
+typedef struct {
+    uint16_t offset; // 在数据区中的偏移
+    uint8_t advance; // 字符宽度
+    uint8_t boxX; // 墨迹框左上角
+    uint8_t boxY;
+    uint8_t boxW; // 墨迹框宽高，0 表示空白字形
+    uint8_t boxH;
+    uint8_t encoding; // FONT_RLE_BITS / FONT_RLE_RUNS
+} tFontRleGlyph;
+
+// 压缩字体
+typedef struct {
+    uint8_t height; // 字符高度
+    uint8_t bytesPerRow; // 解码后每行字节数
+    uint8_t first; // 第一个字符
+    uint8_t last; // 最后一个字符
+    uint8_t extraCount; // 范围外另外收录的字符数
+    const tFontRleGlyph* pGlyphs; // 范围内的字形，之后是范围外收录的字形
+    const uint8_t* pData;
+    const uint8_t* pExtra; // 范围外收录的字符（如 CELSIUS_SYMBOL 的 0xB0）
+} tFontRle;
+
+// 解码槽，保存最近一次解码的字符（与原始表相同的 [宽度, 高度, 点阵...] 格式）
+typedef struct {
+    int16_t Char; // 槽中的字符，-1 表示空
+    uint8_t Buff[2 + 32 * 2];
+} tFontRleSlot;
+
 // 包含指向字体的 GetCharTable 函数的指针的类型
 typedef uint8_t *(*t_font_getchar)(uint8_t Char);
 
@@ -293,4 +338,7 @@ uint8_t font_GetCharHeight(uint8_t *pCharTable);
 // 返回字符的数据
 uint8_t* font_GetCharFont(uint8_t* pCharTable);
 
+// 把压缩字体中的字符解码到解码槽，返回与原始表相同格式的字符结构，字体中没有该字符时返回 NULL
+uint8_t* font_rle_Decode(const tFontRle* pFont, uint8_t Char, tFontRleSlot* pSlot);
+
 #endif
@@ -0,0 +1,38 @@
+#ifndef _HOSTFB_H
+#define _HOSTFB_H
+
+#include "dispbackend.h"
+
+// 内存帧缓冲尺寸（与液晶一致）
+#ifndef HOSTFB_WIDTH
+#define HOSTFB_WIDTH 240
+#endif
+#ifndef HOSTFB_HEIGHT
+#define HOSTFB_HEIGHT 240
+#endif
+
+// 绘图和刷新统计
+typedef struct {
+    uint32_t pixelsTouched; // 自上次刷新以来写入的像素数（重复写同一像素会重复计数）
+    uint32_t lastUpdateBytes; // 上一次刷新"发送"的字节数（脏行区间 x 2 字节）
+    uint32_t lastUpdateRows; // 上一次刷新涉及的行数
+    uint32_t totalBytes; // 累计"发送"字节数
+    uint32_t updateCount; // 刷新次数
+} sHostFbStats;
+
+// 返回帧缓冲（RGB565，本机字节序，按行存放）
+const uint16_t* hostfb_GetBuffer(void);
+
+// 返回统计信息
+void hostfb_GetStats(sHostFbStats* pStats);
+
+// 清零统计信息
+void hostfb_ResetStats(void);
+
+// 把帧缓冲保存为 PPM（P6）文件，返回 0 成功
+int hostfb_SavePPM(const char* pPath);
+
+// 把帧缓冲保存为 PNG 文件（不压缩），返回 0 成功
+int hostfb_SavePNG(const char* pPath);
+
+#endif
@@ -729,6 +729,30 @@ void lcd_cmd(spi_device_handle_t spi, const uint8_t cmd);
  */
 void lcd_data(spi_device_handle_t spi, const uint8_t* data, int len);
 
+/**
+ * @brief  把长度为len个字节的数据加入SPI队列后立即返回（D/C线电平为1）
+ *       - 发送完成前一直占用SPI，再次发送命令之前必须调用 lcd_data_wait
+ *       - 例：lcd_data_queue(LCD_SPI, bandBuf, 7680);
+ *
+ * @param  spi LCD与SPI关联的句柄，通过此来调用SPI总线上的LCD设备
+ * @param  data 要发送数据的指针（必须可被DMA访问，发送完成前保持不变）
+ * @param  len 发送的字节数
+ *
+ * @return
+ *     - none
+ */
+void lcd_data_queue(spi_device_handle_t spi, const uint8_t* data, int len);
+
+/**
+ * @brief  等待 lcd_data_queue 排队的数据发送完成，没有排队中的数据时直接返回
+ *
+ * @param  spi LCD与SPI关联的句柄，通过此来调用SPI总线上的LCD设备
+ *
+ * @return
+ *     - none
+ */
+void lcd_data_wait(spi_device_handle_t spi);
+
 /**
  * @brief  向LCD发送单点16Bit的像素数据，（根据驱动IC的不同，可能为2或3个字节，需要转换RGB565、RGB666）
  *       - ili9488\ili9481 这类IC，SPI总线仅能使用RGB666-18Bit/像素，分3字节传输。而不能使用16Bit/像素，分2字节传输。（0x3A寄存器）
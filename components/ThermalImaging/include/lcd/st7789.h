@@ -7,8 +7,20 @@
 // 模式选择
 #define ST7789_DIRECT_MODE 0 // 直接显示访问模式（无帧缓冲区）
 #define ST7789_BUFFER_MODE 1 // 更改帧缓冲区以便稍后加载到显示器的模式
+#define ST7789_STREAM_MODE 2 // 记录显示列表，刷新时按 PARALLEL_LINES 行一条带光栅化并发送的模式（无整屏帧缓冲区）
 #define ST7789_MODE ST7789_BUFFER_MODE // 使用显存模式 占用内存 刷新快
 // #define ST7789_MODE ST7789_DIRECT_MODE // 直接显示模式 慢 
+// #define ST7789_MODE ST7789_STREAM_MODE // 流式模式 只占几十KB内存 刷新时光栅化
+
+#if (ST7789_MODE == ST7789_STREAM_MODE)
+// 显示列表大小（字节）。溢出时先把脏区域发送到液晶再清空列表，被丢弃图元的范围记为丢失区域：
+// 之后的刷新在丢失区域内只发送新图元写过的像素，其余保持液晶上的内容，直到被新的不透明图元覆盖。
+// 这是有损的：丢失区域内的降低亮度（DarkenRect）不会显示，有丢失区域时 getScreenData 返回 false（不能截图），
+// getRowData / GetPixel 在丢失区域内是黑色
+#define ST7789_DISPLAY_LIST_SIZE (12 * 1024)
+// 不透明图元面积不小于该值时，删除列表中被它完全覆盖的图元
+#define ST7789_CULL_MIN_AREA 64
+#endif
 
 // LCD 旋转角度
 #define DIRECTION0		0
@@ -32,12 +44,45 @@ void st7789_DrawPixel(int16_t x, int16_t y, uint16_t color);
 // 用颜色填充矩形的过程
 void st7789_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
 
-#if (ST7789_MODE == ST7789_BUFFER_MODE)
-// 该过程从帧缓冲区更新显示
+// 绘制一条水平线
+void st7789_DrawHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+
+// 写入一段水平像素，mirror 为 true 时 pColors[0] 写到最右侧
+void st7789_WriteSpan(int16_t x, int16_t y, const uint16_t* pColors, int16_t len, bool mirror);
+
+// 把调用者内存中的矩形图像（stride 为一行像素数）复制到屏幕
+void st7789_BlitRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pSrc, int16_t stride, bool mirror);
+
+// 设置裁剪矩形，之后的绘图只写入该区域
+void st7789_SetClip(int16_t x, int16_t y, int16_t w, int16_t h);
+
+// 取消裁剪，恢复为整个屏幕
+void st7789_ResetClip(void);
+
+// 设置写入窗口（起点 + 宽高）并开始写入GRAM
+void st7789_setWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
+#if (ST7789_MODE == ST7789_BUFFER_MODE) || (ST7789_MODE == ST7789_STREAM_MODE)
+// 该过程从帧缓冲区更新显示（整屏）
 void st7789_update(void);
 
-// 复制显存数据到指定内存
-void st7789_getScreenData(uint16_t *pBuff);
+// 只把脏区域（自上次刷新后被修改过的行区间）刷新到显示器
+void st7789_updateDirty(void);
+
+// 立即把指定矩形区域刷新到显示器
+void st7789_updateRect(int16_t x, int16_t y, int16_t w, int16_t h);
+
+// 把指定矩形标记为脏区域
+void st7789_markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+
+// 整屏标记为脏区域，并丢弃行校验（液晶GRAM内容不可信时调用）
+void st7789_invalidate(void);
+
+// 返回上一次刷新实际发送的像素字节数
+uint32_t st7789_getLastUpdateBytes(void);
+
+// 复制显存数据到指定内存，流式模式有丢失区域时不复制，返回 false
+bool st7789_getScreenData(uint16_t *pBuff);
 
 // 复制一行显存数据到指定内存（节省内存版本）
 void st7789_getRowData(uint16_t row, uint16_t *pBuff);
@@ -46,6 +91,34 @@ void st7789_getRowData(uint16_t row, uint16_t *pBuff);
 uint16_t st7789_GetPixel(int16_t x, int16_t y);
 #endif
 
+#if (ST7789_MODE == ST7789_STREAM_MODE)
+// 把一条直线记录为一个图元
+void st7789_DrawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+
+// 把单行字符串记录为一个图元，返回下一个字符的X坐标
+int16_t st7789_DrawString(int16_t X, int16_t Y, uint8_t FontID, const uint8_t* Str, uint16_t TextColor, uint16_t BgColor, uint8_t TransparentBg);
+
+// 记录查找表图像（只保存指针，pValues 和 pLut 在被覆盖或调用 st7789_releaseBuffer 之前必须保持不变）
+void st7789_DrawImageLut(int16_t x, int16_t y, int16_t w, int16_t h, const int16_t* pValues, int16_t valueMin, const uint16_t* pLut, uint16_t lutSize, bool mirror);
+
+// 调用者将改写或释放一块内存：删除引用它的查找表图像图元（液晶上保持当前内容）
+void st7789_releaseBuffer(const void* pBuff, size_t size);
+
+// 把矩形内已绘制的内容亮度降低约 2 倍
+void st7789_DarkenRect(int16_t x, int16_t y, int16_t w, int16_t h);
+
+// 显示列表使用情况
+typedef struct {
+    uint32_t usedBytes; // 已使用字节数（含被覆盖待整理的图元）
+    uint32_t liveOps; // 有效图元数
+    uint32_t overflows; // 溢出次数
+    uint16_t lostRows; // 有丢失区域的行数
+    bool complete; // false 表示有丢失区域（列表不能重绘整屏）
+} sSt7789ListStats;
+
+void st7789_getListStats(sSt7789ListStats* pStats);
+#endif
+
 
 /**
  * @brief  设置光标位置（写入窗口大小为 当前光标~全屏）
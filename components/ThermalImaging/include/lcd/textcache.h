@@ -0,0 +1,47 @@
+#ifndef _TEXTCACHE_H
+#define _TEXTCACHE_H
+
+#ifdef ESP_PLATFORM
+#include "esp_system.h"
+#else
+#include <stdbool.h>
+#include <stdint.h>
+#endif
+
+// 字形游程缓冲池大小（游程个数），池满后新字形每次临时解码，不再缓存
+#define TEXTCACHE_GLYPH_RUNS        3072
+
+// 字符串缓存条目数
+#define TEXTCACHE_STR_ENTRIES       16
+// 可缓存字符串的最大长度，更长的字符串逐字绘制
+#define TEXTCACHE_STR_MAXLEN        48
+
+// 字形的一个游程：第 row 行从 x 开始连续 len 个前景像素
+typedef struct {
+    uint8_t row;
+    uint8_t x;
+    uint8_t len;
+} sGlyphRun;
+
+// 预光栅化的字形
+typedef struct {
+    const sGlyphRun* pRuns; // 游程数组
+    uint16_t runCount; // 游程个数
+    uint8_t width; // 字符宽度
+    uint8_t height; // 字符高度
+    bool built; // 是否已经从点阵生成
+} sGlyph;
+
+// 返回字符的预光栅化字形，第一次使用时从点阵表生成
+const sGlyph* textcache_GetGlyph(uint8_t FontID, uint8_t Char);
+
+// 按游程绘制一个字符，返回字符宽度
+uint8_t textcache_DrawChar(int16_t X, int16_t Y, uint8_t FontID, uint8_t Char, uint16_t TextColor, uint16_t BgColor, uint8_t TransparentBg);
+
+// 绘制单行字符串（内容、字体、颜色相同的字符串直接重放缓存的游程），返回下一个字符的X坐标
+int16_t textcache_DrawString(int16_t X, int16_t Y, uint8_t FontID, const uint8_t* Str, uint16_t TextColor, uint16_t BgColor, uint8_t TransparentBg);
+
+// 清空字符串缓存
+void textcache_Clear(void);
+
+#endif
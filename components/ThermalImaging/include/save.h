@@ -1,15 +1,72 @@
 #ifndef MAIN_SAVE_SAVE_H_
 #define MAIN_SAVE_SAVE_H_
 #include "esp_system.h"
+#include "mlx90640_task.h"
+#include "snapshot.h"
+#include "thumbnail.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
 
-int save_ImageCSV(void);
+// 保存路径：内置存储分区（capstore 或 SPIFFS）
+#define SAVE_MOUNT_POINT "/spiffs"
+
+// 保存结果
+#define SAVE_OK 0
+#define SAVE_ERR_ACCESS (-1) // 无法访问 SPIFFS
+#define SAVE_ERR_FULL (-2) // 空间不足
+#define SAVE_ERR_MEMORY (-3) // 内存不足
+#define SAVE_ERR_WRITE (-4) // 写文件失败
+#define SAVE_ERR_NODATA (-5) // 还没有热成像数据
+#define SAVE_ERR_BUSY (-6) // 存储任务的队列或缓冲池已满
+#define SAVE_ERR_SCREEN (-7) // 屏幕内容不完整，不能截图（流式显示模式的丢失区域）
+
+// 为 1 时内置存储分区使用日志结构的 capstore（见 capstore.h，写入延迟固定，空闲时回收），为 0 时使用 SPIFFS
+// 从 SPIFFS 升级时第一次挂载把 SPIFFS 中的文件迁移到 capstore（文件无法暂存到内存时不修改分区，继续用 SPIFFS）；
+// 切回 SPIFFS 时第一次挂载格式化分区，已有的保存文件丢失
+#define SAVE_USE_CAPSTORE 1
+
+// 文件扩展名
+#define SAVE_BMP_EXT ".BMP"
+#define SAVE_SNAPSHOT_EXT ".TIR" // 温度图（辐射快照）
+#define SAVE_PARAMS_EXT ".PAR" // MLX90640 EEPROM 参数
+#define SAVE_RECORDING_EXT ".TIV" // 温度录像
+#define SAVE_QOI_EXT ".QOI" // 压缩截图
+#define SAVE_BMP_THUMB_EXT ".BTH" // BMP 截图的缩略图（见 thumbnail.h）
+#define SAVE_QOI_THUMB_EXT ".QTH" // QOI 截图的缩略图
+#define SAVE_TIMELAPSE_EXT ".TLS" // 定时拍摄的温度统计（CSV）
+
+// 挂载内置存储分区（启动时最先调用）
+bool save_Mount(void);
+
+// 打开保存目录的文件清单（存储挂载后、启动存储任务前调用）
+bool save_Init(void);
+
+// 保存并用消息框显示结果（由存储任务写入，调用者等待写完）
+int save_ImageSnapshot(void);
 int save_ImageBMP(uint8_t bits);
 int save_MLX90640Params(void);
 
-// 截图管理功能
+// 以下供存储任务使用：只编码/写文件，不显示提示，返回 SAVE_OK / SAVE_ERR_xxx
+size_t save_SnapshotSize(void);
+void save_FillHeader(sSnapshotHeader* pHeader, const sMlxData* pFrame);
+size_t save_BuildSnapshot(uint8_t* pOut, size_t outSize);
+int save_WriteFile(const char* pExtension, const void* pData, size_t size, int32_t* pIndex);
+int save_WriteBmp(const uint16_t* pScreen, uint16_t width, uint16_t height, uint8_t bits, int32_t* pIndex);
+int save_WriteQoi(const uint16_t* pScreen, uint16_t width, uint16_t height, int32_t* pIndex);
+const char* save_ErrorStr(int err);
+
+// 边写边追加的文件（录像）：创建时分配序号，关闭时记入清单
+FILE* save_CreateFile(const char* pExtension, size_t minFree, int32_t* pIndex, int* pErr);
+int save_CloseFile(const char* pExtension, FILE* f, int32_t index);
+// 向已关闭的文件追加一块数据（打开、写入、关闭各一次，断电时最多丢失这一块），并更新清单中的大小
+int save_AppendFile(const char* pExtension, int32_t index, const void* pData, size_t size);
+
+// 截图管理功能（BMP 和 QOI 截图）
 int save_listBmpFiles(char fileList[][32], int maxFiles);
 int save_deleteBmpFile(const char* fileName);
 int save_deleteAllBmpFiles(void);
 int save_viewBmpFile(const char* fileName);
+bool save_loadThumbnail(const char* fileName, sThumbnail* pThumb);
 
 #endif /* MAIN_SAVE_SAVE_H_ */
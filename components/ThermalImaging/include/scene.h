@@ -0,0 +1,162 @@
+#ifndef _SCENE_H
+#define _SCENE_H
+
+#include "mlx90640_task.h"
+#include "palette.h"
+#include "compositor.h"
+#include "autoscale.h"
+
+// 实时界面的画面合成：计算阶段（量程、调色板查找表、坐标图放大）和合成阶段（图层绘制）
+// 只依赖帧数据、界面状态和 dispcolor，不依赖 FreeRTOS 和全局设置，可以在主机上用内存帧缓冲运行
+
+// 调色板坐标位数：量程 [min, max] 线性映射到 0..SCENE_COORD_MAX，放大和查表都在这个整数域里做
+#define SCENE_COORD_BITS 10
+#define SCENE_COORD_MAX ((1 << SCENE_COORD_BITS) - 1)
+// 调色板坐标 -> RGB565 查找表的长度
+#define SCENE_LUT_SIZE (SCENE_COORD_MAX + 1)
+
+// 焦点区域
+typedef enum {
+    SECTION_TITLE = 0,
+    SECTION_IMAGE,
+    SECTION_LOCK,
+    SECTION_DATA,
+    SECTION_COUNT
+} focus_section_t;
+
+// 标题区域的子选择（左、中、右三项）
+typedef enum {
+    TITLE_SUB_LEFT = 0,   // 左侧：BOM
+    TITLE_SUB_CENTER,     // 中间：BOM_FRUIT
+    TITLE_SUB_RIGHT,      // 右侧：BOM
+    TITLE_SUB_COUNT
+} title_sub_selection_t;
+
+// 底部数据区域的子选择（左、中、右三项）
+typedef enum {
+    DATA_SUB_LEFT = 0,   // 左侧：Max/Min/Ctr温度
+    DATA_SUB_CENTER,     // 中间：边框区域
+    DATA_SUB_RIGHT,      // 右侧：Atr/Set FPS
+    DATA_SUB_COUNT
+} data_sub_selection_t;
+
+// 界面状态：合成一帧需要的全部输入（渲染任务从设置和输入处理中收集，合成时只读）
+typedef struct {
+    // 计算阶段
+    eColorScale colorScale;          // 伪彩色
+    uint8_t paletteCenterPercent;    // 调色板 50% 对应的温度在 min..max 中的位置，0-100
+    bool autoScale;                  // 自动量程
+    float manualMin;                 // 手动量程
+    float manualMax;
+    bool lowQuality;                 // 最近邻缩放（否则高斯模糊 + 双线性插值）
+
+    // 合成阶段
+    focus_section_t focus;
+    bool subItemMode;                // 在子项中左右选择
+    title_sub_selection_t titleSub;
+    data_sub_selection_t dataSub;
+    bool paletteSelectMode;
+    bool tempUnitSelectMode;
+    bool channelSelectMode;
+    bool crosshairMode;              // 正在移动十字线
+    bool crosshairAxisIsY;           // 正在移动的轴
+    bool showCrosshair;              // 显示十字线
+    int crossX;                      // 十字线位置（传感器列/行）
+    int crossY;
+    bool useFahrenheit;
+    bool plotChannelY;               // 折线图通道：false -> 十字线所在行，true -> 十字线所在列
+    bool tempMarkers;                // 显示中心温度
+    bool realTimeAnalysis;           // 显示底部数据栏
+    bool lockActive;                 // 临时固定量程生效
+    bool overlayActive;              // 显示临时提示消息
+    uint32_t overlayId;              // 每条新消息不同（重绘提示图层）
+    const char* overlayLine1;
+    const char* overlayLine2;
+    float fps;                       // 显示在折线图右下角
+} sSceneUiState;
+
+// 计算阶段的结果
+typedef struct {
+    sMlxData frame;          // 帧数据（含采集时计算的统计）
+    int16_t* pHqImage;       // 放大后的调色板坐标图（超出 0..SCENE_COORD_MAX 的取两端颜色）
+    uint16_t* pLut565;       // 调色板坐标 -> RGB565 查找表，下标为 (坐标 - lutMin)
+    int16_t lutMin;
+    uint16_t lutSize;
+    uint32_t lutSig;         // 生成查找表时的调色板签名，没有改变时不重建
+    float minTemp;           // 显示量程
+    float maxTemp;
+    uint16_t width;          // 放大后的尺寸
+    uint16_t height;
+    uint32_t version;        // 每次计算加一，合成时据此判断热图是否需要重绘
+} sSceneFrame;
+
+// 计算阶段的工作缓冲区和跨帧状态
+typedef struct {
+    int16_t* pCoord16;       // 传感器分辨率的调色板坐标
+    float* pGaussBuff;       // 高斯模糊缓冲区
+    tRGBcolor* pPalette;     // 伪彩色调色板
+    sAutoScale autoScale;    // 自动量程跟踪
+} sSceneScratch;
+
+// 界面布局
+typedef struct {
+    uint16_t top_bar_h;      // 顶部标题栏高度
+    uint16_t bottom_bar_h;   // 底部信息栏高度
+    uint16_t img_x;          // 热成像显示区域
+    uint16_t img_y;
+    uint16_t img_w;
+    uint16_t img_h;
+} sSceneLayout;
+
+// 图层
+typedef enum {
+    SCENE_LAYER_CHROME = 0,  // 界面底色
+    SCENE_LAYER_TITLE,       // 标题栏
+    SCENE_LAYER_THERMAL,     // 热图
+    SCENE_LAYER_PANEL,       // 底部数据栏
+    SCENE_LAYER_MARKERS,     // 热图上的中心温度和十字线
+    SCENE_LAYER_FOCUS,       // 焦点标记和锁定图标
+    SCENE_LAYER_OVERLAY,     // 临时提示消息
+    SCENE_LAYER_COUNT
+} eSceneLayer;
+
+// 界面部件（签名改变时重绘所在图层）
+typedef enum {
+    SCENE_WIDGET_TITLE = 0,
+    SCENE_WIDGET_FOCUS,
+    SCENE_WIDGET_PANEL,
+    SCENE_WIDGET_MARKERS,
+    SCENE_WIDGET_OVERLAY,
+    SCENE_WIDGET_COUNT
+} eSceneWidget;
+
+// 合成目标：布局、在合成器中创建的图层，以及上一次合成时的输入
+typedef struct {
+    sSceneLayout layout;
+    int8_t layers[SCENE_LAYER_COUNT];
+    const sSceneFrame* pFrame;       // 上一次合成的帧
+    uint32_t frameVersion;
+    const sSceneUiState* pUi;
+    uint32_t widgetSig[SCENE_WIDGET_COUNT];
+} sSceneTarget;
+
+// 分配计算结果缓冲区（放大后的尺寸 width x height），失败返回 false
+bool scene_AllocFrame(sSceneFrame* pFrame, uint16_t width, uint16_t height);
+
+// 分配计算阶段的工作缓冲区，失败返回 false
+bool scene_AllocScratch(sSceneScratch* pScratch);
+
+// 计算阶段的输入签名（量程、调色板、插值），改变后需要用同一帧重新计算
+uint32_t scene_ComputeSignature(const sSceneUiState* pUi);
+
+// 计算阶段：pFrame->frame 已填好，生成量程、查找表和放大后的调色板坐标图
+void scene_Compute(sSceneFrame* pFrame, const sSceneUiState* pUi, sSceneScratch* pScratch);
+
+// 在合成器中创建图层（dispcolor 已初始化），失败返回 false
+bool scene_InitTarget(sSceneTarget* pTarget, const sSceneLayout* pLayout);
+
+// 合成一帧：只重绘输入改变了的图层（pFrame 为 NULL 时只绘制界面），返回是否绘制了内容
+// 只写显存，刷新由调用者用 dispcolor_Update 完成
+bool scene_ComposeFrame(const sSceneFrame* pFrame, const sSceneUiState* pUi, sSceneTarget* pTarget);
+
+#endif
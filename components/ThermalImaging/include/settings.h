@@ -1,7 +1,12 @@
 #ifndef SETTINGS_H_
 #define SETTINGS_H_
 
+#ifdef ESP_PLATFORM
 #include "esp_system.h"
+#else
+#include <stdbool.h>
+#include <stdint.h>
+#endif
 
 // 原始热谱图的分辨率
 #define THERMALIMAGE_RESOLUTION_WIDTH 32 // 宽
@@ -48,7 +53,7 @@ typedef enum {
     Scale_Prev,
     Markers_OnOff,
     Save_BMP16, // 保存BMP16
-    Save_CSV, // 保存CSV
+    Save_CSV, // 保存温度图（辐射快照）
     Brightness_Plus, // 增加背光
     Brightness_Minus, // 减小背光
     Save_90640Params, // 保存 90640 参数表
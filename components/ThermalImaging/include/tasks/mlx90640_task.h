@@ -1,8 +1,19 @@
 #ifndef _MLX90640_TASK_H_
 #define _MLX90640_TASK_H_
 
+#ifdef ESP_PLATFORM
 #include "esp_system.h"
+#endif
 #include "settings.h"
+#include "driver_MLX90640.h"
+
+// MLX90640 最大最小温度
+#define MIN_TEMP -40
+#define MAX_TEMP 300
+
+// 整帧粗直方图：从 MIN_TEMP 开始每 FRAME_HIST_STEP 度一个桶，超出范围的计入首尾桶
+#define FRAME_HIST_STEP 10
+#define FRAME_HIST_BINS ((MAX_TEMP - MIN_TEMP) / FRAME_HIST_STEP)
 
 typedef struct
 {
@@ -17,11 +28,21 @@ typedef struct
 	int8_t minT_Y;
 	int8_t maxT_X; // 最大温度 坐标
 	int8_t maxT_Y;
+
+	// 以下统计在采集时由 framestats_Calc 计算，只统计有效像素
+	float AvgT; // 平均温度
+	float VarT; // 方差
+	float StdT; // 标准差
+	uint16_t ValidCount; // 有效像素数
+	uint16_t NanCount; // 无效像素数（NaN/Inf）
+	uint16_t Hist[FRAME_HIST_BINS]; // 粗直方图
+
+	uint32_t FrameSeq; // 帧序号（从 1 开始递增）
+	uint32_t TimestampUs; // 帧数据读取完成的时间（微秒，与 profiler_Now 同一时基）
 } sMlxData;
 
-// MLX90640 最大最小温度
-#define MIN_TEMP -40
-#define MAX_TEMP 300
+// 帧缓冲槽数：最新完成的帧 + 读者占用的帧 + 正在采集的帧
+#define MLX_FRAME_SLOTS 3
 
 extern const float FPS_RATES[];
 extern const int FPS_RATES_COUNT;
@@ -42,4 +63,13 @@ void mlx90640_task(void* arg);
 
 uint8_t setMLX90640IsPause(uint8_t isPause);
 
+// 取出最新的完整帧（采集任务不会覆盖被取出的帧），没有数据时返回 NULL，用完后调用 mlx90640_ReleaseFrame
+const sMlxData* mlx90640_AcquireLatest(void);
+
+// 归还 mlx90640_AcquireLatest 取出的帧
+void mlx90640_ReleaseFrame(const sMlxData* pFrame);
+
+// 采集完成但在被取出前就被更新的帧覆盖（丢弃）的帧数
+uint32_t mlx90640_GetDroppedFrames(void);
+
 #endif /* _MLX90640_TASK_H_ */
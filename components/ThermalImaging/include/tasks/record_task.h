@@ -0,0 +1,55 @@
+#ifndef _RECORD_TASK_H_
+#define _RECORD_TASK_H_
+
+#include "esp_system.h"
+#include "mlx90640_task.h"
+#include <stdbool.h>
+
+// 录像任务：采集任务把每一帧温度复制到两个帧缓冲之一（双缓冲，不等待写文件），
+// 录像任务编码（见 recording.h）后攒成块，写满的块交给写文件任务追加到 *.TIV 文件，写一块时继续编码下一块；
+// 两个帧缓冲都在排队时丢弃新帧。
+// 插着 SD 卡时录像写在卡上（交给 SD 卡流式写入任务，见 sdstream_task.h），否则写内置存储
+
+// 帧缓冲数
+#define RECORD_SLOT_COUNT 2
+// 编码后的数据攒够一块再写文件
+#define RECORD_BLOCK_SIZE (8 * 1024)
+// 块数（一块在写文件时编码下一块）
+#define RECORD_BLOCK_COUNT 2
+// 等待空闲块的最长时间（毫秒），超时说明存储写不动了，停止录像
+#define RECORD_STALL_TIMEOUT_MS 3000
+// 开始录像时至少需要的剩余空间
+#define RECORD_MIN_FREE (64 * 1024)
+
+// 录像统计
+typedef struct {
+    bool active;        // 正在录像
+    int32_t fileIndex;  // 文件序号
+    bool sdCard;        // 录像写在 SD 卡上
+    uint32_t frames;    // 已写入的帧数
+    uint32_t keyFrames; // 其中的关键帧数
+    uint32_t dropped;   // 帧缓冲满而丢弃的帧数
+    uint32_t bytes;     // 文件字节数（包括还没有写出的块）
+    uint32_t elapsedMs; // 第一帧到最新一帧的时间
+    int lastError;      // SAVE_OK，或录像因写文件失败而停止时的 SAVE_ERR_xxx
+} sRecordStats;
+
+// 分配帧缓冲并启动录像任务
+bool recordtask_Init(void);
+
+// 开始录像，返回 SAVE_OK 或 SAVE_ERR_xxx，pIndex 输出文件序号（可以为 NULL）
+int recordtask_Start(int32_t* pIndex);
+
+// 停止录像（等待剩余的帧写完并关闭文件），返回录像结果，pStats 输出最终统计（可以为 NULL）
+int recordtask_Stop(sRecordStats* pStats);
+
+// 是否正在录像
+bool recordtask_IsActive(void);
+
+// 采集任务每完成一帧调用：录像时复制到空闲的帧缓冲，没有空闲缓冲时丢弃
+void recordtask_OnFrame(const sMlxData* pFrame);
+
+// 读取统计
+void recordtask_GetStats(sRecordStats* pStats);
+
+#endif /* _RECORD_TASK_H_ */
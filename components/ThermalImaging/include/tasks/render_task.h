@@ -9,8 +9,8 @@ extern EventGroupHandle_t pHandleEventGroup;
 extern SemaphoreHandle_t pSPIMutex;
 
 typedef enum _render_type {
-    RENDER_MLX90640_NO0 = 1 << 0, // 第0帧
-    RENDER_MLX90640_NO1 = 1 << 1, // 第1帧
+    RENDER_MLX90640_NO0 = 1 << 0, // 有新的一帧（用 mlx90640_AcquireLatest 取最新帧）
+    RENDER_MLX90640_NO1 = 1 << 1, // 第1帧（保留兼容）
     RENDER_ShortPress_Up = 1 << 2, // Up按钮 (保留兼容)
     RENDER_Hold_Up = 1 << 3, // Up按钮长按 (保留兼容)
     RENDER_ShortPress_Center = 1 << 4, // Center按钮 (保留兼容)
@@ -25,6 +25,9 @@ typedef enum _render_type {
     RENDER_Encoder_Up = 1 << 11,    // 编码器左转 = 值增加/向上
     RENDER_Encoder_Down = 1 << 12,  // 编码器右转 = 值减少/向下
     RENDER_Encoder_Press = 1 << 13, // 编码器按下 = 确认
+    // 渲染流水线
+    RENDER_Recompute = 1 << 14, // 请求计算阶段用上一帧数据重新计算（界面状态改变）
+    RENDER_FrameReady = 1 << 15, // 计算阶段有新的帧可以合成
 } render_type;
 
 void render_task(void* arg);
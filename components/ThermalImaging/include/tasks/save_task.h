@@ -0,0 +1,59 @@
+#ifndef _SAVE_TASK_H_
+#define _SAVE_TASK_H_
+
+#include "esp_system.h"
+#include <stdbool.h>
+
+// 存储任务：截图和温度图先复制到缓冲池，再由低优先级任务写入 SPIFFS，实时画面不用等待写文件
+
+// 等待写入的最大任务数
+#define SAVE_QUEUE_DEPTH 4
+// 缓冲池大小（每个缓冲区一整屏 RGB565），决定同时排队/写入的截图数
+#define SAVE_POOL_SIZE 2
+
+// 保存任务类型
+typedef enum {
+    SAVE_JOB_BMP = 0, // 屏幕截图（BMP）
+    SAVE_JOB_SNAPSHOT, // 温度图（辐射快照）
+    SAVE_JOB_QOI, // 屏幕截图（QOI 压缩）
+} eSaveJob;
+
+// 一次保存的结果
+typedef struct {
+    eSaveJob type;
+    int result; // SAVE_OK / SAVE_ERR_xxx
+    int32_t fileIndex; // 文件序号
+    uint32_t bytes; // 写入的字节数（截图为屏幕数据的字节数）
+    uint32_t writeUs; // 写文件耗时
+} sSaveResult;
+
+// 统计
+typedef struct {
+    uint32_t submitted; // 已排队
+    uint32_t completed; // 写入成功
+    uint32_t failed; // 写入失败
+    uint32_t rejected; // 队列或缓冲池满，没有排队
+    uint8_t depth; // 当前排队和正在写入的任务数
+    uint8_t maxDepth; // 最大排队深度
+    uint32_t bytesWritten; // 累计写入字节数
+    uint32_t writeUs; // 累计写文件耗时
+} sSaveStats;
+
+// 分配缓冲池并启动存储任务
+bool savetask_Init(void);
+
+// 保存任务类型对应的文件扩展名
+const char* savetask_Extension(eSaveJob type);
+
+// 复制当前屏幕（SAVE_JOB_BMP / SAVE_JOB_QOI，bits 为 BMP 位数）或最新一帧温度（SAVE_JOB_SNAPSHOT）并排队，不等待缓冲区
+// wait 为 true 时等待写完，结果写到 pResult；否则结果由 savetask_PollResult 取出
+// 返回 SAVE_OK 或 SAVE_ERR_xxx（排队失败，或 wait 时的写入结果）
+int savetask_Submit(eSaveJob type, uint8_t bits, bool wait, sSaveResult* pResult);
+
+// 取出一个已完成的（不等待的）保存结果，没有时返回 false
+bool savetask_PollResult(sSaveResult* pResult);
+
+// 读取统计
+void savetask_GetStats(sSaveStats* pStats);
+
+#endif /* _SAVE_TASK_H_ */
@@ -3,6 +3,9 @@
 
 #include "esp_system.h"
 
+// 挂载位置
+#define SD_MOUNT_POINT "/sdcard"
+
 uint8_t sdcardIsMount();
 void sdcard_task(void* arg);
 
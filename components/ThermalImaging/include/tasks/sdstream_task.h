@@ -0,0 +1,77 @@
+#ifndef _SDSTREAM_TASK_H_
+#define _SDSTREAM_TASK_H_
+
+#include "esp_system.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// SD 卡流式写入任务：调用者把数据复制进簇对齐的大缓冲，写满的缓冲交给流式写入任务整块写入（不经过 stdio 缓冲），
+// 调用者不等待 SD 卡，只有所有缓冲都在排队时才等待。
+// 文件创建时预分配 SDSTREAM_PREALLOC_SIZE（写满后再扩展），写入时不再分配簇、改写 FAT 表，关闭时截断到实际长度。
+// 拔卡时（卡检测中断）立即关闭文件，之后的写入返回 SAVE_ERR_ACCESS；拔卡时文件长度停在预分配的大小
+
+// 每块缓冲的大小，是簇大小（不超过 32KB）的整数倍，格式化时也用它作簇大小
+#define SDSTREAM_BUFFER_SIZE (32 * 1024)
+// 缓冲块数（在可以 DMA 的内部 RAM 中，第一次打开文件时分配），能吸收卡内部整理时几百毫秒的写入停顿
+#define SDSTREAM_BUFFER_COUNT 3
+// 每次预分配的文件长度
+#define SDSTREAM_PREALLOC_SIZE (16 * 1024 * 1024)
+// 等待空闲缓冲的最长时间（毫秒），超时说明卡写不动了
+#define SDSTREAM_STALL_TIMEOUT_MS 3000
+// 拔卡时等待写入任务关闭文件的最长时间（毫秒），写入任务可能正卡在对已拔出的卡的写入里
+#define SDSTREAM_EJECT_TIMEOUT_MS 1000
+
+// 写入测试（菜单 Storage Test）每项写入的数据量：SD 卡 / 内置存储
+#define SDSTREAM_BENCH_SD_SIZE (4 * 1024 * 1024)
+#define SDSTREAM_BENCH_FLASH_SIZE (128 * 1024)
+// 写入测试的项数：SD 卡流式写入、SD 卡普通写入、内置存储
+#define SDSTREAM_BENCH_COUNT 3
+
+// 流式写入统计（当前或最近一个文件）
+typedef struct {
+    bool open;           // 文件已打开
+    int32_t fileIndex;   // 文件序号
+    uint32_t bytes;      // 已交给写入任务的字节数
+    uint32_t written;    // 已写入卡的字节数
+    uint32_t writes;     // 整块写入的次数
+    uint32_t waits;      // 调用者等待空闲缓冲的次数
+    uint32_t maxWriteUs; // 最慢的一次整块写入
+    uint32_t preallocs;  // 预分配的次数
+    int lastError;       // SAVE_OK 或 SAVE_ERR_xxx
+} sSdStreamStats;
+
+// 启动流式写入任务（缓冲在第一次打开文件时分配）
+bool sdstreamtask_Init(void);
+
+// 在 SD 卡上创建新文件（序号接着卡上同类文件的最大序号），返回 SAVE_OK 或 SAVE_ERR_xxx
+int sdstreamtask_Open(const char* pExtension, int32_t* pIndex);
+
+// 追加数据（复制到缓冲后返回），返回 SAVE_OK 或 SAVE_ERR_xxx
+int sdstreamtask_Write(const void* pData, size_t size);
+
+// 写出剩余数据，截断预分配的部分并关闭文件，返回结果，pSize 输出文件长度（可以为 NULL）
+int sdstreamtask_Close(uint32_t* pSize);
+
+// 卡将被卸载：停止写入并关闭文件（SD 卡任务在拔卡和卸载前调用），写入任务没有及时关闭文件时返回 false，这时还不能卸载
+bool sdstreamtask_Eject(void);
+
+// 读取统计
+void sdstreamtask_GetStats(sSdStreamStats* pStats);
+
+// 一项写入测试的结果
+typedef struct {
+    const char* pLabel; // "SD stream" / "SD stdio" / "internal"
+    int result;         // SAVE_OK 或 SAVE_ERR_xxx（没有卡时 SD 的两项为 SAVE_ERR_ACCESS）
+    uint32_t bytes;     // 写入的字节数
+    uint32_t rate;      // 字节/秒
+    uint32_t p50Us;     // 每次写入调用（一帧）的耗时：中位数
+    uint32_t p99Us;     // 99% 分位
+    uint32_t maxUs;     // 最慢
+    bool sustained;     // 能否跟上 64Hz 原始帧（速率够，最慢一次调用不超过一帧的时间）
+} sSdStreamBench;
+
+// 写入测试：按 64Hz 原始温度帧的大小连续写入，比较 SD 卡流式写入、SD 卡普通写入和内置存储（测试文件写完后删除），
+// 结果同时输出到串口。不能和录像、延时摄影同时运行，返回 SAVE_OK 或 SAVE_ERR_xxx
+int sdstreamtask_Bench(sSdStreamBench pResults[SDSTREAM_BENCH_COUNT]);
+
+#endif /* _SDSTREAM_TASK_H_ */
@@ -0,0 +1,97 @@
+#ifndef _TIMELAPSE_TASK_H_
+#define _TIMELAPSE_TASK_H_
+
+#include "esp_system.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// 定时拍摄任务：两次拍摄之间暂停传感器读取，屏幕关闭时 CPU 进入浅睡眠（定时器或旋钮按键唤醒）；
+// 到时间后恢复读取，等传感器送出新帧后取一帧，再暂停读取。
+// 一次定时拍摄的所有帧写入同一个文件：辐射快照按录像格式编码（*.TIV，见 recording.h），统计写成 CSV（*.TLS），
+// 攒够 TIMELAPSE_BATCH_CAPTURES 帧或 TIMELAPSE_BATCH_MAX_S 秒后追加一次
+
+// 最短拍摄间隔（秒）
+#define TIMELAPSE_MIN_INTERVAL_S 1
+// 恢复读取后保存第几帧（第一帧可能带着暂停前读出的子页）
+#define TIMELAPSE_SETTLE_FRAMES 2
+// 等待新帧的最长时间（毫秒），超时记为一次失败的拍摄
+#define TIMELAPSE_SETTLE_TIMEOUT_MS 3000
+// 等待新帧时查询的间隔（毫秒）
+#define TIMELAPSE_SETTLE_POLL_MS 20
+// 攒够多少帧写一次文件
+#define TIMELAPSE_BATCH_CAPTURES 16
+// 攒着的帧最多等多久写文件（秒），断电时最多丢失这么长时间的数据
+#define TIMELAPSE_BATCH_MAX_S 900
+// 写文件前攒数据的缓冲
+#define TIMELAPSE_BLOCK_SIZE (16 * 1024)
+// 开始定时拍摄时至少需要的剩余空间
+#define TIMELAPSE_MIN_FREE (16 * 1024)
+// 距离下次拍摄不足这么久（毫秒）时不再睡眠
+#define TIMELAPSE_SLEEP_MIN_MS 50
+// 唤醒浅睡眠的按键（旋钮按键，低电平有效）
+#define TIMELAPSE_WAKE_GPIO GPIO_NUM_11
+// 按键唤醒后保持运行多久（毫秒），让按键任务和界面处理输入
+#define TIMELAPSE_WAKE_GRACE_MS 3000
+// 状态画面无操作多久后关闭屏幕（毫秒）
+#define TIMELAPSE_SCREEN_OFF_MS 15000
+
+// 功耗估算（毫瓦，3.3V）：没有电量计，按各状态的时间乘以下面的典型值估算能量；
+// MLX90640 没有休眠模式，暂停读取时仍在测量（约 23mA），是浅睡眠时的主要功耗
+#define TIMELAPSE_POWER_ACTIVE_MW 300 // CPU 运行，读取传感器、编码、写文件
+#define TIMELAPSE_POWER_IDLE_MW 180   // CPU 空闲等待（屏幕开着或刚被唤醒）
+#define TIMELAPSE_POWER_SLEEP_MW 80   // 浅睡眠
+#define TIMELAPSE_POWER_SCREEN_MW 120 // 屏幕和背光（另加）
+
+// 每次拍摄保存的内容
+typedef enum {
+    TIMELAPSE_MODE_SNAPSHOT = 0, // 整帧温度（*.TIV）
+    TIMELAPSE_MODE_STATS,        // 温度统计（*.TLS）
+} eTimelapseMode;
+
+typedef struct {
+    uint32_t intervalS;   // 拍摄间隔（秒）
+    eTimelapseMode mode;
+    uint32_t maxCaptures; // 拍够后自动停止，0 表示不限
+} sTimelapseConfig;
+
+// 定时拍摄统计
+typedef struct {
+    bool active;          // 正在定时拍摄
+    int32_t fileIndex;    // 文件序号
+    eTimelapseMode mode;
+    uint32_t intervalS;
+    uint32_t captures;    // 已拍摄的帧数
+    uint32_t failed;      // 等不到新帧的次数
+    uint32_t pending;     // 其中还没有写入文件的帧数
+    uint32_t batches;     // 追加写入文件的次数
+    uint32_t bytes;       // 已写入文件的字节数
+    uint32_t wakeups;     // 被按键唤醒的次数
+    uint32_t nextMs;      // 距离下次拍摄的时间
+    uint64_t activeUs;    // 拍摄用的时间
+    uint64_t idleUs;      // 空闲等待的时间
+    uint64_t sleepUs;     // 浅睡眠的时间
+    uint64_t screenUs;    // 屏幕开着的时间
+    float energyMj;       // 估算的总能量
+    float captureMj;      // 估算的每次拍摄能量（总能量 / 拍摄数）
+    int lastError;        // SAVE_OK，或定时拍摄因写文件失败而停止时的 SAVE_ERR_xxx
+} sTimelapseStats;
+
+// 分配缓冲并启动定时拍摄任务
+bool timelapsetask_Init(void);
+
+// 开始定时拍摄（立即拍摄第一帧），返回 SAVE_OK 或 SAVE_ERR_xxx，pIndex 输出文件序号（可以为 NULL）
+int timelapsetask_Start(const sTimelapseConfig* pConfig, int32_t* pIndex);
+
+// 停止定时拍摄（写出攒着的帧），返回结果，pStats 输出最终统计（可以为 NULL）
+int timelapsetask_Stop(sTimelapseStats* pStats);
+
+// 是否正在定时拍摄
+bool timelapsetask_IsActive(void);
+
+// 界面打开/关闭屏幕时调用：屏幕关闭时才进入浅睡眠，屏幕时间计入能量估算
+void timelapsetask_SetScreenOn(bool on);
+
+// 读取统计
+void timelapsetask_GetStats(sTimelapseStats* pStats);
+
+#endif /* _TIMELAPSE_TASK_H_ */
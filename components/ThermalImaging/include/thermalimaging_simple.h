@@ -8,6 +8,7 @@
 // 基本功能 (简化版本只保留必要的)
 #include "console.h"
 #include "func.h"
+#include "save.h"
 #include "settings.h"
 
 // LCD显示
@@ -18,6 +19,8 @@
 #include "f6x8m.h"
 #include "font.h"
 #include "st7789.h"
+#include "textcache.h"
+#include "compositor.h"
 
 // IIC和MLX90640热成像传感器
 #include "MLX90640_I2C_Driver.h"
@@ -28,5 +31,10 @@
 #include "buttons_task.h"
 #include "render_task.h"
 #include "mlx90640_task.h"
+#include "save_task.h"
+#include "record_task.h"
+#include "timelapse_task.h"
+#include "sd_task.h"
+#include "sdstream_task.h"
 
 #endif // _THERMALIMAGING_H
\ No newline at end of file
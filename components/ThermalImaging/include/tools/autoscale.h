@@ -0,0 +1,35 @@
+#ifndef _AUTOSCALE_H
+#define _AUTOSCALE_H
+
+#include "mlx90640_task.h"
+
+// 每端裁掉的像素比例（千分比）：5 = 去掉最冷和最热各 0.5% 的像素，坏点和反光不会拉大量程
+#define AUTOSCALE_CLIP_PERMILLE     5
+// 每端最多裁掉的像素数
+#define AUTOSCALE_MAX_CLIP          8
+// 量程扩大时每帧向目标靠近的比例（快速跟上新出现的冷热物体）
+#define AUTOSCALE_ATTACK            0.5f
+// 量程缩小时每帧向目标靠近的比例（慢慢收回，画面不闪）
+#define AUTOSCALE_DECAY             0.05f
+// 量程量化步长（度），量程只在跨过整步时改变，下游查找表不用每帧重建
+#define AUTOSCALE_STEP              0.5f
+// 最小量程（度），温度均匀的画面不把噪声放大成满色阶
+#define AUTOSCALE_MIN_SPAN          2.0f
+
+// 自动量程跟踪状态
+typedef struct {
+    bool valid;          // 已经跟踪过至少一帧
+    uint32_t lastSeq;    // 上一次跟踪的帧序号（重新计算同一帧时不再平滑）
+    float smoothMin;     // 平滑后的量程
+    float smoothMax;
+    float minT;          // 量化后的输出量程
+    float maxT;
+} sAutoScale;
+
+// 清除跟踪状态，下一帧直接取该帧的量程
+void autoscale_Reset(sAutoScale* pState);
+
+// 用一帧数据更新量程：百分位裁剪 -> 扩大快、缩小慢的平滑 -> 带回差的量化，结果在 pState->minT/maxT
+void autoscale_Update(sAutoScale* pState, const sMlxData* pFrame);
+
+#endif
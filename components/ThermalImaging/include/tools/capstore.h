@@ -0,0 +1,119 @@
+#ifndef _CAPSTORE_H
+#define _CAPSTORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 日志结构的保存文件存储（直接使用一块原始闪存区域，代替 SPIFFS）
+//  - 区域分成若干段（CAPSTORE_SEGMENT_SIZE），写入只在当前段末尾追加记录：文件数据分块写成 DATA 记录，
+//    关闭文件时追加一条 CLOSE 记录（文件名、大小、版本号），没有 CLOSE 的数据在重新挂载时作废
+//  - 删除、覆盖只把旧记录的状态字节写成 0（闪存只需把位清零，不用擦除），写入时从不擦除，延迟固定
+//  - 垃圾回收按步进行（每步复制一条有效记录或擦除一个扇区），由空闲任务调用，把无效空间尽量变成已擦除的段；
+//    空闲段快用完时写入每块数据前分摊几步回收（CAPSTORE_GC_STEPS_PER_CHUNK），一次写调用最多等这几步，
+//    不会在一次写入里回收整个段。CAPSTORE_SPARE_SEGMENTS 个段不计入容量，存满时也有空闲段和足够的无效空间
+//  - 磨损均衡：新段取擦除次数最少的空闲段；擦除次数差超过 CAPSTORE_WEAR_DELTA 时把最少擦除的段中的冷数据搬走
+//  - 所有记录带 CRC，挂载时扫描整个区域重建内存索引，写到一半断电的记录及其所在段的剩余部分被丢弃
+// 本模块不加锁、不依赖 ESP-IDF，ESP 上由 capstore_vfs 加锁并注册成 VFS，主机上用 capstore_sim 的模拟闪存做基准测试
+
+// 段大小（擦除扇区的整数倍）
+#define CAPSTORE_SEGMENT_SIZE (32 * 1024)
+// 最多段数
+#define CAPSTORE_MAX_SEGMENTS 64
+// 文件名最大长度（含结尾 0）
+#define CAPSTORE_NAME_MAX 24
+// 一条 DATA 记录最多的数据字节数，也是每个写句柄的缓冲区大小
+#define CAPSTORE_CHUNK_SIZE 4096
+// 同时打开的文件数
+#define CAPSTORE_MAX_OPEN 5
+// 留给垃圾回收的空闲段数，写入不能占用
+#define CAPSTORE_GC_RESERVE 1
+// 不计入容量的段数（存满时的回收余量，空闲时回收出的段要能放下一张 BMP 截图）
+#define CAPSTORE_SPARE_SEGMENTS 6
+// 空闲段不多于 CAPSTORE_GC_RESERVE + 这个数时，写入每块数据之前先回收几步（分摊回收一个段的工作）
+#define CAPSTORE_GC_AHEAD 2
+// 写入每块数据（CAPSTORE_CHUNK_SIZE）之前最多的回收步数，每步复制一条记录或擦除一个扇区
+#define CAPSTORE_GC_STEPS_PER_CHUNK 2
+// 擦除次数最大差，超过时做静态磨损均衡
+#define CAPSTORE_WEAR_DELTA 16
+
+// 打开方式
+#define CAPSTORE_READ 0
+#define CAPSTORE_WRITE 1 // 创建或覆盖（关闭时才替换同名文件）
+#define CAPSTORE_APPEND 2 // 追加（文件不存在时创建）
+
+// 闪存后端，地址从 0 开始，出错返回非 0
+typedef struct {
+    uint32_t size; // 区域字节数
+    uint32_t sectorSize; // 擦除单位
+    int (*read)(void* pCtx, uint32_t addr, void* pBuff, size_t size);
+    int (*write)(void* pCtx, uint32_t addr, const void* pData, size_t size); // 只能把位从 1 写成 0
+    int (*erase)(void* pCtx, uint32_t addr, size_t size); // addr、size 是 sectorSize 的整数倍
+    void* pCtx;
+} tCapstoreFlash;
+
+// 存储状态
+typedef struct {
+    uint32_t capacity; // 可用于文件的字节数（不含留给回收的段和余量段）
+    uint32_t used; // 有效记录占用的字节数（含记录头）
+    uint16_t segments;
+    uint16_t freeSegments; // 已擦除的段
+    uint16_t files;
+    uint32_t eraseMin; // 段擦除次数
+    uint32_t eraseMax;
+    uint32_t eraseAvg;
+    uint64_t hostBytes; // 写入的文件数据字节数
+    uint64_t flashBytes; // 实际写入闪存的字节数（含记录头、回收复制）
+    uint32_t gcCopied; // 回收复制的记录数
+    uint32_t gcErased; // 回收擦除的段数
+    uint32_t foregroundGc; // 写入时执行的回收步数（分摊的和没有空闲段时的）
+    uint32_t gcStalls; // 写入时空闲段用完、必须一次回收出一个段的次数
+} sCapstoreInfo;
+
+// 挂载：扫描闪存重建索引，返回 0 或 -errno
+//  - 没有有效段头时只有整个区域都是擦除状态才格式化；区域中是其他数据（如旧的 SPIFFS）时不修改，返回 -ENODEV
+//  - 读闪存出错时不修改闪存，返回 -EIO（不当作空白区域或写坏的记录）
+int capstore_Mount(const tCapstoreFlash* pFlash);
+
+// 卸载（未关闭的写句柄丢弃）
+void capstore_Unmount(void);
+
+// 擦除全部段、写段头并挂载为空存储（区域中的数据全部丢失，只在数据已经迁移或用户确认后调用）
+bool capstore_Format(const tCapstoreFlash* pFlash);
+
+// 打开文件，返回句柄（>= 0）或 -errno
+int capstore_Open(const char* pName, int mode);
+
+// 读写，返回字节数或 -errno
+int capstore_Read(int handle, void* pBuff, size_t size);
+int capstore_Write(int handle, const void* pData, size_t size);
+
+// 读句柄可任意定位；写句柄只能查询当前位置（offset 为 0 的 SEEK_CUR / SEEK_END），返回新位置或 -errno
+long capstore_Seek(int handle, long offset, int whence);
+
+// 关闭：写句柄写出剩余数据和 CLOSE 记录，返回 0 或 -errno
+int capstore_Close(int handle);
+
+// 文件大小（写句柄为已写入的字节数），返回 -errno 表示句柄无效
+long capstore_Size(int handle);
+
+// 删除 / 改名（目标存在时替换），返回 0 或 -errno
+int capstore_Remove(const char* pName);
+int capstore_Rename(const char* pFrom, const char* pTo);
+
+// 文件是否存在，pSize 可以为 NULL
+bool capstore_Stat(const char* pName, uint32_t* pSize);
+
+// 按下标列出文件（0 .. files-1，删除文件后下标会变化），返回 false 表示没有更多文件
+bool capstore_List(int index, char* pName, size_t nameSize, uint32_t* pSize);
+
+// 存储状态
+void capstore_Info(sCapstoreInfo* pInfo);
+
+// 是否有回收工作（空闲段不足或正在回收一个段）
+bool capstore_NeedsGc(void);
+
+// 执行一步回收，返回 false 表示没有可做的工作
+bool capstore_GcStep(void);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef _CAPSTORE_SIM_H
+#define _CAPSTORE_SIM_H
+
+#include "capstore.h"
+
+// 内存中的模拟 NOR 闪存（主机上测试 capstore 的延迟、磨损和断电恢复）
+// 只用于 tools/ 下的主机程序，不编进固件（CMakeLists.txt 中没有 capstore_sim.c）
+//  - 写入只能把位从 1 变成 0，违反时计数
+//  - 按典型 SPI NOR 的时间累计读、写、擦除耗时（模拟时间，不真的等待）
+//  - 可以在写入到第 N 个字节时模拟断电：只写入前面的部分，之后所有写入和擦除都失败（擦除一个扇区按扇区大小计入，断电时只擦除一半）
+
+// 时间模型（微秒），数值取自常见 SPI NOR 数据手册的典型值
+#define CAPSTORESIM_PAGE_SIZE 256
+#define CAPSTORESIM_PAGE_PROGRAM_US 700.0 // 每页编程
+#define CAPSTORESIM_BYTE_PROGRAM_US 0.1 // 每字节传输
+#define CAPSTORESIM_SECTOR_ERASE_US 45000.0 // 每个 4KB 扇区擦除
+#define CAPSTORESIM_BYTE_READ_US 0.05 // 每字节读取（约 20MB/s）
+#define CAPSTORESIM_OP_US 20.0 // 每次操作的命令开销
+
+typedef struct {
+    uint8_t* pData;
+    uint32_t size;
+    uint32_t sectorSize;
+    uint32_t* pEraseCounts; // 每个扇区的擦除次数
+    double timeUs; // 累计的模拟耗时
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+    uint64_t erases;
+    uint32_t violations; // 写入试图把 0 变成 1 的次数
+    int64_t failAfter; // 再写入（或擦除）多少字节后断电，< 0 表示不断电
+    bool failed; // 已经断电
+} sCapstoreSim;
+
+// 分配模拟闪存（全部为擦除状态）
+bool capstoresim_Init(sCapstoreSim* pSim, uint32_t size, uint32_t sectorSize);
+
+// 释放
+void capstoresim_Free(sCapstoreSim* pSim);
+
+// 填写 capstore 的闪存后端
+void capstoresim_GetFlash(sCapstoreSim* pSim, tCapstoreFlash* pFlash);
+
+#endif
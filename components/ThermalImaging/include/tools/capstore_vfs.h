@@ -0,0 +1,21 @@
+#ifndef _CAPSTORE_VFS_H
+#define _CAPSTORE_VFS_H
+
+#include "capstore.h"
+#include <stdbool.h>
+
+// capstore 在 ESP 上的封装：闪存后端是数据分区，所有调用加锁，注册成 VFS 后 fopen / remove / rename / opendir 照常使用，
+// 另有一个低优先级任务在存储空闲时执行回收
+
+// 存储空闲多久后开始回收（毫秒）
+#define CAPSTORE_VFS_IDLE_MS 200
+
+// 挂载分区，注册 VFS 并启动回收任务
+//  - 分区全部为擦除状态时格式化；分区中是旧的 SPIFFS 时把文件暂存到内存后格式化并写回
+//  - 其他数据、读闪存出错、内存不够暂存时不修改分区，返回 false
+bool capstorevfs_Mount(const char* pBasePath, const char* pPartitionLabel);
+
+// 存储状态（加锁读取），未挂载时返回 false
+bool capstorevfs_Info(sCapstoreInfo* pInfo);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef _FRAMESTATS_H
+#define _FRAMESTATS_H
+
+#include "mlx90640_task.h"
+
+// 一次遍历计算整帧统计并写入 pMlxData：
+// 中心温度、最小/最大温度及坐标（限制在 MIN_TEMP..MAX_TEMP）、平均值、方差、标准差、粗直方图、无效像素数
+void framestats_Calc(sMlxData* pMlxData);
+
+#endif
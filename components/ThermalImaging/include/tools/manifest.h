@@ -0,0 +1,53 @@
+#ifndef _MANIFEST_H
+#define _MANIFEST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 保存文件清单：目录下每个保存文件（序号 + 类型扩展名，如 00012.BMP）的序号、大小和时间
+// 清单文件只追加记录（添加/删除），打开时重放到内存；清单缺失、损坏或与目录不一致时才扫描目录重建
+// 保存、列表和删除都只查内存表，不再遍历目录
+
+// 最多管理的文件类型数（超出时 manifest_Open 失败）
+#define MANIFEST_MAX_TYPES 8
+// 清单文件名（在保存目录下）
+#define MANIFEST_FILE_NAME "CAPTURES.IDX"
+// 清单中的删除记录超过有效记录数加这个数时压缩（重写清单）
+#define MANIFEST_COMPACT_SLACK 32
+
+// 一个保存文件
+typedef struct {
+    uint32_t Id; // 文件序号
+    uint32_t Size; // 字节数
+    uint32_t Timestamp; // 保存时间（UNIX 秒）
+} sManifestEntry;
+
+// 打开保存目录的清单：pExtensions[type] 为每种类型的扩展名（如 ".BMP"），返回 false 表示类型数超出或目录不可用
+bool manifest_Open(const char* pDir, const char* const* pExtensions, uint8_t typeCount);
+
+// 下一个文件序号（该类型的最大序号 + 1）
+uint32_t manifest_NextId(uint8_t type);
+
+// 文件的完整路径
+void manifest_FilePath(uint8_t type, uint32_t id, char* pOut, size_t size);
+
+// 记录新文件
+bool manifest_Add(uint8_t type, uint32_t id, uint32_t size, uint32_t timestamp);
+
+// 删除文件（先追加删除记录再删除文件），返回 remove() 的结果
+int manifest_Remove(uint8_t type, uint32_t id);
+
+// 删除该类型的全部文件，返回删除的文件数
+int manifest_RemoveAll(uint8_t type);
+
+// 该类型的文件数
+int manifest_Count(uint8_t type);
+
+// 按序号从小到大取出该类型的文件，从第 first 个开始最多 maxCount 个，返回取出的个数
+int manifest_List(uint8_t type, int first, sManifestEntry* pOut, int maxCount);
+
+// 扫描目录重建清单（发现清单与目录不一致时调用）
+bool manifest_Rebuild(void);
+
+#endif
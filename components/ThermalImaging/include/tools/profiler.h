@@ -0,0 +1,87 @@
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#ifdef ESP_PLATFORM
+#include "esp_system.h"
+#else
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+// 为 0 时所有计时宏为空操作
+#define PROFILER_ENABLE             1
+
+// 最多命名阶段数
+#define PROFILER_MAX_SCOPES         16
+// 采样环大小（2 的幂），汇总前最多缓存的采样数，写满后最旧的采样计入丢弃数
+#define PROFILER_RING_SIZE          256
+// 直方图桶数：0..3us 每微秒一个桶，之后每个 2 的幂区间分 4 个桶（80 个桶覆盖到约 2 秒）
+#define PROFILER_HIST_BINS          80
+
+// 一个阶段的统计结果（微秒）
+typedef struct {
+    const char* name;
+    uint32_t count;
+    uint32_t min;
+    uint32_t avg;
+    uint32_t p99; // 直方图估计值（所在桶的上界）
+    uint32_t max;
+} sProfilerStats;
+
+// 整帧统计
+typedef struct {
+    uint32_t frames;
+    uint32_t overBudget; // 超出帧预算的帧数
+    uint32_t budgetUs;
+    uint32_t worstUs;
+    uint32_t dropped; // 汇总前被覆盖的采样数
+} sProfilerFrameStats;
+
+// 返回单调递增的微秒时间
+uint32_t profiler_Now(void);
+
+// 按名字注册阶段（同名返回同一个ID），失败返回 -1
+int8_t profiler_Register(const char* name);
+
+// 记录一次阶段耗时（无锁，任意任务/核心都可以调用）
+void profiler_Record(int8_t scope, uint32_t us);
+
+// 一帧结束：记录整帧耗时并统计超出预算的帧，同时汇总采样环
+void profiler_FrameEnd(uint32_t frameUs);
+
+// 设置帧预算（微秒）
+void profiler_SetFrameBudget(uint32_t budgetUs);
+
+// 把采样环中的新采样汇总到各阶段直方图
+void profiler_Collect(void);
+
+// 读取一个阶段的统计，返回 false 表示阶段不存在
+bool profiler_GetStats(int8_t scope, sProfilerStats* pStats);
+
+// 读取整帧统计
+void profiler_GetFrameStats(sProfilerFrameStats* pStats);
+
+// 把全部统计格式化成文本表格，返回写入的字符数（不含结尾的 0）
+int profiler_Format(char* pBuff, size_t size);
+
+// 把全部统计打印到串口（渲染任务每 300 帧调用一次）。这是统计唯一的输出：网页服务器没有编进固件
+void profiler_Print(void);
+
+// 清零全部统计（已注册的阶段保留）
+void profiler_Reset(void);
+
+#if PROFILER_ENABLE
+// 阶段计时：PROFILE_BEGIN(gauss); ... PROFILE_END(gauss);（BEGIN 和 END 必须在同一个作用域内）
+#define PROFILE_BEGIN(name)                                  \
+    static int8_t _profId_##name = -1;                       \
+    if (_profId_##name < 0)                                  \
+        _profId_##name = profiler_Register(#name);           \
+    uint32_t _profStart_##name = profiler_Now()
+#define PROFILE_END(name) profiler_Record(_profId_##name, profiler_Now() - _profStart_##name)
+#else
+#define PROFILE_BEGIN(name) do { } while (0)
+#define PROFILE_END(name) do { } while (0)
+#endif
+
+#endif
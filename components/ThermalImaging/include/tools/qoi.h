@@ -0,0 +1,63 @@
+#ifndef _QOI_H
+#define _QOI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// QOI 图片（https://qoiformat.org）的流式编码/解码，像素为 RGB565
+// 文件为标准的 3 通道 QOI（RGB565 按位复制扩展为 RGB888，解码时截断回 RGB565，无损），
+// PC 上的 ffmpeg、ImageMagick、GIMP 等可以直接打开
+// 编码和解码都按行进行，只需要几百字节的状态，不需要整幅图的缓冲区
+
+#define QOI_HEADER_SIZE 14
+#define QOI_END_SIZE 8
+
+// 编码 pixels 个像素的最大字节数（每个像素最多 4 字节，加上未结束的游程）
+#define QOI_MAX_ENCODED(pixels) ((size_t)(pixels) * 4 + 1)
+
+// 解码器的读缓冲
+#define QOI_READ_BUFF_SIZE 512
+
+// 编码器状态
+typedef struct {
+    uint32_t Index[64]; // 最近出现的颜色（A << 24 | R << 16 | G << 8 | B）
+    uint32_t Prev;
+    uint16_t PrevRgb565;
+    uint8_t Run;
+} sQoiEncoder;
+
+// 解码器的数据来源，返回读到的字节数，0 表示结束
+typedef size_t (*tQoiRead)(void* pCtx, uint8_t* pBuff, size_t size);
+
+// 解码器状态
+typedef struct {
+    uint32_t Index[64];
+    uint32_t Prev;
+    uint8_t Run;
+    tQoiRead Read;
+    void* pCtx;
+    uint8_t Buff[QOI_READ_BUFF_SIZE];
+    uint16_t Pos;
+    uint16_t Len;
+} sQoiDecoder;
+
+// 写文件头，返回 QOI_HEADER_SIZE
+size_t qoi_EncodeHeader(uint8_t* pOut, uint32_t width, uint32_t height);
+
+// 初始化编码器
+void qoi_EncoderInit(sQoiEncoder* pEncoder);
+
+// 编码 count 个像素（可以是一行或几行）到 pOut（长度至少 QOI_MAX_ENCODED(count)），返回写入的字节数
+size_t qoi_EncodeRgb565(sQoiEncoder* pEncoder, const uint16_t* pPixels, uint32_t count, uint8_t* pOut);
+
+// 结束编码：写出未结束的游程和结束标记，pOut 至少 QOI_END_SIZE + 1 字节，返回写入的字节数
+size_t qoi_EncodeEnd(sQoiEncoder* pEncoder, uint8_t* pOut);
+
+// 读取并检查文件头，初始化解码器
+bool qoi_DecoderInit(sQoiDecoder* pDecoder, tQoiRead read, void* pCtx, uint32_t* pWidth, uint32_t* pHeight);
+
+// 解码 count 个像素到 pOut，返回解码的像素数（数据不完整时小于 count）
+uint32_t qoi_DecodeRgb565(sQoiDecoder* pDecoder, uint16_t* pOut, uint32_t count);
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef _RECORDING_H
+#define _RECORDING_H
+
+#include "snapshot.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// 温度录像文件：快照文件头（Magic 为 RECORDING_MAGIC，没有温度块）+ 连续的帧
+// 每帧 = sRecordingFrameHeader + 变长编码的温度：
+//  - 温度量化为 int16（与快照相同，温度 * TempScale）
+//  - 关键帧用左边（每行第一个用上面）的像素预测，其他帧用上一帧同一像素预测
+//  - 残差 zigzag 后用自适应 Rice 码编码（参数按帧重置，每帧只依赖上一帧）
+// 录像中断时末尾可能有不完整的帧，解码时丢弃；主机端用 tools/recconv.py 导出图片序列
+
+#define RECORDING_MAGIC "TIRV"
+#define RECORDING_VERSION 1
+
+// 帧头同步字
+#define RECORDING_SYNC 0x5246 // "FR"
+
+// 帧类型
+#define RECORDING_FRAME_KEY 0
+#define RECORDING_FRAME_DELTA 1
+
+// 最大像素数（MLX90640）
+#define RECORDING_MAX_PIXELS (32 * 24)
+
+// 每隔多少帧插入一个关键帧（截断或损坏后从关键帧重新同步）
+#define RECORDING_KEY_INTERVAL 32
+
+// Rice 码：商达到 RECORDING_RICE_ESCAPE 时改为直接存放 RECORDING_RICE_RAW_BITS 位的值
+#define RECORDING_RICE_ESCAPE 24
+#define RECORDING_RICE_RAW_BITS 18
+
+// 一帧编码后的最大字节数
+#define RECORDING_MAX_FRAME_SIZE(pixels) \
+    (sizeof(sRecordingFrameHeader) + ((pixels) * (RECORDING_RICE_ESCAPE + RECORDING_RICE_RAW_BITS) + 7) / 8)
+
+typedef struct {
+    uint16_t Sync;        // RECORDING_SYNC
+    uint8_t Type;         // RECORDING_FRAME_xxx
+    uint8_t Reserved;
+    uint16_t PayloadSize; // 编码数据的字节数
+    uint16_t Reserved2;
+    uint32_t FrameSeq;    // 采集任务的帧序号（跳过的序号为丢弃的帧）
+    uint32_t TimeMs;      // 相对录像开始的时间
+    float Ta;             // 传感器环境温度
+} sRecordingFrameHeader;
+
+_Static_assert(sizeof(sRecordingFrameHeader) == 20, "recording frame header layout");
+
+// 编码器状态
+typedef struct {
+    int16_t Prev[RECORDING_MAX_PIXELS]; // 上一帧（预测用）
+    int16_t Cur[RECORDING_MAX_PIXELS];
+    uint8_t Width;
+    uint8_t Height;
+    uint16_t KeyInterval;
+    uint32_t Frames; // 已编码的帧数
+} sRecordingEncoder;
+
+// 填写录像文件头的固定字段（其余字段与快照相同，由调用者填写）
+void recording_InitHeader(sSnapshotHeader* pHeader, uint8_t width, uint8_t height);
+
+// 初始化编码器，下一帧为关键帧
+void recording_EncoderInit(sRecordingEncoder* pEncoder, uint8_t width, uint8_t height, uint16_t keyInterval);
+
+// 编码一帧到 pOut（长度至少 RECORDING_MAX_FRAME_SIZE），返回写入的字节数，pOut 太小时返回 0
+size_t recording_EncodeFrame(sRecordingEncoder* pEncoder, const float* pTemps, uint32_t frameSeq, uint32_t timeMs, float ta,
+    uint8_t* pOut, size_t outSize);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 辐射快照文件：固定长度的文件头 + 温度 int16 块（温度 * TempScale）+ 可选的 float 块
+// 所有字段小端存放，主机端用 tools/snapconv.py 转成 CSV 和 PNG 预览
+
+#define SNAPSHOT_MAGIC "TIRS"
+#define SNAPSHOT_VERSION 1
+
+// 温度 int16 的放大倍数（0.01 度，-40..300 度都在 int16 范围内）
+#define SNAPSHOT_TEMP_SCALE 100
+// int16 块中无效像素（NaN/Inf）的值
+#define SNAPSHOT_INVALID INT16_MIN
+
+// 文件头 Flags
+#define SNAPSHOT_FLAG_FLOAT 0x0001 // int16 块之后还有原始 float 温度块
+
+typedef struct {
+    char Magic[4];                // SNAPSHOT_MAGIC
+    uint16_t Version;             // SNAPSHOT_VERSION
+    uint16_t HeaderSize;          // sizeof(sSnapshotHeader)，新版本只在末尾追加字段
+    uint16_t Flags;
+    uint8_t Width;                // 传感器分辨率
+    uint8_t Height;
+    uint32_t Timestamp;           // UNIX 时间（秒），时钟未设置时为开机后的秒数
+    uint32_t FrameSeq;            // 采集任务的帧序号
+    float Emissivity;             // 辐射率
+    float Ta;                     // 传感器环境温度
+    float Vdd;                    // 传感器供电电压
+    float RefreshRate;            // 刷新率（Hz）
+    uint8_t AdcResolution;        // AD 分辨率（位）
+    uint8_t ScaleMode;            // 插值算法 eScaleMode
+    uint8_t ColorScale;           // 伪彩色 eColorScale
+    uint8_t AutoScale;            // 自动量程
+    uint8_t PaletteCenterPercent; // 调色板 50% 对应的温度在 min..max 中的位置，0-100
+    uint8_t Reserved[3];
+    uint16_t TempScale;           // int16 块的放大倍数
+    uint16_t Reserved2;
+    float ScaleMin;               // 保存时的显示量程
+    float ScaleMax;
+    float MinT;                   // 帧统计
+    float MaxT;
+} sSnapshotHeader;
+
+_Static_assert(sizeof(sSnapshotHeader) == 64, "snapshot header layout");
+
+// 快照文件的字节数
+size_t snapshot_Size(const sSnapshotHeader* pHeader);
+
+// 填写文件头中与帧数据无关的固定字段（Magic、版本、尺寸、放大倍数）
+void snapshot_InitHeader(sSnapshotHeader* pHeader, uint8_t width, uint8_t height, bool withFloat);
+
+// 温度乘以 scale 后取整为 int16，无效像素为 SNAPSHOT_INVALID，超出范围的饱和
+void snapshot_Quantize(const float* pTemps, size_t pixels, uint16_t scale, int16_t* pOut);
+
+// 把文件头和温度编码到 pOut（长度至少 snapshot_Size），返回写入的字节数，pOut 太小时返回 0
+size_t snapshot_Encode(const sSnapshotHeader* pHeader, const float* pTemps, uint8_t* pOut, size_t outSize);
+
+#endif
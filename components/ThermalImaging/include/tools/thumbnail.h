@@ -0,0 +1,39 @@
+#ifndef _THUMBNAIL_H
+#define _THUMBNAIL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 截图的缩略图：保存截图时按 THUMB_SCALE 缩小整屏（每块取平均色），与截图同序号另存一个小文件
+// 文件为 8 字节文件头 + RGB565 像素（按行存放，小端），图库一次 fread 读入后整块显示
+
+#define THUMB_MAGIC "THMB"
+// 缩小倍数：240x240 的屏幕得到 60x60 的缩略图
+#define THUMB_SCALE 4
+// 缩略图最大尺寸（320x320 的屏幕）
+#define THUMB_MAX_WIDTH 80
+#define THUMB_MAX_HEIGHT 80
+
+typedef struct {
+    char Magic[4]; // THUMB_MAGIC
+    uint16_t Width;
+    uint16_t Height;
+} sThumbHeader;
+
+// 一张缩略图（文件内容，按最大尺寸分配）
+typedef struct {
+    sThumbHeader Header;
+    uint16_t Pixels[THUMB_MAX_WIDTH * THUMB_MAX_HEIGHT];
+} sThumbnail;
+
+// 缩略图文件的字节数
+#define THUMB_FILE_SIZE(width, height) (sizeof(sThumbHeader) + (size_t)(width) * (height) * sizeof(uint16_t))
+
+// 把一屏 RGB565 缩小成缩略图，返回文件字节数（0 表示屏幕太大）
+size_t thumbnail_Build(const uint16_t* pScreen, uint16_t width, uint16_t height, sThumbnail* pThumb);
+
+// 检查读入的缩略图文件（size 为读到的字节数）
+bool thumbnail_Check(const sThumbnail* pThumb, size_t size);
+
+#endif
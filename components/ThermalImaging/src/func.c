@@ -141,7 +141,7 @@ static void shortPressButtonHandler(eButtonFunc btnSetup)
 
     case Save_CSV:
         setMLX90640IsPause(1);
-        save_ImageCSV();
+        save_ImageSnapshot();
         setMLX90640IsPause(0);
         break;
 
@@ -1,5 +1,4 @@
 #include "IDW.h"
-#include "esp_log.h"
 
 // 设置指定像素的颜色值
 static inline void set_point(int16_t* pSrc, uint16_t width, uint16_t height, int16_t x, int16_t y, float f)
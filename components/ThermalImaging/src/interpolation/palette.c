@@ -1,7 +1,5 @@
 #include "palette.h"
 #include "dispcolor.h"
-#include <freertos/FreeRTOS.h>
-#include <freertos/task.h>
 
 /**
  * @brief 构建多色 伪彩色
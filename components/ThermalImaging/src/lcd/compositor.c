@@ -0,0 +1,272 @@
+#include "compositor.h"
+#include "dispcolor.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// 图层
+typedef struct {
+    sLayerRect rect;
+    uint8_t z;
+    bool opaque;
+    bool visible;
+    tLayerDrawFunc draw;
+    void* pArg;
+} sLayer;
+
+static sLayer Layers[COMPOSITOR_MAX_LAYERS]; // 按添加顺序存放，下标即图层号
+static int8_t LayerOrder[COMPOSITOR_MAX_LAYERS]; // 按 z 从低到高排列的图层号
+static uint8_t LayerCount = 0;
+
+static sLayerRect Damage[COMPOSITOR_MAX_DAMAGE];
+static uint8_t DamageCount = 0;
+
+/**
+ * @brief 求两个矩形的交集
+ *
+ * @param a
+ * @param b
+ * @param pOut 交集（可以为 NULL）
+ * @return true 交集不为空
+ */
+static bool compositor_intersect(const sLayerRect* a, const sLayerRect* b, sLayerRect* pOut)
+{
+    int16_t x0 = (a->x > b->x) ? a->x : b->x;
+    int16_t y0 = (a->y > b->y) ? a->y : b->y;
+    int16_t x1 = (a->x + a->w < b->x + b->w) ? (a->x + a->w) : (b->x + b->w);
+    int16_t y1 = (a->y + a->h < b->y + b->h) ? (a->y + a->h) : (b->y + b->h);
+
+    if ((x1 <= x0) || (y1 <= y0))
+        return false;
+
+    if (pOut) {
+        pOut->x = x0;
+        pOut->y = y0;
+        pOut->w = x1 - x0;
+        pOut->h = y1 - y0;
+    }
+    return true;
+}
+
+/**
+ * @brief 求包含两个矩形的最小矩形
+ *
+ * @param a
+ * @param b
+ * @return sLayerRect
+ */
+static sLayerRect compositor_union(const sLayerRect* a, const sLayerRect* b)
+{
+    sLayerRect r;
+    int16_t x1 = (a->x + a->w > b->x + b->w) ? (a->x + a->w) : (b->x + b->w);
+    int16_t y1 = (a->y + a->h > b->y + b->h) ? (a->y + a->h) : (b->y + b->h);
+
+    r.x = (a->x < b->x) ? a->x : b->x;
+    r.y = (a->y < b->y) ? a->y : b->y;
+    r.w = x1 - r.x;
+    r.h = y1 - r.y;
+    return r;
+}
+
+static inline int32_t compositor_area(const sLayerRect* r)
+{
+    return (int32_t)r->w * r->h;
+}
+
+/**
+ * @brief 判断矩形 a 是否完全包含矩形 b
+ *
+ * @param a
+ * @param b
+ * @return true
+ */
+static bool compositor_contains(const sLayerRect* a, const sLayerRect* b)
+{
+    return (b->x >= a->x) && (b->y >= a->y) && (b->x + b->w <= a->x + a->w) && (b->y + b->h <= a->y + a->h);
+}
+
+/**
+ * @brief 记录一个损坏区域
+ *  - 与已有区域合并后面积不大于两者之和时合并（包含、重叠较多或对齐相邻）
+ *  - 列表已满时与合并后面积增长最小的区域合并
+ *
+ * @param pRect
+ */
+static void compositor_addDamage(const sLayerRect* pRect)
+{
+    sLayerRect screen = { 0, 0, dispcolor_getWidth(), dispcolor_getHeight() };
+    sLayerRect r;
+
+    if (!compositor_intersect(pRect, &screen, &r))
+        return;
+
+    for (uint8_t i = 0; i < DamageCount;) {
+        sLayerRect u = compositor_union(&Damage[i], &r);
+
+        if (compositor_area(&u) <= compositor_area(&Damage[i]) + compositor_area(&r)) {
+            // 合并后从列表移除，再与其余区域比较
+            r = u;
+            Damage[i] = Damage[--DamageCount];
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+
+    if (DamageCount == COMPOSITOR_MAX_DAMAGE) {
+        uint8_t best = 0;
+        int32_t bestGrowth = INT32_MAX;
+
+        for (uint8_t i = 0; i < DamageCount; i++) {
+            sLayerRect u = compositor_union(&Damage[i], &r);
+            int32_t growth = compositor_area(&u) - compositor_area(&Damage[i]);
+            if (growth < bestGrowth) {
+                bestGrowth = growth;
+                best = i;
+            }
+        }
+
+        r = compositor_union(&Damage[best], &r);
+        Damage[best] = Damage[--DamageCount];
+        compositor_addDamage(&r);
+        return;
+    }
+
+    Damage[DamageCount++] = r;
+}
+
+/**
+ * @brief 添加图层
+ *
+ * @param x 图层矩形
+ * @param y 图层矩形
+ * @param w 图层矩形
+ * @param h 图层矩形
+ * @param z 叠放顺序，越大越靠上，相同时后添加的在上
+ * @param opaque 图层是否完全覆盖自己的矩形（被不透明图层完全覆盖的区域不再绘制下层）
+ * @param draw 绘制回调
+ * @param pArg 回调参数
+ * @return int8_t 图层号，失败返回 -1
+ */
+int8_t compositor_AddLayer(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t z, bool opaque, tLayerDrawFunc draw, void* pArg)
+{
+    if ((LayerCount >= COMPOSITOR_MAX_LAYERS) || (draw == NULL))
+        return -1;
+
+    int8_t layer = LayerCount;
+    sLayer* pLayer = &Layers[layer];
+
+    pLayer->rect.x = x;
+    pLayer->rect.y = y;
+    pLayer->rect.w = w;
+    pLayer->rect.h = h;
+    pLayer->z = z;
+    pLayer->opaque = opaque;
+    pLayer->visible = true;
+    pLayer->draw = draw;
+    pLayer->pArg = pArg;
+
+    // 插入排序，保持 LayerOrder 按 z 递增
+    uint8_t pos = LayerCount;
+    while ((pos > 0) && (Layers[LayerOrder[pos - 1]].z > z)) {
+        LayerOrder[pos] = LayerOrder[pos - 1];
+        pos--;
+    }
+    LayerOrder[pos] = layer;
+    LayerCount++;
+
+    compositor_addDamage(&pLayer->rect);
+    return layer;
+}
+
+/**
+ * @brief 显示/隐藏图层
+ *
+ * @param layer 图层号
+ * @param visible
+ */
+void compositor_SetVisible(int8_t layer, bool visible)
+{
+    if ((layer < 0) || (layer >= LayerCount) || (Layers[layer].visible == visible))
+        return;
+
+    Layers[layer].visible = visible;
+    compositor_addDamage(&Layers[layer].rect);
+}
+
+/**
+ * @brief 图层内容改变，下次合成时重绘该图层区域
+ *
+ * @param layer 图层号
+ */
+void compositor_Invalidate(int8_t layer)
+{
+    if ((layer < 0) || (layer >= LayerCount) || !Layers[layer].visible)
+        return;
+
+    compositor_addDamage(&Layers[layer].rect);
+}
+
+/**
+ * @brief 指定区域需要重新合成
+ *
+ * @param x
+ * @param y
+ * @param w
+ * @param h
+ */
+void compositor_InvalidateRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    sLayerRect r = { x, y, w, h };
+
+    compositor_addDamage(&r);
+}
+
+/**
+ * @brief 整屏需要重新合成
+ *
+ */
+void compositor_InvalidateAll(void)
+{
+    DamageCount = 0;
+    compositor_InvalidateRect(0, 0, dispcolor_getWidth(), dispcolor_getHeight());
+}
+
+/**
+ * @brief 合成：对每个损坏区域，从完全覆盖它的最上层不透明图层开始，
+ *        按 z 顺序把与之相交的可见图层裁剪后重绘到显存
+ *
+ * @return true 绘制了内容（需要刷新显示）
+ */
+bool compositor_Compose(void)
+{
+    bool drawn = false;
+
+    for (uint8_t d = 0; d < DamageCount; d++) {
+        const sLayerRect* pDamage = &Damage[d];
+        uint8_t start = 0;
+
+        for (int8_t i = LayerCount - 1; i >= 0; i--) {
+            const sLayer* pLayer = &Layers[LayerOrder[i]];
+            if (pLayer->visible && pLayer->opaque && compositor_contains(&pLayer->rect, pDamage)) {
+                start = i;
+                break;
+            }
+        }
+
+        for (uint8_t i = start; i < LayerCount; i++) {
+            const sLayer* pLayer = &Layers[LayerOrder[i]];
+            sLayerRect clip;
+
+            if (!pLayer->visible || !compositor_intersect(&pLayer->rect, pDamage, &clip))
+                continue;
+
+            dispcolor_SetClip(clip.x, clip.y, clip.w, clip.h);
+            pLayer->draw(&clip, pLayer->pArg);
+            drawn = true;
+        }
+    }
+
+    dispcolor_ResetClip();
+    DamageCount = 0;
+    return drawn;
+}
@@ -1,8 +1,16 @@
+#ifdef ESP_PLATFORM
 #include "esp_system.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "spi_lcd.h"
 #include "thermalimaging_simple.h"
+#else
+#include "dispcolor.h"
+#include "textcache.h"
+#include "hostfb.h"
+#define LINE_PIXEL_MAX_SIZE HOSTFB_WIDTH
+#endif
+#include "dispbackend.h"
 #include <math.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -22,6 +30,34 @@ static void SwapInt16Values(int16_t* pValue1, int16_t* pValue2)
     *pValue2 = TempValue;
 }
 
+// 当前显示后端
+#ifdef ESP_PLATFORM
+static const tDispBackend* pBackend = &dispbackend_st7789;
+#else
+static const tDispBackend* pBackend = &dispbackend_hostfb;
+#endif
+
+/**
+ * @brief 选择显示后端，需在 dispcolor_Init 之前调用
+ *
+ * @param pNewBackend
+ */
+void dispcolor_SetBackend(const tDispBackend* pNewBackend)
+{
+    if (pNewBackend != NULL)
+        pBackend = pNewBackend;
+}
+
+/**
+ * @brief 返回当前显示后端
+ *
+ * @return const tDispBackend*
+ */
+const tDispBackend* dispcolor_GetBackend(void)
+{
+    return pBackend;
+}
+
 /**
  * @brief 程序初始化彩色显示
  *
@@ -29,7 +65,7 @@ static void SwapInt16Values(int16_t* pValue1, int16_t* pValue2)
 void dispcolor_Init()
 {
     // 初始化显示
-    st7789_init();
+    pBackend->init();
 }
 
 /**
@@ -40,7 +76,7 @@ void dispcolor_DisplayOff(void)
 {
     dispcolor_SetBrightness(0);
     dispcolor_ClearScreen();
-    st7789_DisplayOff();
+    pBackend->displayOff();
 }
 
 /**
@@ -50,12 +86,12 @@ void dispcolor_DisplayOff(void)
  */
 uint16_t dispcolor_getWidth()
 {
-    return lcddev.width;
+    return pBackend->getWidth();
 }
 
 uint16_t dispcolor_getHeight()
 {
-    return lcddev.height;
+    return pBackend->getHeight();
 }
 
 /**
@@ -65,7 +101,7 @@ uint16_t dispcolor_getHeight()
  */
 void dispcolor_SetBrightness(uint16_t Value)
 {
-    lcd_backlight_set(Value);
+    pBackend->setBrightness(Value);
 }
 
 /**
@@ -77,7 +113,7 @@ void dispcolor_SetBrightness(uint16_t Value)
  */
 void dispcolor_DrawPixel(int16_t x, int16_t y, uint16_t color)
 {
-    st7789_DrawPixel(x, y, color);
+    pBackend->drawPixel(x, y, color);
 }
 
 /**
@@ -89,11 +125,10 @@ void dispcolor_DrawPixel(int16_t x, int16_t y, uint16_t color)
  */
 uint16_t dispcolor_GetPixel(int16_t x, int16_t y)
 {
-#if (ST7789_MODE == ST7789_BUFFER_MODE)
-    return st7789_GetPixel(x, y);
-#else
-    return 0x0000;
-#endif
+    if (pBackend->getPixel == NULL)
+        return 0x0000;
+
+    return pBackend->getPixel(x, y);
 }
 
 /**
@@ -107,18 +142,159 @@ uint16_t dispcolor_GetPixel(int16_t x, int16_t y)
  */
 void dispcolor_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
 {
-    st7789_FillRect(x, y, w, h, color);
+    pBackend->fillRect(x, y, w, h, color);
+}
+
+/**
+ * @brief 绘制一条水平线
+ *
+ * @param x 起始坐标
+ * @param y 坐标
+ * @param w 长度
+ * @param color 颜色
+ */
+void dispcolor_DrawHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    pBackend->drawHLine(x, y, w, color);
+}
+
+/**
+ * @brief 写入一段水平像素
+ *
+ * @param x 起始坐标
+ * @param y 坐标
+ * @param pColors 颜色数组
+ * @param len 像素数
+ * @param mirror 是否水平镜像（pColors[0] 写到最右侧）
+ */
+void dispcolor_WriteSpan(int16_t x, int16_t y, const uint16_t* pColors, int16_t len, bool mirror)
+{
+    pBackend->writeSpan(x, y, pColors, len, mirror);
+}
+
+/**
+ * @brief 把内存中的矩形图像复制到屏幕
+ *
+ * @param x 坐标
+ * @param y 坐标
+ * @param w 宽
+ * @param h 高
+ * @param pSrc 图像数据，按行存放
+ * @param stride 源图像一行的像素数
+ * @param mirror 是否水平镜像
+ */
+void dispcolor_BlitRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pSrc, int16_t stride, bool mirror)
+{
+    pBackend->blitRect(x, y, w, h, pSrc, stride, mirror);
+}
+
+/**
+ * @brief 按查找表把数值图像（例如放大后的温度图）转换成颜色写到屏幕
+ *  - 颜色 = pLut[value - valueMin]，超出查找表范围的数值取两端的颜色
+ *  - 流式模式只记录指针，pValues 和 pLut 在该区域被覆盖或调用 dispcolor_ReleaseBuffer 之前必须保持有效且内容不变
+ *
+ * @param x 坐标
+ * @param y 坐标
+ * @param w 宽（同时是 pValues 一行的元素数）
+ * @param h 高
+ * @param pValues 数值图像，按行存放
+ * @param valueMin pLut[0] 对应的数值
+ * @param pLut 颜色查找表（RGB565）
+ * @param lutSize 查找表元素数
+ * @param mirror 是否水平镜像（每行第 0 个元素显示在最右侧）
+ */
+void dispcolor_DrawImageLut(int16_t x, int16_t y, int16_t w, int16_t h, const int16_t* pValues, int16_t valueMin, const uint16_t* pLut, uint16_t lutSize, bool mirror)
+{
+    uint16_t rowBuff[LINE_PIXEL_MAX_SIZE];
+
+    if ((w <= 0) || (h <= 0) || (lutSize == 0))
+        return;
+
+    if (pBackend->drawImageLut != NULL) {
+        pBackend->drawImageLut(x, y, w, h, pValues, valueMin, pLut, lutSize, mirror);
+        return;
+    }
+
+    int16_t len = (w > LINE_PIXEL_MAX_SIZE) ? LINE_PIXEL_MAX_SIZE : w;
+    for (int16_t row = 0; row < h; row++, pValues += w) {
+        for (int16_t col = 0; col < len; col++) {
+            int32_t idx = (int32_t)pValues[col] - valueMin;
+            if (idx < 0)
+                idx = 0;
+            if (idx >= lutSize)
+                idx = lutSize - 1;
+            rowBuff[col] = pLut[idx];
+        }
+        dispcolor_WriteSpan(mirror ? (x + w - len) : x, y + row, rowBuff, len, mirror);
+    }
+}
+
+/**
+ * @brief 将改写或释放传给 dispcolor_DrawImageLut 的内存之前调用：后端不再引用这块内存
+ *
+ * @param pBuff 内存起始地址
+ * @param size 字节数
+ */
+void dispcolor_ReleaseBuffer(const void* pBuff, size_t size)
+{
+    if (pBackend->releaseBuffer != NULL)
+        pBackend->releaseBuffer(pBuff, size);
+}
+
+/**
+ * @brief 设置裁剪矩形，之后的绘图只写入该区域
+ *
+ * @param x 坐标
+ * @param y 坐标
+ * @param w 宽
+ * @param h 高
+ */
+void dispcolor_SetClip(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    pBackend->setClip(x, y, w, h);
+}
+
+/**
+ * @brief 取消裁剪，恢复为整个屏幕
+ *
+ */
+void dispcolor_ResetClip(void)
+{
+    pBackend->resetClip();
 }
 
 /**
- * @brief 把显存内容刷新到液晶屏上
+ * @brief 把显存中被修改过的区域刷新到液晶屏上
  *
  */
 void dispcolor_Update(void)
 {
-#if (ST7789_MODE == ST7789_BUFFER_MODE)
-    st7789_update();
-#endif
+    if (pBackend->update != NULL)
+        pBackend->update();
+}
+
+/**
+ * @brief 把整个显存内容刷新到液晶屏上
+ *
+ */
+void dispcolor_UpdateFull(void)
+{
+    if (pBackend->updateFull != NULL)
+        pBackend->updateFull();
+}
+
+/**
+ * @brief 立即把指定矩形区域刷新到液晶屏上
+ *
+ * @param x 坐标
+ * @param y 坐标
+ * @param w 宽
+ * @param h 高
+ */
+void dispcolor_UpdateRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (pBackend->updateRect != NULL)
+        pBackend->updateRect(x, y, w, h);
 }
 
 /**
@@ -186,6 +362,11 @@ static void dispcolor_DrawLine_Slow(int16_t x1, int16_t y1, int16_t x2, int16_t
  */
 void dispcolor_DrawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
 {
+    if (pBackend->drawLine != NULL) {
+        pBackend->drawLine(x1, y1, x2, y2, color);
+        return;
+    }
+
     if (x1 == x2) {
         // 水平线 用快速方法画线
         if (y1 > y2) {
@@ -197,9 +378,9 @@ void dispcolor_DrawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t
     } else if (y1 == y2) {
         // 垂直线 用快速方法画线
         if (x1 > x2) {
-            dispcolor_FillRect(x2, y1, x1 - x2 + 1, 1, color);
+            dispcolor_DrawHLine(x2, y1, x1 - x2 + 1, color);
         } else {
-            dispcolor_FillRect(x1, y1, x2 - x1 + 1, 1, color);
+            dispcolor_DrawHLine(x1, y1, x2 - x1 + 1, color);
         }
 
     } else {
@@ -326,65 +507,6 @@ void dispcolor_DrawCircleFilled(int16_t x0, int16_t y0, int16_t radius, uint16_t
     }
 }
 
-/**
- * @brief 在显示屏上显示 Char 字符
- * 这个函数如果超过了屏幕宽高，则不会显示了（不会自动换行处理）
- * @param X 起始坐标
- * @param Y 起始坐标
- * @param FontID 字体ID
- * @param Char 字符
- * @param TextColor 文本颜色
- * @param BgColor 背景颜色
- * @param TransparentBg 字符串背景是否透明
- * @return uint8_t 返回渲染字符的宽度
- */
-static uint8_t dispcolor_DrawChar_General(int16_t X, int16_t Y, uint8_t FontID, uint8_t Char, uint16_t TextColor, uint16_t BgColor, uint8_t TransparentBg)
-{
-    // 指向特定字体字符的子标签的指针
-    uint8_t* pCharTable = font_GetFontStruct(FontID, Char);
-    if (NULL == pCharTable) {
-        return 0;
-    }
-
-    uint8_t* pCharData = font_GetCharFont(pCharTable); // 点阵字符信息
-    uint8_t CharWidth = font_GetCharWidth(pCharTable); // 符号宽度
-    uint8_t CharHeight = font_GetCharHeight(pCharTable); // 符号高度
-
-    if (FontID == FONTID_6X8M) {
-        for (uint8_t row = 0; row < CharHeight; row++) {
-            for (uint8_t col = 0; col < CharWidth; col++) {
-                if (pCharData[row] & (1 << (7 - col))) {
-                    dispcolor_DrawPixel(X + col, Y + row, TextColor); // 绘制文本
-                } else if (!TransparentBg) {
-                    dispcolor_DrawPixel(X + col, Y + row, BgColor); // 绘制文本背景色
-                }
-            }
-        }
-
-    } else {
-        for (uint8_t row = 0; row < CharHeight; row++) {
-            for (uint8_t col = 0; col < CharWidth; col++) {
-                if (col < 8) {
-                    if (pCharData[row * 2] & (1 << (7 - col))) {
-                        dispcolor_DrawPixel(X + col, Y + row, TextColor);
-                    } else if (!TransparentBg) {
-                        dispcolor_DrawPixel(X + col, Y + row, BgColor);
-                    }
-
-                } else {
-                    if (pCharData[(row * 2) + 1] & (1 << (15 - col))) {
-                        dispcolor_DrawPixel(X + col, Y + row, TextColor);
-                    } else if (!TransparentBg) {
-                        dispcolor_DrawPixel(X + col, Y + row, BgColor);
-                    }
-                }
-            }
-        }
-    }
-
-    return CharWidth;
-}
-
 /**
  * @brief 在显示器上显示字符串 Str 中的文本的功能
  *
@@ -403,6 +525,13 @@ static int16_t dispcolor_DrawString_General(int16_t X, int16_t Y, uint8_t FontID
     int16_t Xstart = X; // 起始显示坐标做为下一行行首
     uint8_t StrHeight = 8; // 移动到下一行的字符高度（以像素为单位）
 
+    // 单行字符串走字符串缓存
+    if (strpbrk((const char*)Str, "\r\n") == NULL) {
+        if (pBackend->drawString != NULL)
+            return pBackend->drawString(X, Y, FontID, Str, TextColor, BgColor, TransparentBg);
+        return textcache_DrawString(X, Y, FontID, Str, TextColor, BgColor, TransparentBg);
+    }
+
     // 字符串循环显示
     while (!done) {
         switch (*Str) {
@@ -421,21 +550,14 @@ static int16_t dispcolor_DrawString_General(int16_t X, int16_t Y, uint8_t FontID
             X = Xstart;
             break;
 
-        default:
+        default: {
             // 显示字符
-            if (TransparentBg)
-                X += dispcolor_DrawChar_General(X, Y, FontID, *Str, TextColor, 0, 1); // 透明 每有背景色
-            else
-                X += dispcolor_DrawChar_General(X, Y, FontID, *Str, TextColor, BgColor, 0); // 不透明 有背景色
-
-            uint8_t* pFontStruct = font_GetFontStruct(FontID, *Str);
-            if (pFontStruct != NULL) {
-                StrHeight = font_GetCharHeight(pFontStruct);
-            } else {
-                StrHeight = 16; // 默认高度
-            }
+            const sGlyph* pGlyph = textcache_GetGlyph(FontID, *Str);
+            X += textcache_DrawChar(X, Y, FontID, *Str, TextColor, BgColor, TransparentBg);
+            StrHeight = pGlyph->height ? pGlyph->height : 16; // 字体中没有该字符时使用默认高度
             break;
         }
+        }
         Str++;
     }
     return X;
@@ -539,10 +661,12 @@ int16_t dispcolor_getStrWidth(uint8_t FontID, char* Str)
         case '\n': // 移动到下一行
         case '\r': // 移动到行首
             break;
-        default: // 显示字符
-            StrWidth += font_GetCharWidth(font_GetFontStruct(FontID, *Str));
+        default: { // 显示字符（宽度取自字形缓存，压缩字体不用每次解码）
+            const sGlyph* pGlyph = textcache_GetGlyph(FontID, *Str);
+            StrWidth += pGlyph->height ? pGlyph->width : font_GetCharWidth(NULL);
             break;
         }
+        }
         Str++;
     }
 
@@ -575,15 +699,23 @@ int16_t dispcolor_getFormatStrWidth(uint8_t FontID, const char* args, ...)
  */
 void dispcolor_screenDark(void)
 {
+    uint16_t rowBuff[LINE_PIXEL_MAX_SIZE];
+
+    if (pBackend->darkenRect != NULL) {
+        pBackend->darkenRect(0, 0, dispcolor_getWidth(), dispcolor_getHeight());
+        return;
+    }
+
+    if (pBackend->getRowData == NULL)
+        return;
+
     for (uint16_t y = 0; y < dispcolor_getHeight(); y++) {
+        dispcolor_getRowData(y, rowBuff);
         for (uint16_t x = 0; x < dispcolor_getWidth(); x++) {
-            uRGB565 color;
-            color.value = dispcolor_GetPixel(x, y);
-            color.rgb_color.r >>= 2;
-            color.rgb_color.g >>= 2;
-            color.rgb_color.b >>= 2;
-            dispcolor_DrawPixel(x, y, color.value);
+            // 每个分量右移2位，等价于 uRGB565 各字段分别 >>= 2
+            rowBuff[x] = (rowBuff[x] >> 2) & 0x39E7;
         }
+        dispcolor_WriteSpan(0, y, rowBuff, dispcolor_getWidth(), false);
     }
 }
 
@@ -591,12 +723,13 @@ void dispcolor_screenDark(void)
  * @brief 复制显存数据到指定内存,保存位图的时候使用到
  *
  * @param pBuff
+ * @return true 得到完整的屏幕内容（后端不支持或流式模式有丢失区域时返回 false）
  */
-void dispcolor_getScreenData(uint16_t* pBuff)
+bool dispcolor_getScreenData(uint16_t* pBuff)
 {
-#if (ST7789_MODE == ST7789_BUFFER_MODE)
-    st7789_getScreenData(pBuff);
-#endif
+    if (pBackend->getScreenData == NULL)
+        return false;
+    return pBackend->getScreenData(pBuff);
 }
 
 /**
@@ -607,7 +740,6 @@ void dispcolor_getScreenData(uint16_t* pBuff)
  */
 void dispcolor_getRowData(uint16_t row, uint16_t* pBuff)
 {
-#if (ST7789_MODE == ST7789_BUFFER_MODE)
-    st7789_getRowData(row, pBuff);
-#endif
+    if (pBackend->getRowData != NULL)
+        pBackend->getRowData(row, pBuff);
 }
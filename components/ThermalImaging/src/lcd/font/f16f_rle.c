@@ -0,0 +1,193 @@
+//------------------------------------------------------------------------------
+// 由 tools/fontgen.py 从 f16f.c 生成，请勿手工修改
+// 字符范围 0x20 ~ 0x7E，另加 0xB0，原始表 8704 字节，压缩后 1730 字节（索引 768 + 数据 962）
+//------------------------------------------------------------------------------
+#include "f16f.h"
+#include "font.h"
+
+static const uint8_t f10x16f_rle_data[961] = {
+    0xFF, 0xFF, 0xCF, 0xCF, 0x3C, 0xF3, 0x36, 0x6C, 0xDF, 0xFF, 0xED, 0x9B, 0x7F, 0xFF, 0xB3, 0x60,
+    0x10, 0x71, 0xF6, 0xBD, 0x1E, 0x1E, 0x1E, 0x1F, 0xAF, 0x5B, 0xE3, 0x82, 0x00, 0x78, 0x31, 0x98,
+    0xC3, 0x31, 0x86, 0x66, 0x0C, 0xD8, 0x0F, 0x30, 0x00, 0xCF, 0x01, 0xB3, 0x06, 0x66, 0x0C, 0xCC,
+    0x31, 0x98, 0xC1, 0xE0, 0x3E, 0x0F, 0xE1, 0x8C, 0x31, 0x83, 0xE0, 0x78, 0x1B, 0x26, 0x76, 0xC7,
+    0x98, 0x79, 0xFF, 0x9E, 0x20, 0xFF, 0x36, 0x66, 0xCC, 0xCC, 0xCC, 0xC6, 0x66, 0x30, 0xC6, 0x66,
+    0x33, 0x33, 0x33, 0x36, 0x66, 0xC0, 0x54, 0x73, 0xF9, 0xC5, 0x40, 0x18, 0x18, 0x18, 0xFF, 0xFF,
+    0x18, 0x18, 0x18, 0xF5, 0x80, 0x0A, 0xF0, 0x33, 0x36, 0x66, 0x66, 0xCC, 0xC0, 0x3C, 0x7E, 0xE7,
+    0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xE7, 0x7E, 0x3C, 0x19, 0xDF, 0xB9, 0x8C, 0x63, 0x18, 0xC6,
+    0x30, 0x3C, 0x7E, 0xE3, 0xC3, 0x03, 0x06, 0x0E, 0x1C, 0x38, 0x60, 0xFF, 0xFF, 0x3E, 0x7F, 0xC3,
+    0x03, 0x1E, 0x1E, 0x07, 0x03, 0xC3, 0xE7, 0x7E, 0x3C, 0x06, 0x0E, 0x0E, 0x1E, 0x36, 0x36, 0x66,
+    0xC6, 0xFF, 0xFF, 0x06, 0x06, 0x7E, 0x7E, 0x60, 0xE0, 0xFC, 0xFE, 0xC7, 0x03, 0xC3, 0xE7, 0x7E,
+    0x3C, 0x3E, 0x7F, 0x63, 0xC0, 0xDC, 0xFE, 0xE7, 0xC3, 0xC3, 0x63, 0x7E, 0x3C, 0xFF, 0xFF, 0x06,
+    0x0C, 0x0C, 0x18, 0x18, 0x18, 0x38, 0x30, 0x30, 0x30, 0x3C, 0x7E, 0xC3, 0xC3, 0xC3, 0x7E, 0x7E,
+    0xC3, 0xC3, 0xC3, 0x7E, 0x3C, 0x3C, 0x7E, 0xC6, 0xC3, 0xC3, 0xE7, 0x7F, 0x3B, 0x03, 0xC6, 0xFE,
+    0x7C, 0xF0, 0x0F, 0xF0, 0x0F, 0x58, 0x01, 0x07, 0x1E, 0x78, 0xE0, 0x78, 0x1E, 0x07, 0x01, 0x0E,
+    0xEE, 0x80, 0xE0, 0x78, 0x1E, 0x07, 0x1E, 0x78, 0xE0, 0x80, 0x3C, 0x7E, 0xE3, 0xC3, 0x07, 0x0E,
+    0x1C, 0x18, 0x18, 0x00, 0x18, 0x18, 0x07, 0xE0, 0x3F, 0xF0, 0xE0, 0x73, 0x9D, 0xE6, 0xFF, 0x7D,
+    0x8E, 0xF6, 0x19, 0xEC, 0x33, 0xD8, 0x67, 0xB1, 0xDB, 0x7F, 0xE3, 0x7B, 0x87, 0x00, 0x67, 0x03,
+    0x87, 0xFE, 0x03, 0xF0, 0x0E, 0x01, 0xC0, 0x6C, 0x0D, 0x81, 0xB0, 0x63, 0x0C, 0x61, 0xFC, 0x7F,
+    0xCC, 0x19, 0x83, 0x60, 0x30, 0xFF, 0x3F, 0xEC, 0x1B, 0x06, 0xC1, 0xBF, 0xCF, 0xFB, 0x07, 0xC0,
+    0xF0, 0x3F, 0xFB, 0xFC, 0x1F, 0x1F, 0xE6, 0x1F, 0x02, 0xC0, 0x30, 0x0C, 0x03, 0x00, 0xC0, 0x98,
+    0x77, 0xF8, 0x7C, 0xFE, 0x3F, 0xEC, 0x1B, 0x03, 0xC0, 0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xF0, 0x6F,
+    0xFB, 0xF8, 0x0F, 0x57, 0x27, 0x27, 0xF5, 0x72, 0x72, 0x7F, 0x30, 0x0F, 0x36, 0x26, 0x26, 0x71,
+    0x71, 0x26, 0x26, 0x26, 0x26, 0x26, 0x1F, 0x1F, 0xE6, 0x1F, 0x02, 0xC0, 0x30, 0x0C, 0x7F, 0x1F,
+    0xC0, 0xD8, 0x77, 0xF8, 0x7C, 0x02, 0x54, 0x54, 0x54, 0x54, 0x5F, 0x75, 0x45, 0x45, 0x45, 0x45,
+    0x20, 0x0F, 0x90, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xC3, 0xE7, 0x7E, 0x3C, 0xC0,
+    0xF0, 0x6C, 0x33, 0x18, 0xCC, 0x37, 0x8F, 0x63, 0x8C, 0xC3, 0x30, 0x6C, 0x1F, 0x03, 0xC0, 0xC0,
+    0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xFF, 0xFF, 0xE0, 0xFC, 0x1F, 0xC7, 0xF8, 0xFD,
+    0x17, 0xB6, 0xF6, 0xDE, 0xDB, 0xCE, 0x79, 0xCF, 0x39, 0xE2, 0x30, 0xC0, 0xF8, 0x3F, 0x0F, 0xC3,
+    0xD8, 0xF3, 0x3C, 0xCF, 0x1B, 0xC3, 0xF0, 0xFC, 0x1F, 0x03, 0x1E, 0x1F, 0xE6, 0x1B, 0x03, 0xC0,
+    0xF0, 0x3C, 0x0F, 0x03, 0xC0, 0xD8, 0x67, 0xF8, 0x78, 0x07, 0x28, 0x12, 0x45, 0x54, 0x4B, 0x17,
+    0x22, 0x72, 0x72, 0x72, 0x72, 0x70, 0x1E, 0x1F, 0xE6, 0x1B, 0x03, 0xC0, 0xF0, 0x3C, 0x0F, 0x03,
+    0xCC, 0xD9, 0xE7, 0xF8, 0x76, 0x00, 0xC0, 0xFF, 0x1F, 0xF3, 0x07, 0x60, 0x6C, 0x1D, 0xFF, 0x3F,
+    0x86, 0x38, 0xC3, 0x98, 0x33, 0x07, 0x60, 0x70, 0x25, 0x37, 0x12, 0x45, 0x56, 0x66, 0x55, 0x75,
+    0x55, 0x33, 0x17, 0x35, 0x20, 0x0F, 0x54, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28, 0x28,
+    0x24, 0x02, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x64, 0x65, 0x43, 0x18, 0x36, 0x20, 0xC0,
+    0x78, 0x0D, 0x83, 0x30, 0x63, 0x18, 0x63, 0x0C, 0x60, 0xD8, 0x1B, 0x01, 0xC0, 0x38, 0x07, 0x00,
+    0xC3, 0x87, 0xC7, 0x0D, 0x8E, 0x33, 0x36, 0x66, 0x6C, 0xC6, 0xDB, 0x0D, 0xB6, 0x1B, 0x6C, 0x1C,
+    0x78, 0x38, 0xE0, 0x71, 0xC0, 0xE3, 0x80, 0xC1, 0xF1, 0xD8, 0xC6, 0xC3, 0xE0, 0xE0, 0x70, 0x7C,
+    0x36, 0x31, 0xB8, 0xF8, 0x30, 0xC0, 0xF8, 0x76, 0x18, 0xCC, 0x33, 0x07, 0x80, 0xC0, 0x30, 0x0C,
+    0x03, 0x00, 0xC0, 0x30, 0x18, 0x18, 0x62, 0x62, 0x63, 0x62, 0x62, 0x63, 0x62, 0x62, 0x6F, 0x30,
+    0xFF, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xFF, 0xCC, 0xC6, 0x66, 0x66, 0x63, 0x33, 0xFF, 0x33, 0x33,
+    0x33, 0x33, 0x33, 0xFF, 0x18, 0x3C, 0x3C, 0x66, 0x66, 0xC3, 0xFF, 0xFF, 0xCC, 0x7C, 0xFE, 0xC6,
+    0x1E, 0x7E, 0xE6, 0xC6, 0xFE, 0x7B, 0xC0, 0xC0, 0xC0, 0xDC, 0xFE, 0xE7, 0xC3, 0xC3, 0xC3, 0xE7,
+    0xFE, 0xDC, 0x3C, 0xFF, 0x9E, 0x0C, 0x18, 0x39, 0xBF, 0x3C, 0x03, 0x03, 0x03, 0x3B, 0x7F, 0xE7,
+    0xC3, 0xC3, 0xC3, 0xE7, 0x7F, 0x3B, 0x38, 0xFB, 0x1F, 0xFF, 0xF8, 0x39, 0xBE, 0x38, 0x3D, 0xF6,
+    0x3E, 0xF9, 0x86, 0x18, 0x61, 0x86, 0x18, 0x3B, 0x7F, 0xE7, 0xC3, 0xC3, 0xC3, 0xE7, 0x7F, 0x3B,
+    0xC3, 0xFF, 0x7E, 0xC0, 0xC0, 0xC0, 0xDE, 0xFF, 0xE3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xF3,
+    0xFF, 0xFF, 0x6C, 0x36, 0xDB, 0x6D, 0xBF, 0x80, 0xC1, 0x83, 0x06, 0x3C, 0xDB, 0x3E, 0x7C, 0xED,
+    0x9B, 0x1E, 0x30, 0x0F, 0x90, 0xDC, 0xEF, 0xFF, 0xE7, 0x3C, 0x63, 0xC6, 0x3C, 0x63, 0xC6, 0x3C,
+    0x63, 0xC6, 0x30, 0xDE, 0xFF, 0xE3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0x3C, 0x7E, 0xE7, 0xC3,
+    0xC3, 0xC3, 0xE7, 0x7E, 0x3C, 0xDE, 0xFF, 0xE3, 0xC3, 0xC3, 0xC3, 0xE7, 0xFE, 0xDC, 0xC0, 0xC0,
+    0x3B, 0x7F, 0xE7, 0xC3, 0xC3, 0xC3, 0xE7, 0x7F, 0x3B, 0x03, 0x03, 0x03, 0xDF, 0xF9, 0x8C, 0x63,
+    0x18, 0xC0, 0x7D, 0xFF, 0x1F, 0x87, 0xC3, 0xF1, 0xFF, 0x7C, 0x23, 0x19, 0xFF, 0xB1, 0x8C, 0x63,
+    0x1E, 0x70, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC7, 0xFF, 0x7B, 0xC7, 0x8F, 0x1B, 0x66, 0xCD,
+    0x8E, 0x1C, 0x38, 0xC7, 0x1E, 0x38, 0xD9, 0xCC, 0xDB, 0x66, 0xDB, 0x36, 0xD8, 0xE3, 0x87, 0x1C,
+    0x38, 0xE0, 0xC7, 0xDD, 0xB1, 0xC3, 0x87, 0x1B, 0x77, 0xC6, 0xC1, 0xB1, 0x98, 0xC6, 0xC3, 0x61,
+    0xF0, 0x70, 0x38, 0x18, 0x3C, 0x1C, 0x00, 0x0E, 0x42, 0x43, 0x33, 0x33, 0x42, 0x4E, 0x1C, 0xF3,
+    0x0C, 0x30, 0xCE, 0x38, 0x30, 0xC3, 0x0C, 0x3C, 0x70, 0x0F, 0xD0, 0xE3, 0xC3, 0x0C, 0x30, 0xC1,
+    0xC7, 0x30, 0xC3, 0x0C, 0xF3, 0x80, 0x71, 0xFF, 0x8E, 0x3C, 0x7E, 0xE7, 0xC3, 0xC3, 0xE7, 0x7E,
+    0x3C,
+};
+
+static const tFontRleGlyph f10x16f_rle_glyphs[96] = {
+    {    0,  8,  0,  0,  0,  0, FONT_RLE_BITS }, // 0x20  
+    {    0,  3,  0,  2,  2, 12, FONT_RLE_BITS }, // 0x21 !
+    {    3,  7,  0,  2,  6,  4, FONT_RLE_BITS }, // 0x22 "
+    {    6,  8,  0,  2,  7, 11, FONT_RLE_BITS }, // 0x23 #
+    {   16,  8,  0,  1,  7, 14, FONT_RLE_BITS }, // 0x24 $
+    {   29, 16,  0,  2, 15, 12, FONT_RLE_BITS }, // 0x25 %
+    {   52, 12,  0,  2, 11, 12, FONT_RLE_BITS }, // 0x26 &
+    {   69,  3,  0,  2,  2,  4, FONT_RLE_BITS }, // 0x27  
+    {   70,  5,  0,  0,  4, 15, FONT_RLE_BITS }, // 0x28 (
+    {   78,  5,  0,  0,  4, 15, FONT_RLE_BITS }, // 0x29 )
+    {   86,  8,  0,  1,  7,  5, FONT_RLE_BITS }, // 0x2A *
+    {   91,  9,  0,  2,  8,  8, FONT_RLE_BITS }, // 0x2B +
+    {   99,  3,  0, 11,  2,  5, FONT_RLE_BITS }, // 0x2C ,
+    {  101,  6,  0,  7,  5,  2, FONT_RLE_RUNS }, // 0x2D -
+    {  102,  3,  0, 11,  2,  2, FONT_RLE_BITS }, // 0x2E .
+    {  103,  5,  0,  2,  4, 11, FONT_RLE_BITS }, // 0x2F /
+    {  109,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x30 0
+    {  121,  6,  0,  2,  5, 12, FONT_RLE_BITS }, // 0x31 1
+    {  129,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x32 2
+    {  141,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x33 3
+    {  153,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x34 4
+    {  165,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x35 5
+    {  177,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x36 6
+    {  189,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x37 7
+    {  201,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x38 8
+    {  213,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x39 9
+    {  225,  3,  0,  4,  2,  8, FONT_RLE_BITS }, // 0x3A :
+    {  227,  3,  0,  4,  2, 11, FONT_RLE_BITS }, // 0x3B ;
+    {  230,  9,  0,  3,  8,  9, FONT_RLE_BITS }, // 0x3C <
+    {  239,  8,  0,  5,  7,  6, FONT_RLE_RUNS }, // 0x3D =
+    {  241,  9,  0,  3,  8,  9, FONT_RLE_BITS }, // 0x3E >
+    {  250,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x3F ?
+    {  262, 16,  0,  0, 15, 16, FONT_RLE_BITS }, // 0x40 @
+    {  292, 12,  0,  2, 11, 12, FONT_RLE_BITS }, // 0x41 A
+    {  309, 11,  0,  2, 10, 12, FONT_RLE_BITS }, // 0x42 B
+    {  324, 11,  0,  2, 10, 12, FONT_RLE_BITS }, // 0x43 C
+    {  339, 11,  0,  2, 10, 12, FONT_RLE_BITS }, // 0x44 D
+    {  354, 10,  0,  2,  9, 12, FONT_RLE_RUNS }, // 0x45 E
+    {  363,  9,  0,  2,  8, 12, FONT_RLE_RUNS }, // 0x46 F
+    {  374, 11,  0,  2, 10, 12, FONT_RLE_BITS }, // 0x47 G
+    {  389, 10,  0,  2,  9, 12, FONT_RLE_RUNS }, // 0x48 H
+    {  401,  3,  0,  2,  2, 12, FONT_RLE_RUNS }, // 0x49 I
+    {  403,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x4A J
+    {  415, 11,  0,  2, 10, 12, FONT_RLE_BITS }, // 0x4B K
+    {  430,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x4C L
+    {  442, 12,  0,  2, 11, 12, FONT_RLE_BITS }, // 0x4D M
+    {  459, 11,  0,  2, 10, 12, FONT_RLE_BITS }, // 0x4E N
+    {  474, 11,  0,  2, 10, 12, FONT_RLE_BITS }, // 0x4F O
+    {  489, 10,  0,  2,  9, 12, FONT_RLE_RUNS }, // 0x50 P
+    {  502, 11,  0,  2, 10, 13, FONT_RLE_BITS }, // 0x51 Q
+    {  519, 12,  0,  2, 11, 12, FONT_RLE_BITS }, // 0x52 R
+    {  536, 10,  0,  2,  9, 12, FONT_RLE_RUNS }, // 0x53 S
+    {  549, 11,  0,  2, 10, 12, FONT_RLE_RUNS }, // 0x54 T
+    {  561, 11,  0,  2, 10, 12, FONT_RLE_RUNS }, // 0x55 U
+    {  575, 12,  0,  2, 11, 12, FONT_RLE_BITS }, // 0x56 V
+    {  592, 16,  0,  2, 15, 12, FONT_RLE_BITS }, // 0x57 W
+    {  615, 10,  0,  2,  9, 12, FONT_RLE_BITS }, // 0x58 X
+    {  629, 11,  0,  2, 10, 12, FONT_RLE_BITS }, // 0x59 Y
+    {  644, 10,  0,  2,  9, 12, FONT_RLE_RUNS }, // 0x5A Z
+    {  656,  5,  0,  1,  4, 14, FONT_RLE_BITS }, // 0x5B [
+    {  663,  5,  0,  2,  4, 12, FONT_RLE_BITS }, // 0x5C  
+    {  669,  5,  0,  1,  4, 14, FONT_RLE_BITS }, // 0x5D ]
+    {  676,  9,  0,  2,  8,  6, FONT_RLE_BITS }, // 0x5E ^
+    {  682,  9,  0, 13,  8,  2, FONT_RLE_BITS }, // 0x5F _
+    {  684,  4,  0,  1,  3,  2, FONT_RLE_BITS }, // 0x60 `
+    {  685,  9,  0,  5,  8,  9, FONT_RLE_BITS }, // 0x61 a
+    {  694,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x62 b
+    {  706,  8,  0,  5,  7,  9, FONT_RLE_BITS }, // 0x63 c
+    {  714,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x64 d
+    {  726,  8,  0,  5,  7,  9, FONT_RLE_BITS }, // 0x65 e
+    {  734,  7,  0,  2,  6, 12, FONT_RLE_BITS }, // 0x66 f
+    {  743,  9,  0,  4,  8, 12, FONT_RLE_BITS }, // 0x67 g
+    {  755,  9,  0,  2,  8, 12, FONT_RLE_BITS }, // 0x68 h
+    {  767,  3,  0,  2,  2, 12, FONT_RLE_BITS }, // 0x69 i
+    {  770,  4,  0,  2,  3, 14, FONT_RLE_BITS }, // 0x6A j
+    {  776,  8,  0,  2,  7, 12, FONT_RLE_BITS }, // 0x6B k
+    {  787,  3,  0,  2,  2, 12, FONT_RLE_RUNS }, // 0x6C l
+    {  789, 13,  0,  5, 12,  9, FONT_RLE_BITS }, // 0x6D m
+    {  803,  9,  0,  5,  8,  9, FONT_RLE_BITS }, // 0x6E n
+    {  812,  9,  0,  5,  8,  9, FONT_RLE_BITS }, // 0x6F o
+    {  821,  9,  0,  5,  8, 11, FONT_RLE_BITS }, // 0x70 p
+    {  832,  9,  0,  4,  8, 12, FONT_RLE_BITS }, // 0x71 q
+    {  844,  6,  0,  5,  5,  9, FONT_RLE_BITS }, // 0x72 r
+    {  850,  8,  0,  5,  7,  9, FONT_RLE_BITS }, // 0x73 s
+    {  858,  6,  0,  2,  5, 12, FONT_RLE_BITS }, // 0x74 t
+    {  866,  9,  0,  5,  8,  9, FONT_RLE_BITS }, // 0x75 u
+    {  875,  8,  0,  5,  7,  9, FONT_RLE_BITS }, // 0x76 v
+    {  883, 14,  0,  5, 13,  9, FONT_RLE_BITS }, // 0x77 w
+    {  898,  8,  0,  5,  7,  9, FONT_RLE_BITS }, // 0x78 x
+    {  906, 10,  0,  5,  9, 11, FONT_RLE_BITS }, // 0x79 y
+    {  919,  8,  0,  5,  7,  9, FONT_RLE_RUNS }, // 0x7A z
+    {  926,  7,  0,  1,  6, 14, FONT_RLE_BITS }, // 0x7B {
+    {  937,  3,  0,  1,  2, 14, FONT_RLE_RUNS }, // 0x7C |
+    {  939,  7,  0,  1,  6, 14, FONT_RLE_BITS }, // 0x7D }
+    {  950,  9,  0,  2,  8,  3, FONT_RLE_BITS }, // 0x7E ~
+    {  953,  9,  0,  0,  8,  8, FONT_RLE_BITS }, // 0xB0 °
+};
+
+static const uint8_t f10x16f_rle_extra[1] = { 0xB0 };
+
+const tFontRle f10x16f_rle = {
+    .height = 16,
+    .bytesPerRow = 2,
+    .first = 0x20,
+    .last = 0x7E,
+    .extraCount = 1,
+    .pGlyphs = f10x16f_rle_glyphs,
+    .pData = f10x16f_rle_data,
+    .pExtra = f10x16f_rle_extra,
+};
+
+static tFontRleSlot f10x16f_rle_slot = { .Char = -1 };
+
+//==============================================================================
+// 该函数返回一个指向 Char 子表的指针（解码到本字体的解码槽，下次调用前有效）
+//==============================================================================
+uint8_t* f10x16f_rle_GetCharTable(uint8_t Char)
+{
+    return font_rle_Decode(&f10x16f_rle, Char, &f10x16f_rle_slot);
+}
+//==============================================================================
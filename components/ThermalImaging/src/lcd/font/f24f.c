@@ -7,7 +7,12 @@
 // Автор: Надыршин Руслан / Nadyrshin Ruslan
 //------------------------------------------------------------------------------
 #include "f24f.h"
+#ifdef ESP_PLATFORM
 #include "esp_system.h"
+#else
+#include <stdbool.h>
+#include <stdint.h>
+#endif
 #include "font.h"
 
 //表格只包含数字
@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+// 由 tools/fontgen.py 从 f6x8m.c 生成，请勿手工修改
+// 字符范围 0x20 ~ 0x7E，另加 0xB0，原始表 2560 字节，压缩后 1147 字节（索引 768 + 数据 379）
+//------------------------------------------------------------------------------
+#include "f6x8m.h"
+#include "font.h"
+
+static const uint8_t f6x8m_rle_data[378] = {
+    0xFA, 0x99, 0x90, 0x52, 0xBE, 0xAF, 0xA9, 0x40, 0x23, 0xE8, 0xE2, 0xF8, 0x80, 0xC6, 0x44, 0x44,
+    0x4C, 0x60, 0x64, 0xA8, 0x8A, 0xC9, 0xA0, 0xD8, 0x2A, 0x48, 0x88, 0x88, 0x92, 0xA0, 0x51, 0x3E,
+    0x45, 0x00, 0x21, 0x3E, 0x42, 0x00, 0xD8, 0xF8, 0xF0, 0x08, 0x88, 0x88, 0x00, 0x74, 0x67, 0x5C,
+    0xC5, 0xC0, 0x59, 0x24, 0xB8, 0x74, 0x42, 0x64, 0x43, 0xE0, 0x74, 0x42, 0x60, 0xC5, 0xC0, 0x11,
+    0x95, 0x2F, 0x88, 0x40, 0xFC, 0x3C, 0x10, 0xC5, 0xC0, 0x32, 0x21, 0xE8, 0xC5, 0xC0, 0xF8, 0x44,
+    0x44, 0x21, 0x00, 0x74, 0x62, 0xE8, 0xC5, 0xC0, 0x74, 0x62, 0xF0, 0x89, 0x80, 0xF3, 0xC0, 0xF3,
+    0x60, 0x12, 0x48, 0x42, 0x10, 0xF8, 0x3E, 0x84, 0x21, 0x24, 0x80, 0x74, 0x42, 0x22, 0x00, 0x80,
+    0x74, 0x42, 0xDA, 0xD5, 0xC0, 0x74, 0x63, 0xF8, 0xC6, 0x20, 0xF4, 0x63, 0xE8, 0xC7, 0xC0, 0x74,
+    0x61, 0x08, 0x45, 0xC0, 0xE4, 0xA3, 0x18, 0xCB, 0x80, 0xFC, 0x21, 0xE8, 0x43, 0xE0, 0xFC, 0x21,
+    0xE8, 0x42, 0x00, 0x74, 0x61, 0x09, 0xC5, 0xE0, 0x8C, 0x63, 0xF8, 0xC6, 0x20, 0xE9, 0x24, 0xB8,
+    0x38, 0x84, 0x21, 0x49, 0x80, 0x8C, 0xA9, 0x8A, 0x4A, 0x20, 0x84, 0x21, 0x08, 0x43, 0xE0, 0x8E,
+    0xEB, 0x58, 0xC6, 0x20, 0x8C, 0x73, 0x59, 0xC6, 0x20, 0x74, 0x63, 0x18, 0xC5, 0xC0, 0xF4, 0x63,
+    0xE8, 0x42, 0x00, 0x74, 0x63, 0x1A, 0xC9, 0xA0, 0xF4, 0x63, 0xEA, 0x4A, 0x20, 0x74, 0x60, 0xE0,
+    0xC5, 0xC0, 0xF9, 0x08, 0x42, 0x10, 0x80, 0x8C, 0x63, 0x18, 0xC5, 0xC0, 0x8C, 0x63, 0x18, 0xA8,
+    0x80, 0x8C, 0x63, 0x5A, 0xD5, 0x40, 0x8C, 0x54, 0x45, 0x46, 0x20, 0x8C, 0x62, 0xA2, 0x10, 0x80,
+    0xF8, 0x44, 0x44, 0x43, 0xE0, 0xF2, 0x49, 0x38, 0x82, 0x08, 0x20, 0x80, 0xE4, 0x92, 0x78, 0x22,
+    0xA2, 0xF8, 0x88, 0x80, 0x70, 0x5F, 0x17, 0x80, 0x84, 0x2D, 0x98, 0xC7, 0xC0, 0x74, 0x21, 0x17,
+    0x00, 0x08, 0x5B, 0x38, 0xC5, 0xE0, 0x74, 0x7F, 0x07, 0x00, 0x32, 0x51, 0xC4, 0x21, 0x00, 0x7C,
+    0x62, 0xF0, 0xB8, 0x84, 0x2D, 0x98, 0xC6, 0x20, 0x43, 0x24, 0xB8, 0x10, 0x31, 0x11, 0x96, 0x88,
+    0x9A, 0xCA, 0x90, 0xC9, 0x24, 0xB8, 0xD5, 0x63, 0x18, 0x80, 0xB6, 0x63, 0x18, 0x80, 0x74, 0x63,
+    0x17, 0x00, 0xF4, 0x63, 0xE8, 0x40, 0x7C, 0x62, 0xF0, 0x84, 0xB6, 0x61, 0x08, 0x00, 0x7C, 0x1C,
+    0x1F, 0x00, 0x42, 0x38, 0x84, 0x24, 0xC0, 0x8C, 0x63, 0x36, 0x80, 0x8C, 0x62, 0xA2, 0x00, 0x8C,
+    0x6B, 0x55, 0x00, 0x8A, 0x88, 0xA8, 0x80, 0x8C, 0x62, 0xF0, 0xB8, 0xF8, 0x88, 0x8F, 0x80, 0x29,
+    0x44, 0x88, 0xFE, 0x89, 0x14, 0xA0, 0x6C, 0x80, 0x69, 0x96,
+};
+
+static const tFontRleGlyph f6x8m_rle_glyphs[96] = {
+    {    0,  6,  0,  0,  0,  0, FONT_RLE_BITS }, // 0x20  
+    {    0,  6,  2,  0,  1,  7, FONT_RLE_BITS }, // 0x21 !
+    {    1,  6,  1,  0,  4,  3, FONT_RLE_BITS }, // 0x22 "
+    {    3,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x23 #
+    {    8,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x24 $
+    {   13,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x25 %
+    {   18,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x26 &
+    {   23,  6,  1,  0,  2,  3, FONT_RLE_BITS }, // 0x27  
+    {   24,  6,  1,  0,  3,  7, FONT_RLE_BITS }, // 0x28 (
+    {   27,  6,  1,  0,  3,  7, FONT_RLE_BITS }, // 0x29 )
+    {   30,  6,  0,  1,  5,  5, FONT_RLE_BITS }, // 0x2A *
+    {   34,  6,  0,  1,  5,  5, FONT_RLE_BITS }, // 0x2B +
+    {   38,  6,  1,  5,  2,  3, FONT_RLE_BITS }, // 0x2C ,
+    {   39,  6,  0,  3,  5,  1, FONT_RLE_BITS }, // 0x2D -
+    {   40,  6,  1,  5,  2,  2, FONT_RLE_BITS }, // 0x2E .
+    {   41,  6,  0,  1,  5,  5, FONT_RLE_BITS }, // 0x2F /
+    {   45,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x30 0
+    {   50,  6,  1,  0,  3,  7, FONT_RLE_BITS }, // 0x31 1
+    {   53,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x32 2
+    {   58,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x33 3
+    {   63,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x34 4
+    {   68,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x35 5
+    {   73,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x36 6
+    {   78,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x37 7
+    {   83,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x38 8
+    {   88,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x39 9
+    {   93,  6,  1,  1,  2,  5, FONT_RLE_BITS }, // 0x3A :
+    {   95,  6,  1,  2,  2,  6, FONT_RLE_BITS }, // 0x3B ;
+    {   97,  6,  0,  0,  4,  7, FONT_RLE_BITS }, // 0x3C <
+    {  101,  6,  0,  2,  5,  3, FONT_RLE_BITS }, // 0x3D =
+    {  103,  6,  0,  0,  4,  7, FONT_RLE_BITS }, // 0x3E >
+    {  107,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x3F ?
+    {  112,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x40 @
+    {  117,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x41 A
+    {  122,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x42 B
+    {  127,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x43 C
+    {  132,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x44 D
+    {  137,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x45 E
+    {  142,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x46 F
+    {  147,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x47 G
+    {  152,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x48 H
+    {  157,  6,  1,  0,  3,  7, FONT_RLE_BITS }, // 0x49 I
+    {  160,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x4A J
+    {  165,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x4B K
+    {  170,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x4C L
+    {  175,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x4D M
+    {  180,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x4E N
+    {  185,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x4F O
+    {  190,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x50 P
+    {  195,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x51 Q
+    {  200,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x52 R
+    {  205,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x53 S
+    {  210,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x54 T
+    {  215,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x55 U
+    {  220,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x56 V
+    {  225,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x57 W
+    {  230,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x58 X
+    {  235,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x59 Y
+    {  240,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x5A Z
+    {  245,  6,  1,  0,  3,  7, FONT_RLE_BITS }, // 0x5B [
+    {  248,  6,  0,  1,  5,  5, FONT_RLE_BITS }, // 0x5C  
+    {  252,  6,  1,  0,  3,  7, FONT_RLE_BITS }, // 0x5D ]
+    {  255,  6,  0,  0,  5,  3, FONT_RLE_BITS }, // 0x5E ^
+    {  257,  6,  0,  7,  5,  1, FONT_RLE_BITS }, // 0x5F _
+    {  258,  6,  1,  0,  3,  3, FONT_RLE_BITS }, // 0x60 `
+    {  260,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x61 a
+    {  264,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x62 b
+    {  269,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x63 c
+    {  273,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x64 d
+    {  278,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x65 e
+    {  282,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x66 f
+    {  287,  6,  0,  2,  5,  6, FONT_RLE_BITS }, // 0x67 g
+    {  291,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x68 h
+    {  296,  6,  1,  0,  3,  7, FONT_RLE_BITS }, // 0x69 i
+    {  299,  6,  0,  0,  4,  8, FONT_RLE_BITS }, // 0x6A j
+    {  303,  6,  0,  0,  4,  7, FONT_RLE_BITS }, // 0x6B k
+    {  307,  6,  1,  0,  3,  7, FONT_RLE_BITS }, // 0x6C l
+    {  310,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x6D m
+    {  314,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x6E n
+    {  318,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x6F o
+    {  322,  6,  0,  2,  5,  6, FONT_RLE_BITS }, // 0x70 p
+    {  326,  6,  0,  2,  5,  6, FONT_RLE_BITS }, // 0x71 q
+    {  330,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x72 r
+    {  334,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x73 s
+    {  338,  6,  0,  0,  5,  7, FONT_RLE_BITS }, // 0x74 t
+    {  343,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x75 u
+    {  347,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x76 v
+    {  351,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x77 w
+    {  355,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x78 x
+    {  359,  6,  0,  2,  5,  6, FONT_RLE_BITS }, // 0x79 y
+    {  363,  6,  0,  2,  5,  5, FONT_RLE_BITS }, // 0x7A z
+    {  367,  6,  1,  0,  3,  7, FONT_RLE_BITS }, // 0x7B {
+    {  370,  6,  2,  0,  1,  7, FONT_RLE_BITS }, // 0x7C |
+    {  371,  6,  1,  0,  3,  7, FONT_RLE_BITS }, // 0x7D }
+    {  374,  6,  0,  0,  5,  2, FONT_RLE_BITS }, // 0x7E ~
+    {  376,  6,  0,  0,  4,  4, FONT_RLE_BITS }, // 0xB0 °
+};
+
+static const uint8_t f6x8m_rle_extra[1] = { 0xB0 };
+
+const tFontRle f6x8m_rle = {
+    .height = 8,
+    .bytesPerRow = 1,
+    .first = 0x20,
+    .last = 0x7E,
+    .extraCount = 1,
+    .pGlyphs = f6x8m_rle_glyphs,
+    .pData = f6x8m_rle_data,
+    .pExtra = f6x8m_rle_extra,
+};
+
+static tFontRleSlot f6x8m_rle_slot = { .Char = -1 };
+
+//==============================================================================
+// 该函数返回一个指向 Char 子表的指针（解码到本字体的解码槽，下次调用前有效）
+//==============================================================================
+uint8_t* f6x8m_rle_GetCharTable(uint8_t Char)
+{
+    return font_rle_Decode(&f6x8m_rle, Char, &f6x8m_rle_slot);
+}
+//==============================================================================
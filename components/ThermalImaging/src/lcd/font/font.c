@@ -7,6 +7,7 @@
 // Автор: Надыршин Руслан / Nadyrshin Ruslan
 //------------------------------------------------------------------------------
 #include "font.h"
+#include <string.h>
 #include "f16f.h"
 #include "f24f.h"
 #include "f32f.h"
@@ -14,8 +15,13 @@
 
 // 带有指向字体字符表提取功能的指针的表。字体到目前为止
 const t_font_getchar font_table_funcs[] = {
+#if (FONT_STORAGE == FONT_STORAGE_RLE)
+    f6x8m_rle_GetCharTable,
+    f10x16f_rle_GetCharTable,
+#else
     f6x8m_GetCharTable,
     f10x16f_GetCharTable,
+#endif
     f24f_GetCharTable,
     f32f_GetCharTable
 };
@@ -73,4 +79,92 @@ uint8_t* font_GetCharFont(uint8_t* pCharTable)
 {
     if (pCharTable == NULL) return NULL;
     return pCharTable + 2; // 字符数据
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 从半字节流中读取一个游程长度
+ *
+ * @param pData 数据
+ * @param pNibble 当前半字节序号，读取后更新
+ * @return uint16_t 游程长度
+ */
+static uint16_t font_rle_ReadRun(const uint8_t* pData, uint16_t* pNibble)
+{
+    uint16_t run = 0;
+    uint8_t nibble;
+
+    do {
+        nibble = (*pNibble & 1) ? (pData[*pNibble >> 1] & 0x0F) : (pData[*pNibble >> 1] >> 4);
+        (*pNibble)++;
+        run += nibble;
+    } while (nibble == 15);
+
+    return run;
+}
+
+/**
+ * @brief 把压缩字体中的字符解码到解码槽
+ *  - 槽中已是该字符时直接返回，不重复解码
+ *  - 范围外的字符在 pExtra 中查找
+ *  - 返回的指针在同一字体下一次解码前有效
+ *
+ * @param pFont 压缩字体
+ * @param Char 字符
+ * @param pSlot 解码槽
+ * @return uint8_t* 与原始表相同格式的字符结构，字体中没有该字符时返回 NULL
+ */
+uint8_t* font_rle_Decode(const tFontRle* pFont, uint8_t Char, tFontRleSlot* pSlot)
+{
+    if (pSlot->Char == Char)
+        return pSlot->Buff;
+
+    uint16_t index = Char - pFont->first;
+    if ((Char < pFont->first) || (Char > pFont->last)) {
+        // 范围外收录的字符
+        uint8_t i = 0;
+        while ((i < pFont->extraCount) && (pFont->pExtra[i] != Char))
+            i++;
+        if (i == pFont->extraCount)
+            return NULL;
+        index = pFont->last - pFont->first + 1 + i;
+    }
+
+    const tFontRleGlyph* pGlyph = &pFont->pGlyphs[index];
+    const uint8_t* pData = &pFont->pData[pGlyph->offset];
+    uint8_t* pRows = &pSlot->Buff[2];
+    uint8_t rowBits = pFont->bytesPerRow * 8;
+    uint16_t pixel = 0; // 墨迹框内的像素序号
+    uint16_t pixelCount = pGlyph->boxW * pGlyph->boxH;
+    uint16_t nibble = 0;
+    uint16_t run = 0;
+    uint8_t value = 1; // 游程从背景开始，第一次读取前翻转为0
+
+    pSlot->Buff[0] = pGlyph->advance;
+    pSlot->Buff[1] = pFont->height;
+    memset(pRows, 0, pFont->height * pFont->bytesPerRow);
+
+    for (; pixel < pixelCount; pixel++) {
+        uint8_t set;
+
+        if (pGlyph->encoding == FONT_RLE_RUNS) {
+            while (run == 0) {
+                run = font_rle_ReadRun(pData, &nibble);
+                value ^= 1;
+            }
+            run--;
+            set = value;
+        } else {
+            set = pData[pixel >> 3] & (0x80 >> (pixel & 7));
+        }
+
+        if (set) {
+            uint8_t x = pGlyph->boxX + pixel % pGlyph->boxW;
+            uint8_t y = pGlyph->boxY + pixel / pGlyph->boxW;
+            if (x < rowBits)
+                pRows[y * pFont->bytesPerRow + (x >> 3)] |= 0x80 >> (x & 7);
+        }
+    }
+
+    pSlot->Char = Char;
+    return pSlot->Buff;
+}
@@ -0,0 +1,481 @@
+#include "hostfb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 内存帧缓冲，RGB565 本机字节序（不像 ST7789 显存那样交换字节）
+static uint16_t* pFrameBuff = NULL;
+
+// 裁剪矩形 [ClipX0, ClipX1) x [ClipY0, ClipY1)
+static int16_t ClipX0 = 0;
+static int16_t ClipY0 = 0;
+static int16_t ClipX1 = HOSTFB_WIDTH;
+static int16_t ClipY1 = HOSTFB_HEIGHT;
+
+// 脏区域：与 ST7789 显存模式相同，每行记录一个列区间 [DirtyX0, DirtyX1)
+static int16_t DirtyX0[HOSTFB_HEIGHT];
+static int16_t DirtyX1[HOSTFB_HEIGHT];
+
+static sHostFbStats Stats;
+
+static void hostfb_clearDirty(void)
+{
+    for (int16_t row = 0; row < HOSTFB_HEIGHT; row++) {
+        DirtyX0[row] = HOSTFB_WIDTH;
+        DirtyX1[row] = 0;
+    }
+}
+
+static void hostfb_markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    for (int16_t row = y; row < y + h; row++) {
+        if (x < DirtyX0[row])
+            DirtyX0[row] = x;
+        if (x + w > DirtyX1[row])
+            DirtyX1[row] = x + w;
+    }
+    Stats.pixelsTouched += (uint32_t)w * h;
+}
+
+/**
+ * @brief 把一段水平像素裁剪到裁剪矩形范围内
+ *
+ * @param x 起始横坐标，裁剪后更新
+ * @param len 像素数，裁剪后更新
+ * @param skip 返回源数据需要跳过的像素数
+ * @param mirror 源数据是否从右向左排列
+ * @return true 还有可见像素
+ */
+static bool hostfb_clipSpan(int16_t* x, int16_t* len, int16_t* skip, bool mirror)
+{
+    int16_t left = (*x < ClipX0) ? (ClipX0 - *x) : 0;
+    int16_t right = (*x + *len > ClipX1) ? (*x + *len - ClipX1) : 0;
+
+    *skip = mirror ? right : left;
+    *x += left;
+    *len -= left + right;
+    return *len > 0;
+}
+
+static void hostfb_init(void)
+{
+    if (pFrameBuff == NULL)
+        pFrameBuff = calloc(HOSTFB_WIDTH * HOSTFB_HEIGHT, sizeof(uint16_t));
+
+    hostfb_clearDirty();
+    memset(&Stats, 0, sizeof(Stats));
+}
+
+static void hostfb_displayOff(void)
+{
+}
+
+static void hostfb_setBrightness(uint16_t Value)
+{
+}
+
+static uint16_t hostfb_getWidth(void)
+{
+    return HOSTFB_WIDTH;
+}
+
+static uint16_t hostfb_getHeight(void)
+{
+    return HOSTFB_HEIGHT;
+}
+
+static void hostfb_setClip(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    ClipX0 = (x < 0) ? 0 : x;
+    ClipY0 = (y < 0) ? 0 : y;
+    ClipX1 = (x + w > HOSTFB_WIDTH) ? HOSTFB_WIDTH : (x + w);
+    ClipY1 = (y + h > HOSTFB_HEIGHT) ? HOSTFB_HEIGHT : (y + h);
+}
+
+static void hostfb_resetClip(void)
+{
+    hostfb_setClip(0, 0, HOSTFB_WIDTH, HOSTFB_HEIGHT);
+}
+
+static void hostfb_drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    if ((pFrameBuff == NULL) || (x < ClipX0) || (x >= ClipX1) || (y < ClipY0) || (y >= ClipY1))
+        return;
+
+    pFrameBuff[y * HOSTFB_WIDTH + x] = color;
+    hostfb_markDirty(x, y, 1, 1);
+}
+
+static void hostfb_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if ((pFrameBuff == NULL) || (w <= 0) || (h <= 0))
+        return;
+
+    if (x < ClipX0) {
+        w -= ClipX0 - x;
+        x = ClipX0;
+    }
+    if (y < ClipY0) {
+        h -= ClipY0 - y;
+        y = ClipY0;
+    }
+    if (x + w > ClipX1)
+        w = ClipX1 - x;
+    if (y + h > ClipY1)
+        h = ClipY1 - y;
+    if ((w <= 0) || (h <= 0))
+        return;
+
+    for (int16_t row = y; row < y + h; row++) {
+        uint16_t* pDst = &pFrameBuff[row * HOSTFB_WIDTH + x];
+        for (int16_t i = 0; i < w; i++)
+            pDst[i] = color;
+    }
+    hostfb_markDirty(x, y, w, h);
+}
+
+static void hostfb_drawHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    hostfb_fillRect(x, y, w, 1, color);
+}
+
+static void hostfb_writeSpan(int16_t x, int16_t y, const uint16_t* pColors, int16_t len, bool mirror)
+{
+    int16_t skip;
+
+    if ((pFrameBuff == NULL) || (y < ClipY0) || (y >= ClipY1) || !hostfb_clipSpan(&x, &len, &skip, mirror))
+        return;
+
+    uint16_t* pDst = &pFrameBuff[y * HOSTFB_WIDTH + x];
+    const uint16_t* pSrc = pColors + skip;
+    if (mirror) {
+        pSrc += len - 1;
+        for (int16_t i = 0; i < len; i++)
+            *pDst++ = *pSrc--;
+    } else {
+        memcpy(pDst, pSrc, len * sizeof(uint16_t));
+    }
+    hostfb_markDirty(x, y, len, 1);
+}
+
+static void hostfb_blitRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pSrc, int16_t stride, bool mirror)
+{
+    for (int16_t row = 0; row < h; row++, pSrc += stride)
+        hostfb_writeSpan(x, y + row, pSrc, w, mirror);
+}
+
+/**
+ * @brief "发送"脏区域：只统计字节数，与 st7789_updateDirty 的传输量对应（不含行校验跳过）
+ *
+ */
+static void hostfb_update(void)
+{
+    uint32_t bytes = 0;
+    uint32_t rows = 0;
+
+    for (int16_t row = 0; row < HOSTFB_HEIGHT; row++) {
+        if (DirtyX0[row] < DirtyX1[row]) {
+            bytes += (DirtyX1[row] - DirtyX0[row]) * sizeof(uint16_t);
+            rows++;
+        }
+    }
+
+    Stats.lastUpdateBytes = bytes;
+    Stats.lastUpdateRows = rows;
+    Stats.totalBytes += bytes;
+    Stats.updateCount++;
+    Stats.pixelsTouched = 0;
+    hostfb_clearDirty();
+}
+
+static void hostfb_updateFull(void)
+{
+    for (int16_t row = 0; row < HOSTFB_HEIGHT; row++) {
+        DirtyX0[row] = 0;
+        DirtyX1[row] = HOSTFB_WIDTH;
+    }
+    hostfb_update();
+}
+
+static void hostfb_updateRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    uint32_t bytes = 0;
+
+    if (x < 0) {
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        h += y;
+        y = 0;
+    }
+    if (x + w > HOSTFB_WIDTH)
+        w = HOSTFB_WIDTH - x;
+    if (y + h > HOSTFB_HEIGHT)
+        h = HOSTFB_HEIGHT - y;
+    if ((w > 0) && (h > 0))
+        bytes = (uint32_t)w * h * sizeof(uint16_t);
+
+    Stats.lastUpdateBytes = bytes;
+    Stats.lastUpdateRows = (h > 0) ? h : 0;
+    Stats.totalBytes += bytes;
+    Stats.updateCount++;
+}
+
+static uint16_t hostfb_getPixel(int16_t x, int16_t y)
+{
+    if ((pFrameBuff == NULL) || (x < 0) || (x >= HOSTFB_WIDTH) || (y < 0) || (y >= HOSTFB_HEIGHT))
+        return 0;
+
+    return pFrameBuff[y * HOSTFB_WIDTH + x];
+}
+
+static void hostfb_getRowData(uint16_t row, uint16_t* pBuff)
+{
+    if ((pFrameBuff == NULL) || (row >= HOSTFB_HEIGHT))
+        return;
+
+    memcpy(pBuff, &pFrameBuff[row * HOSTFB_WIDTH], HOSTFB_WIDTH * sizeof(uint16_t));
+}
+
+static bool hostfb_getScreenData(uint16_t* pBuff)
+{
+    if (pFrameBuff == NULL)
+        return false;
+
+    memcpy(pBuff, pFrameBuff, HOSTFB_WIDTH * HOSTFB_HEIGHT * sizeof(uint16_t));
+    return true;
+}
+
+const tDispBackend dispbackend_hostfb = {
+    .name = "hostfb",
+    .init = hostfb_init,
+    .displayOff = hostfb_displayOff,
+    .setBrightness = hostfb_setBrightness,
+    .getWidth = hostfb_getWidth,
+    .getHeight = hostfb_getHeight,
+    .drawPixel = hostfb_drawPixel,
+    .fillRect = hostfb_fillRect,
+    .drawHLine = hostfb_drawHLine,
+    .writeSpan = hostfb_writeSpan,
+    .blitRect = hostfb_blitRect,
+    .setClip = hostfb_setClip,
+    .resetClip = hostfb_resetClip,
+    .update = hostfb_update,
+    .updateFull = hostfb_updateFull,
+    .updateRect = hostfb_updateRect,
+    .getPixel = hostfb_getPixel,
+    .getRowData = hostfb_getRowData,
+    .getScreenData = hostfb_getScreenData,
+};
+
+/**
+ * @brief 返回帧缓冲
+ *
+ * @return const uint16_t* RGB565，本机字节序，按行存放（未初始化时为 NULL）
+ */
+const uint16_t* hostfb_GetBuffer(void)
+{
+    return pFrameBuff;
+}
+
+/**
+ * @brief 返回统计信息
+ *
+ * @param pStats
+ */
+void hostfb_GetStats(sHostFbStats* pStats)
+{
+    *pStats = Stats;
+}
+
+/**
+ * @brief 清零统计信息
+ *
+ */
+void hostfb_ResetStats(void)
+{
+    memset(&Stats, 0, sizeof(Stats));
+}
+
+/**
+ * @brief 把一行 RGB565 转换成 RGB888（与 save.c 保存 24 位位图的换算一致）
+ *
+ * @param row 行号
+ * @param pRgb 输出，HOSTFB_WIDTH * 3 字节
+ */
+static void hostfb_rowToRgb(int16_t row, uint8_t* pRgb)
+{
+    const uint16_t* pSrc = &pFrameBuff[row * HOSTFB_WIDTH];
+
+    for (int16_t x = 0; x < HOSTFB_WIDTH; x++) {
+        uint16_t c = pSrc[x];
+        *pRgb++ = ((c >> 11) & 0x1F) << 3;
+        *pRgb++ = ((c >> 5) & 0x3F) << 2;
+        *pRgb++ = (c & 0x1F) << 3;
+    }
+}
+
+/**
+ * @brief 把帧缓冲保存为 PPM（P6）文件
+ *
+ * @param pPath 文件路径
+ * @return int 0 成功，-1 失败
+ */
+int hostfb_SavePPM(const char* pPath)
+{
+    uint8_t rgb[HOSTFB_WIDTH * 3];
+
+    if (pFrameBuff == NULL)
+        return -1;
+
+    FILE* f = fopen(pPath, "wb");
+    if (f == NULL)
+        return -1;
+
+    fprintf(f, "P6\n%d %d\n255\n", HOSTFB_WIDTH, HOSTFB_HEIGHT);
+    for (int16_t row = 0; row < HOSTFB_HEIGHT; row++) {
+        hostfb_rowToRgb(row, rgb);
+        fwrite(rgb, 1, sizeof(rgb), f);
+    }
+
+    return fclose(f) ? -1 : 0;
+}
+
+//==============================================================================
+// PNG：deflate 只使用不压缩的存储块，图像比对时不需要压缩率
+//==============================================================================
+static uint32_t PngCrcTable[256];
+
+static void hostfb_pngCrcInit(void)
+{
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++)
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        PngCrcTable[n] = c;
+    }
+}
+
+static uint32_t hostfb_pngCrc(uint32_t crc, const uint8_t* pData, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+        crc = PngCrcTable[(crc ^ pData[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static void hostfb_putBE32(uint8_t* p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+/**
+ * @brief 写一个 PNG 数据块，CRC 覆盖类型和数据
+ *
+ * @param f
+ * @param pType 4 字符块类型
+ * @param pData
+ * @param len
+ */
+static void hostfb_pngChunk(FILE* f, const char* pType, const uint8_t* pData, uint32_t len)
+{
+    uint8_t buf[4];
+    uint32_t crc = 0xFFFFFFFFu;
+
+    hostfb_putBE32(buf, len);
+    fwrite(buf, 1, 4, f);
+    fwrite(pType, 1, 4, f);
+    crc = hostfb_pngCrc(crc, (const uint8_t*)pType, 4);
+    if (len) {
+        fwrite(pData, 1, len, f);
+        crc = hostfb_pngCrc(crc, pData, len);
+    }
+    hostfb_putBE32(buf, crc ^ 0xFFFFFFFFu);
+    fwrite(buf, 1, 4, f);
+}
+
+/**
+ * @brief 把帧缓冲保存为 PNG 文件（RGB 8 位，不压缩）
+ *
+ * @param pPath 文件路径
+ * @return int 0 成功，-1 失败
+ */
+int hostfb_SavePNG(const char* pPath)
+{
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    const uint32_t rowBytes = 1 + HOSTFB_WIDTH * 3; // 每行前面一个过滤类型字节（0 = 无）
+    const uint32_t rawBytes = rowBytes * HOSTFB_HEIGHT;
+    const uint32_t blockCount = (rawBytes + 65534) / 65535;
+    const uint32_t zlibBytes = 2 + rawBytes + blockCount * 5 + 4;
+
+    if (pFrameBuff == NULL)
+        return -1;
+
+    uint8_t* pZlib = malloc(zlibBytes);
+    if (pZlib == NULL)
+        return -1;
+
+    // 先生成原始扫描行，再切成存储块
+    uint8_t* pRaw = malloc(rawBytes);
+    if (pRaw == NULL) {
+        free(pZlib);
+        return -1;
+    }
+    for (int16_t row = 0; row < HOSTFB_HEIGHT; row++) {
+        pRaw[row * rowBytes] = 0;
+        hostfb_rowToRgb(row, &pRaw[row * rowBytes + 1]);
+    }
+
+    uint8_t* p = pZlib;
+    *p++ = 0x78; // CMF：deflate，32K 窗口
+    *p++ = 0x01; // FLG：无字典，校验使 (CMF*256+FLG) % 31 == 0
+    uint32_t a = 1, b = 0; // Adler-32
+    for (uint32_t pos = 0; pos < rawBytes;) {
+        uint32_t len = rawBytes - pos;
+        if (len > 65535)
+            len = 65535;
+
+        *p++ = (pos + len == rawBytes) ? 1 : 0; // BFINAL + BTYPE=00
+        *p++ = len & 0xFF;
+        *p++ = len >> 8;
+        *p++ = ~len & 0xFF;
+        *p++ = (~len >> 8) & 0xFF;
+        memcpy(p, &pRaw[pos], len);
+        p += len;
+
+        for (uint32_t i = 0; i < len; i++) {
+            a = (a + pRaw[pos + i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        pos += len;
+    }
+    hostfb_putBE32(p, (b << 16) | a);
+    free(pRaw);
+
+    FILE* f = fopen(pPath, "wb");
+    if (f == NULL) {
+        free(pZlib);
+        return -1;
+    }
+
+    uint8_t ihdr[13];
+    hostfb_putBE32(&ihdr[0], HOSTFB_WIDTH);
+    hostfb_putBE32(&ihdr[4], HOSTFB_HEIGHT);
+    ihdr[8] = 8; // 位深
+    ihdr[9] = 2; // 颜色类型：RGB
+    ihdr[10] = 0; // 压缩方法
+    ihdr[11] = 0; // 过滤方法
+    ihdr[12] = 0; // 不隔行
+
+    hostfb_pngCrcInit();
+    fwrite(signature, 1, sizeof(signature), f);
+    hostfb_pngChunk(f, "IHDR", ihdr, sizeof(ihdr));
+    hostfb_pngChunk(f, "IDAT", pZlib, zlibBytes);
+    hostfb_pngChunk(f, "IEND", NULL, 0);
+    free(pZlib);
+
+    return fclose(f) ? -1 : 0;
+}
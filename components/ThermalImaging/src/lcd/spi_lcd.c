@@ -65,6 +65,65 @@ void lcd_data(spi_device_handle_t spi, const uint8_t* data, int len)
     assert(ret == ESP_OK); // 应该没有问题
 }
 
+// 排队中的数据事务（同一时间最多一个），发送完成前 tx 缓冲区不能改动
+static spi_transaction_t QueuedTrans;
+static bool QueuedPending = false;
+
+/**
+ * @brief  把长度为len个字节的数据加入SPI队列后立即返回（D/C线电平为1），DMA发送期间CPU可以准备下一块数据
+ *      - 发送完成前会一直占用 pSPIMutex，必须调用 lcd_data_wait 结束后才能再发送命令
+ *      - 已有排队中的数据时先等待它发送完成
+ *      - 例：lcd_data_queue(LCD_SPI, bandBuf, 7680);
+ *
+ * @param  spi LCD与SPI关联的句柄，通过此来调用SPI总线上的LCD设备
+ * @param  data 要发送数据的指针（必须可被DMA访问，发送完成前保持不变）
+ * @param  len 发送的字节数
+ *
+ * @return
+ *     - none
+ */
+void lcd_data_queue(spi_device_handle_t spi, const uint8_t* data, int len)
+{
+    if (len == 0)
+        return; // len为0直接返回，无需发送任何东西
+
+    lcd_data_wait(spi);
+
+    esp_err_t ret;
+    memset(&QueuedTrans, 0, sizeof(QueuedTrans)); // 清空传输结构体
+
+    QueuedTrans.length = len * 8; // len单位为字节, 发送长度的单位是Bit
+    QueuedTrans.tx_buffer = data; // 数据指针
+    QueuedTrans.user = (void*)1; // D/C 线电平为1，传输数据
+
+    xSemaphoreTake(pSPIMutex, portMAX_DELAY);
+    ret = spi_device_queue_trans(spi, &QueuedTrans, portMAX_DELAY);
+    assert(ret == ESP_OK); // 应该没有问题
+    QueuedPending = true;
+}
+
+/**
+ * @brief  等待 lcd_data_queue 排队的数据发送完成并释放 pSPIMutex，没有排队中的数据时直接返回
+ *
+ * @param  spi LCD与SPI关联的句柄，通过此来调用SPI总线上的LCD设备
+ *
+ * @return
+ *     - none
+ */
+void lcd_data_wait(spi_device_handle_t spi)
+{
+    if (!QueuedPending)
+        return;
+
+    esp_err_t ret;
+    spi_transaction_t* pTrans;
+
+    ret = spi_device_get_trans_result(spi, &pTrans, portMAX_DELAY);
+    assert(ret == ESP_OK); // 应该没有问题
+    QueuedPending = false;
+    xSemaphoreGive(pSPIMutex);
+}
+
 /**
  * @brief  向LCD发送单点16Bit的像素数据，（根据驱动IC的不同，可能为2或3个字节，需要转换RGB565、RGB666）
  *      - ili9488\ili9481 这类IC，SPI总线仅能使用RGB666-18Bit/像素，分3字节传输。而不能使用16Bit/像素，分2字节传输。（0x3A寄存器）
@@ -1,23 +1,127 @@
 #include "thermalimaging_simple.h"
+#include "dispbackend.h"
 #include <driver/gpio.h>
 #include <driver/spi_master.h>
 #include <esp_system.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <soc/gpio_struct.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #ifdef CONFIG_ESP32_SPI_ST7789_LCD
+#if (ST7789_MODE == ST7789_BUFFER_MODE) || (ST7789_MODE == ST7789_STREAM_MODE)
+// 脏区域：每行记录一个被修改过的列区间 [DirtyX0, DirtyX1)，DirtyX0 >= DirtyX1 表示该行干净
+static int16_t DirtyX0[ROW_PIXEL_MAX_SIZE];
+static int16_t DirtyX1[ROW_PIXEL_MAX_SIZE];
+// 上一次刷新发送的字节数
+static uint32_t LastUpdateBytes = 0;
+#endif
+
 #if (ST7789_MODE == ST7789_BUFFER_MODE)
 // LCD 缓存
 /* EXT_RAM_ATTR */ static uint16_t ScreenBuff[LINE_PIXEL_MAX_SIZE * ROW_PIXEL_MAX_SIZE]; // LCD显存
+
+// 每行上一次发送到液晶的内容校验，内容没变的脏行不再发送（菜单整屏重绘时几乎不产生传输）
+static uint32_t RowHash[ROW_PIXEL_MAX_SIZE];
+static bool RowHashValid[ROW_PIXEL_MAX_SIZE]; // false 表示该行液晶内容未知，必须发送
+// 局部宽度窗口的中转缓冲（窗口内的行在显存中不连续）
+static uint16_t WindowBuff[PARALLEL_LINES * LINE_PIXEL_MAX_SIZE];
+
+// 设置一次写入窗口的开销折算成像素数，用于判断相邻脏行是否合并到同一窗口
+#define ST7789_WINDOW_COST_PIXELS 32
 #endif
 
 #if (ST7789_MODE == ST7789_DIRECT_MODE)
 static uint16_t* ScreenBuff = NULL;
 #endif
+
+#if (ST7789_MODE == ST7789_STREAM_MODE)
+// 显示列表中的图元类型
+#define ST7789_OP_FILL 0 // 填充矩形（像素、水平线）
+#define ST7789_OP_SPAN 1 // 一段水平像素，颜色跟在记录后面
+#define ST7789_OP_IMAGE 2 // 查找表图像，只保存指针
+#define ST7789_OP_TEXT 3 // 单行字符串，字符串跟在记录后面
+#define ST7789_OP_LINE 4 // 直线
+#define ST7789_OP_DARKEN 5 // 降低已绘制内容的亮度
+
+// 图元标志
+#define ST7789_OPF_DEAD 0x01 // 已被后面的不透明图元完全覆盖，整理列表时删除
+#define ST7789_OPF_OPAQUE 0x02 // 完全覆盖自己的范围
+#define ST7789_OPF_MIRROR 0x04 // 图像水平镜像
+
+// 显示列表中的一条图元记录
+typedef struct {
+    uint8_t type; // ST7789_OP_xxx
+    uint8_t flags; // ST7789_OPF_xxx
+    uint16_t size; // 整条记录的字节数（含跟在后面的数据）
+    int16_t x0, y0, x1, y1; // 可见范围 [x0, x1) x [y0, y1)，已按屏幕和记录时的裁剪矩形裁剪
+    union {
+        struct {
+            uint16_t color;
+        } fill;
+        struct {
+            uint16_t pad; // 颜色（RGB565，从 x0 开始从左到右）跟在记录后面
+        } span;
+        struct {
+            const int16_t* pValues;
+            const uint16_t* pLut;
+            int16_t x, y, w;
+            int16_t valueMin;
+            uint16_t lutSize;
+        } image;
+        struct {
+            int16_t x, y;
+            uint16_t textColor;
+            uint16_t bgColor;
+            uint8_t fontId;
+            uint8_t transparent; // 字符串跟在记录后面
+        } text;
+        struct {
+            int16_t x1, y1, x2, y2;
+            uint16_t color;
+        } line;
+    } u;
+} sDispOp;
+
+// 记录头（不含 union）和各类图元的记录大小
+#define ST7789_OP_HEAD_SIZE offsetof(sDispOp, u)
+#define ST7789_OP_SIZE(member) (ST7789_OP_HEAD_SIZE + sizeof(((sDispOp*)0)->u.member))
+
+// 显示列表：图元按绘制顺序依次存放
+static uintptr_t DispList[ST7789_DISPLAY_LIST_SIZE / sizeof(uintptr_t)];
+static uint32_t DispListUsed = 0; // 已使用字节数
+static uint32_t DispListDead = 0; // 被覆盖图元占用的字节数
+static uint32_t DispListOverflows = 0;
+
+// 丢失区域：溢出或删除图元后液晶上仍在显示、显示列表中已没有对应图元的像素，每行一个列区间 [LostX0, LostX1)，
+// LostX0 >= LostX1 表示该行没有。刷新时这些像素只发送被现有图元写过的部分，其余保持液晶上的内容
+static int16_t LostX0[ROW_PIXEL_MAX_SIZE];
+static int16_t LostX1[ROW_PIXEL_MAX_SIZE];
+static uint16_t LostRows = 0; // 有丢失区域的行数
+
+// 光栅化含丢失区域的窗口时记录被图元写过的像素（每像素 1 位，按窗口的行连续存放）
+static uint8_t CoverMap[PARALLEL_LINES * LINE_PIXEL_MAX_SIZE / 8];
+static bool CoverTrack = false;
+
+// 两个条带缓冲区（DMA），一个在发送时光栅化另一个
+static uint16_t* BandBuff[2] = { NULL, NULL };
+static uint8_t BandIndex = 0;
+
+// 光栅化目标：不为 NULL 时绘图函数直接写入该缓冲区（已交换字节序），否则记录到显示列表
+static uint16_t* pTarget = NULL;
+static int16_t TargetX = 0;
+static int16_t TargetY = 0;
+static int16_t TargetW = 0;
+#endif
+
+// 裁剪矩形 [ClipX0, ClipX1) x [ClipY0, ClipY1)，绘图函数只写入该区域（合成器按区域重绘图层时使用）
+static int16_t ClipX0 = 0;
+static int16_t ClipY0 = 0;
+static int16_t ClipX1 = LINE_PIXEL_MAX_SIZE;
+static int16_t ClipY1 = ROW_PIXEL_MAX_SIZE;
 #endif // CONFIG_ESP32_SPI_ST7789_LCD
 
 _lcd_dev lcddev;
@@ -342,14 +446,14 @@ static void LCD_Display_Dir(lcd_display_dir_t dir, lcd_display_invert_t invert,
 }
 
 /**
- * @brief 设置绘图矩形的4个点坐标
+ * @brief 设置绘图窗口并开始写入GRAM
  *
  * @param x 起始坐标
  * @param y 起始坐标
- * @param x_end 终点坐标
- * @param y_end 终点坐标
+ * @param w 窗口宽度
+ * @param h 窗口高度
  */
-void st7789_setWindow(uint16_t x, uint16_t y, uint16_t x_end, uint16_t y_end)
+void st7789_setWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
 #ifdef CONFIG_ESP32_SPI_ST7789_LCD
     uint8_t Buff[4];
@@ -357,15 +461,15 @@ void st7789_setWindow(uint16_t x, uint16_t y, uint16_t x_end, uint16_t y_end)
     lcd_cmd(LCD_SPI, ST7789_CASET); // Column addr set
     Buff[0] = (x >> 8) & 0xFF;
     Buff[1] = x & 0xFF;
-    Buff[2] = ((x + x_end - 1) >> 8) & 0xFF;
-    Buff[3] = (x + x_end - 1) & 0xFF;
+    Buff[2] = ((x + w - 1) >> 8) & 0xFF;
+    Buff[3] = (x + w - 1) & 0xFF;
     lcd_data(LCD_SPI, Buff, 4);
 
     lcd_cmd(LCD_SPI, ST7789_RASET); // Row addr set
     Buff[0] = (y >> 8) & 0xFF;
     Buff[1] = y & 0xFF;
-    Buff[2] = ((y + y_end - 1) >> 8) & 0xFF;
-    Buff[3] = (y + y_end - 1) & 0xFF;
+    Buff[2] = ((y + h - 1) >> 8) & 0xFF;
+    Buff[3] = (y + h - 1) & 0xFF;
     lcd_data(LCD_SPI, Buff, 4);
 
     lcd_cmd(LCD_SPI, ST7789_RAMWR); // write to RAM
@@ -390,6 +494,10 @@ void st7789_DisplayOn(void)
     lcd_cmd(LCD_SPI, ST7789_SLPOUT); // ensure out of sleep
     vTaskDelay(10 / portTICK_PERIOD_MS);
     lcd_cmd(LCD_SPI, ST7789_DISPON);
+#if (ST7789_MODE == ST7789_BUFFER_MODE) || (ST7789_MODE == ST7789_STREAM_MODE)
+    // 睡眠唤醒后液晶GRAM内容不可信，下次刷新整屏发送
+    st7789_invalidate();
+#endif
 #endif // CONFIG_ESP32_SPI_ST7789_LCD
 }
 
@@ -404,7 +512,136 @@ static void SwapBytes(uint16_t* color)
     uint8_t temp = *color >> 8;
     *color = (*color << 8) | temp;
 }
+
+/**
+ * @brief 返回交换字节序后的颜色（液晶按高字节在前接收）
+ *
+ * @param color
+ * @return uint16_t
+ */
+static inline uint16_t SwapColor(uint16_t color)
+{
+    return (uint16_t)((color << 8) | (color >> 8));
+}
+
+/**
+ * @brief 把一段水平像素裁剪到裁剪矩形范围内
+ *
+ * @param x 起始横坐标，裁剪后更新
+ * @param len 像素数，裁剪后更新
+ * @param skip 返回源数据需要跳过的像素数
+ * @param mirror 源数据是否从右向左排列（pColors[0] 位于最右侧）
+ * @return true 还有可见像素
+ */
+static bool st7789_clipSpan(int16_t* x, int16_t* len, int16_t* skip, bool mirror)
+{
+    int16_t left = (*x < ClipX0) ? (ClipX0 - *x) : 0;
+    int16_t right = (*x + *len > ClipX1) ? (*x + *len - ClipX1) : 0;
+
+    *skip = mirror ? right : left;
+    *x += left;
+    *len -= left + right;
+    return *len > 0;
+}
+
+/**
+ * @brief 把矩形裁剪到裁剪矩形范围内
+ *
+ * @param x 起始横坐标，裁剪后更新
+ * @param y 起始纵坐标，裁剪后更新
+ * @param w 宽，裁剪后更新
+ * @param h 高，裁剪后更新
+ * @return true 还有可见像素
+ */
+static bool st7789_clipRect(int16_t* x, int16_t* y, int16_t* w, int16_t* h)
+{
+    if (*x < ClipX0) {
+        *w -= ClipX0 - *x;
+        *x = ClipX0;
+    }
+    if (*y < ClipY0) {
+        *h -= ClipY0 - *y;
+        *y = ClipY0;
+    }
+
+    if ((*x + *w) > ClipX1)
+        *w = ClipX1 - *x;
+    if ((*y + *h) > ClipY1)
+        *h = ClipY1 - *y;
+
+    return (*w > 0) && (*h > 0);
+}
+
+/**
+ * @brief 把一段颜色交换字节序后复制到目标内存
+ *
+ * @param pDst 目标内存
+ * @param pSrc 源颜色（RGB565）
+ * @param len 像素数
+ * @param mirror 是否水平镜像（pSrc[0] 写到最右侧）
+ */
+static inline void st7789_copySpan(uint16_t* pDst, const uint16_t* pSrc, int16_t len, bool mirror)
+{
+    if (mirror) {
+        pSrc += len - 1;
+        for (int16_t i = 0; i < len; i++)
+            *pDst++ = SwapColor(*pSrc--);
+    } else {
+        for (int16_t i = 0; i < len; i++)
+            *pDst++ = SwapColor(*pSrc++);
+    }
+}
+
+/**
+ * @brief 用32位写入填充一段内存
+ *
+ * @param pDst 目标内存（16位对齐）
+ * @param color 已交换字节序的颜色
+ * @param len 像素数
+ */
+static inline void st7789_fillSpan(uint16_t* pDst, uint16_t color, int16_t len)
+{
+    if ((len > 0) && ((uintptr_t)pDst & 2)) {
+        *pDst++ = color;
+        len--;
+    }
+
+    uint32_t color2 = ((uint32_t)color << 16) | color;
+    uint32_t* pDst32 = (uint32_t*)pDst;
+    for (int16_t i = 0; i < (len >> 1); i++)
+        pDst32[i] = color2;
+
+    if (len & 1)
+        pDst[len - 1] = color;
+}
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+
+/**
+ * @brief 设置裁剪矩形，之后的绘图只写入该矩形与屏幕的交集
+ *
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽
+ * @param h 高
+ */
+void st7789_SetClip(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    ClipX0 = (x < 0) ? 0 : x;
+    ClipY0 = (y < 0) ? 0 : y;
+    ClipX1 = (x + w > lcddev.width) ? lcddev.width : (x + w);
+    ClipY1 = (y + h > lcddev.height) ? lcddev.height : (y + h);
 #endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 取消裁剪，恢复为整个屏幕
+ *
+ */
+void st7789_ResetClip(void)
+{
+    st7789_SetClip(0, 0, lcddev.width, lcddev.height);
+}
 
 #if (ST7789_MODE == ST7789_DIRECT_MODE)
 //==============================================================================
@@ -420,12 +657,12 @@ static void SwapBytes(uint16_t* color)
 void st7789_DrawPixel(int16_t x, int16_t y, uint16_t color)
 {
 #ifdef CONFIG_ESP32_SPI_ST7789_LCD
-    if ((x < 0) || (x >= lcddev.width) || (y < 0) || (y >= lcddev.height))
+    if ((x < ClipX0) || (x >= ClipX1) || (y < ClipY0) || (y >= ClipY1))
         return;
 
     SwapBytes(&color);
 
-    st7789_setWindow(x, y, x, y);
+    st7789_setWindow(x, y, 1, 1);
     lcd_data(LCD_SPI, (uint8_t*)&color, 2);
 #endif // CONFIG_ESP32_SPI_ST7789_LCD
 }
@@ -442,39 +679,141 @@ void st7789_DrawPixel(int16_t x, int16_t y, uint16_t color)
 void st7789_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
 {
 #ifdef CONFIG_ESP32_SPI_ST7789_LCD
-    if ((w <= 0) || (h <= 0) || (x >= lcddev.width) || (y >= lcddev.height))
+    if ((w <= 0) || (h <= 0) || !st7789_clipRect(&x, &y, &w, &h))
+        return;
+
+    uint32_t lineSize = w * 2;
+    uint16_t lineBuf[LINE_PIXEL_MAX_SIZE]; // 一行LCD显存
+
+    st7789_fillSpan(lineBuf, SwapColor(color), w);
+
+    st7789_setWindow(x, y, w, h);
+
+    for (uint16_t i = 0; i < h; i++) {
+        lcd_data(LCD_SPI, (uint8_t*)lineBuf, lineSize);
+    }
+#endif
+}
+
+/**
+ * @brief 绘制一条水平线
+ *
+ * @param x 起始横坐标
+ * @param y 纵坐标
+ * @param w 长度
+ * @param color 颜色
+ */
+void st7789_DrawHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    st7789_FillRect(x, y, w, 1, color);
+}
+
+/**
+ * @brief 写入一段水平像素
+ *
+ * @param x 起始横坐标
+ * @param y 纵坐标
+ * @param pColors 颜色数组（RGB565）
+ * @param len 像素数
+ * @param mirror 是否水平镜像（pColors[0] 写到最右侧）
+ */
+void st7789_WriteSpan(int16_t x, int16_t y, const uint16_t* pColors, int16_t len, bool mirror)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    int16_t skip;
+    uint16_t lineBuf[LINE_PIXEL_MAX_SIZE]; // 一行LCD显存
+
+    if ((y < ClipY0) || (y >= ClipY1) || !st7789_clipSpan(&x, &len, &skip, mirror))
         return;
 
+    st7789_copySpan(lineBuf, pColors + skip, len, mirror);
+    st7789_setWindow(x, y, len, 1);
+    lcd_data(LCD_SPI, (uint8_t*)lineBuf, len * sizeof(uint16_t));
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+#endif // ST7789_MODE == ST7789_DIRECT_MODE
+
+#if (ST7789_MODE == ST7789_BUFFER_MODE) || (ST7789_MODE == ST7789_STREAM_MODE)
+//==============================================================================
+// 脏区域（显存模式和流式模式共用）
+//==============================================================================
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+/**
+ * @brief 清除全部脏标记
+ *
+ */
+static void st7789_clearDirty(void)
+{
+    for (uint16_t row = 0; row < ROW_PIXEL_MAX_SIZE; row++) {
+        DirtyX0[row] = INT16_MAX;
+        DirtyX1[row] = 0;
+    }
+}
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+
+/**
+ * @brief 把指定矩形标记为脏区域（会被裁剪到屏幕范围）
+ *
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽
+ * @param h 高
+ */
+void st7789_markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
     if (x < 0) {
+        w += x;
         x = 0;
     }
     if (y < 0) {
+        h += y;
         y = 0;
     }
-
     if ((x + w) > lcddev.width)
         w = lcddev.width - x;
-
     if ((y + h) > lcddev.height)
         h = lcddev.height - y;
+    if ((w <= 0) || (h <= 0))
+        return;
 
-    uint32_t lineSize = w * 2;
-    uint16_t lineBuf[LINE_PIXEL_MAX_SIZE]; // 一行LCD显存
-
-    SwapBytes(&color);
-
-    for (uint16_t i = 0; i < w; i++) {
-        lineBuf[i] = color;
+    for (int16_t row = y; row < y + h; row++) {
+        if (x < DirtyX0[row])
+            DirtyX0[row] = x;
+        if ((x + w) > DirtyX1[row])
+            DirtyX1[row] = x + w;
     }
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
 
-    st7789_setWindow(x, y, w, h);
-
-    for (uint16_t i = 0; i < h; i++) {
-        lcd_data(LCD_SPI, (uint8_t*)lineBuf, lineSize);
-    }
+/**
+ * @brief 整屏标记为脏区域，并丢弃行校验（显存模式），下一次 st7789_updateDirty 会发送整屏
+ *
+ */
+void st7789_invalidate(void)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+#if (ST7789_MODE == ST7789_BUFFER_MODE)
+    memset(RowHashValid, 0, sizeof(RowHashValid));
 #endif
+    st7789_markDirty(0, 0, lcddev.width, lcddev.height);
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
 }
-#endif // ST7789_MODE == ST7789_DIRECT_MODE
+
+/**
+ * @brief 返回上一次刷新实际发送的像素字节数
+ *
+ * @return uint32_t 字节数
+ */
+uint32_t st7789_getLastUpdateBytes(void)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    return LastUpdateBytes;
+#else
+    return 0;
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+#endif // ST7789_MODE == ST7789_BUFFER_MODE || ST7789_MODE == ST7789_STREAM_MODE
 
 #if (ST7789_MODE == ST7789_BUFFER_MODE)
 //==============================================================================
@@ -491,12 +830,17 @@ void st7789_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
 void st7789_DrawPixel(int16_t x, int16_t y, uint16_t color)
 {
 #ifdef CONFIG_ESP32_SPI_ST7789_LCD
-    if ((x < 0) || (x >= lcddev.width) || (y < 0) || (y >= lcddev.height))
+    if ((x < ClipX0) || (x >= ClipX1) || (y < ClipY0) || (y >= ClipY1))
         return;
 
     SwapBytes(&color);
 
     ScreenBuff[y * lcddev.width + x] = color;
+
+    if (x < DirtyX0[y])
+        DirtyX0[y] = x;
+    if (x >= DirtyX1[y])
+        DirtyX1[y] = x + 1;
 #endif // CONFIG_ESP32_SPI_ST7789_LCD
 }
 
@@ -512,119 +856,1268 @@ void st7789_DrawPixel(int16_t x, int16_t y, uint16_t color)
 void st7789_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
 {
 #ifdef CONFIG_ESP32_SPI_ST7789_LCD
-    if ((w <= 0) || (h <= 0) || (x >= lcddev.width) || (y >= lcddev.height))
+    if ((w <= 0) || (h <= 0) || !st7789_clipRect(&x, &y, &w, &h))
         return;
 
-    if (x < 0) {
-        x = 0;
-    }
-    if (y < 0) {
-        y = 0;
-    }
-
-    if ((x + w) > lcddev.width)
-        w = lcddev.width - x;
-
-    if ((y + h) > lcddev.height)
-        h = lcddev.height - y;
-
-    SwapBytes(&color);
+    color = SwapColor(color);
 
-    for (uint16_t row = 0; row < h; row++) {
-        for (uint16_t col = 0; col < w; col++) {
-            ScreenBuff[(y + row) * lcddev.width + x + col] = color;
-        }
+    uint16_t* pDst = &ScreenBuff[y * lcddev.width + x];
+    for (uint16_t row = 0; row < h; row++, pDst += lcddev.width) {
+        st7789_fillSpan(pDst, color, w);
     }
+
+    st7789_markDirty(x, y, w, h);
 #endif // CONFIG_ESP32_SPI_ST7789_LCD
 }
 
 /**
- * @brief 刷新一帧
+ * @brief 绘制一条水平线
  *
+ * @param x 起始横坐标
+ * @param y 纵坐标
+ * @param w 长度
+ * @param color 颜色
  */
-void st7789_update(void)
+void st7789_DrawHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
 {
 #ifdef CONFIG_ESP32_SPI_ST7789_LCD
-    // 使用分块传输，避免超过SPI传输限制
-    const int lines_per_chunk = PARALLEL_LINES; // 每次传输的行数
-    
-    for(int y = 0; y < lcddev.height; y += lines_per_chunk) {
-        int actual_lines = (y + lines_per_chunk > lcddev.height) ? 
-                          (lcddev.height - y) : lines_per_chunk;
-        
-        st7789_setWindow(0, y, lcddev.width, actual_lines);
-        lcd_data(LCD_SPI, (uint8_t*)&ScreenBuff[y * lcddev.width], 
-                actual_lines * lcddev.width * sizeof(uint16_t));
-    }
+    int16_t skip;
+
+    if ((y < ClipY0) || (y >= ClipY1) || !st7789_clipSpan(&x, &w, &skip, false))
+        return;
+
+    st7789_fillSpan(&ScreenBuff[y * lcddev.width + x], SwapColor(color), w);
+    st7789_markDirty(x, y, w, 1);
 #endif // CONFIG_ESP32_SPI_ST7789_LCD
 }
 
 /**
- * @brief 复制显存数据到指定内存,保存位图的时候使用到
+ * @brief 写入一段水平像素
  *
- * @param pBuff 目标内存
+ * @param x 起始横坐标
+ * @param y 纵坐标
+ * @param pColors 颜色数组（RGB565）
+ * @param len 像素数
+ * @param mirror 是否水平镜像（pColors[0] 写到最右侧）
  */
-void st7789_getScreenData(uint16_t* pBuff)
+void st7789_WriteSpan(int16_t x, int16_t y, const uint16_t* pColors, int16_t len, bool mirror)
 {
 #ifdef CONFIG_ESP32_SPI_ST7789_LCD
-    for (uint32_t pixel = 0; pixel < lcddev.height * lcddev.width; pixel++, pBuff++)
-        *pBuff = (ScreenBuff[pixel] >> 8) | (ScreenBuff[pixel] << 8);
+    int16_t skip;
+
+    if ((y < ClipY0) || (y >= ClipY1) || !st7789_clipSpan(&x, &len, &skip, mirror))
+        return;
+
+    st7789_copySpan(&ScreenBuff[y * lcddev.width + x], pColors + skip, len, mirror);
+    st7789_markDirty(x, y, len, 1);
 #endif // CONFIG_ESP32_SPI_ST7789_LCD
 }
 
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
 /**
- * @brief 复制一行显存数据到指定内存（节省内存版本）
+ * @brief 计算一行显存内容的校验值（FNV-1a）
  *
  * @param row 行号
- * @param pBuff 目标内存（需要能容纳一行数据）
+ * @return uint32_t 校验值
  */
-void st7789_getRowData(uint16_t row, uint16_t* pBuff)
+static uint32_t st7789_rowHash(int16_t row)
 {
-#ifdef CONFIG_ESP32_SPI_ST7789_LCD
-    if (row >= lcddev.height) return;
-    uint16_t* src = &ScreenBuff[row * lcddev.width];
-    for (uint16_t col = 0; col < lcddev.width; col++, pBuff++, src++)
-        *pBuff = (*src >> 8) | (*src << 8);
-#endif // CONFIG_ESP32_SPI_ST7789_LCD
+    const uint16_t* p = &ScreenBuff[row * lcddev.width];
+    uint32_t hash = 2166136261u;
+
+    for (uint16_t col = 0; col < lcddev.width; col++) {
+        hash ^= p[col];
+        hash *= 16777619u;
+    }
+    return hash;
 }
 
 /**
- * @brief 获取指定位置的颜色
+ * @brief 把显存中的一个窗口发送到液晶，窗口高度不超过 PARALLEL_LINES
  *
- * @param x 指定位置横坐标
- * @param y 指定位置纵坐标
- * @return uint16_t 返回指定位置的颜色
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽
+ * @param h 高
  */
-uint16_t st7789_GetPixel(int16_t x, int16_t y)
+static void st7789_sendWindow(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    const uint16_t* pData;
+
+    st7789_setWindow(x, y, w, h);
+
+    if (w == lcddev.width) {
+        // 整行宽度的窗口在显存中是连续的，直接发送
+        pData = &ScreenBuff[y * lcddev.width];
+    } else {
+        for (int16_t row = 0; row < h; row++) {
+            memcpy(&WindowBuff[row * w], &ScreenBuff[(y + row) * lcddev.width + x], w * sizeof(uint16_t));
+        }
+        pData = WindowBuff;
+    }
+
+    lcd_data(LCD_SPI, (const uint8_t*)pData, w * h * sizeof(uint16_t));
+    LastUpdateBytes += w * h * sizeof(uint16_t);
+}
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+
+/**
+ * @brief 只刷新脏区域
+ *  - 内容与上一次发送相同的脏行会被丢弃
+ *  - 相邻脏行的列区间合并成一个窗口，合并后多发的像素比单独设置窗口的开销还大时另起窗口
+ *  - 每个窗口最多 PARALLEL_LINES 行，与SPI一次传输的上限一致
+ *
+ */
+void st7789_updateDirty(void)
 {
 #ifdef CONFIG_ESP32_SPI_ST7789_LCD
-    if ((x < 0) || (x >= lcddev.width) || (y < 0) || (y >= lcddev.height))
-        return 0;
+    int16_t startRow = -1; // 当前窗口的起始行，-1 表示还没有窗口
+    int16_t x0 = 0, x1 = 0; // 当前窗口的列区间 [x0, x1)
+    int16_t rows = 0; // 当前窗口的行数
+
+    LastUpdateBytes = 0;
+
+    for (int16_t row = 0; row < lcddev.height; row++) {
+        int16_t rx0 = DirtyX0[row];
+        int16_t rx1 = DirtyX1[row];
+        bool dirty = false;
+
+        if (rx0 < rx1) {
+            DirtyX0[row] = INT16_MAX;
+            DirtyX1[row] = 0;
+
+            uint32_t hash = st7789_rowHash(row);
+            if (!RowHashValid[row] || (hash != RowHash[row])) {
+                RowHash[row] = hash;
+                RowHashValid[row] = true;
+                dirty = true;
+            }
+        }
 
-    uint16_t color = ScreenBuff[y * lcddev.width + x];
-    SwapBytes(&color);
-    return color;
-#else
-    return 0x0000;
+        if (startRow >= 0) {
+            if (dirty && (rows < PARALLEL_LINES)) {
+                int16_t ux0 = (rx0 < x0) ? rx0 : x0;
+                int16_t ux1 = (rx1 > x1) ? rx1 : x1;
+                int32_t merged = (int32_t)(ux1 - ux0) * (rows + 1);
+                int32_t separate = (int32_t)(x1 - x0) * rows + (rx1 - rx0) + ST7789_WINDOW_COST_PIXELS;
+
+                if (merged <= separate) {
+                    x0 = ux0;
+                    x1 = ux1;
+                    rows++;
+                    continue;
+                }
+            }
+
+            st7789_sendWindow(x0, startRow, x1 - x0, rows);
+            startRow = -1;
+        }
+
+        if (dirty) {
+            startRow = row;
+            x0 = rx0;
+            x1 = rx1;
+            rows = 1;
+        }
+    }
+
+    if (startRow >= 0) {
+        st7789_sendWindow(x0, startRow, x1 - x0, rows);
+    }
 #endif // CONFIG_ESP32_SPI_ST7789_LCD
 }
-#endif //  ST7789_MODE == ST7789_BUFFER_MODE
 
 /**
- * @brief 初始化ST7789液晶
+ * @brief 刷新一帧（整屏发送，并清除全部脏标记）
  *
  */
-void st7789_init()
+void st7789_update(void)
 {
-#if (ST7789_MODE == ST7789_DIRECT_MODE)
-    ScreenBuff = heap_caps_malloc((LINE_PIXEL_MAX_SIZE * ROW_PIXEL_MAX_SIZE) << 1, MALLOC_CAP_8BIT);
-#endif
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    // 使用分块传输，避免超过SPI传输限制
+    const int lines_per_chunk = PARALLEL_LINES; // 每次传输的行数
 
-    // 配置SPI3-主机模式，配置DMA通道、DMA字节大小，及 MISO、MOSI、CLK的引脚。
-    spi_master_init(LCD_SPI_SLOT, LCD_DEF_DMA_CHAN, LCD_DMA_MAX_SIZE, SPI_LCD_PIN_NUM_MISO, SPI_LCD_PIN_NUM_MOSI, SPI_LCD_PIN_NUM_CLK);
+    LastUpdateBytes = 0;
 
-    // lcd-驱动IC初始化（注意：普通GPIO最大只能30MHz，而IOMUX默认的SPI引脚，CLK最大可以设置到80MHz）（注意排线不要太长，高速时可能会花屏）
-    spi_lcd_init(LCD_SPI_SLOT, /* 80 * 1000 * 1000 */ CONFIG_LCD_SPI_CLOCK, SPI_LCD_PIN_NUM_CS);
+    for(int y = 0; y < lcddev.height; y += lines_per_chunk) {
+        int actual_lines = (y + lines_per_chunk > lcddev.height) ? 
+                          (lcddev.height - y) : lines_per_chunk;
+        
+        st7789_sendWindow(0, y, lcddev.width, actual_lines);
+    }
+
+    // 液晶内容与显存一致，重建行校验
+    for (int16_t row = 0; row < lcddev.height; row++) {
+        RowHash[row] = st7789_rowHash(row);
+        RowHashValid[row] = true;
+    }
+    st7789_clearDirty();
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 立即刷新指定矩形区域，不影响脏标记
+ *
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽
+ * @param h 高
+ */
+void st7789_updateRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    if (x < 0) {
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        h += y;
+        y = 0;
+    }
+    if ((x + w) > lcddev.width)
+        w = lcddev.width - x;
+    if ((y + h) > lcddev.height)
+        h = lcddev.height - y;
+    if ((w <= 0) || (h <= 0))
+        return;
+
+    LastUpdateBytes = 0;
+
+    for (int16_t row = y; row < y + h; row += PARALLEL_LINES) {
+        int16_t lines = (row + PARALLEL_LINES > y + h) ? (y + h - row) : PARALLEL_LINES;
+        st7789_sendWindow(x, row, w, lines);
+    }
+
+    // 这些行的液晶内容与记录的校验不再对应，下次有脏标记时必须重新发送
+    for (int16_t row = y; row < y + h; row++) {
+        RowHashValid[row] = false;
+    }
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 复制显存数据到指定内存,保存位图的时候使用到
+ *
+ * @param pBuff 目标内存
+ * @return true
+ */
+bool st7789_getScreenData(uint16_t* pBuff)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    for (uint16_t row = 0; row < lcddev.height; row++, pBuff += lcddev.width)
+        st7789_copySpan(pBuff, &ScreenBuff[row * lcddev.width], lcddev.width, false);
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+    return true;
+}
+
+/**
+ * @brief 复制一行显存数据到指定内存（节省内存版本）
+ *
+ * @param row 行号
+ * @param pBuff 目标内存（需要能容纳一行数据）
+ */
+void st7789_getRowData(uint16_t row, uint16_t* pBuff)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    if (row >= lcddev.height) return;
+    st7789_copySpan(pBuff, &ScreenBuff[row * lcddev.width], lcddev.width, false);
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 获取指定位置的颜色
+ *
+ * @param x 指定位置横坐标
+ * @param y 指定位置纵坐标
+ * @return uint16_t 返回指定位置的颜色
+ */
+uint16_t st7789_GetPixel(int16_t x, int16_t y)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    if ((x < 0) || (x >= lcddev.width) || (y < 0) || (y >= lcddev.height))
+        return 0;
+
+    uint16_t color = ScreenBuff[y * lcddev.width + x];
+    SwapBytes(&color);
+    return color;
+#else
+    return 0x0000;
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+#endif //  ST7789_MODE == ST7789_BUFFER_MODE
+
+#if (ST7789_MODE == ST7789_STREAM_MODE)
+//==============================================================================
+// 流式模式
+//  - 绘图函数只把图元记录到显示列表并标记脏区域
+//  - 刷新时把脏区域按 PARALLEL_LINES 行分成条带，重放与条带相交的图元光栅化到条带缓冲区，
+//    DMA 发送一条带的同时光栅化下一条带
+//==============================================================================
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+/**
+ * @brief 返回显示列表中指定偏移处的图元
+ *
+ * @param offset 字节偏移
+ * @return sDispOp*
+ */
+static inline sDispOp* st7789_opAt(uint32_t offset)
+{
+    return (sDispOp*)((uint8_t*)DispList + offset);
+}
+
+/**
+ * @brief 返回跟在图元记录后面的数据（SPAN 的颜色、TEXT 的字符串）
+ *
+ * @param pOp 图元
+ * @return void*
+ */
+static inline void* st7789_opData(const sDispOp* pOp)
+{
+    return (uint8_t*)pOp + ((pOp->type == ST7789_OP_TEXT) ? ST7789_OP_SIZE(text) : ST7789_OP_SIZE(span));
+}
+
+/**
+ * @brief 返回光栅化目标中 (x, y) 处像素的地址
+ *
+ * @param x 屏幕横坐标
+ * @param y 屏幕纵坐标
+ * @return uint16_t*
+ */
+static inline uint16_t* st7789_targetAt(int16_t x, int16_t y)
+{
+    return &pTarget[(y - TargetY) * TargetW + (x - TargetX)];
+}
+
+/**
+ * @brief 把矩形加入丢失区域
+ *
+ * @param x0
+ * @param y0
+ * @param x1
+ * @param y1
+ */
+static void st7789_markLost(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    for (int16_t row = y0; row < y1; row++) {
+        if (LostX0[row] >= LostX1[row]) {
+            LostX0[row] = x0;
+            LostX1[row] = x1;
+            LostRows++;
+            continue;
+        }
+        if (x0 < LostX0[row])
+            LostX0[row] = x0;
+        if (x1 > LostX1[row])
+            LostX1[row] = x1;
+    }
+}
+
+/**
+ * @brief 不透明图元覆盖了矩形：从丢失区域中去掉（只在覆盖区间的一端或全部时缩小区间）
+ *
+ * @param x0
+ * @param y0
+ * @param x1
+ * @param y1
+ */
+static void st7789_clearLost(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    if (LostRows == 0)
+        return;
+
+    for (int16_t row = y0; row < y1; row++) {
+        if (LostX0[row] >= LostX1[row])
+            continue;
+
+        if ((x0 <= LostX0[row]) && (x1 >= LostX1[row])) {
+            LostX0[row] = 0;
+            LostX1[row] = 0;
+            LostRows--;
+        } else if ((x0 <= LostX0[row]) && (x1 > LostX0[row])) {
+            LostX0[row] = x1;
+        } else if ((x1 >= LostX1[row]) && (x0 < LostX1[row])) {
+            LostX1[row] = x0;
+        }
+    }
+}
+
+/**
+ * @brief 矩形是否与丢失区域相交
+ *
+ * @param x
+ * @param y
+ * @param w
+ * @param h
+ * @return bool
+ */
+static bool st7789_hasLost(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (LostRows == 0)
+        return false;
+
+    for (int16_t row = y; row < y + h; row++) {
+        if ((LostX0[row] < LostX1[row]) && (LostX0[row] < x + w) && (LostX1[row] > x))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 记录光栅化目标中一段像素被图元写过（只在光栅化含丢失区域的窗口时记录）
+ *
+ * @param x 屏幕横坐标
+ * @param y 屏幕纵坐标
+ * @param w 像素数
+ */
+static inline void st7789_cover(int16_t x, int16_t y, int16_t w)
+{
+    if (!CoverTrack)
+        return;
+
+    uint32_t bit = (uint32_t)(y - TargetY) * TargetW + (x - TargetX);
+    for (int16_t i = 0; i < w; i++, bit++)
+        CoverMap[bit >> 3] |= 1 << (bit & 7);
+}
+
+/**
+ * @brief 删除被覆盖的图元，把有效图元移到列表前面
+ *
+ */
+static void st7789_compactList(void)
+{
+    uint32_t dst = 0;
+
+    for (uint32_t src = 0; src < DispListUsed;) {
+        sDispOp* pOp = st7789_opAt(src);
+        uint16_t size = pOp->size;
+
+        if (!(pOp->flags & ST7789_OPF_DEAD)) {
+            if (dst != src)
+                memmove(st7789_opAt(dst), pOp, size);
+            dst += size;
+        }
+        src += size;
+    }
+
+    DispListUsed = dst;
+    DispListDead = 0;
+}
+
+/**
+ * @brief 标记被不透明矩形 [x0, x1) x [y0, y1) 完全覆盖的图元
+ *
+ * @param x0
+ * @param y0
+ * @param x1
+ * @param y1
+ */
+static void st7789_cullCovered(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    for (uint32_t offset = 0; offset < DispListUsed;) {
+        sDispOp* pOp = st7789_opAt(offset);
+
+        if (!(pOp->flags & ST7789_OPF_DEAD) && (pOp->x0 >= x0) && (pOp->y0 >= y0) && (pOp->x1 <= x1) && (pOp->y1 <= y1)) {
+            pOp->flags |= ST7789_OPF_DEAD;
+            DispListDead += pOp->size;
+        }
+        offset += pOp->size;
+    }
+
+    // 全部被覆盖（例如清屏）时直接清空
+    if (DispListDead == DispListUsed) {
+        DispListUsed = 0;
+        DispListDead = 0;
+    }
+}
+
+/**
+ * @brief 在显示列表末尾分配一条图元记录，并把可见范围标记为脏区域
+ *  - 空间不够时先整理列表，仍然不够时把脏区域发送到液晶后清空列表
+ *  - 面积较大的不透明图元会删除被它完全覆盖的旧图元
+ *
+ * @param type 图元类型
+ * @param flags 图元标志
+ * @param size 记录字节数（含跟在后面的数据）
+ * @param x0 可见范围（已裁剪）
+ * @param y0 可见范围（已裁剪）
+ * @param x1 可见范围（已裁剪）
+ * @param y1 可见范围（已裁剪）
+ * @return sDispOp* 新记录，类型相关的字段由调用者填写；记录太大时返回 NULL
+ */
+static sDispOp* st7789_addOp(uint8_t type, uint8_t flags, uint32_t size, int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    size = (size + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1);
+    if (size > sizeof(DispList))
+        return NULL;
+
+    if ((DispListUsed + size > sizeof(DispList)) && (DispListDead > 0))
+        st7789_compactList();
+
+    if (DispListUsed + size > sizeof(DispList)) {
+        // 列表已满：液晶先显示到当前为止的内容，清空列表后被丢弃图元的范围记为丢失区域（液晶上保持不变）
+        st7789_updateDirty();
+        for (uint32_t offset = 0; offset < DispListUsed; offset += st7789_opAt(offset)->size) {
+            const sDispOp* pLive = st7789_opAt(offset);
+            if (!(pLive->flags & ST7789_OPF_DEAD))
+                st7789_markLost(pLive->x0, pLive->y0, pLive->x1, pLive->y1);
+        }
+        DispListUsed = 0;
+        DispListDead = 0;
+        DispListOverflows++;
+    }
+
+    if (flags & ST7789_OPF_OPAQUE) {
+        st7789_clearLost(x0, y0, x1, y1);
+        if ((int32_t)(x1 - x0) * (y1 - y0) >= ST7789_CULL_MIN_AREA)
+            st7789_cullCovered(x0, y0, x1, y1);
+    }
+
+    sDispOp* pOp = st7789_opAt(DispListUsed);
+    DispListUsed += size;
+
+    pOp->type = type;
+    pOp->flags = flags;
+    pOp->size = size;
+    pOp->x0 = x0;
+    pOp->y0 = y0;
+    pOp->x1 = x1;
+    pOp->y1 = y1;
+
+    st7789_markDirty(x0, y0, x1 - x0, y1 - y0);
+    return pOp;
+}
+
+/**
+ * @brief 把查找表图像中位于裁剪矩形内的部分写入光栅化目标
+ *
+ * @param pOp 图像图元
+ */
+static void st7789_rasterImage(const sDispOp* pOp)
+{
+    int16_t x0 = (pOp->x0 > ClipX0) ? pOp->x0 : ClipX0;
+    int16_t y0 = (pOp->y0 > ClipY0) ? pOp->y0 : ClipY0;
+    int16_t x1 = (pOp->x1 < ClipX1) ? pOp->x1 : ClipX1;
+    int16_t y1 = (pOp->y1 < ClipY1) ? pOp->y1 : ClipY1;
+    bool mirror = (pOp->flags & ST7789_OPF_MIRROR) != 0;
+
+    for (int16_t y = y0; y < y1; y++) {
+        const int16_t* pRow = pOp->u.image.pValues + (int32_t)(y - pOp->u.image.y) * pOp->u.image.w;
+        uint16_t* pDst = st7789_targetAt(x0, y);
+
+        for (int16_t x = x0; x < x1; x++) {
+            int16_t col = mirror ? (pOp->u.image.x + pOp->u.image.w - 1 - x) : (x - pOp->u.image.x);
+            int32_t idx = (int32_t)pRow[col] - pOp->u.image.valueMin;
+
+            if (idx < 0)
+                idx = 0;
+            if (idx >= pOp->u.image.lutSize)
+                idx = pOp->u.image.lutSize - 1;
+            *pDst++ = SwapColor(pOp->u.image.pLut[idx]);
+        }
+        st7789_cover(x0, y, x1 - x0);
+    }
+}
+
+/**
+ * @brief 把直线写入光栅化目标（与 dispcolor_DrawLine 逐点画线的结果一致）
+ *
+ * @param x1
+ * @param y1
+ * @param x2
+ * @param y2
+ * @param color
+ */
+static void st7789_rasterLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+{
+    if ((x1 == x2) || (y1 == y2)) {
+        st7789_FillRect((x1 < x2) ? x1 : x2, (y1 < y2) ? y1 : y2, abs(x2 - x1) + 1, abs(y2 - y1) + 1, color);
+        return;
+    }
+
+    const int16_t deltaX = abs(x2 - x1);
+    const int16_t deltaY = abs(y2 - y1);
+    const int16_t signX = x1 < x2 ? 1 : -1;
+    const int16_t signY = y1 < y2 ? 1 : -1;
+
+    int16_t error = deltaX - deltaY;
+
+    st7789_DrawPixel(x2, y2, color);
+
+    while (x1 != x2 || y1 != y2) {
+        st7789_DrawPixel(x1, y1, color);
+        const int16_t error2 = error * 2;
+
+        if (error2 > -deltaY) {
+            error -= deltaY;
+            x1 += signX;
+        }
+        if (error2 < deltaX) {
+            error += deltaX;
+            y1 += signY;
+        }
+    }
+}
+
+/**
+ * @brief 重放显示列表，把矩形区域光栅化到指定内存（已交换字节序，按行连续存放）
+ *  - 没有图元覆盖的地方为黑色（丢失区域内这些像素的真实内容只在液晶上）
+ *  - 区域与丢失区域相交时在 CoverMap 中记录被图元写过的像素
+ *
+ * @param pDst 目标内存（w * h 个像素）
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽
+ * @param h 高
+ * @return bool 区域是否与丢失区域相交
+ */
+static bool st7789_rasterize(uint16_t* pDst, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    int16_t savedClip[4] = { ClipX0, ClipY0, ClipX1, ClipY1 };
+
+    pTarget = pDst;
+    TargetX = x;
+    TargetY = y;
+    TargetW = w;
+    st7789_fillSpan(pDst, SwapColor(BLACK), w * h);
+
+    // 只有条带窗口（不超过 PARALLEL_LINES 行）需要记录
+    CoverTrack = (h <= PARALLEL_LINES) && st7789_hasLost(x, y, w, h);
+    if (CoverTrack)
+        memset(CoverMap, 0, ((uint32_t)w * h + 7) / 8);
+
+    for (uint32_t offset = 0; offset < DispListUsed;) {
+        const sDispOp* pOp = st7789_opAt(offset);
+        offset += pOp->size;
+
+        if ((pOp->flags & ST7789_OPF_DEAD) || (pOp->x1 <= x) || (pOp->x0 >= x + w) || (pOp->y1 <= y) || (pOp->y0 >= y + h))
+            continue;
+
+        // 图元只能写入自己的可见范围与目标区域的交集
+        ClipX0 = (pOp->x0 > x) ? pOp->x0 : x;
+        ClipY0 = (pOp->y0 > y) ? pOp->y0 : y;
+        ClipX1 = (pOp->x1 < x + w) ? pOp->x1 : (x + w);
+        ClipY1 = (pOp->y1 < y + h) ? pOp->y1 : (y + h);
+
+        switch (pOp->type) {
+        case ST7789_OP_FILL:
+            st7789_FillRect(pOp->x0, pOp->y0, pOp->x1 - pOp->x0, pOp->y1 - pOp->y0, pOp->u.fill.color);
+            break;
+
+        case ST7789_OP_SPAN:
+            st7789_WriteSpan(pOp->x0, pOp->y0, (const uint16_t*)st7789_opData(pOp), pOp->x1 - pOp->x0, false);
+            break;
+
+        case ST7789_OP_IMAGE:
+            st7789_rasterImage(pOp);
+            break;
+
+        case ST7789_OP_TEXT:
+            textcache_DrawString(pOp->u.text.x, pOp->u.text.y, pOp->u.text.fontId, (const uint8_t*)st7789_opData(pOp),
+                pOp->u.text.textColor, pOp->u.text.bgColor, pOp->u.text.transparent);
+            break;
+
+        case ST7789_OP_LINE:
+            st7789_rasterLine(pOp->u.line.x1, pOp->u.line.y1, pOp->u.line.x2, pOp->u.line.y2, pOp->u.line.color);
+            break;
+
+        case ST7789_OP_DARKEN:
+            st7789_DarkenRect(pOp->x0, pOp->y0, pOp->x1 - pOp->x0, pOp->y1 - pOp->y0);
+            break;
+        }
+    }
+
+    bool lost = CoverTrack;
+    CoverTrack = false;
+    pTarget = NULL;
+    ClipX0 = savedClip[0];
+    ClipY0 = savedClip[1];
+    ClipX1 = savedClip[2];
+    ClipY1 = savedClip[3];
+    return lost;
+}
+
+/**
+ * @brief 窗口内的像素是否可以发送：不在丢失区域内，或者被图元写过
+ *
+ * @param x 窗口起始横坐标
+ * @param y 窗口起始纵坐标
+ * @param w 窗口宽
+ * @param col 窗口内的列
+ * @param row 窗口内的行
+ * @return bool
+ */
+static inline bool st7789_isKnown(int16_t x, int16_t y, int16_t w, int16_t col, int16_t row)
+{
+    int16_t sx = x + col;
+    int16_t sy = y + row;
+    uint32_t bit = (uint32_t)row * w + col;
+
+    return (sx < LostX0[sy]) || (sx >= LostX1[sy]) || (CoverMap[bit >> 3] & (1 << (bit & 7)));
+}
+
+/**
+ * @brief 发送与丢失区域相交的窗口：每行只发送可以发送的连续像素段（每段单独设置窗口），
+ *        其余像素保持液晶上的内容
+ *
+ * @param pBuff 已光栅化的窗口
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽
+ * @param h 高
+ */
+static void st7789_sendKnown(const uint16_t* pBuff, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    for (int16_t row = 0; row < h; row++) {
+        int16_t col = 0;
+
+        while (col < w) {
+            while ((col < w) && !st7789_isKnown(x, y, w, col, row))
+                col++;
+            int16_t start = col;
+            while ((col < w) && st7789_isKnown(x, y, w, col, row))
+                col++;
+            if (col == start)
+                continue;
+
+            lcd_data_wait(LCD_SPI);
+            st7789_setWindow(x + start, y + row, col - start, 1);
+            lcd_data_queue(LCD_SPI, (const uint8_t*)&pBuff[row * w + start], (col - start) * sizeof(uint16_t));
+            LastUpdateBytes += (col - start) * sizeof(uint16_t);
+        }
+    }
+}
+
+/**
+ * @brief 光栅化一个窗口并排队发送，窗口高度不超过 PARALLEL_LINES
+ *  - 两个条带缓冲区轮流使用，光栅化这一条带时上一条带还在 DMA 发送
+ *
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽
+ * @param h 高
+ */
+static void st7789_sendBand(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    uint16_t* pBuff = BandBuff[BandIndex];
+
+    if (st7789_rasterize(pBuff, x, y, w, h)) {
+        st7789_sendKnown(pBuff, x, y, w, h);
+    } else {
+        // 上一条带发送完成后才能设置新的窗口
+        lcd_data_wait(LCD_SPI);
+        st7789_setWindow(x, y, w, h);
+        lcd_data_queue(LCD_SPI, (const uint8_t*)pBuff, w * h * sizeof(uint16_t));
+        LastUpdateBytes += w * h * sizeof(uint16_t);
+    }
+    BandIndex ^= 1;
+}
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+
+/**
+ * @brief 绘制一个像素
+ *
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param color 颜色
+ */
+void st7789_DrawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    st7789_FillRect(x, y, 1, 1, color);
+}
+
+/**
+ * @brief 填充矩形
+ *
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽
+ * @param h 高
+ * @param color 颜色
+ */
+void st7789_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    if ((w <= 0) || (h <= 0) || !st7789_clipRect(&x, &y, &w, &h))
+        return;
+
+    if (pTarget != NULL) {
+        uint16_t* pDst = st7789_targetAt(x, y);
+
+        color = SwapColor(color);
+        for (uint16_t row = 0; row < h; row++, pDst += TargetW) {
+            st7789_fillSpan(pDst, color, w);
+            st7789_cover(x, y + row, w);
+        }
+        return;
+    }
+
+    sDispOp* pOp = st7789_addOp(ST7789_OP_FILL, ST7789_OPF_OPAQUE, ST7789_OP_SIZE(fill), x, y, x + w, y + h);
+    if (pOp != NULL)
+        pOp->u.fill.color = color;
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 绘制一条水平线
+ *
+ * @param x 起始横坐标
+ * @param y 纵坐标
+ * @param w 长度
+ * @param color 颜色
+ */
+void st7789_DrawHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    st7789_FillRect(x, y, w, 1, color);
+}
+
+/**
+ * @brief 写入一段水平像素（颜色复制到显示列表中）
+ *
+ * @param x 起始横坐标
+ * @param y 纵坐标
+ * @param pColors 颜色数组（RGB565）
+ * @param len 像素数
+ * @param mirror 是否水平镜像（pColors[0] 写到最右侧）
+ */
+void st7789_WriteSpan(int16_t x, int16_t y, const uint16_t* pColors, int16_t len, bool mirror)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    int16_t skip;
+
+    if ((y < ClipY0) || (y >= ClipY1) || !st7789_clipSpan(&x, &len, &skip, mirror))
+        return;
+
+    if (pTarget != NULL) {
+        st7789_copySpan(st7789_targetAt(x, y), pColors + skip, len, mirror);
+        st7789_cover(x, y, len);
+        return;
+    }
+
+    sDispOp* pOp = st7789_addOp(ST7789_OP_SPAN, ST7789_OPF_OPAQUE, ST7789_OP_SIZE(span) + len * sizeof(uint16_t), x, y, x + len, y + 1);
+    if (pOp == NULL)
+        return;
+
+    // 按屏幕从左到右的顺序保存
+    uint16_t* pPixels = (uint16_t*)st7789_opData(pOp);
+    pColors += skip;
+    if (mirror) {
+        for (int16_t i = 0; i < len; i++)
+            pPixels[i] = pColors[len - 1 - i];
+    } else {
+        memcpy(pPixels, pColors, len * sizeof(uint16_t));
+    }
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 把一条直线记录为一个图元
+ *
+ * @param x1
+ * @param y1
+ * @param x2
+ * @param y2
+ * @param color
+ */
+void st7789_DrawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    int16_t x = (x1 < x2) ? x1 : x2;
+    int16_t y = (y1 < y2) ? y1 : y2;
+    int16_t w = abs(x2 - x1) + 1;
+    int16_t h = abs(y2 - y1) + 1;
+
+    if (!st7789_clipRect(&x, &y, &w, &h))
+        return;
+
+    if (pTarget != NULL) {
+        st7789_rasterLine(x1, y1, x2, y2, color);
+        return;
+    }
+
+    // 水平线和垂直线完全覆盖自己的外接矩形
+    uint8_t flags = ((x1 == x2) || (y1 == y2)) ? ST7789_OPF_OPAQUE : 0;
+    sDispOp* pOp = st7789_addOp(ST7789_OP_LINE, flags, ST7789_OP_SIZE(line), x, y, x + w, y + h);
+    if (pOp == NULL)
+        return;
+
+    pOp->u.line.x1 = x1;
+    pOp->u.line.y1 = y1;
+    pOp->u.line.x2 = x2;
+    pOp->u.line.y2 = y2;
+    pOp->u.line.color = color;
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 把单行字符串记录为一个图元
+ *
+ * @param X 起始坐标
+ * @param Y 起始坐标
+ * @param FontID 字体ID
+ * @param Str 字符串（复制到显示列表中）
+ * @param TextColor 文本颜色
+ * @param BgColor 背景颜色
+ * @param TransparentBg 背景是否透明
+ * @return int16_t 下一个字符的X坐标
+ */
+int16_t st7789_DrawString(int16_t X, int16_t Y, uint8_t FontID, const uint8_t* Str, uint16_t TextColor, uint16_t BgColor, uint8_t TransparentBg)
+{
+    int16_t width = 0;
+    int16_t height = 0;
+
+    for (const uint8_t* p = Str; *p; p++) {
+        const sGlyph* pGlyph = textcache_GetGlyph(FontID, *p);
+        width += pGlyph->width;
+        if (pGlyph->height > height)
+            height = pGlyph->height;
+    }
+
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    if (pTarget != NULL)
+        return textcache_DrawString(X, Y, FontID, Str, TextColor, BgColor, TransparentBg);
+
+    int16_t x = X, y = Y, w = width, h = height;
+    if ((w <= 0) || (h <= 0) || !st7789_clipRect(&x, &y, &w, &h))
+        return X + width;
+
+    size_t len = strlen((const char*)Str);
+    sDispOp* pOp = st7789_addOp(ST7789_OP_TEXT, 0, ST7789_OP_SIZE(text) + len + 1, x, y, x + w, y + h);
+    if (pOp == NULL)
+        return X + width;
+
+    pOp->u.text.x = X;
+    pOp->u.text.y = Y;
+    pOp->u.text.textColor = TextColor;
+    pOp->u.text.bgColor = BgColor;
+    pOp->u.text.fontId = FontID;
+    pOp->u.text.transparent = TransparentBg;
+    memcpy(st7789_opData(pOp), Str, len + 1);
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+
+    return X + width;
+}
+
+/**
+ * @brief 记录查找表图像，颜色 = pLut[value - valueMin]（超出查找表范围取两端的颜色）
+ *  - 只保存指针，pValues 和 pLut 在该区域被新的不透明图元覆盖之前必须保持有效且内容不变
+ *
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽（同时是 pValues 一行的元素数）
+ * @param h 高
+ * @param pValues 数值图像，按行存放
+ * @param valueMin pLut[0] 对应的数值
+ * @param pLut 颜色查找表（RGB565）
+ * @param lutSize 查找表元素数
+ * @param mirror 是否水平镜像
+ */
+void st7789_DrawImageLut(int16_t x, int16_t y, int16_t w, int16_t h, const int16_t* pValues, int16_t valueMin, const uint16_t* pLut, uint16_t lutSize, bool mirror)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    int16_t cx = x, cy = y, cw = w, ch = h;
+    sDispOp op;
+
+    if ((w <= 0) || (h <= 0) || (lutSize == 0) || !st7789_clipRect(&cx, &cy, &cw, &ch))
+        return;
+
+    op.type = ST7789_OP_IMAGE;
+    op.flags = ST7789_OPF_OPAQUE | (mirror ? ST7789_OPF_MIRROR : 0);
+    op.x0 = cx;
+    op.y0 = cy;
+    op.x1 = cx + cw;
+    op.y1 = cy + ch;
+    op.u.image.pValues = pValues;
+    op.u.image.pLut = pLut;
+    op.u.image.x = x;
+    op.u.image.y = y;
+    op.u.image.w = w;
+    op.u.image.valueMin = valueMin;
+    op.u.image.lutSize = lutSize;
+
+    if (pTarget != NULL) {
+        st7789_rasterImage(&op);
+        return;
+    }
+
+    sDispOp* pOp = st7789_addOp(op.type, op.flags, ST7789_OP_SIZE(image), op.x0, op.y0, op.x1, op.y1);
+    if (pOp != NULL)
+        pOp->u.image = op.u.image;
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 把矩形内已绘制的内容亮度降低约 2 倍（每个分量右移 2 位）
+ *
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽
+ * @param h 高
+ */
+void st7789_DarkenRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    if ((w <= 0) || (h <= 0) || !st7789_clipRect(&x, &y, &w, &h))
+        return;
+
+    if (pTarget != NULL) {
+        for (int16_t row = 0; row < h; row++) {
+            uint16_t* pDst = st7789_targetAt(x, y + row);
+            for (int16_t col = 0; col < w; col++)
+                pDst[col] = SwapColor((SwapColor(pDst[col]) >> 2) & 0x39E7);
+        }
+        return;
+    }
+
+    st7789_addOp(ST7789_OP_DARKEN, 0, ST7789_OP_HEAD_SIZE, x, y, x + w, y + h);
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 调用者将改写或释放一块内存：删除引用这块内存的查找表图像图元
+ *  - 先把脏区域发送到液晶，删除的图元范围记为丢失区域（被新的不透明图元覆盖前保持液晶上的内容）
+ *
+ * @param pBuff 内存起始地址
+ * @param size 字节数
+ */
+void st7789_releaseBuffer(const void* pBuff, size_t size)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    uintptr_t begin = (uintptr_t)pBuff;
+    uintptr_t end = begin + size;
+    bool flushed = false;
+
+    for (uint32_t offset = 0; offset < DispListUsed; offset += st7789_opAt(offset)->size) {
+        sDispOp* pOp = st7789_opAt(offset);
+        if ((pOp->type != ST7789_OP_IMAGE) || (pOp->flags & ST7789_OPF_DEAD))
+            continue;
+
+        uintptr_t values = (uintptr_t)pOp->u.image.pValues;
+        uintptr_t lut = (uintptr_t)pOp->u.image.pLut;
+        if (((values < begin) || (values >= end)) && ((lut < begin) || (lut >= end)))
+            continue;
+
+        if (!flushed) {
+            st7789_updateDirty();
+            flushed = true;
+        }
+        st7789_markLost(pOp->x0, pOp->y0, pOp->x1, pOp->y1);
+        pOp->flags |= ST7789_OPF_DEAD;
+        DispListDead += pOp->size;
+    }
+
+    if (DispListDead == DispListUsed) {
+        DispListUsed = 0;
+        DispListDead = 0;
+    }
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 只刷新脏区域：每个条带内的脏行合并成一个窗口重新光栅化并发送
+ *
+ */
+void st7789_updateDirty(void)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    LastUpdateBytes = 0;
+
+    for (int16_t band = 0; band < lcddev.height; band += PARALLEL_LINES) {
+        int16_t bandEnd = (band + PARALLEL_LINES > lcddev.height) ? lcddev.height : (band + PARALLEL_LINES);
+        int16_t y0 = -1, y1 = 0; // 条带内脏行范围 [y0, y1)
+        int16_t x0 = INT16_MAX, x1 = 0; // 脏行列区间的并集 [x0, x1)
+
+        for (int16_t row = band; row < bandEnd; row++) {
+            if (DirtyX0[row] >= DirtyX1[row])
+                continue;
+
+            if (y0 < 0)
+                y0 = row;
+            y1 = row + 1;
+            if (DirtyX0[row] < x0)
+                x0 = DirtyX0[row];
+            if (DirtyX1[row] > x1)
+                x1 = DirtyX1[row];
+
+            DirtyX0[row] = INT16_MAX;
+            DirtyX1[row] = 0;
+        }
+
+        if (y0 >= 0)
+            st7789_sendBand(x0, y0, x1 - x0, y1 - y0);
+    }
+
+    lcd_data_wait(LCD_SPI);
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 刷新一帧（整屏光栅化并发送）
+ *
+ */
+void st7789_update(void)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    st7789_markDirty(0, 0, lcddev.width, lcddev.height);
+    st7789_updateDirty();
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 立即刷新指定矩形区域，不影响脏标记
+ *
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽
+ * @param h 高
+ */
+void st7789_updateRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    if (x < 0) {
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        h += y;
+        y = 0;
+    }
+    if ((x + w) > lcddev.width)
+        w = lcddev.width - x;
+    if ((y + h) > lcddev.height)
+        h = lcddev.height - y;
+    if ((w <= 0) || (h <= 0))
+        return;
+
+    LastUpdateBytes = 0;
+
+    for (int16_t row = y; row < y + h; row += PARALLEL_LINES) {
+        int16_t lines = (row + PARALLEL_LINES > y + h) ? (y + h - row) : PARALLEL_LINES;
+        st7789_sendBand(x, row, w, lines);
+    }
+
+    lcd_data_wait(LCD_SPI);
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 光栅化整屏到指定内存,保存位图的时候使用到
+ *  - 有丢失区域时这些像素只在液晶上，显示列表重绘不出来：不复制，返回 false（不保存带黑块的截图）
+ *
+ * @param pBuff 目标内存
+ * @return true 成功
+ */
+bool st7789_getScreenData(uint16_t* pBuff)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    if (LostRows > 0)
+        return false;
+
+    for (uint16_t row = 0; row < lcddev.height; row++, pBuff += lcddev.width)
+        st7789_getRowData(row, pBuff);
+    return true;
+#else
+    return false;
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 光栅化一行到指定内存
+ *
+ * @param row 行号
+ * @param pBuff 目标内存（需要能容纳一行数据）
+ */
+void st7789_getRowData(uint16_t row, uint16_t* pBuff)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    if (row >= lcddev.height) return;
+
+    st7789_rasterize(pBuff, 0, row, lcddev.width, 1);
+    for (uint16_t col = 0; col < lcddev.width; col++)
+        SwapBytes(&pBuff[col]);
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 获取指定位置的颜色（只光栅化这一个像素）
+ *
+ * @param x 指定位置横坐标
+ * @param y 指定位置纵坐标
+ * @return uint16_t 返回指定位置的颜色
+ */
+uint16_t st7789_GetPixel(int16_t x, int16_t y)
+{
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    uint16_t color;
+
+    if ((x < 0) || (x >= lcddev.width) || (y < 0) || (y >= lcddev.height))
+        return 0;
+
+    st7789_rasterize(&color, x, y, 1, 1);
+    SwapBytes(&color);
+    return color;
+#else
+    return 0x0000;
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+
+/**
+ * @brief 返回显示列表使用情况
+ *
+ * @param pStats
+ */
+void st7789_getListStats(sSt7789ListStats* pStats)
+{
+    memset(pStats, 0, sizeof(*pStats));
+#ifdef CONFIG_ESP32_SPI_ST7789_LCD
+    for (uint32_t offset = 0; offset < DispListUsed; offset += st7789_opAt(offset)->size) {
+        if (!(st7789_opAt(offset)->flags & ST7789_OPF_DEAD))
+            pStats->liveOps++;
+    }
+    pStats->usedBytes = DispListUsed;
+    pStats->overflows = DispListOverflows;
+    pStats->lostRows = LostRows;
+    pStats->complete = (LostRows == 0);
+#endif // CONFIG_ESP32_SPI_ST7789_LCD
+}
+#endif // ST7789_MODE == ST7789_STREAM_MODE
+
+/**
+ * @brief 把调用者内存中的矩形图像复制到屏幕
+ *
+ * @param x 起始横坐标
+ * @param y 起始纵坐标
+ * @param w 宽
+ * @param h 高
+ * @param pSrc 图像数据（RGB565，按行存放）
+ * @param stride 源图像一行的像素数
+ * @param mirror 是否水平镜像
+ */
+void st7789_BlitRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pSrc, int16_t stride, bool mirror)
+{
+    for (int16_t row = 0; row < h; row++, pSrc += stride) {
+        st7789_WriteSpan(x, y + row, pSrc, w, mirror);
+    }
+}
+
+/**
+ * @brief 初始化ST7789液晶
+ *
+ */
+void st7789_init()
+{
+#if (ST7789_MODE == ST7789_DIRECT_MODE)
+    ScreenBuff = heap_caps_malloc((LINE_PIXEL_MAX_SIZE * ROW_PIXEL_MAX_SIZE) << 1, MALLOC_CAP_8BIT);
+#endif
+#if (ST7789_MODE == ST7789_STREAM_MODE)
+    BandBuff[0] = heap_caps_malloc(PARALLEL_LINES * LINE_PIXEL_MAX_SIZE * sizeof(uint16_t), MALLOC_CAP_DMA);
+    BandBuff[1] = heap_caps_malloc(PARALLEL_LINES * LINE_PIXEL_MAX_SIZE * sizeof(uint16_t), MALLOC_CAP_DMA);
+#endif
+
+    // 配置SPI3-主机模式，配置DMA通道、DMA字节大小，及 MISO、MOSI、CLK的引脚。
+    spi_master_init(LCD_SPI_SLOT, LCD_DEF_DMA_CHAN, LCD_DMA_MAX_SIZE, SPI_LCD_PIN_NUM_MISO, SPI_LCD_PIN_NUM_MOSI, SPI_LCD_PIN_NUM_CLK);
+
+    // lcd-驱动IC初始化（注意：普通GPIO最大只能30MHz，而IOMUX默认的SPI引脚，CLK最大可以设置到80MHz）（注意排线不要太长，高速时可能会花屏）
+    spi_lcd_init(LCD_SPI_SLOT, /* 80 * 1000 * 1000 */ CONFIG_LCD_SPI_CLOCK, SPI_LCD_PIN_NUM_CS);
 
     // 设置LCD的安装方向、及横竖方向的像素数目（需要与下面的扫描方式保持一致）
     LCD_Display_Resolution(LCD_DIR);
@@ -633,6 +2126,7 @@ void st7789_init()
     // 初始化 显示区域的大小，和扫描方向。
     // 来匹配屏幕的安装方向。或镜像安装方式（可用于镜面反射及棱镜的镜像显示）（提供了8中扫描方式，以便横竖屏、翻转和镜像的切换）
     LCD_Display_Dir(LCD_DIR, LCD_INVERT, LCD_MIRROR);
+    st7789_ResetClip();
 
     // 清空成黑色
     st7789_FillRect(0, 0, lcddev.width, lcddev.height, BLACK);
@@ -641,3 +2135,47 @@ void st7789_init()
     // 初始化背光PWM
     lcd_backlight_init();
 }
+
+//==============================================================================
+// dispcolor 显示后端
+//==============================================================================
+static uint16_t st7789_getWidth(void)
+{
+    return lcddev.width;
+}
+
+static uint16_t st7789_getHeight(void)
+{
+    return lcddev.height;
+}
+
+const tDispBackend dispbackend_st7789 = {
+    .name = "st7789",
+    .init = st7789_init,
+    .displayOff = st7789_DisplayOff,
+    .setBrightness = lcd_backlight_set,
+    .getWidth = st7789_getWidth,
+    .getHeight = st7789_getHeight,
+    .drawPixel = st7789_DrawPixel,
+    .fillRect = st7789_FillRect,
+    .drawHLine = st7789_DrawHLine,
+    .writeSpan = st7789_WriteSpan,
+    .blitRect = st7789_BlitRect,
+    .setClip = st7789_SetClip,
+    .resetClip = st7789_ResetClip,
+#if (ST7789_MODE == ST7789_STREAM_MODE)
+    .drawLine = st7789_DrawLine,
+    .drawString = st7789_DrawString,
+    .drawImageLut = st7789_DrawImageLut,
+    .darkenRect = st7789_DarkenRect,
+    .releaseBuffer = st7789_releaseBuffer,
+#endif
+#if (ST7789_MODE == ST7789_BUFFER_MODE) || (ST7789_MODE == ST7789_STREAM_MODE)
+    .update = st7789_updateDirty,
+    .updateFull = st7789_update,
+    .updateRect = st7789_updateRect,
+    .getPixel = st7789_GetPixel,
+    .getRowData = st7789_getRowData,
+    .getScreenData = st7789_getScreenData,
+#endif
+};
@@ -0,0 +1,312 @@
+#include "textcache.h"
+#include "dispcolor.h"
+#include "font.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 字体个数（FONTID_6X8M ~ FONTID_32F）
+#define TEXTCACHE_FONT_COUNT (FONTID_32F + 1)
+// 单个字形最多的游程数：宽度不超过16，每行最多8段，高度不超过32
+#define TEXTCACHE_GLYPH_MAX_RUNS (8 * 32)
+
+// 字符串的一个游程，坐标相对字符串左上角
+typedef struct {
+    uint16_t x;
+    uint8_t row;
+    uint8_t len;
+} sStrRun;
+
+// 字符串缓存条目，游程与颜色无关，绘制时再着色
+typedef struct {
+    char text[TEXTCACHE_STR_MAXLEN + 1];
+    uint32_t hash;
+    uint8_t fontId;
+    uint8_t height;
+    uint16_t width;
+    uint16_t runCount;
+    sStrRun* pRuns; // NULL 表示空条目
+    uint32_t lastUse;
+} sStrEntry;
+
+static sGlyph* pGlyphTables[TEXTCACHE_FONT_COUNT]; // 每种字体 256 个字形，第一次使用该字体时分配
+static sGlyphRun GlyphRunPool[TEXTCACHE_GLYPH_RUNS];
+static uint16_t GlyphRunUsed = 0;
+
+// 缓冲池用完（或分配失败）时的临时字形
+static sGlyphRun ScratchRuns[TEXTCACHE_GLYPH_MAX_RUNS];
+static sGlyph ScratchGlyph;
+
+static sStrEntry StrCache[TEXTCACHE_STR_ENTRIES];
+static uint32_t StrUseCounter = 0;
+
+/**
+ * @brief 把点阵字形转换成游程
+ *
+ * @param FontID 字体ID
+ * @param pCharTable font_GetFontStruct 返回的字符结构
+ * @param pRuns 输出的游程数组（至少 TEXTCACHE_GLYPH_MAX_RUNS 个）
+ * @return uint16_t 游程个数
+ */
+static uint16_t textcache_rasterize(uint8_t FontID, uint8_t* pCharTable, sGlyphRun* pRuns)
+{
+    uint8_t* pCharData = font_GetCharFont(pCharTable);
+    uint8_t CharWidth = font_GetCharWidth(pCharTable);
+    uint8_t CharHeight = font_GetCharHeight(pCharTable);
+    uint8_t bytesPerRow = (FontID == FONTID_6X8M) ? 1 : 2; // 6x8 每行1字节，其余字体每行2字节
+    uint16_t runCount = 0;
+
+    if (CharWidth > 16)
+        CharWidth = 16;
+
+    for (uint8_t row = 0; row < CharHeight; row++) {
+        uint16_t bits = pCharData[row * bytesPerRow] << 8;
+        if (bytesPerRow == 2)
+            bits |= pCharData[row * 2 + 1];
+
+        uint8_t col = 0;
+        while (col < CharWidth) {
+            if (!(bits & (0x8000 >> col))) {
+                col++;
+                continue;
+            }
+
+            uint8_t start = col;
+            while ((col < CharWidth) && (bits & (0x8000 >> col)))
+                col++;
+
+            if (runCount < TEXTCACHE_GLYPH_MAX_RUNS) {
+                pRuns[runCount].row = row;
+                pRuns[runCount].x = start;
+                pRuns[runCount].len = col - start;
+                runCount++;
+            }
+        }
+    }
+
+    return runCount;
+}
+
+/**
+ * @brief 返回字符的预光栅化字形，第一次使用时从点阵表生成
+ *
+ * @param FontID 字体ID
+ * @param Char 字符
+ * @return const sGlyph* 字形（字体中没有该字符时宽高为0）
+ */
+const sGlyph* textcache_GetGlyph(uint8_t FontID, uint8_t Char)
+{
+    sGlyph* pGlyph = &ScratchGlyph;
+
+    if (FontID < TEXTCACHE_FONT_COUNT) {
+        if (pGlyphTables[FontID] == NULL)
+            pGlyphTables[FontID] = calloc(256, sizeof(sGlyph));
+
+        if (pGlyphTables[FontID] != NULL) {
+            pGlyph = &pGlyphTables[FontID][Char];
+            if (pGlyph->built)
+                return pGlyph;
+        }
+    }
+
+    memset(pGlyph, 0, sizeof(sGlyph));
+
+    uint8_t* pCharTable = font_GetFontStruct(FontID, Char);
+    if (pCharTable != NULL) {
+        uint16_t runCount = textcache_rasterize(FontID, pCharTable, ScratchRuns);
+
+        pGlyph->width = font_GetCharWidth(pCharTable);
+        pGlyph->height = font_GetCharHeight(pCharTable);
+        pGlyph->runCount = runCount;
+        pGlyph->pRuns = ScratchRuns;
+
+        if (pGlyph == &ScratchGlyph)
+            return pGlyph;
+
+        if (GlyphRunUsed + runCount > TEXTCACHE_GLYPH_RUNS) {
+            // 缓冲池已满：本次用临时字形绘制，下次仍需重新生成
+            ScratchGlyph = *pGlyph;
+            memset(pGlyph, 0, sizeof(sGlyph));
+            return &ScratchGlyph;
+        }
+
+        memcpy(&GlyphRunPool[GlyphRunUsed], ScratchRuns, runCount * sizeof(sGlyphRun));
+        pGlyph->pRuns = &GlyphRunPool[GlyphRunUsed];
+        GlyphRunUsed += runCount;
+    }
+
+    pGlyph->built = (pGlyph != &ScratchGlyph);
+    return pGlyph;
+}
+
+/**
+ * @brief 按游程绘制一个字形
+ *
+ * @param X 起始坐标
+ * @param Y 起始坐标
+ * @param pGlyph 字形
+ * @param TextColor 文本颜色
+ * @param BgColor 背景颜色
+ * @param TransparentBg 背景是否透明
+ */
+static void textcache_drawGlyph(int16_t X, int16_t Y, const sGlyph* pGlyph, uint16_t TextColor, uint16_t BgColor, uint8_t TransparentBg)
+{
+    if (!TransparentBg)
+        dispcolor_FillRect(X, Y, pGlyph->width, pGlyph->height, BgColor);
+
+    const sGlyphRun* pRun = pGlyph->pRuns;
+    for (uint16_t i = 0; i < pGlyph->runCount; i++, pRun++)
+        dispcolor_DrawHLine(X + pRun->x, Y + pRun->row, pRun->len, TextColor);
+}
+
+/**
+ * @brief 按游程绘制一个字符
+ *
+ * @param X 起始坐标
+ * @param Y 起始坐标
+ * @param FontID 字体ID
+ * @param Char 字符
+ * @param TextColor 文本颜色
+ * @param BgColor 背景颜色
+ * @param TransparentBg 背景是否透明
+ * @return uint8_t 字符宽度
+ */
+uint8_t textcache_DrawChar(int16_t X, int16_t Y, uint8_t FontID, uint8_t Char, uint16_t TextColor, uint16_t BgColor, uint8_t TransparentBg)
+{
+    const sGlyph* pGlyph = textcache_GetGlyph(FontID, Char);
+
+    textcache_drawGlyph(X, Y, pGlyph, TextColor, BgColor, TransparentBg);
+    return pGlyph->width;
+}
+
+/**
+ * @brief 字符串校验（FNV-1a）
+ *
+ * @param Str
+ * @return uint32_t
+ */
+static uint32_t textcache_hash(const uint8_t* Str)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*Str) {
+        hash ^= *Str++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief 查找缓存的字符串，没有则生成并替换最久未使用的条目
+ *
+ * @param FontID 字体ID
+ * @param Str 字符串（长度不超过 TEXTCACHE_STR_MAXLEN）
+ * @return sStrEntry* 缓存条目，内存不足时返回 NULL
+ */
+static sStrEntry* textcache_lookup(uint8_t FontID, const uint8_t* Str)
+{
+    uint32_t hash = textcache_hash(Str);
+    sStrEntry* pVictim = &StrCache[0];
+
+    for (uint8_t i = 0; i < TEXTCACHE_STR_ENTRIES; i++) {
+        sStrEntry* pEntry = &StrCache[i];
+
+        if (pEntry->pRuns && (pEntry->hash == hash) && (pEntry->fontId == FontID) && !strcmp(pEntry->text, (const char*)Str)) {
+            pEntry->lastUse = ++StrUseCounter;
+            return pEntry;
+        }
+        if (!pVictim->pRuns)
+            continue;
+        if (!pEntry->pRuns || (pEntry->lastUse < pVictim->lastUse))
+            pVictim = pEntry;
+    }
+
+    // 第一遍统计游程数和尺寸
+    uint32_t runCount = 0;
+    uint16_t width = 0;
+    uint8_t height = 0;
+    for (const uint8_t* p = Str; *p; p++) {
+        const sGlyph* pGlyph = textcache_GetGlyph(FontID, *p);
+        runCount += pGlyph->runCount;
+        width += pGlyph->width;
+        if (pGlyph->height > height)
+            height = pGlyph->height;
+    }
+
+    // 空字符串也分配一个游程，避免与空条目混淆
+    sStrRun* pRuns = malloc((runCount ? runCount : 1) * sizeof(sStrRun));
+    if (pRuns == NULL)
+        return NULL;
+
+    // 第二遍拷贝游程并换算成字符串坐标
+    uint16_t x = 0;
+    sStrRun* pDst = pRuns;
+    for (const uint8_t* p = Str; *p; p++) {
+        const sGlyph* pGlyph = textcache_GetGlyph(FontID, *p);
+        for (uint16_t i = 0; i < pGlyph->runCount; i++, pDst++) {
+            pDst->x = x + pGlyph->pRuns[i].x;
+            pDst->row = pGlyph->pRuns[i].row;
+            pDst->len = pGlyph->pRuns[i].len;
+        }
+        x += pGlyph->width;
+    }
+
+    free(pVictim->pRuns);
+    strcpy(pVictim->text, (const char*)Str);
+    pVictim->hash = hash;
+    pVictim->fontId = FontID;
+    pVictim->width = width;
+    pVictim->height = height;
+    pVictim->runCount = runCount;
+    pVictim->pRuns = pRuns;
+    pVictim->lastUse = ++StrUseCounter;
+    return pVictim;
+}
+
+/**
+ * @brief 绘制单行字符串
+ *  - 内容和字体相同的字符串直接重放缓存的游程，颜色在绘制时指定
+ *  - 超过 TEXTCACHE_STR_MAXLEN 的字符串逐字按游程绘制，不进入缓存
+ *
+ * @param X 起始坐标
+ * @param Y 起始坐标
+ * @param FontID 字体ID
+ * @param Str 字符串（不含 '\n' '\r'）
+ * @param TextColor 文本颜色
+ * @param BgColor 背景颜色
+ * @param TransparentBg 背景是否透明
+ * @return int16_t 下一个字符的X坐标
+ */
+int16_t textcache_DrawString(int16_t X, int16_t Y, uint8_t FontID, const uint8_t* Str, uint16_t TextColor, uint16_t BgColor, uint8_t TransparentBg)
+{
+    sStrEntry* pEntry = NULL;
+
+    if (strlen((const char*)Str) <= TEXTCACHE_STR_MAXLEN)
+        pEntry = textcache_lookup(FontID, Str);
+
+    if (pEntry == NULL) {
+        while (*Str)
+            X += textcache_DrawChar(X, Y, FontID, *Str++, TextColor, BgColor, TransparentBg);
+        return X;
+    }
+
+    if (!TransparentBg)
+        dispcolor_FillRect(X, Y, pEntry->width, pEntry->height, BgColor);
+
+    const sStrRun* pRun = pEntry->pRuns;
+    for (uint16_t i = 0; i < pEntry->runCount; i++, pRun++)
+        dispcolor_DrawHLine(X + pRun->x, Y + pRun->row, pRun->len, TextColor);
+
+    return X + pEntry->width;
+}
+
+/**
+ * @brief 清空字符串缓存
+ *
+ */
+void textcache_Clear(void)
+{
+    for (uint8_t i = 0; i < TEXTCACHE_STR_ENTRIES; i++) {
+        free(StrCache[i].pRuns);
+        StrCache[i].pRuns = NULL;
+    }
+}
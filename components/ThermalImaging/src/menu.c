@@ -284,7 +284,7 @@ static void menu_build()
     strcpy(item.ComboItems[idx++].Str, "Palette -");
     strcpy(item.ComboItems[idx++].Str, "MAX/MIN Mark");
     strcpy(item.ComboItems[idx++].Str, "Save BMP");
-    strcpy(item.ComboItems[idx++].Str, "Save CSV");
+    strcpy(item.ComboItems[idx++].Str, "Save TempMap");
 #ifdef LCD_PIN_NUM_BCKL
     strcpy(item.ComboItems[idx++].Str, "Brightnes +");
     strcpy(item.ComboItems[idx++].Str, "Brightnes -");
@@ -2,31 +2,49 @@
 #include "console.h"
 #include "dispcolor.h"
 #include "driver_MLX90640.h"
+#include "capstore_vfs.h"
+#include "manifest.h"
 #include "messagebox.h"
+#include "qoi.h"
+#include "save_task.h"
 #include "sd_task.h"
 #include "settings.h"
+#include "snapshot.h"
 #include "thermalimaging.h"
-#include <dirent.h>
+#include <errno.h>
+#include <esp_heap_caps.h>
 #include <esp_psram.h>
 #include <esp_spi_flash.h>
 #include <esp_spiffs.h>
 #include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <freertos/task.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <time.h>
 
 #define SAVE_CSV_WINDOW_WIDTH 200 // 消息串口 宽度
 #define SAVE_BMP_WINDOW_WIDTH 200
 
+// 为 1 时在 int16 温度块之后附带原始 float 温度块
+#define SAVE_SNAPSHOT_FLOAT 0
+
 // 预估文件大小（用于空间检查）
 #define BMP_24BIT_SIZE  (320 * 240 * 4 + 100)   // ~307KB for 24-bit BMP
 #define BMP_16BIT_SIZE  (320 * 240 * 2 + 100)   // ~154KB for 16-bit BMP
 #define MIN_FREE_SPACE  (10 * 1024)              // 保留 10KB 安全空间
+#define QOI_MIN_SIZE    (32 * 1024)              // QOI 截图一般只有 10-20KB，空间检查按这个大小
+
+// QOI 截图攒够一块再写文件（每次写入都是整块）
+#define SAVE_QOI_BLOCK_SIZE (4 * 1024)
 
-#define WORD uint16_t
-#define DWORD uint32_t
-#define LONG int32_t
+// BMP 截图按块转换、整块写入：块缓冲（首次使用时分配，优先 PSRAM，之后重复使用）
+#define SAVE_BMP_BLOCK_SIZE (16 * 1024)
+// BMP 文件头最大长度（BITMAPFILEHEADER + BITMAPINFOHEADER）
+#define BMP_HEADER_MAX (14 + 40)
 
 static int16_t GetStringF(char* pOut, const char* args, ...)
 {
@@ -40,12 +58,10 @@ static int16_t GetStringF(char* pOut, const char* args, ...)
     strcpy(pOut, StrBuff);
     return strlen(StrBuff);
 }
-// 保存路径：使用内置 SPIFFS 存储
-#define SAVE_MOUNT_POINT "/spiffs"
 #define SPIFFS_PARTITION_LABEL "storage"
 
 /**
- * @brief 检查 SPIFFS 剩余空间是否足够
+ * @brief 检查内置存储剩余空间是否足够
  *
  * @param requiredSize 需要的空间大小（字节）
  * @return int 0=空间足够, -1=空间不足, -2=获取信息失败
@@ -53,14 +69,26 @@ static int16_t GetStringF(char* pOut, const char* args, ...)
 static int checkSpiffsSpace(size_t requiredSize)
 {
     size_t total = 0, used = 0;
-    esp_err_t ret = esp_spiffs_info(SPIFFS_PARTITION_LABEL, &total, &used);
-    if (ret != ESP_OK) {
-        printf("Failed to get SPIFFS info: %d\n", ret);
-        return -2;
+#if SAVE_USE_CAPSTORE
+    sCapstoreInfo info;
+    if (capstorevfs_Info(&info)) {
+        total = info.capacity;
+        used = info.used;
+        // 每个数据块有 16 字节的记录头
+        requiredSize += requiredSize / CAPSTORE_CHUNK_SIZE * 16 + 16;
+    } else
+#endif
+    {
+        // SPIFFS（包括没能迁移到 capstore 的旧分区）
+        esp_err_t ret = esp_spiffs_info(SPIFFS_PARTITION_LABEL, &total, &used);
+        if (ret != ESP_OK) {
+            printf("Failed to get SPIFFS info: %d\n", ret);
+            return -2;
+        }
     }
-    
-    size_t freeSpace = total - used;
-    printf("SPIFFS: total=%d, used=%d, free=%d, required=%d\n", 
+
+    size_t freeSpace = (total > used) ? total - used : 0;
+    printf("Storage: total=%d, used=%d, free=%d, required=%d\n", 
            (int)total, (int)used, (int)freeSpace, (int)requiredSize);
     
     if (freeSpace < requiredSize + MIN_FREE_SPACE) {
@@ -69,203 +97,303 @@ static int checkSpiffsSpace(size_t requiredSize)
     return 0;  // 空间足够
 }
 
+// 保存文件类型（清单中的类型号）
+typedef enum {
+    SAVE_TYPE_BMP = 0,
+    SAVE_TYPE_SNAPSHOT,
+    SAVE_TYPE_PARAMS,
+    SAVE_TYPE_RECORDING,
+    SAVE_TYPE_QOI,
+    SAVE_TYPE_BMP_THUMB, // 缩略图与截图同序号
+    SAVE_TYPE_QOI_THUMB,
+    SAVE_TYPE_TIMELAPSE,
+    SAVE_TYPE_COUNT,
+} eSaveType;
+
+static const char* const SaveExtensions[SAVE_TYPE_COUNT] = { SAVE_BMP_EXT, SAVE_SNAPSHOT_EXT, SAVE_PARAMS_EXT, SAVE_RECORDING_EXT, SAVE_QOI_EXT,
+    SAVE_BMP_THUMB_EXT, SAVE_QOI_THUMB_EXT, SAVE_TIMELAPSE_EXT };
+// 新增类型时如果超出清单的类型数，manifest_Open 会失败
+_Static_assert(SAVE_TYPE_COUNT <= MANIFEST_MAX_TYPES, "MANIFEST_MAX_TYPES too small for eSaveType");
+
+// 清单由存储任务和菜单共同使用
+static SemaphoreHandle_t ManifestLock = NULL;
+static bool ManifestReady = false;
+
 /**
- * @brief 获取最后的文件序号
+ * @brief 扩展名对应的文件类型
  *
- * @param pExtensionStr 扩展名
- * @return int32_t
+ * @param pExtension
+ * @return int 类型号，未知扩展名返回 -1
  */
-static int32_t GetLastIndex(char* pExtensionStr)
+static int save_typeOf(const char* pExtension)
 {
-    int32_t maxFileIndex = 0;
-
-    // 打开内置 SPIFFS 存储
-    DIR* dr = opendir(SAVE_MOUNT_POINT);
-    if (dr == NULL) {
-        // SPIFFS 未挂载或不可用
-        return -1;
+    for (int type = 0; type < SAVE_TYPE_COUNT; type++) {
+        if (strcmp(pExtension, SaveExtensions[type]) == 0)
+            return type;
     }
+    return -1;
+}
 
-    // 搜索名称中具有最大索引的指定扩展名文件
-    struct dirent* de;
-    while ((de = readdir(dr)) != NULL) {
-        if (de->d_type == DT_REG && strstr(de->d_name, pExtensionStr)) {
-            uint32_t FileIndex = atoi(de->d_name);
-            if (FileIndex > maxFileIndex) {
-                maxFileIndex = FileIndex;
-            }
+/**
+ * @brief 截图文件名对应的类型（按扩展名）
+ *
+ * @param fileName
+ * @return eSaveType SAVE_TYPE_BMP 或 SAVE_TYPE_QOI
+ */
+static eSaveType save_screenshotType(const char* fileName)
+{
+    const char* pExtension = strrchr(fileName, '.');
+    return (pExtension && (strcmp(pExtension, SAVE_QOI_EXT) == 0)) ? SAVE_TYPE_QOI : SAVE_TYPE_BMP;
+}
+
+/**
+ * @brief 截图类型对应的缩略图类型
+ *
+ * @param type SAVE_TYPE_BMP 或 SAVE_TYPE_QOI
+ * @return eSaveType
+ */
+static eSaveType save_thumbType(eSaveType type)
+{
+    return (type == SAVE_TYPE_QOI) ? SAVE_TYPE_QOI_THUMB : SAVE_TYPE_BMP_THUMB;
+}
+
+/**
+ * @brief 分配新文件的序号和路径（清单中该类型的最大序号 + 1）
+ *  目标文件已经存在说明清单与目录不一致（例如文件是从别处拷进来的），重建清单后重新分配
+ *
+ * @param type
+ * @param pPath 输出完整路径
+ * @param size
+ * @param pIndex 输出文件序号
+ * @return int SAVE_OK / SAVE_ERR_ACCESS
+ */
+static int save_newFile(eSaveType type, char* pPath, size_t size, int32_t* pIndex)
+{
+    struct stat st;
+
+    if (ManifestLock == NULL)
+        return SAVE_ERR_ACCESS;
+
+    xSemaphoreTake(ManifestLock, portMAX_DELAY);
+    if (!ManifestReady)
+        ManifestReady = manifest_Open(SAVE_MOUNT_POINT, SaveExtensions, SAVE_TYPE_COUNT);
+    if (ManifestReady) {
+        *pIndex = manifest_NextId(type);
+        manifest_FilePath(type, *pIndex, pPath, size);
+        if (stat(pPath, &st) == 0) {
+            printf("Manifest: %s already exists\r\n", pPath);
+            manifest_Rebuild();
+            *pIndex = manifest_NextId(type);
+            manifest_FilePath(type, *pIndex, pPath, size);
         }
     }
+    xSemaphoreGive(ManifestLock);
 
-    closedir(dr);
-    return maxFileIndex;
+    return ManifestReady ? SAVE_OK : SAVE_ERR_ACCESS;
 }
 
 /**
- * @brief 写入BMP文件头
+ * @brief 把写好的文件记入清单
  *
- * @param f
- * @param bitsPerPixel
- * @param width
- * @param height
+ * @param type
+ * @param index
+ * @param size
+ */
+static void save_addFile(eSaveType type, int32_t index, size_t size)
+{
+    xSemaphoreTake(ManifestLock, portMAX_DELAY);
+    manifest_Add(type, index, size, (uint32_t)time(NULL));
+    xSemaphoreGive(ManifestLock);
+}
+
+/**
+ * @brief 挂载内置存储分区
+ *
+ * @return true 成功
  */
-static void WriteBmpFileHeaderCore24Bit(FILE* f, uint8_t bitsPerPixel, uint16_t width, uint16_t height)
+bool save_Mount(void)
 {
-    WORD uint16;
-    DWORD buff32;
+#if SAVE_USE_CAPSTORE
+    if (capstorevfs_Mount(SAVE_MOUNT_POINT, SPIFFS_PARTITION_LABEL)) {
+        sCapstoreInfo info;
+        capstorevfs_Info(&info);
+        printf("Capstore mounted: total=%d bytes, used=%d bytes, erase count %d..%d\n", (int)info.capacity, (int)info.used,
+            (int)info.eraseMin, (int)info.eraseMax);
+        return true;
+    }
+    // 没能迁移的旧 SPIFFS 照常使用，分区无法识别时也不格式化
+    printf("Failed to mount capstore, trying SPIFFS\n");
+#endif
+
+    esp_vfs_spiffs_conf_t spiffs_conf = {
+        .base_path = SAVE_MOUNT_POINT,
+        .partition_label = SPIFFS_PARTITION_LABEL,
+        .max_files = 5,
+        .format_if_mount_failed = !SAVE_USE_CAPSTORE
+    };
+    esp_err_t spiffs_ret = esp_vfs_spiffs_register(&spiffs_conf);
+    if (spiffs_ret != ESP_OK) {
+        printf("Failed to mount SPIFFS (error %d)\n", spiffs_ret);
+        return false;
+    }
 
-    if (bitsPerPixel == 15)
-        bitsPerPixel = 16;
-    if (bitsPerPixel == 24)
-        bitsPerPixel = 32;
+    size_t total = 0, used = 0;
+    esp_spiffs_info(spiffs_conf.partition_label, &total, &used);
+    printf("SPIFFS mounted: total=%d bytes, used=%d bytes\n", (int)total, (int)used);
+    return true;
+}
 
-    uint32_t pixelDataOffset = 14 + 12;
-    uint32_t fileSize = pixelDataOffset + width * height;
-    fileSize *= bitsPerPixel / 8;
-
-    // 填充 BITMAPFILEHEADER 结构
-    // 文件签名 "BM"
-    uint16 = 0x4D42;
-    fwrite(&uint16, 2, 1, f);
-    // 文件大小
-    buff32 = fileSize;
-    fwrite(&buff32, 4, 1, f);
-    // 2 保留
-    uint16 = 0;
-    fwrite(&uint16, 2, 1, f);
-    uint16 = 0;
-    fwrite(&uint16, 2, 1, f);
-    // 点数据相对于 BITMAPFILEHEADER 结构（和文件本身）开头的偏移量
-    buff32 = pixelDataOffset;
-    fwrite(&buff32, 4, 1, f);
-
-    // 填充 BITMAPCOREHEADER 结构
-    buff32 = 12; // 此结构的大小（定义结构的版本
-    fwrite(&buff32, 4, 1, f);
-    // 光栅宽度和高度
-    fwrite(&width, 2, 1, f);
-    fwrite(&height, 2, 1, f);
-    // 平面字段（对于 BMP，始终 = 1）
-    uint16 = 1;
-    fwrite(&uint16, 2, 1, f);
-    // 位计数字段
-    uint16 = 32; // bitsPerPixel;
-    fwrite(&uint16, 2, 1, f);
-}
-
-/**
- * @brief 写入BMP文件头
+/**
+ * @brief 打开保存目录的清单（存储挂载后调用）
  *
- * @param f 句柄
- * @param bitsPerPixel BMP位数
- * @param width
- * @param height
+ * @return true 成功
  */
-static void WriteBmpFileHeaderCore16Bit(FILE* f, uint8_t bitsPerPixel, uint16_t width, uint16_t height)
+bool save_Init(void)
 {
-    WORD uint16;
-    DWORD uint32;
-    LONG int32;
+    if (ManifestLock == NULL)
+        ManifestLock = xSemaphoreCreateMutex();
+    if (ManifestLock == NULL)
+        return false;
+
+    xSemaphoreTake(ManifestLock, portMAX_DELAY);
+    ManifestReady = manifest_Open(SAVE_MOUNT_POINT, SaveExtensions, SAVE_TYPE_COUNT);
+    xSemaphoreGive(ManifestLock);
+    return ManifestReady;
+}
 
-    if (bitsPerPixel == 15)
-        bitsPerPixel = 16;
-    else if (bitsPerPixel == 24)
-        bitsPerPixel = 32;
+static uint8_t* bmp_Put16(uint8_t* p, uint16_t value)
+{
+    *(p++) = value;
+    *(p++) = value >> 8;
+    return p;
+}
 
-    uint32_t pixelDataOffset = 14 + 40;
-    uint32_t fileSize = pixelDataOffset + width * height;
-    fileSize *= bitsPerPixel / 8;
-
-    // Заполнение структуры BITMAPFILEHEADER
-    // Сигнатура файла "BM"
-    uint16 = 0x4D42;
-    fwrite(&uint16, 2, 1, f);
-    // Размер файла
-    uint32 = fileSize;
-    fwrite(&uint32, 4, 1, f);
-    // 2 резервных слова
-    uint16 = 0;
-    fwrite(&uint16, 2, 1, f);
-    uint16 = 0;
-    fwrite(&uint16, 2, 1, f);
-    // Смещение данных о точках относительно начала структуры BITMAPFILEHEADER (и самого файла)
-    uint32 = pixelDataOffset;
-    fwrite(&uint32, 4, 1, f);
-
-    // Заполнение структуры BITMAPCOREHEADER
-    uint32 = 40; // Размер этой структуры (определяет версию структуры)
-    fwrite(&uint32, 4, 1, f);
-    // Поле biWidth
-    int32 = width;
-    fwrite(&int32, 4, 1, f);
-    // Поле biHeight
-    int32 = height;
-    fwrite(&int32, 4, 1, f);
-    // 平面字段（始终 = 1 为 BMP）
-    uint16 = 1;
-    fwrite(&uint16, 2, 1, f);
-    // bi比特计数
-    uint16 = 16;
-    fwrite(&uint16, 2, 1, f);
-    // 双压缩
-    uint32 = 0; // 无压缩
-    fwrite(&uint32, 4, 1, f);
-    // biSizeImage
-    uint32 = 0; // 0 如果未使用压缩
-    fwrite(&uint32, 4, 1, f);
-    // 字段 biXPelsPerMeter
-    int32 = 0;
-    fwrite(&int32, 4, 1, f);
-    // 字段 biYPelsPerMeter
-    int32 = 0;
-    fwrite(&int32, 4, 1, f);
-    // 字段 biClrUsed
-    uint32 = 0;
-    fwrite(&uint32, 4, 1, f);
-    // biClr导入字段
-    uint32 = 0;
-    fwrite(&uint32, 4, 1, f);
-}
-
-/**
- * @brief 写入BMP数据15Bit
+static uint8_t* bmp_Put32(uint8_t* p, uint32_t value)
+{
+    p = bmp_Put16(p, value);
+    return bmp_Put16(p, value >> 16);
+}
+
+/**
+ * @brief 生成 BMP 文件头（BITMAPFILEHEADER + BITMAPCOREHEADER，每像素 32 位）
  *
- * @param f
+ * @param pOut 输出缓冲（至少 BMP_HEADER_MAX 字节）
  * @param width
- * @param pBuffRgb565
+ * @param height
+ * @return size_t 文件头长度
  */
-static void WriteBmpRow_15bit(FILE* f, uint16_t width, uint16_t* pBuffRgb565)
+static size_t WriteBmpFileHeaderCore24Bit(uint8_t* pOut, uint16_t width, uint16_t height)
 {
-    for (int col = 0; col < width; col++) {
-        uRGB565 color;
-        color.value = *(pBuffRgb565++);
+    uint32_t pixelDataOffset = 14 + 12;
+    uint32_t fileSize = (pixelDataOffset + width * height) * 4;
+    uint8_t* p = pOut;
+
+    // 填充 BITMAPFILEHEADER 结构：签名 "BM"、文件大小、2 个保留字、点数据偏移量
+    p = bmp_Put16(p, 0x4D42);
+    p = bmp_Put32(p, fileSize);
+    p = bmp_Put16(p, 0);
+    p = bmp_Put16(p, 0);
+    p = bmp_Put32(p, pixelDataOffset);
+
+    // 填充 BITMAPCOREHEADER 结构：结构大小、光栅宽度和高度、平面数（始终 = 1）、位数
+    p = bmp_Put32(p, 12);
+    p = bmp_Put16(p, width);
+    p = bmp_Put16(p, height);
+    p = bmp_Put16(p, 1);
+    p = bmp_Put16(p, 32);
+    return p - pOut;
+}
 
-        WORD buff16 = color.rgb_color.b;
-        buff16 |= (color.rgb_color.g >> 1) << 5;
-        buff16 |= color.rgb_color.r << 10;
+/**
+ * @brief 生成 BMP 文件头（BITMAPFILEHEADER + BITMAPINFOHEADER，每像素 16 位 X1R5G5B5）
+ *
+ * @param pOut 输出缓冲（至少 BMP_HEADER_MAX 字节）
+ * @param width
+ * @param height
+ * @return size_t 文件头长度
+ */
+static size_t WriteBmpFileHeaderCore16Bit(uint8_t* pOut, uint16_t width, uint16_t height)
+{
+    uint32_t pixelDataOffset = 14 + 40;
+    uint32_t fileSize = (pixelDataOffset + width * height) * 2;
+    uint8_t* p = pOut;
+
+    // 填充 BITMAPFILEHEADER 结构：签名 "BM"、文件大小、2 个保留字、点数据偏移量
+    p = bmp_Put16(p, 0x4D42);
+    p = bmp_Put32(p, fileSize);
+    p = bmp_Put16(p, 0);
+    p = bmp_Put16(p, 0);
+    p = bmp_Put32(p, pixelDataOffset);
+
+    // 填充 BITMAPINFOHEADER 结构
+    p = bmp_Put32(p, 40); // 结构大小
+    p = bmp_Put32(p, width); // biWidth
+    p = bmp_Put32(p, height); // biHeight
+    p = bmp_Put16(p, 1); // 平面数（始终 = 1）
+    p = bmp_Put16(p, 16); // biBitCount
+    p = bmp_Put32(p, 0); // biCompression：无压缩
+    p = bmp_Put32(p, 0); // biSizeImage：不压缩时为 0
+    p = bmp_Put32(p, 0); // biXPelsPerMeter
+    p = bmp_Put32(p, 0); // biYPelsPerMeter
+    p = bmp_Put32(p, 0); // biClrUsed
+    p = bmp_Put32(p, 0); // biClrImportant
+    return p - pOut;
+}
 
-        fwrite(&buff16, 2, 1, f);
+/**
+ * @brief 把若干行 RGB565 转成 BMP 15Bit（X1R5G5B5），从 pRow 开始往上取行（BMP 从下到上存放）
+ *  - 一次转换 2 个像素
+ *
+ * @param pOut 输出
+ * @param pRow 第一行（最下面一行）
+ * @param width
+ * @param rows 行数
+ * @return size_t 输出字节数
+ */
+static size_t ConvertBmpRows_15bit(uint8_t* pOut, const uint16_t* pRow, uint16_t width, int rows)
+{
+    uint8_t* p = pOut;
+
+    for (int row = 0; row < rows; row++, pRow -= width) {
+        int col = 0;
+        for (; col + 2 <= width; col += 2, p += 4) {
+            uint32_t pair;
+            memcpy(&pair, &pRow[col], 4);
+            // r、g 的高 5 位右移 1 位，b 不动
+            pair = ((pair >> 1) & 0x7FE07FE0) | (pair & 0x001F001F);
+            memcpy(p, &pair, 4);
+        }
+        if (col < width) {
+            uint16_t value = pRow[col];
+            value = ((value >> 1) & 0x7FE0) | (value & 0x001F);
+            memcpy(p, &value, 2);
+            p += 2;
+        }
     }
+    return p - pOut;
 }
 
 /**
- * @brief 写入BMP数据24Bit
+ * @brief 把若干行 RGB565 转成 BMP 32Bit（X8R8G8B8），从 pRow 开始往上取行（BMP 从下到上存放）
  *
- * @param f
+ * @param pOut 输出
+ * @param pRow 第一行（最下面一行）
  * @param width
- * @param pBuffRgb565
+ * @param rows 行数
+ * @return size_t 输出字节数
  */
-static void WriteBmpRow_24bit(FILE* f, uint16_t width, uint16_t* pBuffRgb565)
+static size_t ConvertBmpRows_24bit(uint8_t* pOut, const uint16_t* pRow, uint16_t width, int rows)
 {
-    for (int col = 0; col < width; col++) {
-        uRGB565 color;
-        color.value = *(pBuffRgb565++);
-        DWORD buff32 = color.rgb_color.b << 3;
-        buff32 |= (color.rgb_color.g << 8) << 2;
-        buff32 |= (color.rgb_color.r << 16) << 3;
+    uint8_t* p = pOut;
 
-        fwrite(&buff32, 4, 1, f);
+    for (int row = 0; row < rows; row++, pRow -= width) {
+        for (int col = 0; col < width; col++, p += 4) {
+            uint32_t value = pRow[col];
+            value = ((value & 0x001F) << 3) | ((value & 0x07E0) << 5) | ((value & 0xF800) << 8);
+            memcpy(p, &value, 4);
+        }
     }
+    return p - pOut;
 }
 
 /**
@@ -316,87 +444,255 @@ static void WriteCsvRow_int16(FILE* f, uint16_t width, int16_t* pValues)
 }
 
 /**
- * @brief 将当前热图保存到内置 SPIFFS 的功能（CSV 格式，值分隔符 - 逗号）
+ * @brief 错误码对应的提示文字
  *
- * @return int
+ * @param err SAVE_ERR_xxx
+ * @return const char*
  */
-int save_ImageCSV(void)
+const char* save_ErrorStr(int err)
 {
-    int ret = 0;
-    FILE* f = NULL;
-    float* pValues = NULL;
-    char fileExtension[] = ".CSV";
-
-    // 获取最大文件名
-    int32_t maxFileIndex = GetLastIndex(fileExtension);
-    if (maxFileIndex < 0) {
-        // 无法打开 SPIFFS
-        message_show(SAVE_CSV_WINDOW_WIDTH, FONTID_6X8M, "Save Error", "SPIFFS Access Error", RED, 1, 1000);
-        printf("SPIFFS Access Error\r\n");
-        ret = 1;
-        goto error;
+    switch (err) {
+    case SAVE_OK:
+        return "OK";
+    case SAVE_ERR_ACCESS:
+        return "SPIFFS Access Error";
+    case SAVE_ERR_FULL:
+        return "SPIFFS Full!";
+    case SAVE_ERR_MEMORY:
+        return "Out of Memory !";
+    case SAVE_ERR_WRITE:
+        return "Error Writing File!";
+    case SAVE_ERR_NODATA:
+        return "No Thermal Data";
+    case SAVE_ERR_BUSY:
+        return "Save Queue Full";
+    case SAVE_ERR_SCREEN:
+        return "Screen Incomplete";
+    default:
+        return "Save Error";
     }
-    maxFileIndex++;
+}
 
-    // 分配内存中的临时缓冲区以存储值
-    // 优先使用 PSRAM，如果没有则使用内部内存
-    pValues = heap_caps_malloc((THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT) << 2, MALLOC_CAP_SPIRAM);
-    if (!pValues) {
-        pValues = malloc((THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT) << 2);
-    }
-    if (!pValues) {
-        message_show(SAVE_CSV_WINDOW_WIDTH, FONTID_6X8M, "Save Error", "Out of Memory !", RED, 1, 1000);
-        printf("Out of Memory !\r\n");
-        ret = 1;
-        goto error;
-    }
+/**
+ * @brief 辐射快照文件的字节数
+ *
+ * @return size_t
+ */
+size_t save_SnapshotSize(void)
+{
+    sSnapshotHeader header;
+    snapshot_InitHeader(&header, THERMALIMAGE_RESOLUTION_WIDTH, THERMALIMAGE_RESOLUTION_HEIGHT, SAVE_SNAPSHOT_FLOAT);
+    return snapshot_Size(&header);
+}
 
-    // 获取热成像数据
-    GetThermoData(pValues);
+/**
+ * @brief 用一帧和当前设置填写快照/录像文件头（固定字段由 snapshot_InitHeader / recording_InitHeader 填写）
+ *  - 文件头记录辐射率、Ta、Vdd、刷新率、AD 分辨率、量程和调色板
+ *
+ * @param pHeader
+ * @param pFrame
+ */
+void save_FillHeader(sSnapshotHeader* pHeader, const sMlxData* pFrame)
+{
+    pHeader->Timestamp = (uint32_t)time(NULL);
+    pHeader->FrameSeq = pFrame->FrameSeq;
+    pHeader->Emissivity = settingsParms.Emissivity;
+    pHeader->Ta = pFrame->Ta;
+    pHeader->Vdd = pFrame->Vdd;
+    pHeader->RefreshRate = FPS_RATES[settingsParms.MLX90640FPS];
+    pHeader->AdcResolution = RESOLUTION[settingsParms.Resolution];
+    pHeader->ScaleMode = settingsParms.ScaleMode;
+    pHeader->ColorScale = settingsParms.ColorScale;
+    pHeader->AutoScale = settingsParms.AutoScaleMode;
+    pHeader->PaletteCenterPercent = settingsParms.PaletteCenterPercent;
+    pHeader->ScaleMin = settingsParms.AutoScaleMode ? pFrame->minT : settingsParms.minTempNew;
+    pHeader->ScaleMax = settingsParms.AutoScaleMode ? pFrame->maxT : settingsParms.maxTempNew;
+    pHeader->MinT = pFrame->minT;
+    pHeader->MaxT = pFrame->maxT;
+}
 
-    // 提示
-    char message[32];
-    GetStringF(message, "Save To File %05d%s", maxFileIndex, fileExtension);
-    progress_start_show(SAVE_CSV_WINDOW_WIDTH, FONTID_6X8M, "Save Temperature Map", message, GREEN, 0, 0);
-    printf("%s\r\n", message);
+/**
+ * @brief 用最新的一帧和当前设置编码辐射快照（见 snapshot.h），温度存为 int16
+ *  - 整帧（包括 Ta、Vdd 和帧统计）来自同一个采集缓冲槽
+ *
+ * @param pOut
+ * @param outSize
+ * @return size_t 快照字节数，没有数据或 pOut 太小时返回 0
+ */
+size_t save_BuildSnapshot(uint8_t* pOut, size_t outSize)
+{
+    sSnapshotHeader header;
+    snapshot_InitHeader(&header, THERMALIMAGE_RESOLUTION_WIDTH, THERMALIMAGE_RESOLUTION_HEIGHT, SAVE_SNAPSHOT_FLOAT);
 
-    // 文件名（内置 SPIFFS 存储）
-    char fileName[128];
-    GetStringF(fileName, "%s/%05d%s", SAVE_MOUNT_POINT, maxFileIndex, fileExtension);
+    const sMlxData* pFrame = mlx90640_AcquireLatest();
+    if (pFrame == NULL)
+        return 0;
 
-    // 打开文件
-    f = fopen(fileName, "w");
-    if (f == NULL) {
-        message_show(SAVE_CSV_WINDOW_WIDTH, FONTID_6X8M, "Save Error", "Error Writing File!", RED, 1, 1000);
-        ret = 1;
-        goto error;
-    }
+    save_FillHeader(&header, pFrame);
+    size_t size = snapshot_Encode(&header, pFrame->ThermoImage, pOut, outSize);
+    mlx90640_ReleaseFrame(pFrame);
 
-    // 写入文件
-    for (uint8_t step = 0; step < THERMALIMAGE_RESOLUTION_HEIGHT; step++) {
-        WriteCsvRow_float(f, THERMALIMAGE_RESOLUTION_WIDTH, &pValues[step * THERMALIMAGE_RESOLUTION_WIDTH]);
-        progress_show(SAVE_CSV_WINDOW_WIDTH, FONTID_6X8M, "Save Temperature Map", message, GREEN, step + 1, 24);
+    return size;
+}
+
+/**
+ * @brief 把一段已编码好的数据写成新文件（序号为该扩展名的最大序号 + 1），不显示提示
+ *
+ * @param pExtension 扩展名（SAVE_xxx_EXT）
+ * @param pData
+ * @param size
+ * @param pIndex 输出文件序号，可以为 NULL
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+int save_WriteFile(const char* pExtension, const void* pData, size_t size, int32_t* pIndex)
+{
+    int spaceCheck = checkSpiffsSpace(size);
+    if (spaceCheck == -1)
+        return SAVE_ERR_FULL;
+    if (spaceCheck == -2)
+        return SAVE_ERR_ACCESS;
+
+    int type = save_typeOf(pExtension);
+    if (type < 0)
+        return SAVE_ERR_ACCESS;
+
+    int32_t maxFileIndex;
+    char fileName[64];
+    int ret = save_newFile(type, fileName, sizeof(fileName), &maxFileIndex);
+    if (ret != SAVE_OK)
+        return ret;
+
+    FILE* f = fopen(fileName, "wb");
+    if (f == NULL)
+        return SAVE_ERR_WRITE;
+
+    size_t written = fwrite(pData, 1, size, f);
+    if ((fclose(f) != 0) || (written != size)) {
+        remove(fileName);
+        return SAVE_ERR_WRITE;
     }
+    save_addFile(type, maxFileIndex, size);
 
-    GetStringF(message, "File %05d%s Saved Successfully", maxFileIndex, fileExtension);
-    message_show(SAVE_CSV_WINDOW_WIDTH, FONTID_6X8M, "Save Temperature Map", message, GREEN, 0, 1000);
-    printf("%s\r\n", message);
-    ret = 0;
+    if (pIndex != NULL)
+        *pIndex = maxFileIndex;
+    return SAVE_OK;
+}
 
-error:
-    if (f != NULL) {
-        fflush(f);
-        fclose(f);
+/**
+ * @brief 创建一个边写边追加的新文件（录像），写完后调用 save_CloseFile 记入清单
+ *
+ * @param pExtension 扩展名（SAVE_xxx_EXT）
+ * @param minFree 至少需要的剩余空间
+ * @param pIndex 输出文件序号
+ * @param pErr 输出 SAVE_OK / SAVE_ERR_xxx
+ * @return FILE* 失败时返回 NULL
+ */
+FILE* save_CreateFile(const char* pExtension, size_t minFree, int32_t* pIndex, int* pErr)
+{
+    int type = save_typeOf(pExtension);
+    if (type < 0) {
+        *pErr = SAVE_ERR_ACCESS;
+        return NULL;
     }
 
-    if (NULL != pValues) {
-        free(pValues);
-        pValues = NULL;
+    int spaceCheck = checkSpiffsSpace(minFree);
+    if (spaceCheck != 0) {
+        *pErr = (spaceCheck == -1) ? SAVE_ERR_FULL : SAVE_ERR_ACCESS;
+        return NULL;
     }
 
+    char fileName[64];
+    *pErr = save_newFile(type, fileName, sizeof(fileName), pIndex);
+    if (*pErr != SAVE_OK)
+        return NULL;
+
+    FILE* f = fopen(fileName, "wb");
+    if (f == NULL)
+        *pErr = SAVE_ERR_WRITE;
+    return f;
+}
+
+/**
+ * @brief 关闭 save_CreateFile 创建的文件并记入清单（写入中途出错时已写入的部分仍然保留）
+ *
+ * @param pExtension
+ * @param f
+ * @param index
+ * @return int SAVE_OK / SAVE_ERR_WRITE
+ */
+int save_CloseFile(const char* pExtension, FILE* f, int32_t index)
+{
+    long size = ftell(f);
+    int ret = (fclose(f) == 0) ? SAVE_OK : SAVE_ERR_WRITE;
+
+    int type = save_typeOf(pExtension);
+    if ((type >= 0) && (size > 0))
+        save_addFile(type, index, size);
     return ret;
 }
 
+/**
+ * @brief 向 save_CreateFile 创建并已关闭的文件追加一块数据（定时拍摄分批写入）
+ *
+ * @param pExtension
+ * @param index 文件序号
+ * @param pData
+ * @param size
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+int save_AppendFile(const char* pExtension, int32_t index, const void* pData, size_t size)
+{
+    int type = save_typeOf(pExtension);
+    if (type < 0)
+        return SAVE_ERR_ACCESS;
+
+    int spaceCheck = checkSpiffsSpace(size);
+    if (spaceCheck != 0)
+        return (spaceCheck == -1) ? SAVE_ERR_FULL : SAVE_ERR_ACCESS;
+
+    char fileName[64];
+    xSemaphoreTake(ManifestLock, portMAX_DELAY);
+    manifest_FilePath(type, index, fileName, sizeof(fileName));
+    xSemaphoreGive(ManifestLock);
+    FILE* f = fopen(fileName, "ab");
+    if (f == NULL)
+        return SAVE_ERR_ACCESS;
+
+    // 整块交给文件系统，不经过 stdio 缓冲再拆开
+    setvbuf(f, NULL, _IONBF, 0);
+    bool ok = fwrite(pData, 1, size, f) == size;
+    long fileSize = ftell(f);
+    if (fclose(f) != 0)
+        ok = false;
+
+    if (fileSize > 0)
+        save_addFile(type, index, fileSize);
+    return ok ? SAVE_OK : SAVE_ERR_WRITE;
+}
+
+/**
+ * @brief 将当前热图保存到内置 SPIFFS（辐射快照格式，由存储任务写入）
+ *
+ * @return int
+ */
+int save_ImageSnapshot(void)
+{
+    sSaveResult result;
+    char message[32];
+
+    int ret = savetask_Submit(SAVE_JOB_SNAPSHOT, 0, true, &result);
+    if (ret != SAVE_OK) {
+        message_show(SAVE_CSV_WINDOW_WIDTH, FONTID_6X8M, "Save Error", save_ErrorStr(ret), RED, 1, 1000);
+        printf("%s\r\n", save_ErrorStr(ret));
+        return 1;
+    }
+
+    GetStringF(message, "File %05d%s Saved Successfully", result.fileIndex, SAVE_SNAPSHOT_EXT);
+    message_show(SAVE_CSV_WINDOW_WIDTH, FONTID_6X8M, "Save Temperature Map", message, GREEN, 0, 1000);
+    printf("%s (%d bytes)\r\n", message, (int)result.bytes);
+    return 0;
+}
+
 /**
  * @brief 保存MLX90640 EEPROM信息
  *
@@ -407,18 +703,19 @@ int save_MLX90640Params(void)
     int ret = 0;
     FILE* f = NULL;
     paramsMLX90640* pValues = NULL;
-    char fileExtension[] = ".PAR";
+    char fileExtension[] = SAVE_PARAMS_EXT;
+    char fileName[64];
+    size_t fileSize = 0;
 
-    // 获取最大文件名
-    int32_t maxFileIndex = GetLastIndex(fileExtension);
-    if (maxFileIndex < 0) {
+    // 获取新文件序号
+    int32_t maxFileIndex;
+    if (save_newFile(SAVE_TYPE_PARAMS, fileName, sizeof(fileName), &maxFileIndex) != SAVE_OK) {
         // 无法打开 SPIFFS
         message_show(SAVE_CSV_WINDOW_WIDTH, FONTID_6X8M, "Save Error", "SPIFFS Access Error", RED, 1, 1000);
         printf("SPIFFS Access Error\r\n");
         ret = 1;
         goto error;
     }
-    maxFileIndex++;
 
     // 分配内存中的临时缓冲区以存储值
     // 优先使用 PSRAM，如果没有则使用内部内存
@@ -442,10 +739,6 @@ int save_MLX90640Params(void)
     progress_start_show(SAVE_CSV_WINDOW_WIDTH, FONTID_6X8M, "Save Temperature Map", message, GREEN, 0, 0);
     printf("%s\r\n", message);
 
-    // 文件名（内置 SPIFFS 存储）
-    char fileName[128];
-    GetStringF(fileName, "%s/%05d%s", SAVE_MOUNT_POINT, maxFileIndex, fileExtension);
-
     // 打开文件
     f = fopen(fileName, "w");
     if (f == NULL) {
@@ -482,6 +775,7 @@ int save_MLX90640Params(void)
     WriteCsvRow_float(f, 3, pValues->ilChessC);
     WriteCsvRow_uint16(f, 5, pValues->brokenPixels);
     WriteCsvRow_uint16(f, 5, pValues->outlierPixels);
+    fileSize = ftell(f);
 
     GetStringF(message, "File %05d%s Saved Successfully", maxFileIndex, fileExtension);
     message_show(SAVE_CSV_WINDOW_WIDTH, FONTID_6X8M, "Save Temperature Map", message, GREEN, 0, 1000);
@@ -492,6 +786,8 @@ error:
     if (f != NULL) {
         fflush(f);
         fclose(f);
+        if (ret == 0)
+            save_addFile(SAVE_TYPE_PARAMS, maxFileIndex, fileSize);
     }
 
     if (NULL != pValues) {
@@ -502,119 +798,231 @@ error:
 }
 
 /**
- * @brief 保存BMP（逐行写入，节省内存）
- *        先捕获屏幕数据再显示提示，避免把弹窗保存到截图中
+ * @brief 为刚保存的截图写缩略图（与截图同序号），失败只打印，不影响截图本身
+ *
+ * @param type 截图类型
+ * @param index 截图序号
+ * @param pScreen
+ * @param width
+ * @param height
+ */
+static void save_writeThumbnail(eSaveType type, int32_t index, const uint16_t* pScreen, uint16_t width, uint16_t height)
+{
+    eSaveType thumbType = save_thumbType(type);
+    char fileName[64];
+
+    sThumbnail* pThumb = malloc(sizeof(sThumbnail));
+    if (!pThumb)
+        return;
+
+    size_t size = thumbnail_Build(pScreen, width, height, pThumb);
+    manifest_FilePath(thumbType, index, fileName, sizeof(fileName));
+    FILE* f = (size != 0) ? fopen(fileName, "wb") : NULL;
+    if (f != NULL) {
+        size_t written = fwrite(pThumb, 1, size, f);
+        if ((fclose(f) == 0) && (written == size)) {
+            save_addFile(thumbType, index, size);
+        } else {
+            remove(fileName);
+            f = NULL;
+        }
+    }
+    if (f == NULL)
+        printf("Thumbnail %s not saved\r\n", fileName);
+    free(pThumb);
+}
+
+/**
+ * @brief 把一屏 RGB565 数据写成BMP文件（序号为最大序号 + 1），不显示提示
+ *  - 文件头和尽量多的整行转换到块缓冲（一块一次转换），整块写入，文件不使用 stdio 缓冲
  *
+ * @param pScreen 整屏数据（按行存放）
+ * @param width
+ * @param height
  * @param bits 保存BMP位数
- * @return int
+ * @param pIndex 输出文件序号，可以为 NULL
+ * @return int SAVE_OK / SAVE_ERR_xxx
  */
-int save_ImageBMP(uint8_t bits)
+int save_WriteBmp(const uint16_t* pScreen, uint16_t width, uint16_t height, uint8_t bits, int32_t* pIndex)
 {
-    uint16_t screenWidth = dispcolor_getWidth();
-    uint16_t screenHeight = dispcolor_getHeight();
-    char fileExtension[] = ".BMP";
+    // 块缓冲只有存储任务使用，分配一次后保留
+    static uint8_t* pBlock = NULL;
+
+    bool is16 = (bits == 15) || (bits == 16);
+    size_t rowBytes = width * (is16 ? 2 : 4);
+    if ((rowBytes == 0) || (BMP_HEADER_MAX + rowBytes > SAVE_BMP_BLOCK_SIZE))
+        return SAVE_ERR_MEMORY;
 
-    // 计算预估文件大小并检查空间（静默检查，不显示弹窗）
-    size_t estimatedSize = (bits == 24) ? BMP_24BIT_SIZE : BMP_16BIT_SIZE;
+    // 计算预估文件大小并检查空间
+    size_t estimatedSize = is16 ? BMP_16BIT_SIZE : BMP_24BIT_SIZE;
     int spaceCheck = checkSpiffsSpace(estimatedSize);
     if (spaceCheck == -1) {
         printf("SPIFFS space insufficient for BMP file\n");
-        // 延迟显示错误，先让用户知道
-        message_show(SAVE_BMP_WINDOW_WIDTH, FONTID_6X8M, "Save Error", "SPIFFS Full!", RED, 1, 1500);
-        return -1;
+        return SAVE_ERR_FULL;
     } else if (spaceCheck == -2) {
-        message_show(SAVE_BMP_WINDOW_WIDTH, FONTID_6X8M, "Save Error", "SPIFFS Error", RED, 1, 1000);
-        return -1;
+        return SAVE_ERR_ACCESS;
     }
 
-    // 获取最大文件序号（静默操作）
-    int32_t maxFileIndex = GetLastIndex(fileExtension);
-    if (maxFileIndex < 0) {
-        message_show(SAVE_BMP_WINDOW_WIDTH, FONTID_6X8M, "Save Error", "SPIFFS Access Error", RED, 1, 1000);
-        return -1;
+    if (pBlock == NULL) {
+        pBlock = heap_caps_malloc(SAVE_BMP_BLOCK_SIZE, MALLOC_CAP_SPIRAM);
+        if (pBlock == NULL)
+            pBlock = malloc(SAVE_BMP_BLOCK_SIZE);
+        if (pBlock == NULL)
+            return SAVE_ERR_MEMORY;
     }
-    maxFileIndex++;
 
-    // 分配行缓冲区
-    uint16_t* pRowBuffer = malloc(screenWidth * sizeof(uint16_t));
-    if (!pRowBuffer) {
-        message_show(SAVE_BMP_WINDOW_WIDTH, FONTID_6X8M, "Save Error", "Out of Memory !", RED, 1, 1000);
-        return -1;
+    // 获取新文件序号
+    int32_t maxFileIndex;
+    char fileName[64];
+    int ret = save_newFile(SAVE_TYPE_BMP, fileName, sizeof(fileName), &maxFileIndex);
+    if (ret != SAVE_OK)
+        return ret;
+
+    FILE* f = fopen(fileName, "wb");
+    if (f == NULL)
+        return SAVE_ERR_WRITE;
+    // 每次写入都是整块，不经过 stdio 缓冲再拆开
+    setvbuf(f, NULL, _IONBF, 0);
+
+    // 第一块以文件头开始，之后各块都是整行；从下到上转换各行
+    size_t used = is16 ? WriteBmpFileHeaderCore16Bit(pBlock, width, height) : WriteBmpFileHeaderCore24Bit(pBlock, width, height);
+    size_t fileSize = 0;
+    int row = height - 1;
+    ret = SAVE_OK;
+    while ((row >= 0) && (ret == SAVE_OK)) {
+        int rows = (SAVE_BMP_BLOCK_SIZE - used) / rowBytes;
+        if (rows > row + 1)
+            rows = row + 1;
+        if (is16)
+            used += ConvertBmpRows_15bit(pBlock + used, &pScreen[row * width], width, rows);
+        else
+            used += ConvertBmpRows_24bit(pBlock + used, &pScreen[row * width], width, rows);
+        row -= rows;
+
+        if (fwrite(pBlock, 1, used, f) != used)
+            ret = SAVE_ERR_WRITE;
+        fileSize += used;
+        used = 0;
     }
 
-    // 分配临时缓冲区保存整个屏幕数据（320x240x2 = 153600字节）
-    // 由于内存有限，我们采用另一种方法：先打开文件并立即捕获屏幕
-    
-    // 拼接路径和文件名
+    if (fclose(f) != 0)
+        ret = SAVE_ERR_WRITE;
+
+    if (ret != SAVE_OK) {
+        remove(fileName);
+        return ret;
+    }
+    save_addFile(SAVE_TYPE_BMP, maxFileIndex, fileSize);
+    save_writeThumbnail(SAVE_TYPE_BMP, maxFileIndex, pScreen, width, height);
+
+    if (pIndex != NULL)
+        *pIndex = maxFileIndex;
+    return SAVE_OK;
+}
+
+/**
+ * @brief 把一屏 RGB565 数据写成 QOI 截图（序号为最大序号 + 1），不显示提示
+ *  - 逐行编码到块缓冲，攒够 SAVE_QOI_BLOCK_SIZE 整块写入，界面截图一般压缩到 BMP 的 1/15 以下
+ *
+ * @param pScreen 整屏数据（按行存放）
+ * @param width
+ * @param height
+ * @param pIndex 输出文件序号，可以为 NULL
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+int save_WriteQoi(const uint16_t* pScreen, uint16_t width, uint16_t height, int32_t* pIndex)
+{
+    int spaceCheck = checkSpiffsSpace(QOI_MIN_SIZE);
+    if (spaceCheck == -1)
+        return SAVE_ERR_FULL;
+    if (spaceCheck == -2)
+        return SAVE_ERR_ACCESS;
+
+    int32_t maxFileIndex;
     char fileName[64];
-    char message[32];
-    GetStringF(fileName, "%s/%05d%s", SAVE_MOUNT_POINT, maxFileIndex, fileExtension);
+    int ret = save_newFile(SAVE_TYPE_QOI, fileName, sizeof(fileName), &maxFileIndex);
+    if (ret != SAVE_OK)
+        return ret;
+
+    // 块缓冲区多留一行的最大编码长度，写出整块后把剩余部分移到开头
+    size_t blockSize = SAVE_QOI_BLOCK_SIZE + QOI_MAX_ENCODED(width) + QOI_END_SIZE + 1;
+    uint8_t* pBlock = malloc(blockSize);
+    sQoiEncoder* pEncoder = malloc(sizeof(sQoiEncoder));
+    if (!pBlock || !pEncoder) {
+        free(pBlock);
+        free(pEncoder);
+        return SAVE_ERR_MEMORY;
+    }
 
-    // 打开文件（在显示任何弹窗之前）
     FILE* f = fopen(fileName, "wb");
     if (f == NULL) {
-        free(pRowBuffer);
-        message_show(SAVE_BMP_WINDOW_WIDTH, FONTID_6X8M, "Save Error", "Error Writing File!", RED, 1, 1000);
-        return -1;
+        free(pBlock);
+        free(pEncoder);
+        return SAVE_ERR_WRITE;
     }
 
-    // ============ 关键：先写入BMP数据，再显示弹窗 ============
-    // 进度条参数：底部一条红线
-    const int16_t progressY = screenHeight - 2;  // 底部位置
-    const int16_t progressH = 2;                 // 进度条高度
-    const uint16_t progressColor = RGB565(0, 255, 128);    // 红色
-    
-    // 写入BMP头
-    if (bits == 15 || bits == 16) {
-        WriteBmpFileHeaderCore16Bit(f, 16, screenWidth, screenHeight);
-
-        // 立即逐行读取屏幕数据并写入（此时屏幕上还是热成像画面）
-        for (int row = screenHeight - 1; row >= 0; row--) {
-            dispcolor_getRowData(row, pRowBuffer);
-            WriteBmpRow_15bit(f, screenWidth, pRowBuffer);
-            
-            // 更新进度条（每10行更新一次，减少刷新次数）
-            if ((screenHeight - 1 - row) % 10 == 0) {
-                int progress = ((screenHeight - 1 - row) * screenWidth) / screenHeight;
-                dispcolor_FillRect(0, progressY, progress, progressH, progressColor);
-                dispcolor_Update();
+    qoi_EncoderInit(pEncoder);
+    size_t used = qoi_EncodeHeader(pBlock, width, height);
+    size_t fileSize = 0;
+    ret = SAVE_OK;
+    for (int row = 0; (row < height) && (ret == SAVE_OK); row++) {
+        used += qoi_EncodeRgb565(pEncoder, &pScreen[row * width], width, pBlock + used);
+        if (row == height - 1)
+            used += qoi_EncodeEnd(pEncoder, pBlock + used);
+
+        while ((used >= SAVE_QOI_BLOCK_SIZE) || ((row == height - 1) && used)) {
+            size_t size = (used >= SAVE_QOI_BLOCK_SIZE) ? SAVE_QOI_BLOCK_SIZE : used;
+            if (fwrite(pBlock, 1, size, f) != size) {
+                ret = SAVE_ERR_WRITE;
+                break;
             }
+            fileSize += size;
+            used -= size;
+            memmove(pBlock, pBlock + size, used);
         }
+    }
 
-    } else if (bits == 24) {
-        WriteBmpFileHeaderCore24Bit(f, 24, screenWidth, screenHeight);
-
-        // 立即逐行读取屏幕数据并写入（此时屏幕上还是热成像画面）
-        for (int row = screenHeight - 1; row >= 0; row--) {
-            dispcolor_getRowData(row, pRowBuffer);
-            WriteBmpRow_24bit(f, screenWidth, pRowBuffer);
-            
-            // 更新进度条（每10行更新一次）
-            if ((screenHeight - 1 - row) % 10 == 0) {
-                int progress = ((screenHeight - 1 - row) * screenWidth) / screenHeight;
-                dispcolor_FillRect(0, progressY, progress, progressH, progressColor);
-                dispcolor_Update();
-            }
-        }
+    if (fclose(f) != 0)
+        ret = SAVE_ERR_WRITE;
+    free(pBlock);
+    free(pEncoder);
+
+    if (ret != SAVE_OK) {
+        remove(fileName);
+        return ret;
     }
-    
-    // 进度条填满
-    dispcolor_FillRect(0, progressY, screenWidth, progressH, progressColor);
-    dispcolor_Update();
+    save_addFile(SAVE_TYPE_QOI, maxFileIndex, fileSize);
+    save_writeThumbnail(SAVE_TYPE_QOI, maxFileIndex, pScreen, width, height);
 
-    fflush(f);
-    fclose(f);
-    free(pRowBuffer);
+    if (pIndex != NULL)
+        *pIndex = maxFileIndex;
+    return SAVE_OK;
+}
 
-    // ============ 数据已保存完毕，现在才显示成功消息 ============
-    GetStringF(message, "File %05d%s Saved!", maxFileIndex, fileExtension);
-    message_show(SAVE_BMP_WINDOW_WIDTH, FONTID_6X8M, "Screenshot Saved", message, GREEN, 0, 1000);
+/**
+ * @brief 保存BMP：当前屏幕复制到存储任务的缓冲池后再显示提示，避免把弹窗保存到截图中
+ *
+ * @param bits 保存BMP位数
+ * @return int
+ */
+int save_ImageBMP(uint8_t bits)
+{
+    sSaveResult result;
+    char message[32];
 
+    int ret = savetask_Submit(SAVE_JOB_BMP, bits, true, &result);
+    if (ret != SAVE_OK) {
+        message_show(SAVE_BMP_WINDOW_WIDTH, FONTID_6X8M, "Save Error", save_ErrorStr(ret), RED, 1, 1000);
+        return -1;
+    }
+
+    GetStringF(message, "File %05d%s Saved!", result.fileIndex, SAVE_BMP_EXT);
+    message_show(SAVE_BMP_WINDOW_WIDTH, FONTID_6X8M, "Screenshot Saved", message, GREEN, 0, 1000);
     return 0;
 }
 
 /**
- * @brief 获取SPIFFS中BMP文件列表
+ * @brief 获取SPIFFS中截图文件列表（从清单中取最新的 maxFiles 个：先是 BMP，后是 QOI，各自按序号排序）
  *
  * @param fileList 输出文件名数组（每个最大32字符）
  * @param maxFiles 最大文件数量
@@ -622,40 +1030,35 @@ int save_ImageBMP(uint8_t bits)
  */
 int save_listBmpFiles(char fileList[][32], int maxFiles)
 {
-    DIR* dr = opendir(SAVE_MOUNT_POINT);
-    if (dr == NULL) {
+    static const eSaveType types[] = { SAVE_TYPE_BMP, SAVE_TYPE_QOI };
+
+    if ((ManifestLock == NULL) || !ManifestReady)
         return -1;
-    }
+
+    xSemaphoreTake(ManifestLock, portMAX_DELAY);
+    int skip = manifest_Count(SAVE_TYPE_BMP) + manifest_Count(SAVE_TYPE_QOI) - maxFiles;
 
     int count = 0;
-    struct dirent* de;
-    while ((de = readdir(dr)) != NULL && count < maxFiles) {
-        if (de->d_type == DT_REG && strstr(de->d_name, ".BMP")) {
-            strncpy(fileList[count], de->d_name, 31);
-            fileList[count][31] = '\0';
-            count++;
+    for (int t = 0; t < 2; t++) {
+        int first = 0;
+        if (skip > 0) {
+            first = (skip < manifest_Count(types[t])) ? skip : manifest_Count(types[t]);
+            skip -= first;
         }
-    }
 
-    closedir(dr);
-    
-    // 简单排序（按文件名）
-    for (int i = 0; i < count - 1; i++) {
-        for (int j = i + 1; j < count; j++) {
-            if (strcmp(fileList[i], fileList[j]) > 0) {
-                char temp[32];
-                strcpy(temp, fileList[i]);
-                strcpy(fileList[i], fileList[j]);
-                strcpy(fileList[j], temp);
-            }
+        sManifestEntry entry;
+        while ((count < maxFiles) && manifest_List(types[t], first++, &entry, 1)) {
+            snprintf(fileList[count], 32, "%05lu%s", (unsigned long)entry.Id, SaveExtensions[types[t]]);
+            count++;
         }
     }
-    
+    xSemaphoreGive(ManifestLock);
+
     return count;
 }
 
 /**
- * @brief 删除指定的BMP文件
+ * @brief 删除指定的截图文件（BMP 或 QOI）和它的缩略图
  *
  * @param fileName 文件名（不含路径）
  * @return int 0成功，-1失败
@@ -664,8 +1067,21 @@ int save_deleteBmpFile(const char* fileName)
 {
     char fullPath[64];
     snprintf(fullPath, sizeof(fullPath), "%s/%s", SAVE_MOUNT_POINT, fileName);
-    
-    if (remove(fullPath) == 0) {
+
+    eSaveType type = save_screenshotType(fileName);
+    int32_t index = atoi(fileName);
+    int ret;
+    // 文件已经不在时也从清单中去掉
+    if ((ManifestLock != NULL) && ManifestReady) {
+        xSemaphoreTake(ManifestLock, portMAX_DELAY);
+        ret = manifest_Remove(type, index);
+        manifest_Remove(save_thumbType(type), index);
+        xSemaphoreGive(ManifestLock);
+    } else {
+        ret = remove(fullPath);
+    }
+
+    if (ret == 0) {
         printf("Deleted: %s\n", fullPath);
         return 0;
     } else {
@@ -675,27 +1091,104 @@ int save_deleteBmpFile(const char* fileName)
 }
 
 /**
- * @brief 删除所有BMP文件
+ * @brief 删除所有截图文件（清单中的全部 BMP 和 QOI 及其缩略图，不只是列表显示的部分）
  *
  * @return int 删除的文件数量，-1表示失败
  */
 int save_deleteAllBmpFiles(void)
 {
-    char fileList[20][32];
-    int count = save_listBmpFiles(fileList, 20);
-    if (count < 0) return -1;
-    
-    int deleted = 0;
-    for (int i = 0; i < count; i++) {
-        if (save_deleteBmpFile(fileList[i]) == 0) {
-            deleted++;
+    if ((ManifestLock == NULL) || !ManifestReady)
+        return -1;
+
+    xSemaphoreTake(ManifestLock, portMAX_DELAY);
+    int deleted = manifest_RemoveAll(SAVE_TYPE_BMP);
+    deleted += manifest_RemoveAll(SAVE_TYPE_QOI);
+    manifest_RemoveAll(SAVE_TYPE_BMP_THUMB);
+    manifest_RemoveAll(SAVE_TYPE_QOI_THUMB);
+    xSemaphoreGive(ManifestLock);
+
+    printf("Deleted %d screenshots\n", deleted);
+    return deleted;
+}
+
+/**
+ * @brief 读取截图的缩略图（整个文件一次读入）
+ *  - 缩略图功能之前保存的截图没有缩略图，返回 false
+ *
+ * @param fileName 截图文件名（不含路径）
+ * @param pThumb
+ * @return true 成功
+ */
+bool save_loadThumbnail(const char* fileName, sThumbnail* pThumb)
+{
+    char fullPath[64];
+
+    manifest_FilePath(save_thumbType(save_screenshotType(fileName)), atoi(fileName), fullPath, sizeof(fullPath));
+    FILE* f = fopen(fullPath, "rb");
+    if (f == NULL)
+        return false;
+
+    size_t size = fread(pThumb, 1, sizeof(sThumbnail), f);
+    fclose(f);
+    return thumbnail_Check(pThumb, size);
+}
+
+static size_t save_readFile(void* pCtx, uint8_t* pBuff, size_t size)
+{
+    return fread(pBuff, 1, size, (FILE*)pCtx);
+}
+
+/**
+ * @brief 显示QOI截图到屏幕（逐行解码）
+ *
+ * @param fullPath
+ * @return int 0成功，-1失败
+ */
+static int save_viewQoiFile(const char* fullPath)
+{
+    FILE* f = fopen(fullPath, "rb");
+    if (f == NULL) {
+        printf("Cannot open file: %s\n", fullPath);
+        return -1;
+    }
+
+    uint32_t width, height;
+    sQoiDecoder* pDecoder = malloc(sizeof(sQoiDecoder));
+    if (!pDecoder || !qoi_DecoderInit(pDecoder, save_readFile, f, &width, &height)
+        || (width == 0) || (width > 320) || (height == 0) || (height > 320)) {
+        printf("Not a supported QOI file: %s\n", fullPath);
+        free(pDecoder);
+        fclose(f);
+        return -1;
+    }
+
+    uint16_t* rowBuf = malloc(width * sizeof(uint16_t));
+    if (!rowBuf) {
+        free(pDecoder);
+        fclose(f);
+        return -1;
+    }
+
+    uint16_t screenWidth = dispcolor_getWidth();
+    uint16_t screenHeight = dispcolor_getHeight();
+    int count = (width < screenWidth) ? width : screenWidth;
+    for (uint32_t row = 0; (row < height) && (row < screenHeight); row++) {
+        if (qoi_DecodeRgb565(pDecoder, rowBuf, width) != width) {
+            printf("QOI data truncated at row %d\n", (int)row);
+            break;
         }
+        dispcolor_WriteSpan(0, row, rowBuf, count, false);
     }
-    return deleted;
+
+    free(rowBuf);
+    free(pDecoder);
+    fclose(f);
+    dispcolor_Update();
+    return 0;
 }
 
 /**
- * @brief 显示BMP文件到屏幕
+ * @brief 显示截图文件到屏幕（BMP 或 QOI）
  *
  * @param fileName 文件名（不含路径）
  * @return int 0成功，-1失败
@@ -704,6 +1197,9 @@ int save_viewBmpFile(const char* fileName)
 {
     char fullPath[64];
     snprintf(fullPath, sizeof(fullPath), "%s/%s", SAVE_MOUNT_POINT, fileName);
+
+    if (save_screenshotType(fileName) == SAVE_TYPE_QOI)
+        return save_viewQoiFile(fullPath);
     
     printf("Opening BMP: %s\n", fullPath);
     
@@ -816,9 +1312,7 @@ int save_viewBmpFile(const char* fileName)
                 break;
             }
             if (row < screenHeight) {
-                for (int x = 0; x < screenWidth && x < width; x++) {
-                    dispcolor_DrawPixel(x, row, rowBuf[x]);
-                }
+                dispcolor_WriteSpan(0, row, rowBuf, (width < screenWidth) ? width : screenWidth, false);
             }
         }
         free(rowBuf);
@@ -839,13 +1333,16 @@ int save_viewBmpFile(const char* fileName)
                 break;
             }
             if (row < screenHeight) {
-                for (int x = 0; x < screenWidth && x < width; x++) {
+                // 原地转换为 RGB565（写入位置始终落后于读取位置），再整行写入
+                uint16_t* colorBuf = (uint16_t*)rowBuf;
+                int count = (width < screenWidth) ? width : screenWidth;
+                for (int x = 0; x < count; x++) {
                     uint8_t b = rowBuf[x * 4];
                     uint8_t g = rowBuf[x * 4 + 1];
                     uint8_t r = rowBuf[x * 4 + 2];
-                    uint16_t color = RGB565(r, g, b);
-                    dispcolor_DrawPixel(x, row, color);
+                    colorBuf[x] = RGB565(r, g, b);
                 }
+                dispcolor_WriteSpan(0, row, colorBuf, count, false);
             }
         }
         free(rowBuf);
@@ -867,13 +1364,16 @@ int save_viewBmpFile(const char* fileName)
                 break;
             }
             if (row < screenHeight) {
-                for (int x = 0; x < screenWidth && x < width; x++) {
+                // 原地转换为 RGB565（写入位置始终落后于读取位置），再整行写入
+                uint16_t* colorBuf = (uint16_t*)rowBuf;
+                int count = (width < screenWidth) ? width : screenWidth;
+                for (int x = 0; x < count; x++) {
                     uint8_t b = rowBuf[x * 3];
                     uint8_t g = rowBuf[x * 3 + 1];
                     uint8_t r = rowBuf[x * 3 + 2];
-                    uint16_t color = RGB565(r, g, b);
-                    dispcolor_DrawPixel(x, row, color);
+                    colorBuf[x] = RGB565(r, g, b);
                 }
+                dispcolor_WriteSpan(0, row, colorBuf, count, false);
             }
         }
         free(rowBuf);
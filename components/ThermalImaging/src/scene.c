@@ -0,0 +1,812 @@
+#include "scene.h"
+#include "dispcolor.h"
+#include "font.h"
+#include "IDW.h"
+#include "CelsiusSymbol.h"
+#include "profiler.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_heap_caps.h"
+#define SCENE_MALLOC(size) heap_caps_malloc(size, MALLOC_CAP_8BIT)
+#else
+#define SCENE_MALLOC(size) malloc(size)
+#endif
+
+// 量程外的坐标限幅：留一倍量程的余量，热图边缘的高斯模糊和插值与在温度域里做的结果一致
+#define COORD_CLAMP_LOW (-(SCENE_COORD_MAX + 1))
+#define COORD_CLAMP_HIGH (2 * SCENE_COORD_MAX + 1)
+
+//==============================================================================
+// 计算阶段
+//==============================================================================
+
+/**
+ * @brief 分配计算结果缓冲区
+ *
+ * @param pFrame
+ * @param width 放大后的宽度
+ * @param height 放大后的高度
+ * @return true 成功
+ */
+bool scene_AllocFrame(sSceneFrame* pFrame, uint16_t width, uint16_t height)
+{
+    memset(pFrame, 0, sizeof(*pFrame));
+    pFrame->width = width;
+    pFrame->height = height;
+    pFrame->pHqImage = SCENE_MALLOC((width * height) * sizeof(int16_t));
+    pFrame->pLut565 = SCENE_MALLOC(SCENE_LUT_SIZE * sizeof(uint16_t));
+
+    return pFrame->pHqImage && pFrame->pLut565;
+}
+
+/**
+ * @brief 分配计算阶段的工作缓冲区
+ *
+ * @param pScratch
+ * @return true 成功
+ */
+bool scene_AllocScratch(sSceneScratch* pScratch)
+{
+    pScratch->pCoord16 = SCENE_MALLOC(THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT * sizeof(int16_t));
+    pScratch->pGaussBuff = SCENE_MALLOC(((THERMALIMAGE_RESOLUTION_WIDTH * 2) * (THERMALIMAGE_RESOLUTION_HEIGHT * 2)) * sizeof(float));
+    pScratch->pPalette = SCENE_MALLOC(SCENE_LUT_SIZE * sizeof(tRGBcolor));
+    autoscale_Reset(&pScratch->autoScale);
+
+    return pScratch->pCoord16 && pScratch->pGaussBuff && pScratch->pPalette;
+}
+
+static inline uint32_t SigMix(uint32_t sig, uint32_t value)
+{
+    return (sig ^ value) * 16777619u;
+}
+
+static inline uint32_t SigMixFloat(uint32_t sig, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return SigMix(sig, bits);
+}
+
+/**
+ * @brief 计算阶段的输入签名
+ *
+ * @param pUi
+ * @return uint32_t
+ */
+uint32_t scene_ComputeSignature(const sSceneUiState* pUi)
+{
+    uint32_t sig = 2166136261u;
+
+    sig = SigMix(sig, pUi->colorScale);
+    sig = SigMix(sig, pUi->autoScale);
+    sig = SigMix(sig, pUi->paletteCenterPercent);
+    sig = SigMix(sig, pUi->lowQuality);
+    if (!pUi->autoScale) {
+        sig = SigMixFloat(sig, pUi->manualMin);
+        sig = SigMixFloat(sig, pUi->manualMax);
+    }
+    return sig;
+}
+
+// 生成调色板坐标查找表：调色板中心百分比映射和高温->暖色的反向映射都折算进去，逐像素只剩一次查表
+// 坐标与量程无关，只有调色板或中心百分比改变时才需要重建
+static void BuildCoordLut(sSceneFrame* pOut, const tRGBcolor* pPalette, uint8_t paletteCenterPercent)
+{
+    const int paletteSize = SCENE_LUT_SIZE;
+    const int paletteMid = paletteSize / 2;
+    const int centerC = (paletteCenterPercent * SCENE_COORD_MAX) / 100;
+
+    pOut->lutMin = 0;
+    pOut->lutSize = SCENE_LUT_SIZE;
+
+    for (int i = 0; i < SCENE_LUT_SIZE; i++) {
+        int idx;
+        if (centerC <= 0 || centerC >= SCENE_COORD_MAX) {
+            // degenerate: fall back to linear mapping
+            idx = i;
+        } else if (i <= centerC) {
+            // Map [0 .. centerC] -> [0 .. paletteMid]
+            idx = (i * paletteMid) / centerC;
+        } else {
+            // Map (centerC .. SCENE_COORD_MAX] -> (paletteMid .. paletteSize-1]
+            idx = paletteMid + ((i - centerC) * (paletteSize - paletteMid)) / (SCENE_COORD_MAX - centerC);
+        }
+
+        // Clamp
+        if (idx < 0) idx = 0;
+        if (idx >= paletteSize) idx = paletteSize - 1;
+
+        const tRGBcolor* c = &pPalette[paletteSize - 1 - idx];
+        pOut->pLut565[i] = RGB565(c->r, c->g, c->b);
+    }
+}
+
+/**
+ * @brief 计算阶段：量程、调色板查找表、温度转换和放大
+ *
+ * @param pFrame 输入 pFrame->frame，输出其余字段
+ * @param pUi
+ * @param pScratch
+ */
+void scene_Compute(sSceneFrame* pFrame, const sSceneUiState* pUi, sSceneScratch* pScratch)
+{
+    const sMlxData* frame = &pFrame->frame;
+    const uint16_t img_width = pFrame->width;
+    const uint16_t img_height = pFrame->height;
+    int16_t* Coord16 = pScratch->pCoord16;
+
+    // 使用自动刻度模式（平滑、量化后的量程）或手动模式
+    float minTemp, maxTemp;
+    if (pUi->autoScale) {
+        autoscale_Update(&pScratch->autoScale, frame);
+        minTemp = pScratch->autoScale.minT;
+        maxTemp = pScratch->autoScale.maxT;
+    } else {
+        // 切回自动量程时从当前帧重新开始跟踪
+        autoscale_Reset(&pScratch->autoScale);
+        minTemp = pUi->manualMin;
+        maxTemp = pUi->manualMax;
+    }
+    pFrame->minTemp = minTemp;
+    pFrame->maxTemp = maxTemp;
+
+    float tempRange = maxTemp - minTemp;
+    if (tempRange < 0.001f) {
+        tempRange = 1.0f; // 避免除零与极小范围
+    }
+
+    // 生成伪彩色调色板 - 参考render_task.c的RedrawPalette
+    // 调色板没有改变时沿用这个缓冲区上一次生成的查找表（量程改变不影响查找表）
+    uint32_t lutSig = 2166136261u;
+    lutSig = SigMix(lutSig, pUi->colorScale);
+    lutSig = SigMix(lutSig, pUi->paletteCenterPercent);
+    if (lutSig != pFrame->lutSig) {
+        PROFILE_BEGIN(palette);
+        getPalette(pUi->colorScale, SCENE_LUT_SIZE, pScratch->pPalette);
+        BuildCoordLut(pFrame, pScratch->pPalette, pUi->paletteCenterPercent);
+        PROFILE_END(palette);
+        pFrame->lutSig = lutSig;
+    }
+
+    // 在传感器分辨率上把温度映射为调色板坐标，放大后的每个像素只需查表
+    PROFILE_BEGIN(convert);
+    const int pixelCount = THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT;
+    const float coordScale = SCENE_COORD_MAX / tempRange;
+    for (int i = 0; i < pixelCount; i++) {
+        float coord = (frame->ThermoImage[i] - minTemp) * coordScale;
+        if (coord < COORD_CLAMP_LOW) coord = COORD_CLAMP_LOW;
+        if (coord > COORD_CLAMP_HIGH) coord = COORD_CLAMP_HIGH;
+        Coord16[i] = (int16_t)coord;
+    }
+    PROFILE_END(convert);
+
+    // 渲染路径选择：lowQuality -> 使用 nearest-neighbor 快速缩放；否则使用高质量 Gauss + Bilinear
+    PROFILE_BEGIN(scale);
+    if (pUi->lowQuality) {
+        // 最近邻缩放：把原始 Coord16 映射到 pHqImage
+        for (int row = 0; row < img_height; row++) {
+            int src_row = (row * THERMALIMAGE_RESOLUTION_HEIGHT) / img_height;
+            if (src_row >= THERMALIMAGE_RESOLUTION_HEIGHT) src_row = THERMALIMAGE_RESOLUTION_HEIGHT - 1;
+            for (int col = 0; col < img_width; col++) {
+                int src_col = (col * THERMALIMAGE_RESOLUTION_WIDTH) / img_width;
+                if (src_col >= THERMALIMAGE_RESOLUTION_WIDTH) src_col = THERMALIMAGE_RESOLUTION_WIDTH - 1;
+                pFrame->pHqImage[row * img_width + col] = Coord16[src_row * THERMALIMAGE_RESOLUTION_WIDTH + src_col];
+            }
+        }
+    } else {
+        // 步骤1: 高斯模糊2倍放大
+        PROFILE_BEGIN(gauss);
+        idwGauss(Coord16, THERMALIMAGE_RESOLUTION_WIDTH, THERMALIMAGE_RESOLUTION_HEIGHT, 2, pScratch->pGaussBuff);
+        PROFILE_END(gauss);
+
+        // 步骤2: 双线性插值到指定区域
+        idwBilinear(pScratch->pGaussBuff, THERMALIMAGE_RESOLUTION_WIDTH * 2, THERMALIMAGE_RESOLUTION_HEIGHT * 2,
+                   pFrame->pHqImage, img_width, img_height, 10 / 2);
+    }
+    PROFILE_END(scale);
+
+    pFrame->version++;
+}
+
+//==============================================================================
+// 合成阶段：各图层的绘制
+//==============================================================================
+
+// 绘制中心温度显示 - 参考render_task.c
+static void DrawCenterTempColor(uint16_t cX, uint16_t cY, float TempCelsius, uint16_t color, bool useFahrenheit)
+{
+    char str[32];
+    float displayTemp = TempCelsius;
+    const char* unitSymbol = CELSIUS_SYMBOL;
+
+    // 如果使用华氏度，进行转换
+    if (useFahrenheit) {
+        displayTemp = TempCelsius * 9.0f / 5.0f + 32.0f;
+        unitSymbol = FAHRENHEIT_SYMBOL;
+    }
+
+    sprintf(str, "%.1f%s", displayTemp, unitSymbol);
+
+    int16_t strWidth = strlen(str) * 6;  // FONTID_6X8M字体宽度
+    int16_t strHeight = 8;
+
+    dispcolor_printf(cX - (strWidth >> 1), cY - (strHeight >> 1), FONTID_6X8M, color, "%s", str);
+}
+
+static void DrawCenterTemp(uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height, float CenterTemp, bool useFahrenheit)
+{
+    uint16_t cX = (Width >> 1) + X;
+    uint16_t cY = (Height >> 1) + Y;
+
+    // 渲染阴影黑色
+    DrawCenterTempColor(cX + 1, cY + 1, CenterTemp, BLACK, useFahrenheit);
+    // 渲染白色
+    DrawCenterTempColor(cX, cY, CenterTemp, WHITE, useFahrenheit);
+}
+
+// 绘制最大最小温度标记 - 参考render_task.c的DrawMarkersHQ
+static void DrawMarkersHQ(const sMlxData* pMlxData, uint16_t img_x, uint16_t img_y, uint16_t img_w, uint16_t img_h)
+{
+    uint8_t lineHalf = 4;
+
+    // 计算缩放比例
+    float scaleX = (float)img_w / THERMALIMAGE_RESOLUTION_WIDTH;
+    float scaleY = (float)img_h / THERMALIMAGE_RESOLUTION_HEIGHT;
+
+    // 绘制最大温度标记 (红色十字)
+    int16_t x = (THERMALIMAGE_RESOLUTION_WIDTH - pMlxData->maxT_X - 1) * scaleX + img_x;
+    int16_t y = pMlxData->maxT_Y * scaleY + img_y;
+
+    uint16_t mainColor = RED;
+    dispcolor_DrawLine(x + 1, y - lineHalf + 1, x + 1, y + lineHalf + 1, BLACK);
+    dispcolor_DrawLine(x - lineHalf + 1, y + 1, x + lineHalf + 1, y + 1, BLACK);
+    dispcolor_DrawLine(x - lineHalf + 1, y - lineHalf + 1, x + lineHalf + 1, y + lineHalf + 1, BLACK);
+    dispcolor_DrawLine(x - lineHalf + 1, y + lineHalf + 1, x + lineHalf + 1, y - lineHalf + 1, BLACK);
+
+    dispcolor_DrawLine(x, y - lineHalf, x, y + lineHalf, mainColor);
+    dispcolor_DrawLine(x - lineHalf, y, x + lineHalf, y, mainColor);
+    dispcolor_DrawLine(x - lineHalf, y - lineHalf, x + lineHalf, y + lineHalf, mainColor);
+    dispcolor_DrawLine(x - lineHalf, y + lineHalf, x + lineHalf, y - lineHalf, mainColor);
+
+    // 绘制最小温度标记 (蓝色X)
+    x = (THERMALIMAGE_RESOLUTION_WIDTH - pMlxData->minT_X - 1) * scaleX + img_x;
+    y = pMlxData->minT_Y * scaleY + img_y;
+
+    mainColor = RGB565(0, 200, 245);
+    dispcolor_DrawLine(x - lineHalf + 1, y - lineHalf + 1, x + lineHalf + 1, y + lineHalf + 1, BLACK);
+    dispcolor_DrawLine(x - lineHalf + 1, y + lineHalf + 1, x + lineHalf + 1, y - lineHalf + 1, BLACK);
+    dispcolor_DrawLine(x - lineHalf, y - lineHalf, x + lineHalf, y + lineHalf, mainColor);
+    dispcolor_DrawLine(x - lineHalf, y + lineHalf, x + lineHalf, y - lineHalf, mainColor);
+}
+
+// 高质量图像绘制函数 - 参考render_task.c的DrawHQImage
+// 只绘制 firstRow 开始的 rowCount 行（图层合成时只重绘被损坏的行），查找表由 BuildCoordLut 预先生成
+// 超出量程的坐标取两端颜色，与逐像素限幅的结果相同
+static void DrawHQImage(const sSceneFrame* pFrame, uint16_t X, uint16_t Y, uint16_t width, uint16_t height,
+                       int firstRow, int rowCount)
+{
+    if (firstRow < 0) {
+        rowCount += firstRow;
+        firstRow = 0;
+    }
+    if (firstRow + rowCount > height)
+        rowCount = height - firstRow;
+    if (rowCount <= 0)
+        return;
+
+    // 水平镜像（第 col 列显示在 X + width - col - 1）
+    dispcolor_DrawImageLut(X, Y + firstRow, width, rowCount, pFrame->pHqImage + firstRow * width,
+                           pFrame->lutMin, pFrame->pLut565, pFrame->lutSize, true);
+}
+
+static void DrawLockIcon(int16_t x, int16_t y, uint16_t color)
+{
+    // Small padlock: shackle + body + keyhole
+    dispcolor_DrawLine(x - 2, y - 3, x + 2, y - 3, color);
+    dispcolor_DrawLine(x - 3, y - 2, x - 3, y - 1, color);
+    dispcolor_DrawLine(x + 3, y - 2, x + 3, y - 1, color);
+    dispcolor_DrawRectangle(x - 3, y - 1, x + 3, y + 3, color);
+    dispcolor_DrawLine(x, y, x, y + 2, color);
+}//man!
+
+static void DrawSectionFocus(focus_section_t focus,
+                             uint16_t top_bar_h,
+                             uint16_t bottom_bar_h,
+                             uint16_t img_y_start,
+                             uint16_t img_height,
+                             bool lockActive)
+{
+    const int16_t xPos = 4;
+    int16_t yPos[SECTION_COUNT];
+    yPos[SECTION_TITLE] = top_bar_h / 2;
+    yPos[SECTION_IMAGE] = img_y_start + (img_height / 2);
+    // Lock focus sits between the image bottom and data bar center
+    int16_t gap_top = img_y_start + img_height;
+    yPos[SECTION_LOCK] = gap_top ;
+    yPos[SECTION_DATA] = dispcolor_getHeight() - (bottom_bar_h / 2);
+
+    // for (int i = 0; i < SECTION_COUNT; i++) {
+    //     dispcolor_DrawCircleFilled(xPos, yPos[i], 4, BLACK);
+    // }
+
+    // dispcolor_DrawCircleFilled(xPos, yPos[focus], 2, RGB565(255, 255, 0));
+    if (focus != SECTION_LOCK){
+        dispcolor_printf(xPos, yPos[focus], FONTID_6X8M, WHITE, ">");
+    }
+
+    // Lock icon sits next to the lock focus marker; color hints state
+    uint16_t lockColor = GRAY;
+    if (lockActive) {
+        lockColor = WHITE;
+    } else if (focus == SECTION_LOCK) {
+        lockColor = WHITE;
+    }
+
+    // Draw background highlighting for lock icon area
+    if (lockActive) {
+        // Red background when locked
+        dispcolor_FillRect(0, yPos[SECTION_LOCK] - 7, 10, 7, RGB565(0, 255, 128));
+    } else if (focus == SECTION_LOCK) {
+        // Blue background when focused
+        // dispcolor_FillRect(0, yPos[SECTION_LOCK] - 7, 10, 7, RGB565(0, 0, 250));
+    }
+
+    DrawLockIcon(xPos , yPos[SECTION_LOCK] - 4, lockColor);
+
+}
+
+// 标题栏：左侧调色板、中间 fix_scale、右侧温度单位，焦点和子项用灰色背景高亮
+static void DrawTitleBar(const sSceneUiState* pUi, uint16_t top_bar_h)
+{
+    // 显示标题（根据字体高度垂直居中）
+    uint8_t* pTitleFont = font_GetFontStruct(FONTID_16F, 'A');
+    uint8_t titleFontH = font_GetCharHeight(pTitleFont);
+    int16_t title_y = (int16_t)((top_bar_h - titleFontH) / 2);
+    if (title_y < 0) title_y = 0;
+    // dispcolor_DrawString(10, title_y, FONTID_16F, (uint8_t*)"Thermal Camera", WHITE);
+    int16_t title_x = dispcolor_getStrWidth(FONTID_16F, "Palette 5");
+    title_x = (dispcolor_getWidth() - title_x) / 2;
+
+    // 标题高亮改为背景灰色高亮（字体默认白色）
+    // 在子项选择模式下，将被选中的子项文字改为黑色以便在灰色背景上更加明显
+    uint16_t leftTitleColor = WHITE;
+    uint16_t centerTitleColor = WHITE;
+    uint16_t rightTitleColor = WHITE;
+
+    // 右侧显示温度单位指示
+    const char* tempUnitText = pUi->useFahrenheit ? FAHRENHEIT_SYMBOL : CELSIUS_SYMBOL;
+    int16_t tempUnitWidth = dispcolor_getStrWidth(FONTID_16F, tempUnitText);
+
+    // 如果焦点在标题区，绘制灰色背景以示高亮；在子项选择模式时只高亮子项
+    if (pUi->focus == SECTION_TITLE) {
+        int16_t top_y = 0;
+        int16_t title_h = top_bar_h;
+        if (pUi->subItemMode) {
+            // 计算每个子项的矩形并填充灰色
+            if (pUi->titleSub == TITLE_SUB_LEFT) {
+                // left area: around x=10, compute text width
+                leftTitleColor = pUi->paletteSelectMode ? BLACK : WHITE;
+                char buf[32];
+                snprintf(buf, sizeof(buf), "Palette %d", pUi->colorScale);
+                int16_t w = dispcolor_getStrWidth(FONTID_16F, buf);
+                dispcolor_FillRect(10, top_y, w + 6, title_h, GRAY);
+            } else if (pUi->titleSub == TITLE_SUB_CENTER) {
+                // center area: center text location at title_x+10
+                // centerTitleColor = SelectMode ? BLACK : WHITE;
+                const char* centerText = "fix_scale";
+                int16_t w = dispcolor_getStrWidth(FONTID_16F, (char*)centerText);
+                int16_t cx = title_x + 10;
+                dispcolor_FillRect(cx - 2, top_y, w + 4, title_h, GRAY);
+            } else if (pUi->titleSub == TITLE_SUB_RIGHT) {
+                rightTitleColor = pUi->tempUnitSelectMode ? BLACK : WHITE;
+                // right area: temp unit text at (230-tempUnitWidth)
+                int16_t rx = 230 - tempUnitWidth - 2;
+                dispcolor_FillRect(rx, top_y, tempUnitWidth + 2, title_h, GRAY);
+            }
+        } else {
+            // 整个标题区域高亮为灰色
+            dispcolor_FillRect(10, 0, dispcolor_getWidth() - 20, top_bar_h, GRAY);
+        }
+    }
+
+    // 绘制标题文字（字体始终为白色）
+    dispcolor_DrawString(title_x + 10, title_y, FONTID_16F, (uint8_t*)"fix_scale", centerTitleColor);
+    // Show palette index same as simple menu (less verbose)
+    dispcolor_printf(10, title_y, FONTID_16F, leftTitleColor, "Palette %d", pUi->colorScale);
+    dispcolor_DrawString(230 - tempUnitWidth, title_y, FONTID_16F, (uint8_t*)tempUnitText, rightTitleColor);
+}
+
+// 界面底色层：整屏黑底（被其他图层覆盖的部分不会绘制）
+static void DrawChromeLayer(const sLayerRect* pClip, void* pArg)
+{
+    dispcolor_FillRect(pClip->x, pClip->y, pClip->w, pClip->h, BLACK);
+}
+
+// 标题栏图层
+static void DrawTitleLayer(const sLayerRect* pClip, void* pArg)
+{
+    const sSceneTarget* pTarget = (const sSceneTarget*)pArg;
+
+    dispcolor_FillRect(pClip->x, pClip->y, pClip->w, pClip->h, BLACK);
+    DrawTitleBar(pTarget->pUi, pTarget->layout.top_bar_h);
+}
+
+// 热图层：只转换并写入被损坏的行
+static void DrawThermalLayer(const sLayerRect* pClip, void* pArg)
+{
+    const sSceneTarget* pTarget = (const sSceneTarget*)pArg;
+    const sSceneLayout* pLayout = &pTarget->layout;
+
+    if (pTarget->pFrame == NULL)
+        return;
+
+    DrawHQImage(pTarget->pFrame, pLayout->img_x, pLayout->img_y, pLayout->img_w, pLayout->img_h,
+                pClip->y - pLayout->img_y, pClip->h);
+}
+
+// 热图上的中心温度和十字线
+static void DrawMarkersLayer(const sLayerRect* pClip, void* pArg)
+{
+    const sSceneTarget* pTarget = (const sSceneTarget*)pArg;
+    const sSceneLayout* pLayout = &pTarget->layout;
+    const sSceneUiState* pUi = pTarget->pUi;
+
+    if (pTarget->pFrame == NULL)
+        return;
+
+    // 热图上的最大/最小标记和中心温度 - 参考render_task.c
+    if (pUi->tempMarkers) {
+        // 在屏幕中央显示温度（使用当前选择的温度单位）
+        DrawCenterTemp(pLayout->img_x, pLayout->img_y, pLayout->img_w, pLayout->img_h, pTarget->pFrame->frame.CenterTemp, pUi->useFahrenheit);
+
+        // 标记最大最小点
+        // DrawMarkersHQ(&pTarget->pFrame->frame, pLayout->img_x, pLayout->img_y, pLayout->img_w, pLayout->img_h);
+    }
+
+    // 绘制十字线（如果启用）
+    if (pUi->showCrosshair) {
+        // 计算十字线位置：始终使用 crossX/crossY（即使退出 crosshairMode 也保持手动调节的位置）
+        int img_w = pLayout->img_w;
+        int img_h = pLayout->img_h;
+        // DrawHQImage uses (width - col - 1) + X horizontally inverted mapping
+        int display_x = pLayout->img_x + (img_w - 1) - (pUi->crossX * (img_w - 1) / (THERMALIMAGE_RESOLUTION_WIDTH - 1));
+        int display_y = pLayout->img_y + (pUi->crossY * (img_h - 1) / (THERMALIMAGE_RESOLUTION_HEIGHT - 1));
+
+        // 在十字线调整模式下，正在调整的轴用白色，另一轴用深灰色以便区分
+        uint16_t colorX = WHITE;  // 垂直线（调整 X 坐标）
+        uint16_t colorY = WHITE;  // 水平线（调整 Y 坐标）
+        if (pUi->crosshairMode) {
+            if (pUi->crosshairAxisIsY) {
+                // 正在调整 Y 轴，Y 轴（水平线）高亮，X 轴（垂直线）变暗
+                colorX = RGB565(60, 60, 60);
+                colorY = WHITE;
+            } else {
+                // 正在调整 X 轴，X 轴（垂直线）高亮，Y 轴（水平线）变暗
+                colorX = WHITE;
+                colorY = RGB565(60, 60, 60);
+            }
+        }
+
+        // 绘制水平十字线（贯穿整个图像宽度）- 对应 Y 轴
+        dispcolor_DrawLine(pLayout->img_x, display_y, pLayout->img_x + img_w - 1, display_y, colorY);
+
+        // 绘制垂直十字线（贯穿整个图像高度）- 对应 X 轴
+        dispcolor_DrawLine(display_x, pLayout->img_y, display_x, pLayout->img_y + img_h - 1, colorX);
+    }
+}
+
+// 底部数据栏（实时分析）：统计值、十字线温度折线图、通道和量程
+static void DrawPanelLayer(const sLayerRect* pClip, void* pArg)
+{
+    const sSceneTarget* pTarget = (const sSceneTarget*)pArg;
+    const sSceneUiState* pUi = pTarget->pUi;
+
+    dispcolor_FillRect(pClip->x, pClip->y, pClip->w, pClip->h, BLACK);
+
+    if (pTarget->pFrame == NULL)
+        return;
+
+    const sMlxData* frame = &pTarget->pFrame->frame;
+
+    // 显示温度范围信息和帧率
+    // 改为背景灰色高亮；在子项选择模式下将选中文本改为黑色以便更好识别
+    uint16_t leftColor = WHITE;
+    uint16_t centerColor = WHITE;
+    uint16_t rightColor = WHITE;
+
+    // 如果焦点在底部数据区域，绘制灰色背景框以示高亮；子项选择时只高亮对应子区域
+    if (pUi->focus == SECTION_DATA) {
+        int16_t bar_top = dispcolor_getHeight() - pTarget->layout.bottom_bar_h;
+        int16_t bar_h = pTarget->layout.bottom_bar_h;
+        if (pUi->subItemMode) {
+            if (pUi->dataSub == DATA_SUB_LEFT) {
+                // 左侧区域高亮（覆盖左侧统计文本区域）
+                dispcolor_FillRect(10, bar_top, 64, bar_h, GRAY);
+            } else if (pUi->dataSub == DATA_SUB_CENTER) {
+                // 中间绘图区（匹配绘图框 75..165）
+                dispcolor_FillRect(75, bar_top, 165 - 75 + 1, bar_h, GRAY);
+            } else if (pUi->dataSub == DATA_SUB_RIGHT) {
+                // 右侧区域高亮
+                rightColor = pUi->channelSelectMode ? BLACK : WHITE;
+
+                dispcolor_FillRect(170, bar_top, dispcolor_getWidth() - 170 - 10, bar_h, GRAY);
+            }
+        } else {
+            // 整个底部区域高亮
+            dispcolor_FillRect(10, bar_top, dispcolor_getWidth() - 20, bar_h, GRAY);
+        }
+    }
+
+    // 左侧显示：overall-std / overall-max / overall-min / overall-avg
+    {
+        // 如果使用华氏度，转换显示值（注意：标准差按比例放大，不加偏移）
+        const char* dataUnit = pUi->useFahrenheit ? FAHRENHEIT_SYMBOL : CELSIUS_SYMBOL;
+        float disp_ostd = frame->StdT;
+        float disp_omax = frame->maxT;
+        float disp_omin = frame->minT;
+        float disp_oavg = frame->AvgT;
+        if (pUi->useFahrenheit) {
+            disp_ostd = frame->StdT * 9.0f / 5.0f;
+            disp_omax = frame->maxT * 9.0f / 5.0f + 32.0f;
+            disp_omin = frame->minT * 9.0f / 5.0f + 32.0f;
+            disp_oavg = frame->AvgT * 9.0f / 5.0f + 32.0f;
+        }
+
+        dispcolor_printf(10, 190, FONTID_6X8M, leftColor, "std:%.2f%s", disp_ostd, dataUnit);
+        dispcolor_printf(10, 200, FONTID_6X8M, leftColor, "max:%.1f%s", disp_omax, dataUnit);
+        dispcolor_printf(10, 210, FONTID_6X8M, leftColor, "min:%.1f%s", disp_omin, dataUnit);
+        dispcolor_printf(10, 220, FONTID_6X8M, leftColor, "avg:%.2f%s", disp_oavg, dataUnit);
+    }
+
+    // 在中间边框内绘制十字线的温度折线图（可在X轴中心行或Y轴中心列之间切换）
+    dispcolor_DrawRectangle(75, 190, 165, 235, centerColor); // 边框
+    {
+        const int16_t box_x1 = 75, box_y1 = 190, box_x2 = 165, box_y2 = 235;
+        const int16_t plot_margin = 2;
+        const int16_t plot_x = box_x1 + plot_margin;
+        const int16_t plot_y = box_y1 + plot_margin;
+        const int16_t plot_w = (box_x2 - box_x1) - 2 * plot_margin;
+        const int16_t plot_h = (box_y2 - box_y1) - 2 * plot_margin;
+
+        // 使用当前显示范围作为 Y 轴范围
+        float plot_min = pTarget->pFrame->minTemp;
+        float plot_max = pTarget->pFrame->maxTemp;
+        float plot_range = plot_max - plot_min;
+        if (plot_range < 0.1f) plot_range = 1.0f;
+
+        int16_t prev_px = -1, prev_py = -1;
+
+        // 折线图通道严格由底部数据区域的通道选择决定（plotChannelY）
+        // 位置（哪一行/列）始终使用十字线位置 crossX/crossY（即使退出 crosshairMode 也保持手动调节的位置）
+        bool useYPlot = pUi->plotChannelY;
+        int target_row = pUi->crossY;
+        int target_col = pUi->crossX;
+
+        if (!useYPlot) {
+            // X 通道：使用某一行（水平）
+            for (int col = 0; col < THERMALIMAGE_RESOLUTION_WIDTH; col++) {
+                float t = frame->ThermoImage[target_row * THERMALIMAGE_RESOLUTION_WIDTH + col];
+                if (!isfinite(t)) continue;
+
+                int16_t px = plot_x + (col * plot_w) / (THERMALIMAGE_RESOLUTION_WIDTH - 1);
+                float norm = (t - plot_min) / plot_range;
+                if (norm < 0.0f) norm = 0.0f;
+                if (norm > 1.0f) norm = 1.0f;
+                int16_t py = plot_y + plot_h - 1 - (int16_t)(norm * (plot_h - 1));
+
+                if (prev_px >= 0) {
+                    dispcolor_DrawLine(prev_px, prev_py, px, py, RGB565(0, 255, 128));
+                }
+                prev_px = px;
+                prev_py = py;
+            }
+        } else {
+            // Y 通道：使用某一列（垂直），沿着行方向绘制到水平绘图区域
+            for (int row = 0; row < THERMALIMAGE_RESOLUTION_HEIGHT; row++) {
+                float t = frame->ThermoImage[row * THERMALIMAGE_RESOLUTION_WIDTH + target_col];
+                if (!isfinite(t)) continue;
+
+                int16_t px = plot_x + (row * plot_w) / (THERMALIMAGE_RESOLUTION_HEIGHT - 1);
+                float norm = (t - plot_min) / plot_range;
+                if (norm < 0.0f) norm = 0.0f;
+                if (norm > 1.0f) norm = 1.0f;
+                int16_t py = plot_y + plot_h - 1 - (int16_t)(norm * (plot_h - 1));
+
+                if (prev_px >= 0) {
+                    dispcolor_DrawLine(prev_px, prev_py, px, py, RGB565(0, 255, 128));
+                }
+                prev_px = px;
+                prev_py = py;
+            }
+        }
+
+        // 在右下角显示 FPS（小字）
+        char fpsStr[16];
+        sprintf(fpsStr, "%.0f", pUi->fps);
+        dispcolor_printf(box_x2 - 28, box_y2 - 10, FONTID_6X8M, centerColor, "%s", fpsStr);
+    }
+
+    // 右侧显示：通道选择（X/Y）以及上量程和下量程
+    dispcolor_printf(170, 190, FONTID_6X8M, rightColor, "Chan:%c", (pUi->plotChannelY ? 'Y' : 'X'));
+    dispcolor_printf(170, 210, FONTID_6X8M, rightColor, "Hi:%.1f", pTarget->pFrame->maxTemp);
+    dispcolor_printf(170, 230, FONTID_6X8M, rightColor, "Lo:%.1f", pTarget->pFrame->minTemp);
+}
+
+// 焦点标记和锁定图标（位于左侧边框，跨越标题栏、热图和数据栏）
+static void DrawFocusLayer(const sLayerRect* pClip, void* pArg)
+{
+    const sSceneTarget* pTarget = (const sSceneTarget*)pArg;
+    const sSceneLayout* pLayout = &pTarget->layout;
+
+    DrawSectionFocus(pTarget->pUi->focus, pLayout->top_bar_h, pLayout->bottom_bar_h, pLayout->img_y, pLayout->img_h,
+                     pTarget->pUi->lockActive);
+}
+
+// 临时提示消息
+static void DrawOverlayLayer(const sLayerRect* pClip, void* pArg)
+{
+    const sSceneTarget* pTarget = (const sSceneTarget*)pArg;
+    const char* pLine1 = pTarget->pUi->overlayLine1;
+    const char* pLine2 = pTarget->pUi->overlayLine2;
+    const int16_t msg_x = 140;
+    const int16_t msg_y = 184;
+    const int16_t msg_w = dispcolor_getWidth() - msg_x - 8;
+    const int16_t msg_h = 32;
+
+    dispcolor_FillRect(msg_x, msg_y, msg_w, msg_h, BLACK);
+    if (pLine1 && pLine1[0]) dispcolor_printf(msg_x, msg_y, FONTID_6X8M, RGB565(255,128,0), "%s", pLine1);
+    if (pLine2 && pLine2[0]) dispcolor_printf(msg_x, msg_y + 14, FONTID_6X8M, RGB565(200,200,200), "%s", pLine2);
+}
+
+//==============================================================================
+// 合成阶段：界面部件的输入签名，任何一项改变都需要重绘该部件
+//==============================================================================
+
+static uint32_t GetTitleSignature(const sSceneUiState* pUi)
+{
+    uint32_t sig = 2166136261u;
+
+    sig = SigMix(sig, pUi->focus == SECTION_TITLE);
+    sig = SigMix(sig, pUi->subItemMode);
+    sig = SigMix(sig, pUi->titleSub);
+    sig = SigMix(sig, pUi->paletteSelectMode);
+    sig = SigMix(sig, pUi->tempUnitSelectMode);
+    sig = SigMix(sig, pUi->useFahrenheit);
+    sig = SigMix(sig, pUi->lockActive);
+    sig = SigMix(sig, pUi->colorScale);
+    return sig;
+}
+
+static uint32_t GetFocusSignature(const sSceneUiState* pUi)
+{
+    uint32_t sig = 2166136261u;
+
+    sig = SigMix(sig, pUi->focus);
+    sig = SigMix(sig, pUi->lockActive);
+    return sig;
+}
+
+static uint32_t GetPanelSignature(const sSceneUiState* pUi)
+{
+    uint32_t sig = 2166136261u;
+
+    sig = SigMix(sig, pUi->focus == SECTION_DATA);
+    sig = SigMix(sig, pUi->subItemMode);
+    sig = SigMix(sig, pUi->dataSub);
+    sig = SigMix(sig, pUi->channelSelectMode);
+    sig = SigMix(sig, pUi->plotChannelY);
+    sig = SigMix(sig, pUi->useFahrenheit);
+    sig = SigMix(sig, pUi->crossX);
+    sig = SigMix(sig, pUi->crossY);
+    return sig;
+}
+
+static uint32_t GetMarkersSignature(const sSceneUiState* pUi)
+{
+    uint32_t sig = 2166136261u;
+
+    sig = SigMix(sig, pUi->tempMarkers);
+    sig = SigMix(sig, pUi->showCrosshair);
+    sig = SigMix(sig, pUi->crosshairMode);
+    sig = SigMix(sig, pUi->crosshairAxisIsY);
+    sig = SigMix(sig, pUi->crossX);
+    sig = SigMix(sig, pUi->crossY);
+    sig = SigMix(sig, pUi->useFahrenheit);
+    return sig;
+}
+
+static uint32_t GetOverlaySignature(const sSceneUiState* pUi)
+{
+    uint32_t sig = 2166136261u;
+
+    sig = SigMix(sig, pUi->overlayActive);
+    sig = SigMix(sig, pUi->overlayId);
+    return sig;
+}
+
+// 界面部件：签名与上一次绘制时不同才重绘部件所在图层，热图沿用上一帧的计算结果
+typedef struct {
+    uint32_t (*signature)(const sSceneUiState* pUi);
+    eSceneLayer layer;
+} sSceneWidget;
+
+static const sSceneWidget Widgets[SCENE_WIDGET_COUNT] = {
+    [SCENE_WIDGET_TITLE] = { GetTitleSignature, SCENE_LAYER_TITLE },
+    [SCENE_WIDGET_FOCUS] = { GetFocusSignature, SCENE_LAYER_FOCUS },
+    [SCENE_WIDGET_PANEL] = { GetPanelSignature, SCENE_LAYER_PANEL },
+    [SCENE_WIDGET_MARKERS] = { GetMarkersSignature, SCENE_LAYER_MARKERS },
+    [SCENE_WIDGET_OVERLAY] = { GetOverlaySignature, SCENE_LAYER_OVERLAY },
+};
+
+/**
+ * @brief 在合成器中创建图层（z 从低到高）
+ *
+ * @param pTarget
+ * @param pLayout
+ * @return true 成功
+ */
+bool scene_InitTarget(sSceneTarget* pTarget, const sSceneLayout* pLayout)
+{
+    const int16_t screenW = dispcolor_getWidth();
+    const int16_t screenH = dispcolor_getHeight();
+    int8_t* layers = pTarget->layers;
+
+    memset(pTarget, 0, sizeof(*pTarget));
+    pTarget->layout = *pLayout;
+
+    layers[SCENE_LAYER_CHROME] = compositor_AddLayer(0, 0, screenW, screenH, 0, true, DrawChromeLayer, pTarget);
+    layers[SCENE_LAYER_TITLE] = compositor_AddLayer(0, 0, screenW, pLayout->top_bar_h, 1, true, DrawTitleLayer, pTarget);
+    layers[SCENE_LAYER_THERMAL] = compositor_AddLayer(pLayout->img_x, pLayout->img_y, pLayout->img_w, pLayout->img_h, 1, true, DrawThermalLayer, pTarget);
+    layers[SCENE_LAYER_PANEL] = compositor_AddLayer(0, screenH - pLayout->bottom_bar_h, screenW, pLayout->bottom_bar_h, 1, true, DrawPanelLayer, pTarget);
+    layers[SCENE_LAYER_MARKERS] = compositor_AddLayer(pLayout->img_x, pLayout->img_y, pLayout->img_w, pLayout->img_h, 2, false, DrawMarkersLayer, pTarget);
+    layers[SCENE_LAYER_FOCUS] = compositor_AddLayer(0, 0, pLayout->img_x, screenH, 3, false, DrawFocusLayer, pTarget);
+    // 提示文字可能超出黑色背景框，图层延伸到屏幕右边缘
+    layers[SCENE_LAYER_OVERLAY] = compositor_AddLayer(140, 184, screenW - 140, 32, 4, false, DrawOverlayLayer, pTarget);
+    compositor_SetVisible(layers[SCENE_LAYER_OVERLAY], false);
+
+    for (uint8_t i = 0; i < SCENE_LAYER_COUNT; i++) {
+        if (layers[i] < 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 合成一帧：新计算的帧重绘热图和数据栏，界面部件只在输入改变时重绘
+ *
+ * @param pFrame 计算结果，NULL 表示还没有数据
+ * @param pUi 界面状态
+ * @param pTarget
+ * @return true 绘制了内容
+ */
+bool scene_ComposeFrame(const sSceneFrame* pFrame, const sSceneUiState* pUi, sSceneTarget* pTarget)
+{
+    const int8_t* layers = pTarget->layers;
+
+    pTarget->pUi = pUi;
+    if ((pFrame != pTarget->pFrame) || (pFrame && (pFrame->version != pTarget->frameVersion))) {
+        pTarget->pFrame = pFrame;
+        pTarget->frameVersion = pFrame ? pFrame->version : 0;
+        compositor_Invalidate(layers[SCENE_LAYER_THERMAL]);
+        compositor_Invalidate(layers[SCENE_LAYER_PANEL]);
+    }
+
+    compositor_SetVisible(layers[SCENE_LAYER_PANEL], pUi->realTimeAnalysis);
+    compositor_SetVisible(layers[SCENE_LAYER_MARKERS], pUi->tempMarkers || pUi->showCrosshair);
+    compositor_SetVisible(layers[SCENE_LAYER_OVERLAY], pUi->overlayActive);
+
+    for (uint8_t i = 0; i < SCENE_WIDGET_COUNT; i++) {
+        uint32_t sig = Widgets[i].signature(pUi);
+
+        if (sig != pTarget->widgetSig[i]) {
+            pTarget->widgetSig[i] = sig;
+            compositor_Invalidate(layers[Widgets[i].layer]);
+        }
+    }
+
+    return compositor_Compose();
+}
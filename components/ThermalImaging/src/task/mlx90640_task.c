@@ -1,4 +1,7 @@
 #include "thermalimaging.h"
+#include "framestats.h"
+#include "profiler.h"
+#include "record_task.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <string.h>
@@ -7,8 +10,15 @@
 #define TA_SHIFT 8 // the default shift for a MLX90640 device in open air
 
 static paramsMLX90640* pMLX90640params = NULL; // MLX90640 解析出的参数
-sMlxData* pMlxData = NULL; // MLX90640 定义2个缓冲
-static int8_t lastFrameNo = 0;
+sMlxData* pMlxData = NULL; // MLX90640 帧缓冲槽（MLX_FRAME_SLOTS 个）
+
+// 帧调度：采集任务只写既不是最新帧、也没有被读者占用的槽，写完后发布为最新帧
+static portMUX_TYPE FrameLock = portMUX_INITIALIZER_UNLOCKED;
+static int8_t LatestSlot = -1; // 最新完成的帧，-1 表示还没有数据
+static bool LatestTaken = false; // 最新帧是否被取出过
+static uint8_t SlotUsers[MLX_FRAME_SLOTS]; // 每个槽的读者数
+static uint32_t FrameSeq = 0;
+static uint32_t DroppedFrames = 0;
 
 const float FPS_RATES[] = { 0.5, 1, 2, 4, 8, 16, 32, 64 }; // MLX90640帧率
 const int FPS_RATES_COUNT = sizeof(FPS_RATES) / sizeof(FPS_RATES[0]);
@@ -28,9 +38,95 @@ static uint8_t MLX90640PausePlay = 0; // 暂停LCD刷新 继续LCD刷新功能
  */
 void GetThermoData(float* pBuff)
 {
-    sMlxData* _pMlxData = &pMlxData[lastFrameNo];
-    float* ThermoImage = _pMlxData->ThermoImage;
-    memcpy(pBuff, ThermoImage, sizeof(_pMlxData->ThermoImage));
+    const sMlxData* _pMlxData = mlx90640_AcquireLatest();
+    if (_pMlxData == NULL)
+        return;
+    memcpy(pBuff, _pMlxData->ThermoImage, sizeof(_pMlxData->ThermoImage));
+    mlx90640_ReleaseFrame(_pMlxData);
+}
+
+/**
+ * @brief 取出最新的完整帧
+ *
+ * @return const sMlxData* 没有数据时返回 NULL
+ */
+const sMlxData* mlx90640_AcquireLatest(void)
+{
+    const sMlxData* pFrame = NULL;
+
+    taskENTER_CRITICAL(&FrameLock);
+    if (LatestSlot >= 0) {
+        SlotUsers[LatestSlot]++;
+        LatestTaken = true;
+        pFrame = &pMlxData[LatestSlot];
+    }
+    taskEXIT_CRITICAL(&FrameLock);
+
+    return pFrame;
+}
+
+/**
+ * @brief 归还取出的帧
+ *
+ * @param pFrame
+ */
+void mlx90640_ReleaseFrame(const sMlxData* pFrame)
+{
+    if (pFrame == NULL)
+        return;
+
+    int slot = pFrame - pMlxData;
+
+    taskENTER_CRITICAL(&FrameLock);
+    if (SlotUsers[slot] > 0)
+        SlotUsers[slot]--;
+    taskEXIT_CRITICAL(&FrameLock);
+}
+
+/**
+ * @brief 被更新的帧覆盖而没有被取出过的帧数
+ *
+ * @return uint32_t
+ */
+uint32_t mlx90640_GetDroppedFrames(void)
+{
+    return DroppedFrames;
+}
+
+/**
+ * @brief 找一个可以写入的槽（不是最新帧，也没有被读者占用）
+ *
+ * @return int8_t 没有空闲槽时返回 -1
+ */
+static int8_t mlx90640_claimSlot(void)
+{
+    int8_t slot = -1;
+
+    taskENTER_CRITICAL(&FrameLock);
+    for (int8_t i = 0; i < MLX_FRAME_SLOTS; i++) {
+        if ((i != LatestSlot) && (SlotUsers[i] == 0)) {
+            slot = i;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&FrameLock);
+
+    return slot;
+}
+
+/**
+ * @brief 发布写好的帧为最新帧
+ *
+ * @param slot
+ */
+static void mlx90640_publishSlot(int8_t slot)
+{
+    taskENTER_CRITICAL(&FrameLock);
+    if ((LatestSlot >= 0) && !LatestTaken)
+        DroppedFrames++;
+    LatestSlot = slot;
+    LatestTaken = false;
+    taskEXIT_CRITICAL(&FrameLock);
 }
 
 void GetThermoParams(paramsMLX90640* pBuf)
@@ -78,7 +174,7 @@ void mlx90640_task(void* arg)
 {
     int result;
 
-    pMlxData = heap_caps_malloc(sizeof(sMlxData) << 1, MALLOC_CAP_8BIT);
+    pMlxData = heap_caps_malloc(sizeof(sMlxData) * MLX_FRAME_SLOTS, MALLOC_CAP_8BIT);
     pMLX90640params = heap_caps_malloc(sizeof(paramsMLX90640), MALLOC_CAP_8BIT);
     uint16_t* pMLX90640Frame = heap_caps_malloc(max(MLX90640_getFrameSize(), MLX90640_getEEPROMSize()) << 1, MALLOC_CAP_8BIT); // 分配 MLX90640 使用的内�? EEPROM读取解析完后 数据就没用了
 
@@ -127,8 +223,13 @@ void mlx90640_task(void* arg)
 
     while (1) {
         if (0 == MLX90640PausePlay) {
-            // 从传感器读取最新帧
-            sMlxData* _pMlxData = &pMlxData[lastFrameNo];
+            // 从传感器读取最新帧（读者同时占用其余的槽时等它们归还）
+            int8_t slot = mlx90640_claimSlot();
+            if (slot < 0) {
+                vTaskDelay(1);
+                continue;
+            }
+            sMlxData* _pMlxData = &pMlxData[slot];
             float* pThermoImage = _pMlxData->ThermoImage;
 
             // 连续读取�?然后计算
@@ -157,9 +258,18 @@ void mlx90640_task(void* arg)
                 }
             }
 
+            _pMlxData->TimestampUs = profiler_Now();
+            _pMlxData->FrameSeq = ++FrameSeq;
+
+            // 采集时计算整帧统计，渲染、保存等直接读取
+            framestats_Calc(_pMlxData);
+
+            // 录像时复制一份给录像任务（发布前该槽不会被读者改写）
+            recordtask_OnFrame(_pMlxData);
+
+            mlx90640_publishSlot(slot);
             if (NULL != pHandleEventGroup)
-                xEventGroupSetBits(pHandleEventGroup, 1 << lastFrameNo);
-            lastFrameNo = (lastFrameNo + 1) & 1;
+                xEventGroupSetBits(pHandleEventGroup, RENDER_MLX90640_NO0);
 
         } else {
             vTaskDelay(100 / portTICK_PERIOD_MS);
@@ -0,0 +1,464 @@
+#include "record_task.h"
+#include "recording.h"
+#include "save.h"
+#include "sd_task.h"
+#include "sdstream_task.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RECORD_PIXELS (THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT)
+
+// 一帧待编码的温度
+typedef struct {
+    float ThermoImage[RECORD_PIXELS];
+    float Ta;
+    uint32_t FrameSeq;
+    uint32_t TimestampUs;
+} sRecordSlot;
+
+// 录像任务的命令，与帧一起按顺序排队
+typedef enum {
+    RECORD_CMD_FRAME = 0,
+    RECORD_CMD_START,
+    RECORD_CMD_STOP,
+} eRecordCmd;
+
+typedef struct {
+    eRecordCmd cmd;
+    sRecordSlot* pSlot; // RECORD_CMD_FRAME 的帧缓冲，编码后归还
+    TaskHandle_t waiter; // 等待命令完成的任务
+} sRecordItem;
+
+// 交给写文件任务的块
+typedef struct {
+    uint8_t* pBlock; // 写完后归还；为 NULL 时只通知 waiter（前面的块都已写完）
+    size_t size;
+    TaskHandle_t waiter;
+} sRecordWrite;
+
+static QueueHandle_t RecordItems = NULL; // 等待编码的帧和命令
+static QueueHandle_t FreeSlots = NULL; // 空闲的帧缓冲
+static QueueHandle_t WriteItems = NULL; // 等待写文件的块
+static QueueHandle_t FreeBlocks = NULL; // 空闲的块
+static volatile bool Recording = false; // 采集任务是否复制帧
+
+static sRecordingEncoder* pEncoder = NULL;
+static uint8_t* pBlock = NULL; // 正在填的块
+static size_t BlockUsed = 0;
+static int WriteResult = SAVE_OK; // 写文件任务的第一个错误（StatsLock）
+static FILE* RecordFile = NULL;
+static bool RecordOnSd = false; // 录像写在 SD 卡上（由 SD 卡流式写入任务写文件，RecordFile 不用）
+static uint64_t ElapsedUs = 0;
+static uint32_t LastFrameUs = 0;
+static int CommandResult = SAVE_OK; // 最近一次开始/停止命令的结果
+
+static portMUX_TYPE StatsLock = portMUX_INITIALIZER_UNLOCKED;
+static sRecordStats Stats;
+
+/**
+ * @brief 优先在 PSRAM 中分配
+ *
+ * @param size
+ * @return void*
+ */
+static void* recordtask_alloc(size_t size)
+{
+    void* p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    return p ? p : malloc(size);
+}
+
+static int recordtask_writeResult(void)
+{
+    taskENTER_CRITICAL(&StatsLock);
+    int result = WriteResult;
+    taskEXIT_CRITICAL(&StatsLock);
+    return result;
+}
+
+/**
+ * @brief 写文件任务：按顺序把块写入文件，编码不等待存储
+ *
+ * @param arg
+ */
+static void record_write_task(void* arg)
+{
+    (void)arg;
+    sRecordWrite item;
+
+    while (1) {
+        if (xQueueReceive(WriteItems, &item, portMAX_DELAY) != pdTRUE)
+            continue;
+
+        if (item.pBlock != NULL) {
+            // 出错后丢弃剩下的块，录像任务在下一帧停止录像
+            if (recordtask_writeResult() == SAVE_OK) {
+                bool ok = RecordOnSd ? (sdstreamtask_Write(item.pBlock, item.size) == SAVE_OK)
+                                     : (fwrite(item.pBlock, 1, item.size, RecordFile) == item.size);
+                if (!ok) {
+                    taskENTER_CRITICAL(&StatsLock);
+                    WriteResult = SAVE_ERR_WRITE;
+                    taskEXIT_CRITICAL(&StatsLock);
+                }
+            }
+            xQueueSend(FreeBlocks, &item.pBlock, 0);
+        }
+
+        if (item.waiter != NULL)
+            xTaskNotifyGive(item.waiter);
+    }
+}
+
+/**
+ * @brief 把攒下的块交给写文件任务，取一块空闲的块（两块都在排队时等待）
+ *
+ * @return true 成功
+ */
+static bool recordtask_flush(void)
+{
+    if (BlockUsed == 0)
+        return true;
+
+    sRecordWrite item = { .pBlock = pBlock, .size = BlockUsed };
+    xQueueSend(WriteItems, &item, portMAX_DELAY);
+    pBlock = NULL;
+    BlockUsed = 0;
+
+    if (xQueueReceive(FreeBlocks, &pBlock, pdMS_TO_TICKS(RECORD_STALL_TIMEOUT_MS)) == pdTRUE)
+        return true;
+
+    // 存储写不动了：等写文件任务归还块后再关闭文件
+    xQueueReceive(FreeBlocks, &pBlock, portMAX_DELAY);
+    return false;
+}
+
+/**
+ * @brief 交出剩余数据并等待写文件任务写完
+ *
+ * @return true 全部写入成功
+ */
+static bool recordtask_sync(void)
+{
+    bool ok = recordtask_flush();
+    sRecordWrite item = { .pBlock = NULL, .waiter = xTaskGetCurrentTaskHandle() };
+
+    ulTaskNotifyTake(pdTRUE, 0);
+    xQueueSend(WriteItems, &item, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return ok && (recordtask_writeResult() == SAVE_OK);
+}
+
+/**
+ * @brief 录像文件是否打开
+ *
+ * @return true
+ */
+static bool recordtask_isOpen(void)
+{
+    return (RecordFile != NULL) || RecordOnSd;
+}
+
+/**
+ * @brief 写出剩余数据，关闭文件并记入清单
+ *
+ * @param result 录像过程中的错误，SAVE_OK 表示正常停止
+ * @return int 录像结果
+ */
+static int recordtask_close(int result)
+{
+    Recording = false;
+    if (!recordtask_isOpen())
+        return result;
+
+    if (!recordtask_sync() && (result == SAVE_OK))
+        result = SAVE_ERR_WRITE;
+    int closeResult = RecordOnSd ? sdstreamtask_Close(NULL) : save_CloseFile(SAVE_RECORDING_EXT, RecordFile, Stats.fileIndex);
+    if (result == SAVE_OK)
+        result = closeResult;
+    RecordFile = NULL;
+    RecordOnSd = false;
+
+    taskENTER_CRITICAL(&StatsLock);
+    Stats.active = false;
+    Stats.lastError = result;
+    taskEXIT_CRITICAL(&StatsLock);
+
+    printf("Record %s%05ld%s: %s, %lu frames (%lu dropped), %lu bytes\r\n", Stats.sdCard ? "SD " : "", (long)Stats.fileIndex, SAVE_RECORDING_EXT,
+        save_ErrorStr(result), (unsigned long)Stats.frames, (unsigned long)Stats.dropped, (unsigned long)Stats.bytes);
+    return result;
+}
+
+/**
+ * @brief 创建录像文件，文件头取自最新一帧和当前设置；插着 SD 卡时写在卡上，否则写内置存储
+ *
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+static int recordtask_open(void)
+{
+    if (recordtask_isOpen())
+        return SAVE_ERR_BUSY;
+
+    sSnapshotHeader header;
+    recording_InitHeader(&header, THERMALIMAGE_RESOLUTION_WIDTH, THERMALIMAGE_RESOLUTION_HEIGHT);
+    const sMlxData* pFrame = mlx90640_AcquireLatest();
+    if (pFrame == NULL)
+        return SAVE_ERR_NODATA;
+    save_FillHeader(&header, pFrame);
+    mlx90640_ReleaseFrame(pFrame);
+
+    int32_t index = 0;
+    int err;
+    if (sdcardIsMount()) {
+        err = sdstreamtask_Open(SAVE_RECORDING_EXT, &index);
+        RecordOnSd = (err == SAVE_OK);
+        if (!RecordOnSd)
+            printf("Record: SD card %s, using internal storage\r\n", save_ErrorStr(err));
+    }
+    if (!RecordOnSd) {
+        RecordFile = save_CreateFile(SAVE_RECORDING_EXT, RECORD_MIN_FREE, &index, &err);
+        if (RecordFile == NULL)
+            return err;
+    }
+
+    recording_EncoderInit(pEncoder, THERMALIMAGE_RESOLUTION_WIDTH, THERMALIMAGE_RESOLUTION_HEIGHT, RECORDING_KEY_INTERVAL);
+    memcpy(pBlock, &header, sizeof(header));
+    BlockUsed = sizeof(header);
+    ElapsedUs = 0;
+
+    taskENTER_CRITICAL(&StatsLock);
+    WriteResult = SAVE_OK;
+    memset(&Stats, 0, sizeof(Stats));
+    Stats.active = true;
+    Stats.fileIndex = index;
+    Stats.sdCard = RecordOnSd;
+    Stats.bytes = BlockUsed;
+    taskEXIT_CRITICAL(&StatsLock);
+
+    Recording = true;
+    return SAVE_OK;
+}
+
+/**
+ * @brief 编码一帧并追加到块，块满时交给写文件任务
+ *
+ * @param pSlot
+ * @return int SAVE_OK / SAVE_ERR_WRITE
+ */
+static int recordtask_encode(const sRecordSlot* pSlot)
+{
+    if (recordtask_writeResult() != SAVE_OK)
+        return SAVE_ERR_WRITE;
+    if ((BlockUsed + RECORDING_MAX_FRAME_SIZE(RECORD_PIXELS) > RECORD_BLOCK_SIZE) && !recordtask_flush())
+        return SAVE_ERR_WRITE;
+
+    if (pEncoder->Frames != 0)
+        ElapsedUs += pSlot->TimestampUs - LastFrameUs;
+    LastFrameUs = pSlot->TimestampUs;
+
+    uint8_t* pOut = pBlock + BlockUsed;
+    size_t size = recording_EncodeFrame(pEncoder, pSlot->ThermoImage, pSlot->FrameSeq, ElapsedUs / 1000, pSlot->Ta,
+        pOut, RECORD_BLOCK_SIZE - BlockUsed);
+    if (size == 0)
+        return SAVE_ERR_MEMORY;
+    BlockUsed += size;
+    bool key = ((const sRecordingFrameHeader*)pOut)->Type == RECORDING_FRAME_KEY;
+
+    taskENTER_CRITICAL(&StatsLock);
+    Stats.frames++;
+    if (key)
+        Stats.keyFrames++;
+    Stats.bytes += size;
+    Stats.elapsedMs = ElapsedUs / 1000;
+    taskEXIT_CRITICAL(&StatsLock);
+    return SAVE_OK;
+}
+
+/**
+ * @brief 录像任务：按顺序处理开始、帧和停止
+ *
+ * @param arg
+ */
+static void record_task(void* arg)
+{
+    (void)arg;
+    sRecordItem item;
+
+    while (1) {
+        if (xQueueReceive(RecordItems, &item, portMAX_DELAY) != pdTRUE)
+            continue;
+
+        switch (item.cmd) {
+        case RECORD_CMD_FRAME:
+            // 停止后仍在排队的帧直接丢弃
+            if (recordtask_isOpen()) {
+                int result = recordtask_encode(item.pSlot);
+                if (result != SAVE_OK)
+                    recordtask_close(result);
+            }
+            xQueueSend(FreeSlots, &item.pSlot, 0);
+            break;
+
+        case RECORD_CMD_START:
+            CommandResult = recordtask_open();
+            break;
+
+        case RECORD_CMD_STOP:
+            CommandResult = recordtask_isOpen() ? recordtask_close(SAVE_OK) : Stats.lastError;
+            break;
+        }
+
+        if (item.waiter != NULL)
+            xTaskNotifyGive(item.waiter);
+    }
+}
+
+/**
+ * @brief 分配帧缓冲并启动录像任务
+ *
+ * @return true 成功
+ */
+bool recordtask_Init(void)
+{
+    if (RecordItems != NULL)
+        return true;
+
+    RecordItems = xQueueCreate(RECORD_SLOT_COUNT + 2, sizeof(sRecordItem));
+    FreeSlots = xQueueCreate(RECORD_SLOT_COUNT, sizeof(sRecordSlot*));
+    WriteItems = xQueueCreate(RECORD_BLOCK_COUNT + 1, sizeof(sRecordWrite));
+    FreeBlocks = xQueueCreate(RECORD_BLOCK_COUNT, sizeof(uint8_t*));
+    pEncoder = recordtask_alloc(sizeof(sRecordingEncoder));
+    if (!RecordItems || !FreeSlots || !WriteItems || !FreeBlocks || !pEncoder) {
+        printf("Record: out of memory\r\n");
+        return false;
+    }
+
+    for (int i = 0; i < RECORD_BLOCK_COUNT; i++) {
+        uint8_t* p = recordtask_alloc(RECORD_BLOCK_SIZE);
+        if (!p)
+            return false;
+        xQueueSend(FreeBlocks, &p, 0);
+    }
+    xQueueReceive(FreeBlocks, &pBlock, 0);
+
+    for (int i = 0; i < RECORD_SLOT_COUNT; i++) {
+        sRecordSlot* pSlot = recordtask_alloc(sizeof(sRecordSlot));
+        if (!pSlot)
+            return false;
+        xQueueSend(FreeSlots, &pSlot, 0);
+    }
+
+    // 写文件任务比录像任务高一级：存储空闲时尽快把块写出去
+    if (xTaskCreatePinnedToCore(record_write_task, "recwrite", 1024 * 4, NULL, tskIDLE_PRIORITY + 2, NULL, tskNO_AFFINITY) != pdPASS)
+        return false;
+    return xTaskCreatePinnedToCore(record_task, "record", 1024 * 4, NULL, tskIDLE_PRIORITY + 1, NULL, tskNO_AFFINITY) == pdPASS;
+}
+
+/**
+ * @brief 发送命令并等待录像任务处理完
+ *
+ * @param cmd
+ * @return int 命令结果
+ */
+static int recordtask_command(eRecordCmd cmd)
+{
+    sRecordItem item = { .cmd = cmd, .waiter = xTaskGetCurrentTaskHandle() };
+
+    if (RecordItems == NULL)
+        return SAVE_ERR_MEMORY;
+
+    ulTaskNotifyTake(pdTRUE, 0); // 清除以前残留的通知
+    xQueueSend(RecordItems, &item, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return CommandResult;
+}
+
+/**
+ * @brief 开始录像
+ *
+ * @param pIndex 输出文件序号，可以为 NULL
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+int recordtask_Start(int32_t* pIndex)
+{
+    if (Recording)
+        return SAVE_ERR_BUSY;
+
+    int ret = recordtask_command(RECORD_CMD_START);
+    if ((ret == SAVE_OK) && (pIndex != NULL))
+        *pIndex = Stats.fileIndex;
+    return ret;
+}
+
+/**
+ * @brief 停止录像
+ *
+ * @param pStats 输出最终统计，可以为 NULL
+ * @return int 录像结果
+ */
+int recordtask_Stop(sRecordStats* pStats)
+{
+    // 先停止复制新帧，已排队的帧在停止命令之前写完
+    Recording = false;
+    int ret = recordtask_command(RECORD_CMD_STOP);
+    if (pStats != NULL)
+        recordtask_GetStats(pStats);
+    return ret;
+}
+
+/**
+ * @brief 是否正在录像
+ *
+ * @return true
+ */
+bool recordtask_IsActive(void)
+{
+    return Recording;
+}
+
+/**
+ * @brief 采集任务每完成一帧调用（在发布该帧之前，帧数据不会被改写）
+ *
+ * @param pFrame
+ */
+void recordtask_OnFrame(const sMlxData* pFrame)
+{
+    if (!Recording)
+        return;
+
+    sRecordSlot* pSlot;
+    if (xQueueReceive(FreeSlots, &pSlot, 0) != pdTRUE) {
+        taskENTER_CRITICAL(&StatsLock);
+        Stats.dropped++;
+        taskEXIT_CRITICAL(&StatsLock);
+        return;
+    }
+
+    memcpy(pSlot->ThermoImage, pFrame->ThermoImage, sizeof(pSlot->ThermoImage));
+    pSlot->Ta = pFrame->Ta;
+    pSlot->FrameSeq = pFrame->FrameSeq;
+    pSlot->TimestampUs = pFrame->TimestampUs;
+
+    sRecordItem item = { .cmd = RECORD_CMD_FRAME, .pSlot = pSlot };
+    if (xQueueSend(RecordItems, &item, 0) != pdTRUE) {
+        xQueueSend(FreeSlots, &pSlot, 0);
+        taskENTER_CRITICAL(&StatsLock);
+        Stats.dropped++;
+        taskEXIT_CRITICAL(&StatsLock);
+    }
+}
+
+/**
+ * @brief 读取统计
+ *
+ * @param pStats
+ */
+void recordtask_GetStats(sRecordStats* pStats)
+{
+    taskENTER_CRITICAL(&StatsLock);
+    *pStats = Stats;
+    taskEXIT_CRITICAL(&StatsLock);
+}
@@ -1,21 +1,18 @@
 #include "thermalimaging_simple.h"
 #include "dispcolor.h"
 #include "st7789.h"
-#include "palette.h"
-#include "IDW.h"
-#include "CelsiusSymbol.h"
 #include <string.h>
 #include <math.h>
 #include <stdlib.h>
-#include <float.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include "simple_menu.h"
 #include "settings.h"
 #include "save.h"
+#include "profiler.h"
+#include "scene.h"
 
 
-#define TEMP_SCALE 10  // 温度放大倍数，与render_task.c一致
 //test on DELL
 
 // Uncomment to enable low-quality fast rendering path (nearest-neighbor)
@@ -25,209 +22,18 @@
 bool lowQualityRender = false;
 
 
+// 渲染流水线：计算阶段（core 0）生成放大后的温度图和颜色查找表，
+// 合成阶段（render_task，core 1）绘制图层并刷新屏幕，两个阶段通过有界队列交换缓冲区
+#define RENDER_PIPELINE_DEPTH 1 // 已计算好、等待合成的最大帧数
+#define RENDER_PIPELINE_BUFFERS (RENDER_PIPELINE_DEPTH + 2) // 排队的帧 + 正在显示的帧 + 正在计算的帧
 
-static bool compute_temp_range(const sMlxData* frame, float* minTemp, float* maxTemp)
-{
-    const int pixelCount = THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT;
-    bool hasValidSample = false;
-    float localMin = FLT_MAX;
-    float localMax = -FLT_MAX;
-
-    for (int i = 0; i < pixelCount; i++) {
-        float sample = frame->ThermoImage[i];
-        if (!isfinite(sample)) {
-            continue;
-        }
-
-        if (!hasValidSample) {
-            localMin = localMax = sample;
-            hasValidSample = true;
-            continue;
-        }
-
-        if (sample < localMin) {
-            localMin = sample;
-        }
-        if (sample > localMax) {
-            localMax = sample;
-        }
-    }
-
-    if (!hasValidSample) {
-        return false;
-    }
-
-    *minTemp = localMin;
-    *maxTemp = localMax;
-    return true;
-}
-
-// 计算MLX90640的温度数据 - 参考render_task.c
-static void CalcTempFromMLX90640(sMlxData* pMlxData)
-{
-    const float* pThermoImage = pMlxData->ThermoImage;
-
-    // 计算屏幕中心的温度 累加中间4个像素的值
-    pMlxData->CenterTemp = 
-        pThermoImage[THERMALIMAGE_RESOLUTION_WIDTH * ((THERMALIMAGE_RESOLUTION_HEIGHT >> 1) - 1) + ((THERMALIMAGE_RESOLUTION_WIDTH >> 1) - 1)] +
-        pThermoImage[THERMALIMAGE_RESOLUTION_WIDTH * ((THERMALIMAGE_RESOLUTION_HEIGHT >> 1) - 1) + (THERMALIMAGE_RESOLUTION_WIDTH >> 1)] +
-        pThermoImage[THERMALIMAGE_RESOLUTION_WIDTH * (THERMALIMAGE_RESOLUTION_HEIGHT >> 1) + ((THERMALIMAGE_RESOLUTION_WIDTH >> 1) - 1)] +
-        pThermoImage[THERMALIMAGE_RESOLUTION_WIDTH * (THERMALIMAGE_RESOLUTION_HEIGHT >> 1) + (THERMALIMAGE_RESOLUTION_WIDTH >> 1)];
-    pMlxData->CenterTemp /= 4;
-
-    // 搜索帧中的最小和最大温度 及坐标
-    pMlxData->minT = MAX_TEMP;
-    pMlxData->maxT = MIN_TEMP;
-
-    for (uint8_t y = 0; y < THERMALIMAGE_RESOLUTION_HEIGHT; y++) {
-        for (uint8_t x = 0; x < THERMALIMAGE_RESOLUTION_WIDTH; x++) {
-            float temp = pThermoImage[y * THERMALIMAGE_RESOLUTION_WIDTH + x];
-
-            if (pMlxData->maxT < temp) {
-                pMlxData->maxT = temp;
-                pMlxData->maxT_X = x;
-                pMlxData->maxT_Y = y;
-            }
-
-            if (pMlxData->minT > temp) {
-                pMlxData->minT = temp;
-                pMlxData->minT_X = x;
-                pMlxData->minT_Y = y;
-            }
-        }
-    }
-
-    if (pMlxData->maxT > MAX_TEMP) {
-        pMlxData->maxT = MAX_TEMP;
-    }
-
-    if (pMlxData->minT < MIN_TEMP) {
-        pMlxData->minT = MIN_TEMP;
-    }
-}
-
-// 绘制中心温度显示 - 参考render_task.c
-static void DrawCenterTempColor(uint16_t cX, uint16_t cY, float TempCelsius, uint16_t color, bool useFahrenheit)
-{
-    char str[32];
-    float displayTemp = TempCelsius;
-    const char* unitSymbol = CELSIUS_SYMBOL;
-    
-    // 如果使用华氏度，进行转换
-    if (useFahrenheit) {
-        displayTemp = TempCelsius * 9.0f / 5.0f + 32.0f;
-        unitSymbol = FAHRENHEIT_SYMBOL;
-    }
-    
-    sprintf(str, "%.1f%s", displayTemp, unitSymbol);
-    
-    int16_t strWidth = strlen(str) * 6;  // FONTID_6X8M字体宽度
-    int16_t strHeight = 8;
-    
-    dispcolor_printf(cX - (strWidth >> 1), cY - (strHeight >> 1), FONTID_6X8M, color, "%s", str);
-}
-
-static void DrawCenterTemp(uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height, float CenterTemp, bool useFahrenheit)
-{
-    uint16_t cX = (Width >> 1) + X;
-    uint16_t cY = (Height >> 1) + Y;
-
-    // 渲染阴影黑色
-    DrawCenterTempColor(cX + 1, cY + 1, CenterTemp, BLACK, useFahrenheit);
-    // 渲染白色
-    DrawCenterTempColor(cX, cY, CenterTemp, WHITE, useFahrenheit);
-}
-
-// 绘制最大最小温度标记 - 参考render_task.c的DrawMarkersHQ
-static void DrawMarkersHQ(sMlxData* pMlxData, uint16_t img_x, uint16_t img_y, uint16_t img_w, uint16_t img_h)
-{
-    uint8_t lineHalf = 4;
-    
-    // 计算缩放比例
-    float scaleX = (float)img_w / THERMALIMAGE_RESOLUTION_WIDTH;
-    float scaleY = (float)img_h / THERMALIMAGE_RESOLUTION_HEIGHT;
-
-    // 绘制最大温度标记 (红色十字)
-    int16_t x = (THERMALIMAGE_RESOLUTION_WIDTH - pMlxData->maxT_X - 1) * scaleX + img_x;
-    int16_t y = pMlxData->maxT_Y * scaleY + img_y;
-
-    uint16_t mainColor = RED;
-    dispcolor_DrawLine(x + 1, y - lineHalf + 1, x + 1, y + lineHalf + 1, BLACK);
-    dispcolor_DrawLine(x - lineHalf + 1, y + 1, x + lineHalf + 1, y + 1, BLACK);
-    dispcolor_DrawLine(x - lineHalf + 1, y - lineHalf + 1, x + lineHalf + 1, y + lineHalf + 1, BLACK);
-    dispcolor_DrawLine(x - lineHalf + 1, y + lineHalf + 1, x + lineHalf + 1, y - lineHalf + 1, BLACK);
-
-    dispcolor_DrawLine(x, y - lineHalf, x, y + lineHalf, mainColor);
-    dispcolor_DrawLine(x - lineHalf, y, x + lineHalf, y, mainColor);
-    dispcolor_DrawLine(x - lineHalf, y - lineHalf, x + lineHalf, y + lineHalf, mainColor);
-    dispcolor_DrawLine(x - lineHalf, y + lineHalf, x + lineHalf, y - lineHalf, mainColor);
-
-    // 绘制最小温度标记 (蓝色X)
-    x = (THERMALIMAGE_RESOLUTION_WIDTH - pMlxData->minT_X - 1) * scaleX + img_x;
-    y = pMlxData->minT_Y * scaleY + img_y;
-
-    mainColor = RGB565(0, 200, 245);
-    dispcolor_DrawLine(x - lineHalf + 1, y - lineHalf + 1, x + lineHalf + 1, y + lineHalf + 1, BLACK);
-    dispcolor_DrawLine(x - lineHalf + 1, y + lineHalf + 1, x + lineHalf + 1, y - lineHalf + 1, BLACK);
-    dispcolor_DrawLine(x - lineHalf, y - lineHalf, x + lineHalf, y + lineHalf, mainColor);
-    dispcolor_DrawLine(x - lineHalf, y + lineHalf, x + lineHalf, y - lineHalf, mainColor);
-}
-
-// 高质量图像绘制函数 - 参考render_task.c的DrawHQImage
-static void DrawHQImage(int16_t* pImage, tRGBcolor* pPalette, uint16_t PaletteSize, 
-                       uint16_t X, uint16_t Y, uint16_t width, uint16_t height, float minTemp, float maxTemp)
-{
-    int cnt = 0;
-
-    // Precompute values used for mapping to avoid per-pixel repeated work
-    int16_t minS = (int16_t)(minTemp * TEMP_SCALE);
-    int16_t maxS = (int16_t)(maxTemp * TEMP_SCALE);
-    int paletteMid = PaletteSize / 2;
-    int pc = settingsParms.PaletteCenterPercent; // 0..100
-    int16_t centerS = (int16_t)((minTemp + (pc / 100.0f) * (maxTemp - minTemp)) * TEMP_SCALE);
-    int denomLower = centerS - minS; // may be <=0
-    int denomUpper = maxS - centerS; // may be <=0
-
-    for (int row = 0; row < height; row++) {
-        for (int col = 0; col < width; col++) {
-            int16_t pixel = pImage[cnt++];
-
-            int idx;
-            if (centerS <= minS || centerS >= maxS) {
-                // degenerate: fall back to linear mapping
-                idx = (int)pixel - (int)minS;
-            } else {
-                if (pixel <= centerS) {
-                    // Map [minS .. centerS] -> [0 .. paletteMid]
-                    if (denomLower <= 0) {
-                        idx = 0;
-                    } else {
-                        idx = ((int32_t)(pixel - minS) * paletteMid) / denomLower;
-                    }
-                } else {
-                    // Map (centerS .. maxS] -> (paletteMid .. PaletteSize-1]
-                    if (denomUpper <= 0) {
-                        idx = paletteMid;
-                    } else {
-                        idx = paletteMid + (((int32_t)(pixel - centerS) * (PaletteSize - paletteMid)) / denomUpper);
-                    }
-                }
-            }
-
-            // Clamp
-            if (idx < 0) idx = 0;
-            if (idx >= (int)PaletteSize) idx = PaletteSize - 1;
-
-            // Invert palette mapping so higher temperatures map to 'hot' colors
-            int16_t invIdx = (int16_t)(PaletteSize - 1 - idx);
-            if (invIdx < 0) invIdx = 0;
-            if (invIdx >= (int)PaletteSize) invIdx = PaletteSize - 1;
-
-            uint16_t color = RGB565(pPalette[invIdx].r, pPalette[invIdx].g, pPalette[invIdx].b);
-            dispcolor_DrawPixel((width - col - 1) + X, row + Y, color);
-        }
-    }
-}
+// 流水线中的一帧
+typedef struct {
+    sSceneFrame scene;       // 帧数据副本和计算结果，采集任务可以继续写自己的缓冲区
+    uint32_t computeSig;     // 计算时的量程/调色板设置签名，设置改变后需要重新计算
+    uint32_t computeStartUs; // 计算阶段开始的时间（微秒），用于统计流水线延迟
+    uint32_t readyUs;        // 进入就绪队列的时间（微秒）
+} sRenderFrame;
 
 // 外部变量声明 (来自mlx90640_task.c)
 extern sMlxData* pMlxData;
@@ -249,40 +55,18 @@ static uint8_t fixScalePrevAutoMode = 0;
 static float fixScalePrevMin = 0.0f;
 static float fixScalePrevMax = 0.0f;
 
-// 图像缓冲区 - 参考render_task.c的优化
-static int16_t* TermoImage16 = NULL;  // 热成像整数缓冲区（温度*10）
-static int16_t* TermoHqImage16 = NULL; // 高质量插值后的图像
-static float* gaussBuff = NULL;        // 高斯模糊缓冲区
-static tRGBcolor* pPaletteImage = NULL;  // 伪彩色调色板
+// 计算阶段的工作缓冲区
+static sSceneScratch Scratch;
 
-typedef enum {
-    SECTION_TITLE = 0,
-    SECTION_IMAGE,
-    SECTION_LOCK,
-    SECTION_DATA,
-    SECTION_COUNT
-} focus_section_t;
+// 流水线缓冲区和队列
+static sRenderFrame RenderFrames[RENDER_PIPELINE_BUFFERS];
+static QueueHandle_t FreeFrames = NULL;  // 空闲的缓冲区
+static QueueHandle_t ReadyFrames = NULL; // 已计算好、等待合成的帧
+static uint32_t PipelineDropped = 0;     // 在就绪队列里被更新的帧替换掉的帧数
 
+// 界面状态：焦点区域和子选择
 static focus_section_t currentFocus = SECTION_IMAGE;
-
-// 标题区域的子选择（左、中、右三项）
-typedef enum {
-    TITLE_SUB_LEFT = 0,   // 左侧：BOM
-    TITLE_SUB_CENTER,     // 中间：BOM_FRUIT
-    TITLE_SUB_RIGHT,      // 右侧：BOM
-    TITLE_SUB_COUNT
-} title_sub_selection_t;
-
 static title_sub_selection_t currentTitleSubSelection = TITLE_SUB_LEFT;
-
-// 底部数据区域的子选择（左、中、右三项）
-typedef enum {
-    DATA_SUB_LEFT = 0,   // 左侧：Max/Min/Ctr温度
-    DATA_SUB_CENTER,     // 中间：边框区域
-    DATA_SUB_RIGHT,      // 右侧：Atr/Set FPS
-    DATA_SUB_COUNT
-} data_sub_selection_t;
-
 static data_sub_selection_t currentDataSubSelection = DATA_SUB_LEFT;
 
 // 子项选择模式：true表示当前在子项中左右选择，false表示在焦点区域间切换
@@ -313,13 +97,157 @@ static bool useFahrenheit = false;
 // 绘图通道：false -> X轴(中心行)，true -> Y轴(中心列)
 static bool plotChannelY = false;
 // 请求立即重绘（即使没有新MLX帧），由输入处理器设置，渲染循环检测并执行一次绘制
-static bool forceRender = false;
 // 临时覆盖消息（短时提示），由输入处理器设置，渲染循环负责绘制并超时清除
 static bool overlay_active = false;
 static char overlay_line1[64] = {0};
 static char overlay_line2[64] = {0};
 static TickType_t overlay_expire_tick = 0;
 
+// 收集合成一帧需要的界面状态
+static void CollectUiState(sSceneUiState* pUi)
+{
+    pUi->colorScale = settingsParms.ColorScale;
+    pUi->paletteCenterPercent = settingsParms.PaletteCenterPercent;
+    pUi->autoScale = settingsParms.AutoScaleMode;
+    pUi->manualMin = settingsParms.minTempNew;
+    pUi->manualMax = settingsParms.maxTempNew;
+    pUi->lowQuality = lowQualityRender;
+
+    pUi->focus = currentFocus;
+    pUi->subItemMode = subItemMode;
+    pUi->titleSub = currentTitleSubSelection;
+    pUi->dataSub = currentDataSubSelection;
+    pUi->paletteSelectMode = paletteSelectMode;
+    pUi->tempUnitSelectMode = tempUnitSelectMode;
+    pUi->channelSelectMode = channelSelectMode;
+    pUi->crosshairMode = crosshairMode;
+    pUi->crosshairAxisIsY = crosshairAxisIsY;
+    pUi->showCrosshair = showImageCrosshair;
+    pUi->crossX = cross_x;
+    pUi->crossY = cross_y;
+    pUi->useFahrenheit = useFahrenheit;
+    pUi->plotChannelY = plotChannelY;
+    pUi->tempMarkers = settingsParms.TempMarkers;
+    pUi->realTimeAnalysis = settingsParms.RealTimeAnalysis;
+    pUi->lockActive = fixScaleTempActive;
+    pUi->overlayActive = overlay_active;
+    pUi->overlayId = overlay_expire_tick; // 每条新消息都会设置新的到期时间
+    pUi->overlayLine1 = overlay_line1;
+    pUi->overlayLine2 = overlay_line2;
+    pUi->fps = actual_fps;
+}
+
+// overlay 提示到期后隐藏，露出下面的图层
+static void ExpireOverlay(void)
+{
+    if (overlay_active && (xTaskGetTickCount() >= overlay_expire_tick)) {
+        overlay_active = false;
+        overlay_line1[0] = 0; overlay_line2[0] = 0;
+    }
+}
+
+// 录像时每秒用覆盖提示显示录像统计（不替换其他还没到期的提示），录像因出错停止时提示一次
+static void UpdateRecordOverlay(void)
+{
+    static bool wasActive = false;
+    static TickType_t recordOverlayTick = 0; // 录像提示设置的到期时间，用来判断当前提示是不是录像提示
+    TickType_t now = xTaskGetTickCount();
+    sRecordStats stats;
+
+    recordtask_GetStats(&stats);
+    if (stats.active) {
+        bool ours = overlay_active && (overlay_expire_tick == recordOverlayTick);
+        if ((!overlay_active || ours) && (!ours || (now + pdMS_TO_TICKS(500) >= overlay_expire_tick))) {
+            snprintf(overlay_line1, sizeof(overlay_line1), "REC %lus %luf", (unsigned long)(stats.elapsedMs / 1000), (unsigned long)stats.frames);
+            snprintf(overlay_line2, sizeof(overlay_line2), "%.1fKB/s drop %lu",
+                stats.elapsedMs ? stats.bytes / 1.024f / stats.elapsedMs : 0.0f, (unsigned long)stats.dropped);
+            overlay_active = true;
+            overlay_expire_tick = now + pdMS_TO_TICKS(1500);
+            recordOverlayTick = overlay_expire_tick;
+        }
+    } else if (wasActive && (stats.lastError != SAVE_OK)) {
+        snprintf(overlay_line1, sizeof(overlay_line1), "REC stopped");
+        snprintf(overlay_line2, sizeof(overlay_line2), "%s", save_ErrorStr(stats.lastError));
+        overlay_active = true;
+        overlay_expire_tick = now + pdMS_TO_TICKS(2000);
+    }
+    wasActive = stats.active;
+}
+
+// 计算阶段任务：每次被唤醒都取 MLX 任务最新的完整帧计算，然后放入就绪队列
+// 合成阶段来不及取走时，用新帧替换就绪队列里的旧帧（新帧优先），旧帧计入丢弃数
+static void render_compute_task(void* arg)
+{
+    uint32_t lastSeq = 0;
+    sSceneUiState ui;
+
+    while (1) {
+        EventBits_t bits = xEventGroupWaitBits(pHandleEventGroup, RENDER_MLX90640_NO0 | RENDER_MLX90640_NO1 | RENDER_Recompute,
+                                               pdTRUE, pdFALSE, portMAX_DELAY);
+
+        const sMlxData* pLatest = mlx90640_AcquireLatest();
+        if (pLatest == NULL)
+            continue;
+
+        // 被新帧唤醒但这一帧已经算过（唤醒前已取走），重新计算请求则照常计算
+        if ((pLatest->FrameSeq == lastSeq) && !(bits & RENDER_Recompute)) {
+            mlx90640_ReleaseFrame(pLatest);
+            continue;
+        }
+
+        sRenderFrame* pOut;
+        xQueueReceive(FreeFrames, &pOut, portMAX_DELAY);
+
+        CollectUiState(&ui);
+        pOut->computeStartUs = profiler_Now();
+        pOut->computeSig = scene_ComputeSignature(&ui);
+        memcpy(&pOut->scene.frame, pLatest, sizeof(sMlxData));
+        mlx90640_ReleaseFrame(pLatest);
+        lastSeq = pOut->scene.frame.FrameSeq;
+
+        scene_Compute(&pOut->scene, &ui, &Scratch);
+        pOut->readyUs = profiler_Now();
+
+        if (xQueueSend(ReadyFrames, &pOut, 0) != pdTRUE) {
+            sRenderFrame* pStale;
+            if (xQueueReceive(ReadyFrames, &pStale, 0) == pdTRUE) {
+                xQueueSend(FreeFrames, &pStale, 0);
+                PipelineDropped++;
+            }
+            xQueueSend(ReadyFrames, &pOut, portMAX_DELAY);
+        }
+        xEventGroupSetBits(pHandleEventGroup, RENDER_FrameReady);
+    }
+}
+
+// 显示过的帧归还给计算阶段：显示后端先不再引用它的热图和查找表（流式模式的显示列表只保存指针）
+static void ReturnShownFrame(sRenderFrame* pFrame)
+{
+    dispcolor_ReleaseBuffer(pFrame->scene.pHqImage, pFrame->scene.width * pFrame->scene.height * sizeof(int16_t));
+    dispcolor_ReleaseBuffer(pFrame->scene.pLut565, SCENE_LUT_SIZE * sizeof(uint16_t));
+    xQueueSend(FreeFrames, &pFrame, 0);
+}
+
+// 分配流水线缓冲区并启动计算阶段任务（core 0）
+static bool StartRenderPipeline(uint16_t img_width, uint16_t img_height)
+{
+    FreeFrames = xQueueCreate(RENDER_PIPELINE_BUFFERS, sizeof(sRenderFrame*));
+    ReadyFrames = xQueueCreate(RENDER_PIPELINE_DEPTH, sizeof(sRenderFrame*));
+    if (!FreeFrames || !ReadyFrames)
+        return false;
+
+    for (int i = 0; i < RENDER_PIPELINE_BUFFERS; i++) {
+        sRenderFrame* pFrame = &RenderFrames[i];
+
+        if (!scene_AllocFrame(&pFrame->scene, img_width, img_height))
+            return false;
+
+        xQueueSend(FreeFrames, &pFrame, 0);
+    }
+
+    return xTaskCreatePinnedToCore(render_compute_task, "render_compute", 1024 * 4, NULL, 3, NULL, 0) == pdPASS;
+}
+
 static void apply_fix_scale(bool exitSubItem)
 {
     if (!fixScaleTempActive) {
@@ -343,7 +271,6 @@ static void apply_fix_scale(bool exitSubItem)
         overlay_line2[0] = '\0';
         overlay_active = true;
         overlay_expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(900);
-        forceRender = true;
     } else {
         settingsParms.minTempNew = lastFrameMinTemp;
         settingsParms.maxTempNew = lastFrameMaxTemp;
@@ -352,87 +279,35 @@ static void apply_fix_scale(bool exitSubItem)
         snprintf(overlay_line1, sizeof(overlay_line1), "Fixed scale (5s refreshed): %.1f..%.1f", settingsParms.minTempNew, settingsParms.maxTempNew);
         overlay_active = true;
         overlay_expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(900);
-        forceRender = true;
     }
 }
 
-static void DrawLockIcon(int16_t x, int16_t y, uint16_t color)
-{
-    // Small padlock: shackle + body + keyhole
-    dispcolor_DrawLine(x - 2, y - 3, x + 2, y - 3, color);
-    dispcolor_DrawLine(x - 3, y - 2, x - 3, y - 1, color);
-    dispcolor_DrawLine(x + 3, y - 2, x + 3, y - 1, color);
-    dispcolor_DrawRectangle(x - 3, y - 1, x + 3, y + 3, color);
-    dispcolor_DrawLine(x, y, x, y + 2, color);
-}//man!
-
-static void DrawSectionFocus(focus_section_t focus,
-                             uint16_t top_bar_h,
-                             uint16_t bottom_bar_h,
-                             uint16_t img_y_start,
-                             uint16_t img_height,
-                             bool lockActive)
-{
-    const int16_t xPos = 4;
-    int16_t yPos[SECTION_COUNT];
-    yPos[SECTION_TITLE] = top_bar_h / 2;
-    yPos[SECTION_IMAGE] = img_y_start + (img_height / 2);
-    // Lock focus sits between the image bottom and data bar center
-    int16_t gap_top = img_y_start + img_height;
-    int16_t gap_bottom = dispcolor_getHeight() - (bottom_bar_h / 2);
-    yPos[SECTION_LOCK] = gap_top ;
-    yPos[SECTION_DATA] = dispcolor_getHeight() - (bottom_bar_h / 2);
-
-    // for (int i = 0; i < SECTION_COUNT; i++) {
-    //     dispcolor_DrawCircleFilled(xPos, yPos[i], 4, BLACK);
-    // }
-
-    // dispcolor_DrawCircleFilled(xPos, yPos[focus], 2, RGB565(255, 255, 0));
-    if (focus != SECTION_LOCK){
-        dispcolor_printf(xPos, yPos[focus], FONTID_6X8M, WHITE, ">");
-    }
-
-    // Lock icon sits next to the lock focus marker; color hints state
-    uint16_t lockColor = GRAY;
-    if (lockActive) {
-        lockColor = WHITE;
-    } else if (focus == SECTION_LOCK) {
-        lockColor = WHITE;
-    }
-    
-    // Draw background highlighting for lock icon area
-    if (lockActive) {
-        // Red background when locked
-        dispcolor_FillRect(0, yPos[SECTION_LOCK] - 7, 10, 7, RGB565(0, 255, 128));
-    } else if (focus == SECTION_LOCK) {
-        // Blue background when focused
-        // dispcolor_FillRect(0, yPos[SECTION_LOCK] - 7, 10, 7, RGB565(0, 0, 250));
-    }
-    
-    DrawLockIcon(xPos , yPos[SECTION_LOCK] - 4, lockColor);
-
-}
+// 合成阶段的界面状态和图层
+static sSceneUiState UiState;
+static sSceneTarget SceneTarget;
 
 // 渲染任务 - 使用render_task的图像优化方法
 void render_task(void* arg)
 {
-    TickType_t perf_start, perf_mlx_read, perf_compute, perf_render, perf_lcd;
-    
+    uint32_t frameStart;
+    uint32_t frameNo = 0;
+    sRenderFrame* pShown = NULL; // 正在显示的流水线帧，收到下一帧后归还给计算阶段
+    uint32_t requestedComputeSig = 0; // 已请求重新计算的设置签名，避免重复请求
+    int8_t queuedScope = profiler_Register("queued");
+    int8_t latencyScope = profiler_Register("latency");
+    int8_t sensorScope = profiler_Register("sensor2lcd");
+    uint32_t shownSeq = 0;       // 上一次显示的帧序号
+    uint32_t skippedFrames = 0;  // 序号不连续（没有显示过）的帧数
+
     printf("Render task started for thermal imaging display\n");
     
     // 分配图像缓冲区 - 使用屏幕尺寸和上下栏高度保持一致
-    const int pixelCount = THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT;
     const uint16_t top_bar_h = 20;   // 顶部标题栏高度（pixels）
     const uint16_t bottom_bar_h = 55; // 底部信息栏高度（pixels）
     const uint16_t hq_img_width = dispcolor_getWidth() - 20;   // 热成像显示宽度（与屏幕宽度一致）
     const uint16_t hq_img_height = dispcolor_getHeight() - top_bar_h - bottom_bar_h;  // 可用显示高度
     
-    TermoImage16 = heap_caps_malloc(pixelCount * sizeof(int16_t), MALLOC_CAP_8BIT);
-    TermoHqImage16 = heap_caps_malloc((hq_img_width * hq_img_height) * sizeof(int16_t), MALLOC_CAP_8BIT);
-    gaussBuff = heap_caps_malloc(((THERMALIMAGE_RESOLUTION_WIDTH * 2) * (THERMALIMAGE_RESOLUTION_HEIGHT * 2)) * sizeof(float), MALLOC_CAP_8BIT);
-    pPaletteImage = heap_caps_malloc((MAX_TEMP - MIN_TEMP) * TEMP_SCALE * sizeof(tRGBcolor), MALLOC_CAP_8BIT);
-    
-    if (!TermoImage16 || !TermoHqImage16 || !gaussBuff || !pPaletteImage) {
+    if (!scene_AllocScratch(&Scratch) || !StartRenderPipeline(hq_img_width, hq_img_height)) {
         printf("Failed to allocate image buffers!\n");
         vTaskDelete(NULL);
         return;
@@ -559,7 +434,7 @@ void render_task(void* arg)
                 dispcolor_DrawString(sub_x, sub_y, FONTID_6X8M, (uint8_t*)temp_sub, WHITE);
             }
 
-            st7789_update();
+            dispcolor_Update();
             vTaskDelay(frame_delay_ms / portTICK_PERIOD_MS);
         }
 
@@ -568,11 +443,32 @@ void render_task(void* arg)
         
         // 闪烁快门
         dispcolor_FillRect(0, 0, screen_w, screen_h, WHITE);
-        st7789_update();
+        dispcolor_Update();
         vTaskDelay(30 / portTICK_PERIOD_MS);
 
         dispcolor_ClearScreen();
-        st7789_update();
+        dispcolor_Update();
+    }
+
+    // 热成像显示区域（留出顶部和底部栏）
+    const uint16_t img_y_start = top_bar_h;
+    const uint16_t img_height = hq_img_height;  // 可用像素高度
+    const uint16_t img_width = hq_img_width;
+    const uint16_t img_x_start = (dispcolor_getWidth() - img_width) / 2;  // 居中显示
+
+    // 创建图层
+    const sSceneLayout layout = {
+        .top_bar_h = top_bar_h,
+        .bottom_bar_h = bottom_bar_h,
+        .img_x = img_x_start,
+        .img_y = img_y_start,
+        .img_w = img_width,
+        .img_h = img_height,
+    };
+    if (!scene_InitTarget(&SceneTarget, &layout)) {
+        printf("Failed to create render layers!\n");
+        vTaskDelete(NULL);
+        return;
     }
 
     // 从持久化设置中恢复十字线位置（如果设置里有的话）
@@ -581,25 +477,64 @@ void render_task(void* arg)
 
     // 主循环
     while (1) {
-        // 等待MLX90640数据更新或输入事件
+        // 输入事件只改变了界面状态：调色板、量程改变时请求计算阶段用上一帧重新计算，
+        // 其他只重绘输入改变了的部件（热图沿用上一帧），不等下一帧
+        ExpireOverlay();
+        UpdateRecordOverlay();
+        CollectUiState(&UiState);
+
+        uint32_t computeSig = scene_ComputeSignature(&UiState);
+        if ((pShown != NULL) && (computeSig != pShown->computeSig) && (computeSig != requestedComputeSig)) {
+            requestedComputeSig = computeSig;
+            xEventGroupSetBits(pHandleEventGroup, RENDER_Recompute);
+        }
+
+        PROFILE_BEGIN(ui);
+        if (scene_ComposeFrame(pShown ? &pShown->scene : NULL, &UiState, &SceneTarget)) {
+            dispcolor_Update();
+            PROFILE_END(ui);
+        }
+
+        // 等待计算阶段的新帧或输入事件
         // Wheel: 左拨=返回, 右拨/按下=确认进入菜单
         // SIQ02: 左转=向上, 右转=向下, 按下=确认
-        EventBits_t uxBitsToWaitFor = RENDER_MLX90640_NO0 | RENDER_MLX90640_NO1 |
+        EventBits_t uxBitsToWaitFor = RENDER_FrameReady |
                          RENDER_Wheel_Back | RENDER_Wheel_Confirm | RENDER_Wheel_Press |
                          RENDER_Encoder_Up | RENDER_Encoder_Down | RENDER_Encoder_Press;
         EventBits_t bits = xEventGroupWaitBits(pHandleEventGroup, uxBitsToWaitFor, pdTRUE, pdFALSE, portMAX_DELAY);
 
-        bool hasMlx = ((bits & RENDER_MLX90640_NO0) == RENDER_MLX90640_NO0) || ((bits & RENDER_MLX90640_NO1) == RENDER_MLX90640_NO1);
-        bool doRender = hasMlx || forceRender;
-        if (doRender) {
-            // 如果是强制重绘，清除请求标志（下次需要再次请求）
-            forceRender = false;
-            perf_start = xTaskGetTickCount();
+        // 从就绪队列取出计算阶段算好的最新一帧，更旧的帧直接归还
+        sRenderFrame* pNext = NULL;
+        if (bits & RENDER_FrameReady) {
+            sRenderFrame* pQueued;
+            while (xQueueReceive(ReadyFrames, &pQueued, 0) == pdTRUE) {
+                if (pNext != NULL) {
+                    xQueueSend(FreeFrames, &pNext, 0);
+                    PipelineDropped++;
+                }
+                pNext = pQueued;
+            }
+        }
+
+        if (pNext != NULL) {
+            frameStart = profiler_Now();
+            profiler_Record(queuedScope, frameStart - pNext->readyUs);
+
+            // 重新计算的帧序号不变；序号跳过的帧都没有显示过
+            uint32_t seq = pNext->scene.frame.FrameSeq;
+            if ((shownSeq != 0) && (seq > shownSeq + 1))
+                skippedFrames += seq - shownSeq - 1;
+            if (seq > shownSeq)
+                shownSeq = seq;
+
+            // 上一帧不再显示，归还给计算阶段
+            if (pShown != NULL)
+                ReturnShownFrame(pShown);
+            pShown = pNext;
 
             // 计算实际帧率
             frame_count++;
             TickType_t current_time = xTaskGetTickCount();
-            TickType_t render_start = current_time;  // 记录渲染开始时间
             
             if (last_fps_time == 0) {
                 last_fps_time = current_time;
@@ -612,365 +547,30 @@ void render_task(void* arg)
                 }
             }
 
-            if (pMlxData == NULL) {
-                printf("MLX90640 data not available\n");
-                continue;
-            }
-
-            // Use whichever frame buffer the MLX task just filled
-            int bufferIndex = (bits & RENDER_MLX90640_NO1) ? 1 : 0;
-            sMlxData* frame = &pMlxData[bufferIndex];
-            perf_mlx_read = xTaskGetTickCount();
-
-            // 计算最大温度、最小温度、中间温度 - 参考render_task.c
-            CalcTempFromMLX90640(frame);
+            // 最大温度、最小温度、中间温度等统计已在采集时计算
             // 记录原始帧的 min/max（用于按下确认时固定为当前实际量程）
-            lastFrameMinTemp = frame->minT;
-            lastFrameMaxTemp = frame->maxT;
-
-            // 使用自动刻度模式或手动模式
-            float minTemp, maxTemp;
-            if (settingsParms.AutoScaleMode) {
-                minTemp = frame->minT;
-                maxTemp = frame->maxT;
-            } else {
-                minTemp = settingsParms.minTempNew;
-                maxTemp = settingsParms.maxTempNew;
-            }
-
-            float tempRange = maxTemp - minTemp;
-            if (tempRange < 0.001f) {
-                tempRange = 1.0f; // 避免除零与极小范围
-            }
-            
-            // 生成伪彩色调色板 - 参考render_task.c的RedrawPalette
-            uint16_t paletteSteps = (uint16_t)(tempRange * TEMP_SCALE);
-            if (paletteSteps == 0) paletteSteps = 1;
-            getPalette(settingsParms.ColorScale, paletteSteps, pPaletteImage);
-            
-            // 将温度转换为整数数组 - 参考render_task.c
-            const int pixelCount = THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT;
-            for (int i = 0; i < pixelCount; i++) {
-                TermoImage16[i] = (int16_t)(frame->ThermoImage[i] * TEMP_SCALE);
-            }
-            
-            perf_compute = xTaskGetTickCount();
-
-            // 清除文字显示区域，避免重叠（使用屏幕尺寸而不是魔法数字）
-            dispcolor_FillRect(0, 0, dispcolor_getWidth(), top_bar_h, BLACK);      // 顶部标题区域
-            dispcolor_FillRect(0, dispcolor_getHeight() - bottom_bar_h, dispcolor_getWidth(), bottom_bar_h, BLACK);    // 底部信息区域
-            dispcolor_FillRect(0, 20, 10, dispcolor_getHeight() - 20, BLACK);      // 热成像左侧区域
-            dispcolor_FillRect(230, 20, 10, dispcolor_getHeight() - 20, BLACK);      // 热成像右侧区域
-
-
-            // 显示标题（根据字体高度垂直居中）
-            uint8_t* pTitleFont = font_GetFontStruct(FONTID_16F, 'A');
-            uint8_t titleFontH = font_GetCharHeight(pTitleFont);
-            int16_t title_y = (int16_t)((top_bar_h - titleFontH) / 2);
-            if (title_y < 0) title_y = 0;
-            // dispcolor_DrawString(10, title_y, FONTID_16F, (uint8_t*)"Thermal Camera", WHITE);
-            int16_t title_x = dispcolor_getStrWidth(FONTID_16F, "Palette 5");
-            title_x = (dispcolor_getWidth() - title_x) / 2;
-            
-            // 标题高亮改为背景灰色高亮（字体默认白色）
-            // 在子项选择模式下，将被选中的子项文字改为黑色以便在灰色背景上更加明显
-            uint16_t leftTitleColor = WHITE;
-            uint16_t centerTitleColor = WHITE;
-            uint16_t rightTitleColor = WHITE;
-
-            // 右侧显示温度单位指示
-            const char* tempUnitText = useFahrenheit ? FAHRENHEIT_SYMBOL : CELSIUS_SYMBOL;
-            int16_t tempUnitWidth = dispcolor_getStrWidth(FONTID_16F, tempUnitText);
-
-            // 如果焦点在标题区，绘制灰色背景以示高亮；在子项选择模式时只高亮子项
-            if (currentFocus == SECTION_TITLE) {
-                int16_t top_y = 0;
-                int16_t title_h = top_bar_h;
-                if (subItemMode) {
-                    // 计算每个子项的矩形并填充灰色
-                    if (currentTitleSubSelection == TITLE_SUB_LEFT) {
-                        // left area: around x=10, compute text width
-                        leftTitleColor = paletteSelectMode ? BLACK : WHITE;
-                        char buf[32];
-                        snprintf(buf, sizeof(buf), "Palette %d", settingsParms.ColorScale);
-                        int16_t w = dispcolor_getStrWidth(FONTID_16F, buf);
-                        dispcolor_FillRect(10, top_y, w + 6, title_h, GRAY);
-                    } else if (currentTitleSubSelection == TITLE_SUB_CENTER) {
-                        // center area: center text location at title_x+10
-                        // centerTitleColor = SelectMode ? BLACK : WHITE;
-                        const char* centerText = "fix_scale";
-                        int16_t w = dispcolor_getStrWidth(FONTID_16F, (char*)centerText);
-                        int16_t cx = title_x + 10;
-                        dispcolor_FillRect(cx - 2, top_y, w + 4, title_h, GRAY);
-                    } else if (currentTitleSubSelection == TITLE_SUB_RIGHT) {
-                        rightTitleColor = tempUnitSelectMode ? BLACK : WHITE;
-                        // right area: temp unit text at (230-tempUnitWidth)
-                        int16_t rx = 230 - tempUnitWidth - 2;
-                        dispcolor_FillRect(rx, top_y, tempUnitWidth + 2, title_h, GRAY);
-                    }
-                } else {
-                    // 整个标题区域高亮为灰色
-                    dispcolor_FillRect(10, 0, dispcolor_getWidth() - 20, top_bar_h, GRAY);
-                }
-            }
+            lastFrameMinTemp = pShown->scene.frame.minT;
+            lastFrameMaxTemp = pShown->scene.frame.maxT;
 
-            // 绘制标题文字（字体始终为白色）
-            dispcolor_DrawString(title_x + 10, title_y, FONTID_16F, (uint8_t*)"fix_scale", centerTitleColor);
-            // Show palette index same as simple menu (less verbose)
-            dispcolor_printf(10, title_y, FONTID_16F, leftTitleColor, "Palette %d", settingsParms.ColorScale);
-            dispcolor_DrawString(230 - tempUnitWidth, title_y, FONTID_16F, (uint8_t*)tempUnitText, rightTitleColor);
+            // 步骤3: 只把变化的图层合成到显存
+            // 热图和数据栏每帧重绘，其他部件只在界面状态改变时重绘
+            ExpireOverlay();
+            CollectUiState(&UiState);
 
-
-            // 使用高斯模糊+双线性插值优化 - 参考render_task.c的HQ3X_2X模式
-            // 计算热成像显示区域（留出顶部和底部栏）
-            const uint16_t img_y_start = top_bar_h;
-            const uint16_t img_height = hq_img_height;  // 可用像素高度
-            const uint16_t img_width = hq_img_width;
-            const uint16_t img_x_start = (dispcolor_getWidth() - img_width) / 2;  // 居中显示（通常为0）
-            
-            // 渲染路径选择：LOW_QUALITY_RENDER -> 使用 nearest-neighbor 快速缩放；否则使用高质量 Gauss + Bilinear
-            if (lowQualityRender) {
-                // 最近邻缩放：把原始 TermoImage16 映射到 TermoHqImage16
-                for (int row = 0; row < img_height; row++) {
-                    int src_row = (row * THERMALIMAGE_RESOLUTION_HEIGHT) / img_height;
-                    if (src_row >= THERMALIMAGE_RESOLUTION_HEIGHT) src_row = THERMALIMAGE_RESOLUTION_HEIGHT - 1;
-                    for (int col = 0; col < img_width; col++) {
-                        int src_col = (col * THERMALIMAGE_RESOLUTION_WIDTH) / img_width;
-                        if (src_col >= THERMALIMAGE_RESOLUTION_WIDTH) src_col = THERMALIMAGE_RESOLUTION_WIDTH - 1;
-                        TermoHqImage16[row * img_width + col] = TermoImage16[src_row * THERMALIMAGE_RESOLUTION_WIDTH + src_col];
-                    }
-                }
-            } else {
-                // 步骤1: 高斯模糊2倍放大
-                idwGauss(TermoImage16, THERMALIMAGE_RESOLUTION_WIDTH, THERMALIMAGE_RESOLUTION_HEIGHT, 2, gaussBuff);
-
-                // 步骤2: 双线性插值到指定区域
-                idwBilinear(gaussBuff, THERMALIMAGE_RESOLUTION_WIDTH * 2, THERMALIMAGE_RESOLUTION_HEIGHT * 2, 
-                           TermoHqImage16, img_width, img_height, 10 / 2);
-            }
-            
-            // 步骤3: 绘制高质量图像到指定区域
-            DrawHQImage(TermoHqImage16, pPaletteImage, paletteSteps, img_x_start, img_y_start, 
-                       img_width, img_height, minTemp, maxTemp);
-            
-            // 热图上的最大/最小标记和中心温度 - 参考render_task.c
-            if (settingsParms.TempMarkers) {
-                // 在屏幕中央显示温度（使用当前选择的温度单位）
-                DrawCenterTemp(img_x_start, img_y_start, img_width, img_height, frame->CenterTemp, useFahrenheit);
-                
-                // 标记最大最小点
-                // DrawMarkersHQ(frame, img_x_start, img_y_start, img_width, img_height);
-            }
-            
-            // 绘制十字线（如果启用）
-            if (showImageCrosshair) {
-                // 计算十字线位置：始终使用 cross_x/cross_y（即使退出 crosshairMode 也保持手动调节的位置）
-                int img_w = img_width;
-                int img_h = img_height;
-                // DrawHQImage uses (width - col - 1) + X horizontally inverted mapping
-                int display_x = img_x_start + (img_w - 1) - (cross_x * (img_w - 1) / (THERMALIMAGE_RESOLUTION_WIDTH - 1));
-                int display_y = img_y_start + (cross_y * (img_h - 1) / (THERMALIMAGE_RESOLUTION_HEIGHT - 1));
-
-                // 在十字线调整模式下，正在调整的轴用白色，另一轴用深灰色以便区分
-                uint16_t colorX = WHITE;  // 垂直线（调整 X 坐标）
-                uint16_t colorY = WHITE;  // 水平线（调整 Y 坐标）
-                if (crosshairMode) {
-                    if (crosshairAxisIsY) {
-                        // 正在调整 Y 轴，Y 轴（水平线）高亮，X 轴（垂直线）变暗
-                        colorX = RGB565(60, 60, 60);
-                        colorY = WHITE;
-                    } else {
-                        // 正在调整 X 轴，X 轴（垂直线）高亮，Y 轴（水平线）变暗
-                        colorX = WHITE;
-                        colorY = RGB565(60, 60, 60);
-                    }
-                }
-
-                // 绘制水平十字线（贯穿整个图像宽度）- 对应 Y 轴
-                dispcolor_DrawLine(img_x_start, display_y, img_x_start + img_w - 1, display_y, colorY);
-
-                // 绘制垂直十字线（贯穿整个图像高度）- 对应 X 轴
-                dispcolor_DrawLine(display_x, img_y_start, display_x, img_y_start + img_h - 1, colorX);
-            }
-            
-            perf_render = xTaskGetTickCount();
-            
-            if (settingsParms.RealTimeAnalysis) {
-                // 显示温度范围信息和帧率
-                // 改为背景灰色高亮；在子项选择模式下将选中文本改为黑色以便更好识别
-                uint16_t leftColor = WHITE;
-                uint16_t centerColor = WHITE;
-                uint16_t rightColor = WHITE;
-
-                // 如果焦点在底部数据区域，绘制灰色背景框以示高亮；子项选择时只高亮对应子区域
-                if (currentFocus == SECTION_DATA) {
-                    int16_t bar_top = dispcolor_getHeight() - bottom_bar_h;
-                    int16_t bar_h = bottom_bar_h;
-                    if (subItemMode) {
-                        if (currentDataSubSelection == DATA_SUB_LEFT) {
-                            // 左侧区域高亮（覆盖左侧统计文本区域）
-                            dispcolor_FillRect(10, bar_top, 64, bar_h, GRAY);
-                        } else if (currentDataSubSelection == DATA_SUB_CENTER) {
-                            // 中间绘图区（匹配绘图框 75..165）
-                            dispcolor_FillRect(75, bar_top, 165 - 75 + 1, bar_h, GRAY);
-                        } else if (currentDataSubSelection == DATA_SUB_RIGHT) {
-                            // 右侧区域高亮
-                            rightColor = channelSelectMode ? BLACK : WHITE;
-
-                            dispcolor_FillRect(170, bar_top, dispcolor_getWidth() - 170 - 10, bar_h, GRAY);
-                        }
-                    } else {
-                        // 整个底部区域高亮
-                        dispcolor_FillRect(10, bar_top, dispcolor_getWidth() - 20, bar_h, GRAY);
-                    }
-                }
-                
-                // 左侧显示：overall-std / overall-max / overall-min / overall-avg
-                {
-                    int cntAll = THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT;
-                    double sumall = 0.0;
-                    double sumsqall = 0.0;
-                    double omin = 1e30;
-                    double omax = -1e30;
-                    int valid = 0;
-                    for (int i = 0; i < cntAll; ++i) {
-                        float v = frame->ThermoImage[i];
-                        if (!isfinite(v)) continue;
-                        valid++;
-                        sumall += v;
-                        sumsqall += (double)v * (double)v;
-                        if (v < omin) omin = v;
-                        if (v > omax) omax = v;
-                    }
-                    double oavg = 0.0;
-                    double ostd = 0.0;
-                    if (valid > 0) {
-                        oavg = sumall / valid;
-                        double var = sumsqall / valid - oavg * oavg;
-                        if (var < 0) var = 0;
-                        ostd = sqrt(var);
-                    }
-
-                    // 如果使用华氏度，转换显示值（注意：标准差按比例放大，不加偏移）
-                    const char* dataUnit = useFahrenheit ? FAHRENHEIT_SYMBOL : CELSIUS_SYMBOL;
-                    double disp_ostd = ostd;
-                    double disp_omax = omax;
-                    double disp_omin = omin;
-                    double disp_oavg = oavg;
-                    if (useFahrenheit) {
-                        disp_ostd = ostd * 9.0 / 5.0;
-                        disp_omax = omax * 9.0 / 5.0 + 32.0;
-                        disp_omin = omin * 9.0 / 5.0 + 32.0;
-                        disp_oavg = oavg * 9.0 / 5.0 + 32.0;
-                    }
-
-                    dispcolor_printf(10, 190, FONTID_6X8M, leftColor, "std:%.2f%s", (float)disp_ostd, dataUnit);
-                    dispcolor_printf(10, 200, FONTID_6X8M, leftColor, "max:%.1f%s", (float)disp_omax, dataUnit);
-                    dispcolor_printf(10, 210, FONTID_6X8M, leftColor, "min:%.1f%s", (float)disp_omin, dataUnit);
-                    dispcolor_printf(10, 220, FONTID_6X8M, leftColor, "avg:%.2f%s", (float)disp_oavg, dataUnit);
-                }
-
-                // 在中间边框内绘制十字线的温度折线图（可在X轴中心行或Y轴中心列之间切换）
-                dispcolor_DrawRectangle(75, 190, 165, 235, centerColor); // 边框
-                {
-                    const int16_t box_x1 = 75, box_y1 = 190, box_x2 = 165, box_y2 = 235;
-                    const int16_t plot_margin = 2;
-                    const int16_t plot_x = box_x1 + plot_margin;
-                    const int16_t plot_y = box_y1 + plot_margin;
-                    const int16_t plot_w = (box_x2 - box_x1) - 2 * plot_margin;
-                    const int16_t plot_h = (box_y2 - box_y1) - 2 * plot_margin;
-
-                    // 使用当前显示范围作为 Y 轴范围
-                    float plot_min = minTemp;
-                    float plot_max = maxTemp;
-                    float plot_range = plot_max - plot_min;
-                    if (plot_range < 0.1f) plot_range = 1.0f;
-
-                    int16_t prev_px = -1, prev_py = -1;
-                    const int center_row = THERMALIMAGE_RESOLUTION_HEIGHT / 2;
-                    const int center_col = THERMALIMAGE_RESOLUTION_WIDTH / 2;
-
-                    // 折线图通道严格由底部数据区域的通道选择决定（plotChannelY）
-                    // 位置（哪一行/列）始终使用十字线位置 cross_x/cross_y（即使退出 crosshairMode 也保持手动调节的位置）
-                    bool useYPlot = plotChannelY;
-                    int target_row = cross_y;
-                    int target_col = cross_x;
-
-                    if (!useYPlot) {
-                        // X 通道：使用某一行（水平）
-                        for (int col = 0; col < THERMALIMAGE_RESOLUTION_WIDTH; col++) {
-                            float t = frame->ThermoImage[target_row * THERMALIMAGE_RESOLUTION_WIDTH + col];
-                            if (!isfinite(t)) continue;
-
-                            int16_t px = plot_x + (col * plot_w) / (THERMALIMAGE_RESOLUTION_WIDTH - 1);
-                            float norm = (t - plot_min) / plot_range;
-                            if (norm < 0.0f) norm = 0.0f;
-                            if (norm > 1.0f) norm = 1.0f;
-                            int16_t py = plot_y + plot_h - 1 - (int16_t)(norm * (plot_h - 1));
-
-                            if (prev_px >= 0) {
-                                dispcolor_DrawLine(prev_px, prev_py, px, py, RGB565(0, 255, 128));
-                            }
-                            prev_px = px;
-                            prev_py = py;
-                        }
-                    } else {
-                        // Y 通道：使用某一列（垂直），沿着行方向绘制到水平绘图区域
-                        for (int row = 0; row < THERMALIMAGE_RESOLUTION_HEIGHT; row++) {
-                            float t = frame->ThermoImage[row * THERMALIMAGE_RESOLUTION_WIDTH + target_col];
-                            if (!isfinite(t)) continue;
-
-                            int16_t px = plot_x + (row * plot_w) / (THERMALIMAGE_RESOLUTION_HEIGHT - 1);
-                            float norm = (t - plot_min) / plot_range;
-                            if (norm < 0.0f) norm = 0.0f;
-                            if (norm > 1.0f) norm = 1.0f;
-                            int16_t py = plot_y + plot_h - 1 - (int16_t)(norm * (plot_h - 1));
-
-                            if (prev_px >= 0) {
-                                dispcolor_DrawLine(prev_px, prev_py, px, py, RGB565(0, 255, 128));
-                            }
-                            prev_px = px;
-                            prev_py = py;
-                        }
-                    }
-
-                    // 在右下角显示 FPS（小字）
-                    char fpsStr[16];
-                    sprintf(fpsStr, "%.0f", actual_fps);
-                    dispcolor_printf(box_x2 - 28, box_y2 - 10, FONTID_6X8M, centerColor, "%s", fpsStr);
-                }
-
-                // 右侧显示：通道选择（X/Y）以及上量程和下量程
-                dispcolor_printf(170, 190, FONTID_6X8M, rightColor, "Chan:%c", (plotChannelY ? 'Y' : 'X'));
-                dispcolor_printf(170, 210, FONTID_6X8M, rightColor, "Hi:%.1f", maxTemp);
-                dispcolor_printf(170, 230, FONTID_6X8M, rightColor, "Lo:%.1f", minTemp);
-            } else {
-                // 清除底部区域避免残留旧数据
-                dispcolor_FillRect(0, dispcolor_getHeight() - bottom_bar_h, dispcolor_getWidth(), bottom_bar_h, BLACK);
-            }
-
-            DrawSectionFocus(currentFocus, top_bar_h, bottom_bar_h, img_y_start, img_height, fixScaleTempActive);
-            
-            // 在最终提交到LCD之前，如果有overlay提示则绘制
-            if (overlay_active) {
-                TickType_t now = xTaskGetTickCount();
-                if (now < overlay_expire_tick) {
-                    const int16_t msg_x = 140;
-                    const int16_t msg_y = 184;
-                    const int16_t msg_w = dispcolor_getWidth() - msg_x - 8;
-                    const int16_t msg_h = 32;
-                    dispcolor_FillRect(msg_x, msg_y, msg_w, msg_h, BLACK);
-                    if (overlay_line1[0]) dispcolor_printf(msg_x, msg_y, FONTID_6X8M, RGB565(255,128,0), "%s", overlay_line1);
-                    if (overlay_line2[0]) dispcolor_printf(msg_x, msg_y + 14, FONTID_6X8M, RGB565(200,200,200), "%s", overlay_line2);
-                } else {
-                    overlay_active = false;
-                    overlay_line1[0] = 0; overlay_line2[0] = 0;
-                }
-            }
+            PROFILE_BEGIN(compose);
+            scene_ComposeFrame(&pShown->scene, &UiState, &SceneTarget);
+            PROFILE_END(compose);
 
             // 更新显示
-            st7789_update();
-            perf_lcd = xTaskGetTickCount();
+            PROFILE_BEGIN(lcd);
+            dispcolor_Update();
+            PROFILE_END(lcd);
+
+            uint32_t frameEnd = profiler_Now();
+            profiler_Record(latencyScope, frameEnd - pShown->computeStartUs);
+            profiler_Record(sensorScope, frameEnd - pShown->scene.frame.TimestampUs);
+            profiler_SetFrameBudget((uint32_t)(1000000.0f / FPS_RATES[settingsParms.MLX90640FPS]));
+            profiler_FrameEnd(frameEnd - frameStart);
 
             // 检查临时 fix-scale 是否已到期，如果到期则恢复原始设置（不持久化）
             if (fixScaleTempActive) {
@@ -986,12 +586,11 @@ void render_task(void* arg)
 
                         fixScaleTempActive = false;
 
-                        // 显示提示并触发重绘
+                        // 显示提示（量程改变后主循环会请求重新计算）
                         snprintf(overlay_line1, sizeof(overlay_line1), "AutoScale restored");
                         overlay_line2[0] = '\0';
                         overlay_active = true;
                         overlay_expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(900);
-                        forceRender = true;
                     } else {
                         // 未超出范围：保留固定量程，延长检查时间（再过 1s 检查一次）并提示已保留
                         fixScaleExpireTick = now + pdMS_TO_TICKS(1000);
@@ -999,22 +598,43 @@ void render_task(void* arg)
                         overlay_line2[0] = '\0';
                         overlay_active = true;
                         overlay_expire_tick = now + pdMS_TO_TICKS(900);
-                        forceRender = true;
                     }
                 }
             }
             
             // 性能分析输出
-            if (frame_count % 30 == 0) { // 每30帧输出一次
-                uint32_t total_ms = pdTICKS_TO_MS(perf_lcd - perf_start);
-                uint32_t mlx_ms = pdTICKS_TO_MS(perf_mlx_read - perf_start);
-                uint32_t compute_ms = pdTICKS_TO_MS(perf_compute - perf_mlx_read);
-                uint32_t render_ms = pdTICKS_TO_MS(perf_render - perf_compute);
-                uint32_t lcd_ms = pdTICKS_TO_MS(perf_lcd - perf_render);
-                
-                printf("FPS: %.2f | Total: %lums | MLX: %lums | Compute: %lums | Render: %lums | LCD: %lums\n", 
-                    actual_fps, (unsigned long)total_ms, (unsigned long)mlx_ms, 
-                    (unsigned long)compute_ms, (unsigned long)render_ms, (unsigned long)lcd_ms);
+            // 每30帧输出一次帧率，每300帧输出一次各阶段统计
+            frameNo++;
+            if (frameNo % 30 == 0) {
+                sProfilerFrameStats frameStats;
+                profiler_GetFrameStats(&frameStats);
+                printf("FPS: %.2f | Frames: %lu | Over budget: %lu | Worst: %luus | Queue: %u/%d\n",
+                    actual_fps, (unsigned long)frameStats.frames, (unsigned long)frameStats.overBudget,
+                    (unsigned long)frameStats.worstUs, (unsigned)uxQueueMessagesWaiting(ReadyFrames), RENDER_PIPELINE_DEPTH);
+                printf("Seq: %lu | Skipped: %lu (sensor %lu, pipeline %lu)\n",
+                    (unsigned long)shownSeq, (unsigned long)skippedFrames,
+                    (unsigned long)mlx90640_GetDroppedFrames(), (unsigned long)PipelineDropped);
+
+                sSaveStats saveStats;
+                savetask_GetStats(&saveStats);
+                if (saveStats.submitted || saveStats.rejected) {
+                    printf("Save: %lu ok, %lu failed, %lu rejected | Depth: %u (max %u) | %lu KB/s\n",
+                        (unsigned long)saveStats.completed, (unsigned long)saveStats.failed, (unsigned long)saveStats.rejected,
+                        saveStats.depth, saveStats.maxDepth,
+                        saveStats.writeUs ? (unsigned long)((uint64_t)saveStats.bytesWritten * 1000 / saveStats.writeUs) : 0ul);
+                }
+
+                sRecordStats recordStats;
+                recordtask_GetStats(&recordStats);
+                if (recordStats.active) {
+                    printf("Record: %05ld%s | %lu frames (%lu key) | %lu dropped | %lu bytes | %lu B/s\n",
+                        (long)recordStats.fileIndex, SAVE_RECORDING_EXT, (unsigned long)recordStats.frames,
+                        (unsigned long)recordStats.keyFrames, (unsigned long)recordStats.dropped, (unsigned long)recordStats.bytes,
+                        recordStats.elapsedMs ? (unsigned long)((uint64_t)recordStats.bytes * 1000 / recordStats.elapsedMs) : 0ul);
+                }
+            }
+            if (frameNo % 300 == 0) {
+                profiler_Print();
             }
         }
         
@@ -1035,7 +655,6 @@ void render_task(void* arg)
                 snprintf(overlay_line2, sizeof(overlay_line2), "Enc:move  Right:axis  Left:exit");
                 overlay_active = true;
                 overlay_expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(800);
-                forceRender = true;
                 continue;
             // 如果当前已经处于十字线模式，则右拨切换调整轴（X/Y）
             } else if (currentFocus == SECTION_IMAGE && crosshairMode) {
@@ -1045,7 +664,6 @@ void render_task(void* arg)
                 overlay_line2[0] = '\0';
                 overlay_active = true;
                 overlay_expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(400);
-                forceRender = true;
                 continue;
             }
             if (currentFocus == SECTION_LOCK && !subItemMode) {
@@ -1114,7 +732,6 @@ void render_task(void* arg)
                 overlay_line2[0] = '\0';
                 overlay_active = true;
                 overlay_expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(400);
-                forceRender = true;
                 // 保存十字线位置到持久化设置
                 settingsParms.CrossX = (uint8_t)cross_x;
                 settingsParms.CrossY = (uint8_t)cross_y;
@@ -1130,6 +747,8 @@ void render_task(void* arg)
                 menu_run_simple();
                 settings_write_all();
                 dispcolor_ClearScreen();
+                // 菜单直接改写了显存，所有图层需要重新合成
+                compositor_InvalidateAll();
             }
         }
         
@@ -1155,11 +774,7 @@ void render_task(void* arg)
                 } else {
                     if (cross_x < (THERMALIMAGE_RESOLUTION_WIDTH - 1)) cross_x++;
                 }
-                // 实时绘制下方折线和十字线提示（如果有最新帧数据）
-                if (pMlxData != NULL) {
-                    // 不在此处直接绘制，由渲染循环统一绘制
-                    forceRender = true;
-                }
+                // 不在此处直接绘制，由主循环对比界面状态后重绘十字线和下方折线
             } else if (subItemMode) {
                 // 子项模式：编码器切换子项（不直接切换通道，需先进入 channelSelectMode）
                 if (currentFocus == SECTION_TITLE) {
@@ -1192,10 +807,6 @@ void render_task(void* arg)
                 } else {
                     if (cross_x > 0) cross_x--;
                 }
-                if (pMlxData != NULL) {
-                    // 请求渲染循环更新显示（不在这里直接绘制）
-                    forceRender = true;
-                }
             } else if (subItemMode) {
                 // 子项模式：编码器切换子项（不直接切换通道，需先进入 channelSelectMode）
                 if (currentFocus == SECTION_TITLE) {
@@ -1210,27 +821,33 @@ void render_task(void* arg)
             }
         }
         
-        // SIQ02 编码器按下：在图像区域按下则保存当前屏幕为BMP到SD卡（使用现有save模块）
+        // SIQ02 编码器按下：在图像区域按下则把当前屏幕交给存储任务保存为QOI压缩截图，实时画面不等待写文件
         if (bits & RENDER_Encoder_Press) {
             if (currentFocus == SECTION_IMAGE) {
-                // 尝试保存24位BMP（full color）
-                int save_ret = save_ImageBMP(24);
-                if (save_ret == 0) {
-                    // 成功，显示短暂覆盖提示
-                    snprintf(overlay_line1, sizeof(overlay_line1), "Screenshot saved to SPIFFS");
-                    overlay_line2[0] = '\0';
-                    overlay_active = true;
-                    overlay_expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(900);
-                    forceRender = true;
+                int save_ret = savetask_Submit(SAVE_JOB_QOI, 0, false, NULL);
+                if (save_ret == SAVE_OK) {
+                    snprintf(overlay_line1, sizeof(overlay_line1), "Saving screenshot...");
                 } else {
-                    // 失败，save_ImageBMP 已用 message_show 报错，这里也用覆盖提示以便在不插SD的情况下提醒
-                    snprintf(overlay_line1, sizeof(overlay_line1), "Save failed");
-                    overlay_line2[0] = '\0';
-                    overlay_active = true;
-                    overlay_expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(900);
-                    forceRender = true;
+                    snprintf(overlay_line1, sizeof(overlay_line1), "Save failed: %s", save_ErrorStr(save_ret));
                 }
+                overlay_line2[0] = '\0';
+                overlay_active = true;
+                overlay_expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(900);
+            }
+        }
+
+        // 存储任务写完后用覆盖提示报告结果
+        sSaveResult saveResult;
+        if (savetask_PollResult(&saveResult)) {
+            if (saveResult.result == SAVE_OK) {
+                snprintf(overlay_line1, sizeof(overlay_line1), "Saved %05ld%s", (long)saveResult.fileIndex,
+                    savetask_Extension(saveResult.type));
+            } else {
+                snprintf(overlay_line1, sizeof(overlay_line1), "Save failed: %s", save_ErrorStr(saveResult.result));
             }
+            overlay_line2[0] = '\0';
+            overlay_active = true;
+            overlay_expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(900);
         }
 
         // 不需要额外延迟，xEventGroupWaitBits已经会等待新数据
@@ -0,0 +1,264 @@
+#include "save_task.h"
+#include "save.h"
+#include "dispcolor.h"
+#include "profiler.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 一个保存任务：数据已经复制到缓冲池中的 pBuff
+typedef struct {
+    eSaveJob type;
+    uint8_t bits; // BMP 位数
+    uint8_t* pBuff; // 缓冲池中的缓冲区，写完后归还
+    uint32_t size; // 有效字节数
+    uint16_t width; // 截图尺寸
+    uint16_t height;
+    TaskHandle_t waiter; // 等待写完的任务，NULL 表示结果放入结果队列
+    sSaveResult* pResult; // waiter 的结果
+} sSaveJobItem;
+
+static QueueHandle_t SaveJobs = NULL; // 等待写入的任务
+static QueueHandle_t FreeBuffers = NULL; // 空闲的缓冲区
+static QueueHandle_t SaveResults = NULL; // 不等待的任务的结果
+static uint32_t BufferSize = 0;
+
+static portMUX_TYPE StatsLock = portMUX_INITIALIZER_UNLOCKED;
+static sSaveStats Stats;
+
+/**
+ * @brief 更新排队深度
+ *
+ * @param delta +1 排队，-1 写完
+ */
+static void savetask_addDepth(int8_t delta)
+{
+    taskENTER_CRITICAL(&StatsLock);
+    Stats.depth += delta;
+    if (Stats.depth > Stats.maxDepth)
+        Stats.maxDepth = Stats.depth;
+    if (delta > 0)
+        Stats.submitted++;
+    taskEXIT_CRITICAL(&StatsLock);
+}
+
+/**
+ * @brief 写入一个任务
+ *
+ * @param pJob
+ * @param pResult
+ */
+static void savetask_write(const sSaveJobItem* pJob, sSaveResult* pResult)
+{
+    uint32_t startUs = profiler_Now();
+
+    pResult->type = pJob->type;
+    pResult->fileIndex = 0;
+    pResult->bytes = pJob->size;
+
+    if (pJob->type == SAVE_JOB_BMP)
+        pResult->result = save_WriteBmp((const uint16_t*)pJob->pBuff, pJob->width, pJob->height, pJob->bits, &pResult->fileIndex);
+    else if (pJob->type == SAVE_JOB_QOI)
+        pResult->result = save_WriteQoi((const uint16_t*)pJob->pBuff, pJob->width, pJob->height, &pResult->fileIndex);
+    else
+        pResult->result = save_WriteFile(SAVE_SNAPSHOT_EXT, pJob->pBuff, pJob->size, &pResult->fileIndex);
+
+    pResult->writeUs = profiler_Now() - startUs;
+}
+
+/**
+ * @brief 存储任务：依次写入排队的任务，写完后归还缓冲区并报告结果
+ *
+ * @param arg
+ */
+static void save_task(void* arg)
+{
+    (void)arg;
+    sSaveJobItem job;
+
+    while (1) {
+        if (xQueueReceive(SaveJobs, &job, portMAX_DELAY) != pdTRUE)
+            continue;
+
+        sSaveResult result;
+        savetask_write(&job, &result);
+
+        // 先归还缓冲区，队列满时下一次截图可以马上排队
+        xQueueSend(FreeBuffers, &job.pBuff, 0);
+
+        taskENTER_CRITICAL(&StatsLock);
+        Stats.depth--;
+        if (result.result == SAVE_OK) {
+            Stats.completed++;
+            Stats.bytesWritten += result.bytes;
+            Stats.writeUs += result.writeUs;
+        } else {
+            Stats.failed++;
+        }
+        taskEXIT_CRITICAL(&StatsLock);
+
+        printf("Save %s: %s, %lu bytes in %lu us\r\n", savetask_Extension(job.type),
+            save_ErrorStr(result.result), (unsigned long)result.bytes, (unsigned long)result.writeUs);
+
+        if (job.waiter != NULL) {
+            *job.pResult = result;
+            xTaskNotifyGive(job.waiter);
+        } else if (xQueueSend(SaveResults, &result, 0) != pdTRUE) {
+            // 没有人取结果时丢弃最旧的一个
+            sSaveResult stale;
+            xQueueReceive(SaveResults, &stale, 0);
+            xQueueSend(SaveResults, &result, 0);
+        }
+    }
+}
+
+/**
+ * @brief 保存任务类型对应的文件扩展名
+ *
+ * @param type
+ * @return const char*
+ */
+const char* savetask_Extension(eSaveJob type)
+{
+    switch (type) {
+    case SAVE_JOB_BMP:
+        return SAVE_BMP_EXT;
+    case SAVE_JOB_QOI:
+        return SAVE_QOI_EXT;
+    default:
+        return SAVE_SNAPSHOT_EXT;
+    }
+}
+
+/**
+ * @brief 分配缓冲池并启动存储任务（dispcolor 已初始化）
+ *
+ * @return true 成功
+ */
+bool savetask_Init(void)
+{
+    if (SaveJobs != NULL)
+        return true;
+
+    BufferSize = dispcolor_getWidth() * dispcolor_getHeight() * sizeof(uint16_t);
+    if (BufferSize < save_SnapshotSize())
+        BufferSize = save_SnapshotSize();
+
+    SaveJobs = xQueueCreate(SAVE_QUEUE_DEPTH, sizeof(sSaveJobItem));
+    FreeBuffers = xQueueCreate(SAVE_POOL_SIZE, sizeof(uint8_t*));
+    SaveResults = xQueueCreate(SAVE_QUEUE_DEPTH, sizeof(sSaveResult));
+    if (!SaveJobs || !FreeBuffers || !SaveResults)
+        return false;
+
+    // 缓冲池优先使用 PSRAM
+    uint8_t count = 0;
+    for (int i = 0; i < SAVE_POOL_SIZE; i++) {
+        uint8_t* pBuff = heap_caps_malloc(BufferSize, MALLOC_CAP_SPIRAM);
+        if (!pBuff)
+            pBuff = malloc(BufferSize);
+        if (!pBuff)
+            break;
+        xQueueSend(FreeBuffers, &pBuff, 0);
+        count++;
+    }
+    if (count == 0) {
+        printf("Save pool: out of memory\r\n");
+        return false;
+    }
+
+    return xTaskCreatePinnedToCore(save_task, "save", 1024 * 4, NULL, tskIDLE_PRIORITY + 1, NULL, tskNO_AFFINITY) == pdPASS;
+}
+
+/**
+ * @brief 复制数据到缓冲池并排队
+ *
+ * @param type
+ * @param bits BMP 位数
+ * @param wait 是否等待写完
+ * @param pResult wait 时的写入结果
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+int savetask_Submit(eSaveJob type, uint8_t bits, bool wait, sSaveResult* pResult)
+{
+    sSaveJobItem job = {
+        .type = type,
+        .bits = bits,
+        .waiter = wait ? xTaskGetCurrentTaskHandle() : NULL,
+        .pResult = pResult,
+    };
+
+    if (SaveJobs == NULL)
+        return SAVE_ERR_MEMORY;
+
+    // 缓冲池空了说明存储任务跟不上，直接拒绝，不阻塞调用者
+    if (xQueueReceive(FreeBuffers, &job.pBuff, 0) != pdTRUE) {
+        taskENTER_CRITICAL(&StatsLock);
+        Stats.rejected++;
+        taskEXIT_CRITICAL(&StatsLock);
+        return SAVE_ERR_BUSY;
+    }
+
+    if ((type == SAVE_JOB_BMP) || (type == SAVE_JOB_QOI)) {
+        job.width = dispcolor_getWidth();
+        job.height = dispcolor_getHeight();
+        job.size = job.width * job.height * sizeof(uint16_t);
+        if (!dispcolor_getScreenData((uint16_t*)job.pBuff)) {
+            xQueueSend(FreeBuffers, &job.pBuff, 0);
+            return SAVE_ERR_SCREEN;
+        }
+    } else {
+        job.size = save_BuildSnapshot(job.pBuff, BufferSize);
+        if (job.size == 0) {
+            xQueueSend(FreeBuffers, &job.pBuff, 0);
+            return SAVE_ERR_NODATA;
+        }
+    }
+
+    savetask_addDepth(1);
+    if (wait)
+        ulTaskNotifyTake(pdTRUE, 0); // 清除以前残留的通知
+    if (xQueueSend(SaveJobs, &job, 0) != pdTRUE) {
+        xQueueSend(FreeBuffers, &job.pBuff, 0);
+        taskENTER_CRITICAL(&StatsLock);
+        Stats.depth--;
+        Stats.submitted--;
+        Stats.rejected++;
+        taskEXIT_CRITICAL(&StatsLock);
+        return SAVE_ERR_BUSY;
+    }
+
+    if (!wait)
+        return SAVE_OK;
+
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return pResult->result;
+}
+
+/**
+ * @brief 取出一个已完成的保存结果
+ *
+ * @param pResult
+ * @return true 有结果
+ */
+bool savetask_PollResult(sSaveResult* pResult)
+{
+    if (SaveResults == NULL)
+        return false;
+    return xQueueReceive(SaveResults, pResult, 0) == pdTRUE;
+}
+
+/**
+ * @brief 读取统计
+ *
+ * @param pStats
+ */
+void savetask_GetStats(sSaveStats* pStats)
+{
+    taskENTER_CRITICAL(&StatsLock);
+    *pStats = Stats;
+    taskEXIT_CRITICAL(&StatsLock);
+}
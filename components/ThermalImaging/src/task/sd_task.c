@@ -1,4 +1,6 @@
-#include "thermalimaging.h"
+#include "thermalimaging_simple.h"
+#include "sd_task.h"
+#include "sdstream_task.h"
 
 #include <driver/gpio.h>
 #include <driver/sdmmc_host.h>
@@ -6,7 +8,8 @@
 #include <esp_vfs_fat.h>
 #include <sdmmc_cmd.h>
 
-// SD卡挂载句�?static sdmmc_card_t* pCardHandler = NULL;
+// SD卡挂载句柄
+static sdmmc_card_t* pCardHandler = NULL;
 
 #define SD_PIN_NUM_MOSI CONFIG_SDCARD_IONUM_MOSI
 #define SD_PIN_NUM_MISO CONFIG_SDCARD_IONUM_MISO
@@ -15,16 +18,13 @@
 #define SD_PIN_NUM_CD CONFIG_SDCARD_IONUM_CD // GPIO插入中断
 
 #ifdef CONFIG_SDCARD_HSPI
-#define SD_SPI_SLOT SPI2_HOST // hspi  
+#define SD_SPI_SLOT SPI2_HOST // hspi
 #elif CONFIG_SDCARD_VSPI
 #define SD_SPI_SLOT SPI3_HOST // vspi
 #else
 #define SD_SPI_SLOT SPI2_HOST // default to SPI2
 #endif
 
-// 挂载位置
-#define MOUNT_POINT "/sdcard"
-
 #if CONFIG_IDF_TARGET_ESP32S2 || CONFIG_IDF_TARGET_ESP32S3
 #define SPI_DMA_CHAN SPI_DMA_CH_AUTO
 #elif CONFIG_IDF_TARGET_ESP32C3
@@ -36,7 +36,8 @@
 static TaskHandle_t xHandleSDCard = NULL; // 任务通知
 
 /**
- * @brief SD卡是否挂�? *
+ * @brief SD卡是否挂载
+ *
  * @return uint8_t
  */
 uint8_t sdcardIsMount()
@@ -49,22 +50,27 @@ uint8_t sdcardIsMount()
 
 #ifdef CONFIG_ESP32_SPI_SDCARD
 /**
- * @brief SD卡卸�? *
+ * @brief SD卡卸载（先关闭正在流式写入的文件）
+ *
+ * 流式写入任务还卡在对拔出的卡的写入里时不卸载（文件系统还在用），SD 卡任务稍后重试
  */
 static void sd_umount()
 {
     if (NULL != pCardHandler) {
+        if (!sdstreamtask_Eject())
+            return;
         xSemaphoreTake(pSPIMutex, portMAX_DELAY);
-        esp_vfs_fat_sdcard_unmount(MOUNT_POINT, pCardHandler);
+        esp_vfs_fat_sdcard_unmount(SD_MOUNT_POINT, pCardHandler);
         spi_bus_free(SD_SPI_SLOT);
         xSemaphoreGive(pSPIMutex);
         pCardHandler = NULL;
-        tips_printf("SD Card UnMount Success");
+        printf("SD Card UnMount Success\r\n");
     }
 }
 
 /**
- * @brief SD卡初始化并挂�? *
+ * @brief SD卡初始化并挂载
+ *
  * @return esp_err_t
  */
 static esp_err_t sd_CardInit()
@@ -79,19 +85,13 @@ static esp_err_t sd_CardInit()
     esp_vfs_fat_sdmmc_mount_config_t mount_config = {
         .format_if_mount_failed = false,
         .max_files = 5,
-        .allocation_unit_size = 16 * 1024
+        .allocation_unit_size = SDSTREAM_BUFFER_SIZE
     };
 
     sdmmc_host_t host = SDSPI_HOST_DEFAULT();
     host.slot = SD_SPI_SLOT;
-    host.max_freq_khz = 4000;
-
-    // sdspi_slot_config_t slot_config = SDSPI_SLOT_CONFIG_DEFAULT();
-    // slot_config.gpio_miso = SD_PIN_NUM_MISO;
-    // slot_config.gpio_mosi = SD_PIN_NUM_MOSI;
-    // slot_config.gpio_sck = SD_PIN_NUM_CLK;
-    // slot_config.gpio_cs = SD_PIN_NUM_CS;
-    // slot_config.dma_channel = 2;
+    // 流式写入需要带宽：SPI 模式的默认最高频率（20MHz）
+    host.max_freq_khz = SDMMC_FREQ_DEFAULT;
 
     spi_bus_config_t bus_cfg = {
         .mosi_io_num = SD_PIN_NUM_MOSI,
@@ -115,9 +115,10 @@ static esp_err_t sd_CardInit()
     slot_config.gpio_cs = SD_PIN_NUM_CS;
     slot_config.host_id = host.slot;
 
-    ret = esp_vfs_fat_sdspi_mount(MOUNT_POINT, &host, &slot_config, &mount_config, &pCardHandler);
+    ret = esp_vfs_fat_sdspi_mount(SD_MOUNT_POINT, &host, &slot_config, &mount_config, &pCardHandler);
     if (ret != ESP_OK) {
         pCardHandler = NULL;
+        spi_bus_free(host.slot);
         if (ret == ESP_FAIL)
             printf("Failed to mount filesystem.\r\nIf you want the pCardHandler to be formatted,\r\nset format_if_mount_failed = true.\r\n");
         else
@@ -131,11 +132,12 @@ static esp_err_t sd_CardInit()
 error:
     xSemaphoreGive(pSPIMutex);
 
-    return ESP_OK;
+    return ret;
 }
 
 /**
- * @brief 获取SD卡剩余空�? *
+ * @brief 获取SD卡剩余空间
+ *
  * @param pFreeMb
  * @param pTotalMb
  * @return int8_t
@@ -154,9 +156,11 @@ static int8_t sd_GetFree(uint32_t* pFreeMb, uint32_t* pTotalMb)
         return -1;
 
     // Get total sectors and free sectors
-    tot_sect = (fs->n_fatent - 2) * fs->csize; // 总空�?    fre_sect = fre_clust * fs->csize; // 剩余空间
+    tot_sect = (fs->n_fatent - 2) * fs->csize; // 总空间
+    fre_sect = fre_clust * fs->csize; // 剩余空间
 
-    // 总空�?    tot_sect /= 1024;
+    // 总空间
+    tot_sect /= 1024;
     tot_sect *= pCardHandler->csd.sector_size;
     tot_sect /= 1024;
 
@@ -192,17 +196,18 @@ static void sdcardOperate(void)
     int32_t level = gpio_get_level(SD_PIN_NUM_CD);
 
     if (0 == level && NULL == pCardHandler) {
-        // 挂载SD�?        if (sd_CardInit() == ESP_OK) {
+        // 挂载SD卡
+        if (sd_CardInit() == ESP_OK) {
             uint32_t FreeMb, TotalMb;
             int8_t err = sd_GetFree(&FreeMb, &TotalMb);
             if (!err) {
-                printf("Available %d MB Total %d MB\r\n", FreeMb, TotalMb);
-                tips_printf("SD Card Mount Success! Available %d MB", FreeMb);
+                printf("SD Card Mount Success! Available %lu MB Total %lu MB\r\n", (unsigned long)FreeMb, (unsigned long)TotalMb);
             }
         }
 
     } else if (1 == level && NULL != pCardHandler) {
-        // 卸载SD�?        sd_umount();
+        // 卸载SD卡
+        sd_umount();
     }
 }
 
@@ -214,20 +219,30 @@ static void sdcardOperate(void)
 static void prvSDCardTask(void* pvParameters)
 {
     while (true) {
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // 卡已拔出但还没卸载（流式写入任务没有及时关闭文件）时每秒重试
+        bool pending = (1 == gpio_get_level(SD_PIN_NUM_CD)) && (NULL != pCardHandler);
+        ulTaskNotifyTake(pdTRUE, pending ? pdMS_TO_TICKS(1000) : portMAX_DELAY);
+        // 拔卡时不等消抖，马上停止流式写入（之后对卡的写入都会失败）
+        if ((1 == gpio_get_level(SD_PIN_NUM_CD)) && (NULL != pCardHandler))
+            sdstreamtask_Eject();
         vTaskDelay(1000 / portTICK_PERIOD_MS); // 消抖
         sdcardOperate();
     }
 }
 
 /**
- * @brief  GPIO配置为中断输入模式。并�?引脚序号、中断类型、上拉方式、下拉方式、isr中断服务函数 进行配置�? *
- * @param  gpio_num GPIO管脚编号�?~19�?1~23�?5~27�?2~39
- *                  （ESP32共有34个GPIO，其�?34~39 仅用作输入）
- * @param  pullup_en    上拉电阻使能与否�?/1
- * @param  pulldown_en  下拉电阻使能与否�?/1
+ * @brief  GPIO配置为中断输入模式。并对 引脚序号、中断类型、上拉方式、下拉方式、isr中断服务函数 进行配置。
+ *
+ * @param  gpio_num GPIO管脚编号
+ * @param  pullup_en    上拉电阻使能与否：0/1
+ * @param  pulldown_en  下拉电阻使能与否：0/1
  * @param  intr_type    中断触发类型
- *                      - GPIO_PIN_INTR_POSEDGE  上升沿中�? *                      - GPIO_PIN_INTR_NEGEDGE  下降沿中�? *                      - GPIO_PIN_INTR_ANYEDGE  双边沿中�? *                      - GPIO_PIN_INTR_LOLEVEL  低电平中�? *                      - GPIO_PIN_INTR_HILEVEL  高电平中�? * @param  isr_handler  ISR中断处理服务函数
+ *                      - GPIO_INTR_POSEDGE  上升沿中断
+ *                      - GPIO_INTR_NEGEDGE  下降沿中断
+ *                      - GPIO_INTR_ANYEDGE  双边沿中断
+ *                      - GPIO_INTR_LOW_LEVEL  低电平中断
+ *                      - GPIO_INTR_HIGH_LEVEL  高电平中断
+ * @param  isr_handler  ISR中断处理服务函数
  *
  * @return
  *     - none
@@ -238,14 +253,19 @@ static void gpiox_set_intr_input(uint32_t gpio_num, uint32_t pullup_en, uint32_t
         gpio_config_t io_conf;
         // IO中断类型：intr_type
         io_conf.intr_type = intr_type;
-        // IO模式：输�?        io_conf.mode = GPIO_MODE_INPUT;
-        // bit mask of the pins that you want to set,e.g.GPIO18/19 配置GPIO_OUT寄存�?        io_conf.pin_bit_mask = (1ULL << gpio_num);
-        //下拉电阻：禁�?        io_conf.pull_down_en = pulldown_en;
-        //上拉电阻：禁�?        io_conf.pull_up_en = pullup_en;
+        // IO模式：输入
+        io_conf.mode = GPIO_MODE_INPUT;
+        // bit mask of the pins that you want to set,e.g.GPIO18/19 配置GPIO_OUT寄存器
+        io_conf.pin_bit_mask = (1ULL << gpio_num);
+        //下拉电阻
+        io_conf.pull_down_en = pulldown_en;
+        //上拉电阻
+        io_conf.pull_up_en = pullup_en;
         //使用给定设置配置GPIO
         gpio_config(&io_conf);
 
-        //安装GPIO ISR处理程序服务。为所有GPIO中断注册一个全局ISR，并通过gpio_isr_handler_add（）函数注册各个引脚处理程序�?        gpio_install_isr_service(0);
+        //安装GPIO ISR处理程序服务。为所有GPIO中断注册一个全局ISR，并通过gpio_isr_handler_add（）函数注册各个引脚处理程序。
+        gpio_install_isr_service(0);
         //添加中断回调处理函数
         gpio_isr_handler_add(gpio_num, isr_handler, (void*)gpio_num);
     }
@@ -253,10 +273,11 @@ static void gpiox_set_intr_input(uint32_t gpio_num, uint32_t pullup_en, uint32_t
 
 void sdcard_task(void* arg)
 {
-    gpiox_set_intr_input(SD_PIN_NUM_CD, GPIO_PULLUP_ENABLE, GPIO_PULLDOWN_DISABLE, GPIO_PIN_INTR_ANYEDGE, gpio_isr_handler);
-    sdcardOperate();
-
+    sdstreamtask_Init();
     xTaskCreate(prvSDCardTask, "sdcard", 1024 * 5, NULL, tskIDLE_PRIORITY, &xHandleSDCard);
+
+    gpiox_set_intr_input(SD_PIN_NUM_CD, GPIO_PULLUP_ENABLE, GPIO_PULLDOWN_DISABLE, GPIO_INTR_ANYEDGE, gpio_isr_handler);
+    sdcardOperate();
 }
 
 #endif // CONFIG_ESP32_SPI_SDCARD
@@ -0,0 +1,631 @@
+#include "sdstream_task.h"
+#include "save.h"
+#include "sd_task.h"
+#include <dirent.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+// 写入测试：64Hz 的原始温度帧（32x24 个 float）
+#define SDSTREAM_BENCH_FRAME_SIZE (32 * 24 * sizeof(float))
+#define SDSTREAM_BENCH_RAW_RATE (SDSTREAM_BENCH_FRAME_SIZE * 64)
+#define SDSTREAM_BENCH_FRAME_US (1000000 / 64)
+#define SDSTREAM_BENCH_MAX_CALLS (SDSTREAM_BENCH_SD_SIZE / SDSTREAM_BENCH_FRAME_SIZE + 1)
+
+typedef enum {
+    SDSTREAM_CMD_OPEN = 0,
+    SDSTREAM_CMD_WRITE,
+    SDSTREAM_CMD_CLOSE,
+    SDSTREAM_CMD_EJECT,
+} eSdStreamCmd;
+
+typedef struct {
+    eSdStreamCmd cmd;
+    uint8_t* pBuffer; // SDSTREAM_CMD_WRITE 的缓冲，写完后归还
+    size_t size;
+    TaskHandle_t waiter; // 等待命令完成的任务
+} sSdStreamItem;
+
+static QueueHandle_t Items = NULL; // 写满的缓冲和命令
+static QueueHandle_t FreeBuffers = NULL; // 空闲的缓冲
+static bool BuffersReady = false;
+static SemaphoreHandle_t EjectDone = NULL; // 拔卡命令处理完（SD 卡任务不用任务通知等待，它的通知留给卡检测中断）
+
+// 调用者一侧
+static volatile bool Open = false;
+static uint8_t* pCurrent = NULL; // 正在填的缓冲
+static size_t CurrentUsed = 0;
+static char Path[32];
+
+// 写入任务一侧
+static FILE* StreamFile = NULL;
+static uint32_t Prealloc = 0; // 已预分配的文件长度
+static int CommandResult = SAVE_OK; // 最近一次命令的结果
+
+static portMUX_TYPE StatsLock = portMUX_INITIALIZER_UNLOCKED;
+static sSdStreamStats Stats;
+
+/**
+ * @brief 在可以 DMA 的内部 RAM 中分配缓冲（SPI 驱动对不能 DMA 的缓冲按扇区逐个复制写入，慢得多）
+ *
+ * @return true 成功
+ */
+static bool sdstreamtask_allocBuffers(void)
+{
+    if (BuffersReady)
+        return true;
+
+    uint8_t* pBuffers[SDSTREAM_BUFFER_COUNT] = { NULL };
+    for (int i = 0; i < SDSTREAM_BUFFER_COUNT; i++) {
+        pBuffers[i] = heap_caps_malloc(SDSTREAM_BUFFER_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (pBuffers[i] == NULL) {
+            printf("SD stream: out of memory\r\n");
+            for (int j = 0; j < i; j++)
+                free(pBuffers[j]);
+            return false;
+        }
+    }
+
+    for (int i = 0; i < SDSTREAM_BUFFER_COUNT; i++)
+        xQueueSend(FreeBuffers, &pBuffers[i], 0);
+    BuffersReady = true;
+    return true;
+}
+
+static int sdstreamtask_error(void)
+{
+    taskENTER_CRITICAL(&StatsLock);
+    int err = Stats.lastError;
+    taskEXIT_CRITICAL(&StatsLock);
+    return err;
+}
+
+static void sdstreamtask_setError(int err)
+{
+    taskENTER_CRITICAL(&StatsLock);
+    if (Stats.lastError == SAVE_OK)
+        Stats.lastError = err;
+    taskEXIT_CRITICAL(&StatsLock);
+}
+
+/**
+ * @brief 把文件预分配到 size（FatFs 在写模式下把位置移到文件末尾之后时分配簇并扩展文件），之后的写入不再分配簇
+ *
+ * @param size
+ * @return true 成功（空间不足时只分配了一部分，返回 false）
+ */
+static bool sdstreamtask_prealloc(uint32_t size)
+{
+    long pos = ftell(StreamFile);
+    bool ok = (fseek(StreamFile, size, SEEK_SET) == 0) && (ftell(StreamFile) == (long)size);
+    if (fseek(StreamFile, pos, SEEK_SET) != 0)
+        ok = false;
+
+    if (ok) {
+        Prealloc = size;
+        taskENTER_CRITICAL(&StatsLock);
+        Stats.preallocs++;
+        taskEXIT_CRITICAL(&StatsLock);
+    }
+    return ok;
+}
+
+/**
+ * @brief 创建文件并预分配
+ *
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+static int sdstreamtask_openFile(void)
+{
+    if (StreamFile != NULL)
+        return SAVE_ERR_BUSY;
+
+    StreamFile = fopen(Path, "wb");
+    if (StreamFile == NULL)
+        return SAVE_ERR_ACCESS;
+
+    // 缓冲已经是整簇，直接交给文件系统
+    setvbuf(StreamFile, NULL, _IONBF, 0);
+    Prealloc = 0;
+    if (!sdstreamtask_prealloc(SDSTREAM_PREALLOC_SIZE))
+        printf("SD stream: preallocation failed, writing without\r\n");
+    return SAVE_OK;
+}
+
+/**
+ * @brief 整块写入，写到预分配的末尾时再扩展
+ *
+ * @param pData
+ * @param size
+ */
+static void sdstreamtask_writeBlock(const uint8_t* pData, size_t size)
+{
+    if ((StreamFile == NULL) || (sdstreamtask_error() != SAVE_OK))
+        return;
+
+    if ((Prealloc != 0) && (Stats.written + size > Prealloc))
+        sdstreamtask_prealloc(Prealloc + SDSTREAM_PREALLOC_SIZE);
+
+    int64_t start = esp_timer_get_time();
+    bool ok = fwrite(pData, 1, size, StreamFile) == size;
+    uint32_t us = esp_timer_get_time() - start;
+
+    taskENTER_CRITICAL(&StatsLock);
+    if (ok)
+        Stats.written += size;
+    Stats.writes++;
+    if (us > Stats.maxWriteUs)
+        Stats.maxWriteUs = us;
+    taskEXIT_CRITICAL(&StatsLock);
+
+    if (!ok)
+        sdstreamtask_setError(SAVE_ERR_WRITE);
+}
+
+/**
+ * @brief 截断没有用到的预分配部分并关闭文件
+ *
+ * @return int 文件结果
+ */
+static int sdstreamtask_closeFile(void)
+{
+    if (StreamFile == NULL)
+        return sdstreamtask_error();
+
+    if ((Prealloc > Stats.written) && (ftruncate(fileno(StreamFile), Stats.written) != 0))
+        sdstreamtask_setError(SAVE_ERR_WRITE);
+    if (fclose(StreamFile) != 0)
+        sdstreamtask_setError(SAVE_ERR_WRITE);
+    StreamFile = NULL;
+
+    taskENTER_CRITICAL(&StatsLock);
+    Stats.open = false;
+    taskEXIT_CRITICAL(&StatsLock);
+    return sdstreamtask_error();
+}
+
+/**
+ * @brief 流式写入任务：按顺序处理打开、写满的缓冲、关闭和拔卡
+ *
+ * @param arg
+ */
+static void sdstream_task(void* arg)
+{
+    (void)arg;
+    sSdStreamItem item;
+
+    while (1) {
+        if (xQueueReceive(Items, &item, portMAX_DELAY) != pdTRUE)
+            continue;
+
+        switch (item.cmd) {
+        case SDSTREAM_CMD_OPEN:
+            CommandResult = sdstreamtask_openFile();
+            break;
+
+        case SDSTREAM_CMD_WRITE:
+            sdstreamtask_writeBlock(item.pBuffer, item.size);
+            xQueueSend(FreeBuffers, &item.pBuffer, 0);
+            break;
+
+        case SDSTREAM_CMD_CLOSE:
+            CommandResult = sdstreamtask_closeFile();
+            break;
+
+        case SDSTREAM_CMD_EJECT:
+            // 卡已经拔出：不再截断，关闭文件释放句柄，之后的写入都返回错误
+            if (StreamFile != NULL) {
+                sdstreamtask_setError(SAVE_ERR_ACCESS);
+                fclose(StreamFile);
+                StreamFile = NULL;
+                printf("SD stream: card removed, %05ld closed at %lu bytes\r\n", (long)Stats.fileIndex, (unsigned long)Stats.written);
+            }
+            xSemaphoreGive(EjectDone);
+            break;
+        }
+
+        if (item.waiter != NULL)
+            xTaskNotifyGive(item.waiter);
+    }
+}
+
+/**
+ * @brief 启动流式写入任务
+ *
+ * @return true 成功
+ */
+bool sdstreamtask_Init(void)
+{
+    if (Items != NULL)
+        return true;
+
+    Items = xQueueCreate(SDSTREAM_BUFFER_COUNT + 2, sizeof(sSdStreamItem));
+    FreeBuffers = xQueueCreate(SDSTREAM_BUFFER_COUNT, sizeof(uint8_t*));
+    EjectDone = xSemaphoreCreateBinary();
+    if (!Items || !FreeBuffers || !EjectDone) {
+        printf("SD stream: out of memory\r\n");
+        return false;
+    }
+
+    // 比录像任务高一级：卡空闲时尽快把缓冲写出去
+    return xTaskCreatePinnedToCore(sdstream_task, "sdstream", 1024 * 4, NULL, tskIDLE_PRIORITY + 2, NULL, tskNO_AFFINITY) == pdPASS;
+}
+
+/**
+ * @brief 发送命令并等待写入任务处理完
+ *
+ * @param cmd
+ * @return int 命令结果
+ */
+static int sdstreamtask_command(eSdStreamCmd cmd)
+{
+    sSdStreamItem item = { .cmd = cmd, .waiter = xTaskGetCurrentTaskHandle() };
+
+    if (Items == NULL)
+        return SAVE_ERR_MEMORY;
+
+    ulTaskNotifyTake(pdTRUE, 0); // 清除以前残留的通知
+    xQueueSend(Items, &item, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return CommandResult;
+}
+
+/**
+ * @brief 卡上同类文件的下一个序号
+ *
+ * @param pExtension
+ * @return int32_t
+ */
+static int32_t sdstreamtask_nextIndex(const char* pExtension)
+{
+    int32_t maxIndex = 0;
+    DIR* pDir = opendir(SD_MOUNT_POINT);
+    if (pDir == NULL)
+        return 1;
+
+    struct dirent* pEntry;
+    while ((pEntry = readdir(pDir)) != NULL) {
+        char* pEnd;
+        long index = strtol(pEntry->d_name, &pEnd, 10);
+        // FAT 的短文件名是大写的
+        if ((pEnd != pEntry->d_name) && (strcasecmp(pEnd, pExtension) == 0) && (index > maxIndex))
+            maxIndex = index;
+    }
+    closedir(pDir);
+    return maxIndex + 1;
+}
+
+/**
+ * @brief 在 SD 卡上创建新文件
+ *
+ * @param pExtension 扩展名（SAVE_xxx_EXT）
+ * @param pIndex 输出文件序号，可以为 NULL
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+int sdstreamtask_Open(const char* pExtension, int32_t* pIndex)
+{
+    if (!sdcardIsMount())
+        return SAVE_ERR_ACCESS;
+    if (Open)
+        return SAVE_ERR_BUSY;
+    if ((Items == NULL) || !sdstreamtask_allocBuffers())
+        return SAVE_ERR_MEMORY;
+
+    int32_t index = sdstreamtask_nextIndex(pExtension);
+    snprintf(Path, sizeof(Path), "%s/%05ld%s", SD_MOUNT_POINT, (long)index, pExtension);
+
+    taskENTER_CRITICAL(&StatsLock);
+    memset(&Stats, 0, sizeof(Stats));
+    Stats.open = true;
+    Stats.fileIndex = index;
+    taskEXIT_CRITICAL(&StatsLock);
+
+    int ret = sdstreamtask_command(SDSTREAM_CMD_OPEN);
+    if (ret != SAVE_OK) {
+        taskENTER_CRITICAL(&StatsLock);
+        Stats.open = false;
+        Stats.lastError = ret;
+        taskEXIT_CRITICAL(&StatsLock);
+        return ret;
+    }
+
+    xQueueReceive(FreeBuffers, &pCurrent, portMAX_DELAY);
+    CurrentUsed = 0;
+    Open = true;
+    if (pIndex != NULL)
+        *pIndex = index;
+    return SAVE_OK;
+}
+
+/**
+ * @brief 把写满的缓冲交给写入任务，取一块空闲缓冲（所有缓冲都在排队时等待）
+ *
+ * @return int SAVE_OK / SAVE_ERR_WRITE
+ */
+static int sdstreamtask_submit(void)
+{
+    sSdStreamItem item = { .cmd = SDSTREAM_CMD_WRITE, .pBuffer = pCurrent, .size = CurrentUsed };
+    xQueueSend(Items, &item, portMAX_DELAY);
+    pCurrent = NULL;
+    CurrentUsed = 0;
+
+    if (xQueueReceive(FreeBuffers, &pCurrent, 0) == pdTRUE)
+        return SAVE_OK;
+
+    taskENTER_CRITICAL(&StatsLock);
+    Stats.waits++;
+    taskEXIT_CRITICAL(&StatsLock);
+    if (xQueueReceive(FreeBuffers, &pCurrent, pdMS_TO_TICKS(SDSTREAM_STALL_TIMEOUT_MS)) == pdTRUE)
+        return SAVE_OK;
+
+    pCurrent = NULL;
+    sdstreamtask_setError(SAVE_ERR_WRITE);
+    return SAVE_ERR_WRITE;
+}
+
+/**
+ * @brief 追加数据
+ *
+ * @param pData
+ * @param size
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+int sdstreamtask_Write(const void* pData, size_t size)
+{
+    const uint8_t* pIn = pData;
+
+    if (!Open || (pCurrent == NULL))
+        return SAVE_ERR_ACCESS;
+
+    while (size > 0) {
+        int err = sdstreamtask_error();
+        if (err != SAVE_OK)
+            return err;
+
+        size_t n = SDSTREAM_BUFFER_SIZE - CurrentUsed;
+        if (n > size)
+            n = size;
+        memcpy(pCurrent + CurrentUsed, pIn, n);
+        CurrentUsed += n;
+        pIn += n;
+        size -= n;
+
+        taskENTER_CRITICAL(&StatsLock);
+        Stats.bytes += n;
+        taskEXIT_CRITICAL(&StatsLock);
+
+        if ((CurrentUsed == SDSTREAM_BUFFER_SIZE) && (sdstreamtask_submit() != SAVE_OK))
+            return SAVE_ERR_WRITE;
+    }
+    return SAVE_OK;
+}
+
+/**
+ * @brief 写出剩余数据并关闭文件
+ *
+ * @param pSize 输出文件长度，可以为 NULL
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+int sdstreamtask_Close(uint32_t* pSize)
+{
+    if (!Open)
+        return sdstreamtask_error();
+    Open = false;
+
+    if (pCurrent != NULL) {
+        if (CurrentUsed > 0) {
+            sSdStreamItem item = { .cmd = SDSTREAM_CMD_WRITE, .pBuffer = pCurrent, .size = CurrentUsed };
+            xQueueSend(Items, &item, portMAX_DELAY);
+        } else {
+            xQueueSend(FreeBuffers, &pCurrent, 0);
+        }
+        pCurrent = NULL;
+        CurrentUsed = 0;
+    }
+
+    int ret = sdstreamtask_command(SDSTREAM_CMD_CLOSE);
+    if (pSize != NULL)
+        *pSize = Stats.written;
+    return ret;
+}
+
+/**
+ * @brief 卡将被卸载：停止写入并关闭文件
+ *
+ * 写入任务可能正卡在对已拔出的卡的 fwrite 里，最多等 SDSTREAM_EJECT_TIMEOUT_MS；
+ * 超时时命令留在队列里，写入任务回来后再关闭文件
+ *
+ * @return true 文件已关闭（或没有打开），可以卸载
+ */
+bool sdstreamtask_Eject(void)
+{
+    if (Items == NULL)
+        return true;
+
+    // 先置错误：录像任务之后的写入马上失败，不再往队列里放缓冲
+    taskENTER_CRITICAL(&StatsLock);
+    if (Stats.open && (Stats.lastError == SAVE_OK))
+        Stats.lastError = SAVE_ERR_ACCESS;
+    taskEXIT_CRITICAL(&StatsLock);
+
+    sSdStreamItem item = { .cmd = SDSTREAM_CMD_EJECT };
+    TickType_t timeout = pdMS_TO_TICKS(SDSTREAM_EJECT_TIMEOUT_MS);
+    xSemaphoreTake(EjectDone, 0); // 清除以前超时的命令留下的完成信号
+    if ((xQueueSend(Items, &item, timeout) == pdTRUE) && (xSemaphoreTake(EjectDone, timeout) == pdTRUE))
+        return true;
+
+    printf("SD stream: eject timed out, writer still busy\r\n");
+    return false;
+}
+
+/**
+ * @brief 读取统计
+ *
+ * @param pStats
+ */
+void sdstreamtask_GetStats(sSdStreamStats* pStats)
+{
+    taskENTER_CRITICAL(&StatsLock);
+    *pStats = Stats;
+    taskEXIT_CRITICAL(&StatsLock);
+}
+
+static int sdstreamtask_benchCompare(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief 由每次写入调用的耗时算出一项结果并输出到串口
+ *
+ * @param pResult 已填好 pLabel、result、bytes
+ * @param pCallUs 每次调用的耗时（会被排序）
+ * @param calls
+ * @param us 总耗时（含关闭文件）
+ */
+static void sdstreamtask_benchReport(sSdStreamBench* pResult, uint32_t* pCallUs, uint32_t calls, int64_t us)
+{
+    if (calls > 0) {
+        qsort(pCallUs, calls, sizeof(uint32_t), sdstreamtask_benchCompare);
+        pResult->p50Us = pCallUs[calls / 2];
+        pResult->p99Us = pCallUs[(calls * 99) / 100];
+        pResult->maxUs = pCallUs[calls - 1];
+    }
+    pResult->rate = (us > 0) ? (uint32_t)((uint64_t)pResult->bytes * 1000000 / us) : 0;
+    pResult->sustained = (pResult->result == SAVE_OK) && (pResult->rate >= SDSTREAM_BENCH_RAW_RATE)
+        && (pResult->maxUs <= SDSTREAM_BENCH_FRAME_US);
+
+    if (pResult->result != SAVE_OK) {
+        printf("Storage test %-9s %s\r\n", pResult->pLabel, save_ErrorStr(pResult->result));
+        return;
+    }
+    printf("Storage test %-9s %lu KB in %lu ms: %lu KB/s, write call p50 %lu.%lu ms p99 %lu.%lu ms max %lu.%lu ms, raw 64 Hz %s\r\n",
+        pResult->pLabel, (unsigned long)(pResult->bytes / 1024), (unsigned long)(us / 1000), (unsigned long)(pResult->rate / 1024),
+        (unsigned long)(pResult->p50Us / 1000), (unsigned long)(pResult->p50Us % 1000 / 100),
+        (unsigned long)(pResult->p99Us / 1000), (unsigned long)(pResult->p99Us % 1000 / 100),
+        (unsigned long)(pResult->maxUs / 1000), (unsigned long)(pResult->maxUs % 1000 / 100),
+        pResult->sustained ? "sustained" : "NOT sustained");
+}
+
+/**
+ * @brief 用普通 stdio（默认缓冲，按帧写入，不预分配）写入
+ *
+ * @param pResult
+ * @param pFileName
+ * @param pFrame
+ * @param pCallUs
+ */
+static void sdstreamtask_benchStdio(sSdStreamBench* pResult, const char* pFileName, const uint8_t* pFrame, uint32_t* pCallUs)
+{
+    FILE* f = fopen(pFileName, "wb");
+    if (f == NULL) {
+        pResult->result = SAVE_ERR_ACCESS;
+        sdstreamtask_benchReport(pResult, pCallUs, 0, 0);
+        return;
+    }
+
+    uint32_t calls = 0;
+    int64_t start = esp_timer_get_time();
+    for (uint32_t done = 0; (pResult->result == SAVE_OK) && (done < pResult->bytes); done += SDSTREAM_BENCH_FRAME_SIZE) {
+        int64_t t = esp_timer_get_time();
+        if (fwrite(pFrame, 1, SDSTREAM_BENCH_FRAME_SIZE, f) != SDSTREAM_BENCH_FRAME_SIZE)
+            pResult->result = SAVE_ERR_WRITE;
+        pCallUs[calls++] = esp_timer_get_time() - t;
+    }
+    if ((fclose(f) != 0) && (pResult->result == SAVE_OK))
+        pResult->result = SAVE_ERR_WRITE;
+    int64_t us = esp_timer_get_time() - start;
+
+    remove(pFileName);
+    sdstreamtask_benchReport(pResult, pCallUs, calls, us);
+}
+
+/**
+ * @brief 用流式写入任务写入（和 SD 卡录像的写法相同）
+ *
+ * @param pResult
+ * @param pFrame
+ * @param pCallUs
+ */
+static void sdstreamtask_benchStream(sSdStreamBench* pResult, const uint8_t* pFrame, uint32_t* pCallUs)
+{
+    pResult->result = sdstreamtask_Open(".BIN", NULL);
+    if (pResult->result != SAVE_OK) {
+        sdstreamtask_benchReport(pResult, pCallUs, 0, 0);
+        return;
+    }
+
+    uint32_t calls = 0;
+    int64_t start = esp_timer_get_time();
+    for (uint32_t done = 0; (pResult->result == SAVE_OK) && (done < pResult->bytes); done += SDSTREAM_BENCH_FRAME_SIZE) {
+        int64_t t = esp_timer_get_time();
+        pResult->result = sdstreamtask_Write(pFrame, SDSTREAM_BENCH_FRAME_SIZE);
+        pCallUs[calls++] = esp_timer_get_time() - t;
+    }
+    int ret = sdstreamtask_Close(NULL);
+    if (pResult->result == SAVE_OK)
+        pResult->result = ret;
+    int64_t us = esp_timer_get_time() - start;
+
+    remove(Path);
+    sdstreamtask_benchReport(pResult, pCallUs, calls, us);
+
+    sSdStreamStats stats;
+    sdstreamtask_GetStats(&stats);
+    printf("Storage test   %lu block writes, slowest %lu ms, %lu waits for a free buffer\r\n", (unsigned long)stats.writes,
+        (unsigned long)(stats.maxWriteUs / 1000), (unsigned long)stats.waits);
+}
+
+/**
+ * @brief 写入测试：按 64Hz 原始温度帧的大小连续写入，比较 SD 卡流式写入、SD 卡普通写入和内置存储（SAVE_MOUNT_POINT，
+ * 按 SAVE_USE_CAPSTORE 是 capstore 或 SPIFFS），测试文件写完后删除
+ *
+ * @param pResults 输出 SDSTREAM_BENCH_COUNT 项结果
+ * @return int SAVE_OK / SAVE_ERR_BUSY（正在流式写入）/ SAVE_ERR_MEMORY
+ */
+int sdstreamtask_Bench(sSdStreamBench pResults[SDSTREAM_BENCH_COUNT])
+{
+    static const char* Labels[SDSTREAM_BENCH_COUNT] = { "SD stream", "SD stdio", "internal" };
+    static const uint32_t Sizes[SDSTREAM_BENCH_COUNT] = { SDSTREAM_BENCH_SD_SIZE, SDSTREAM_BENCH_SD_SIZE, SDSTREAM_BENCH_FLASH_SIZE };
+
+    if (Open)
+        return SAVE_ERR_BUSY;
+
+    uint8_t* pFrame = malloc(SDSTREAM_BENCH_FRAME_SIZE);
+    uint32_t* pCallUs = malloc(SDSTREAM_BENCH_MAX_CALLS * sizeof(uint32_t));
+    if ((pFrame == NULL) || (pCallUs == NULL)) {
+        free(pFrame);
+        free(pCallUs);
+        return SAVE_ERR_MEMORY;
+    }
+    for (int i = 0; i < SDSTREAM_BENCH_FRAME_SIZE; i++)
+        pFrame[i] = i * 7;
+
+    memset(pResults, 0, SDSTREAM_BENCH_COUNT * sizeof(sSdStreamBench));
+    for (int i = 0; i < SDSTREAM_BENCH_COUNT; i++) {
+        pResults[i].pLabel = Labels[i];
+        pResults[i].bytes = Sizes[i];
+    }
+
+    sdstreamtask_benchStream(&pResults[0], pFrame, pCallUs);
+    if (sdcardIsMount()) {
+        sdstreamtask_benchStdio(&pResults[1], SD_MOUNT_POINT "/BENCH.BIN", pFrame, pCallUs);
+    } else {
+        pResults[1].result = SAVE_ERR_ACCESS;
+        sdstreamtask_benchReport(&pResults[1], pCallUs, 0, 0);
+    }
+    sdstreamtask_benchStdio(&pResults[2], SAVE_MOUNT_POINT "/BENCH.BIN", pFrame, pCallUs);
+
+    free(pFrame);
+    free(pCallUs);
+    return SAVE_OK;
+}
@@ -0,0 +1,541 @@
+#include "timelapse_task.h"
+#include "mlx90640_task.h"
+#include "record_task.h"
+#include "recording.h"
+#include "save.h"
+#include <driver/gpio.h>
+#include <esp_heap_caps.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 统计模式一行 CSV 的最大长度
+#define TIMELAPSE_LINE_SIZE 128
+
+static const char TimelapseCsvHeader[] = "time_s,frame,ta,min,max,avg,std,center,min_x,min_y,max_x,max_y\n";
+
+typedef enum {
+    TIMELAPSE_CMD_START = 0,
+    TIMELAPSE_CMD_STOP,
+    TIMELAPSE_CMD_SCREEN, // 屏幕开关改变，重新判断能否睡眠
+} eTimelapseCmd;
+
+typedef struct {
+    eTimelapseCmd cmd;
+    const sTimelapseConfig* pConfig; // TIMELAPSE_CMD_START 的设置
+    TaskHandle_t waiter; // 等待命令完成的任务
+} sTimelapseItem;
+
+static QueueHandle_t Commands = NULL;
+static volatile bool Active = false;
+static volatile bool ScreenOn = true;
+static sTimelapseConfig Config;
+static uint8_t WasPaused = 0; // 开始前传感器是否已经暂停，停止时恢复
+
+static sRecordingEncoder* pEncoder = NULL;
+static uint8_t* pBlock = NULL; // 还没有写出的数据
+static size_t BlockUsed = 0;
+static int64_t StartUs = 0;
+static int64_t NextCaptureUs = 0;
+static int64_t BatchStartUs = 0; // 块中第一帧的拍摄时间
+static int64_t WakeUntilUs = 0; // 在此之前不睡眠
+static int64_t ScreenSinceUs = 0;
+static int CommandResult = SAVE_OK; // 最近一次开始/停止命令的结果
+
+static portMUX_TYPE StatsLock = portMUX_INITIALIZER_UNLOCKED;
+static sTimelapseStats Stats;
+
+/**
+ * @brief 优先在 PSRAM 中分配
+ *
+ * @param size
+ * @return void*
+ */
+static void* timelapsetask_alloc(size_t size)
+{
+    void* p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    return p ? p : malloc(size);
+}
+
+static const char* timelapsetask_ext(eTimelapseMode mode)
+{
+    return (mode == TIMELAPSE_MODE_SNAPSHOT) ? SAVE_RECORDING_EXT : SAVE_TIMELAPSE_EXT;
+}
+
+/**
+ * @brief 累计各状态的时间（微秒）
+ *
+ * @param pTotal Stats 中的计数
+ * @param us
+ */
+static void timelapsetask_account(uint64_t* pTotal, int64_t us)
+{
+    taskENTER_CRITICAL(&StatsLock);
+    *pTotal += us;
+    taskEXIT_CRITICAL(&StatsLock);
+}
+
+/**
+ * @brief 把攒下的帧追加到文件
+ *
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+static int timelapsetask_flush(void)
+{
+    if (BlockUsed == 0)
+        return SAVE_OK;
+
+    int ret = save_AppendFile(timelapsetask_ext(Config.mode), Stats.fileIndex, pBlock, BlockUsed);
+    if (ret == SAVE_OK) {
+        taskENTER_CRITICAL(&StatsLock);
+        Stats.bytes += BlockUsed;
+        Stats.batches++;
+        Stats.pending = 0;
+        taskEXIT_CRITICAL(&StatsLock);
+    }
+    BlockUsed = 0;
+    return ret;
+}
+
+/**
+ * @brief 写出剩余的帧，恢复传感器和唤醒设置
+ *
+ * @param result 定时拍摄过程中的错误，SAVE_OK 表示正常停止
+ * @return int 定时拍摄结果
+ */
+static int timelapsetask_close(int result)
+{
+    if (!Active)
+        return result;
+
+    int flushResult = timelapsetask_flush();
+    if (result == SAVE_OK)
+        result = flushResult;
+    Active = false;
+
+    setMLX90640IsPause(WasPaused);
+    gpio_wakeup_disable(TIMELAPSE_WAKE_GPIO);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&StatsLock);
+    if (ScreenOn)
+        Stats.screenUs += now - ScreenSinceUs;
+    Stats.active = false;
+    Stats.lastError = result;
+    taskEXIT_CRITICAL(&StatsLock);
+
+    sTimelapseStats stats;
+    timelapsetask_GetStats(&stats);
+    printf("Timelapse %05ld%s: %s, %lu captures (%lu failed), %lu bytes, %.1f mJ/capture\r\n", (long)stats.fileIndex,
+        timelapsetask_ext(stats.mode), save_ErrorStr(result), (unsigned long)stats.captures, (unsigned long)stats.failed,
+        (unsigned long)stats.bytes, stats.captureMj);
+    return result;
+}
+
+/**
+ * @brief 创建文件并写入文件头（录像文件头取自最新一帧和当前设置，统计文件为 CSV 表头），之后按块追加
+ *
+ * @param pConfig
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+static int timelapsetask_open(const sTimelapseConfig* pConfig)
+{
+    if (Active || recordtask_IsActive())
+        return SAVE_ERR_BUSY;
+
+    Config = *pConfig;
+    if (Config.intervalS < TIMELAPSE_MIN_INTERVAL_S)
+        Config.intervalS = TIMELAPSE_MIN_INTERVAL_S;
+
+    const char* pExt = timelapsetask_ext(Config.mode);
+    if (Config.mode == TIMELAPSE_MODE_SNAPSHOT) {
+        sSnapshotHeader header;
+        recording_InitHeader(&header, THERMALIMAGE_RESOLUTION_WIDTH, THERMALIMAGE_RESOLUTION_HEIGHT);
+        const sMlxData* pFrame = mlx90640_AcquireLatest();
+        if (pFrame == NULL)
+            return SAVE_ERR_NODATA;
+        save_FillHeader(&header, pFrame);
+        mlx90640_ReleaseFrame(pFrame);
+        memcpy(pBlock, &header, sizeof(header));
+        BlockUsed = sizeof(header);
+        recording_EncoderInit(pEncoder, THERMALIMAGE_RESOLUTION_WIDTH, THERMALIMAGE_RESOLUTION_HEIGHT, RECORDING_KEY_INTERVAL);
+    } else {
+        BlockUsed = strlen(TimelapseCsvHeader);
+        memcpy(pBlock, TimelapseCsvHeader, BlockUsed);
+    }
+
+    int32_t index = 0;
+    int err;
+    FILE* f = save_CreateFile(pExt, TIMELAPSE_MIN_FREE, &index, &err);
+    if (f == NULL) {
+        BlockUsed = 0;
+        return err;
+    }
+    bool ok = fwrite(pBlock, 1, BlockUsed, f) == BlockUsed;
+    err = save_CloseFile(pExt, f, index);
+    if (!ok && (err == SAVE_OK))
+        err = SAVE_ERR_WRITE;
+
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&StatsLock);
+    memset(&Stats, 0, sizeof(Stats));
+    Stats.active = (err == SAVE_OK);
+    Stats.fileIndex = index;
+    Stats.mode = Config.mode;
+    Stats.intervalS = Config.intervalS;
+    Stats.bytes = BlockUsed;
+    Stats.lastError = err;
+    ScreenSinceUs = now;
+    taskEXIT_CRITICAL(&StatsLock);
+    BlockUsed = 0;
+    if (err != SAVE_OK)
+        return err;
+
+    // 第一帧立即拍摄
+    StartUs = now;
+    NextCaptureUs = now;
+    WakeUntilUs = 0;
+    WasPaused = setMLX90640IsPause(1);
+    gpio_wakeup_enable(TIMELAPSE_WAKE_GPIO, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    Active = true;
+    return SAVE_OK;
+}
+
+/**
+ * @brief 恢复传感器读取，取恢复后的第 TIMELAPSE_SETTLE_FRAMES 帧，然后再暂停
+ *
+ * @return const sMlxData* 取出的帧（用完后 mlx90640_ReleaseFrame），超时返回 NULL
+ */
+static const sMlxData* timelapsetask_grab(void)
+{
+    uint32_t seq0 = 0;
+    const sMlxData* pFrame = mlx90640_AcquireLatest();
+    if (pFrame != NULL) {
+        seq0 = pFrame->FrameSeq;
+        mlx90640_ReleaseFrame(pFrame);
+        pFrame = NULL;
+    }
+
+    setMLX90640IsPause(0);
+    int64_t deadline = esp_timer_get_time() + TIMELAPSE_SETTLE_TIMEOUT_MS * 1000LL;
+    do {
+        vTaskDelay(pdMS_TO_TICKS(TIMELAPSE_SETTLE_POLL_MS));
+        const sMlxData* pLatest = mlx90640_AcquireLatest();
+        if ((pLatest != NULL) && (pLatest->FrameSeq - seq0 >= TIMELAPSE_SETTLE_FRAMES)) {
+            pFrame = pLatest;
+            break;
+        }
+        if (pLatest != NULL)
+            mlx90640_ReleaseFrame(pLatest);
+    } while (esp_timer_get_time() < deadline);
+    setMLX90640IsPause(1);
+
+    return pFrame;
+}
+
+/**
+ * @brief 把一帧编码（或写成一行统计）追加到块，块放不下时先写文件
+ *
+ * @param pFrame
+ * @param captureUs 拍摄时间
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+static int timelapsetask_encode(const sMlxData* pFrame, int64_t captureUs)
+{
+    size_t maxSize = (Config.mode == TIMELAPSE_MODE_SNAPSHOT) ? RECORDING_MAX_FRAME_SIZE(THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT)
+                                                              : TIMELAPSE_LINE_SIZE;
+    if (BlockUsed + maxSize > TIMELAPSE_BLOCK_SIZE) {
+        int ret = timelapsetask_flush();
+        if (ret != SAVE_OK)
+            return ret;
+    }
+
+    uint32_t timeMs = (captureUs - StartUs) / 1000;
+    size_t size;
+    if (Config.mode == TIMELAPSE_MODE_SNAPSHOT) {
+        size = recording_EncodeFrame(pEncoder, pFrame->ThermoImage, pFrame->FrameSeq, timeMs, pFrame->Ta,
+            pBlock + BlockUsed, TIMELAPSE_BLOCK_SIZE - BlockUsed);
+    } else {
+        int len = snprintf((char*)pBlock + BlockUsed, TIMELAPSE_LINE_SIZE, "%lu.%03lu,%lu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%d,%d,%d,%d\n",
+            (unsigned long)(timeMs / 1000), (unsigned long)(timeMs % 1000), (unsigned long)pFrame->FrameSeq, pFrame->Ta,
+            pFrame->minT, pFrame->maxT, pFrame->AvgT, pFrame->StdT, pFrame->CenterTemp,
+            pFrame->minT_X, pFrame->minT_Y, pFrame->maxT_X, pFrame->maxT_Y);
+        size = ((len > 0) && (len < TIMELAPSE_LINE_SIZE)) ? len : 0;
+    }
+    if (size == 0)
+        return SAVE_ERR_MEMORY;
+
+    if (BlockUsed == 0)
+        BatchStartUs = captureUs;
+    BlockUsed += size;
+
+    taskENTER_CRITICAL(&StatsLock);
+    Stats.captures++;
+    Stats.pending++;
+    taskEXIT_CRITICAL(&StatsLock);
+    return SAVE_OK;
+}
+
+/**
+ * @brief 拍摄一帧，攒够一批时写文件，拍够设定的帧数时停止
+ *
+ * @param now
+ */
+static void timelapsetask_capture(int64_t now)
+{
+    // 按计划时间推算下次拍摄，落后（例如写文件太慢）时从现在算起
+    int64_t interval = Config.intervalS * 1000000LL;
+    NextCaptureUs += interval;
+    if (NextCaptureUs <= now)
+        NextCaptureUs = now + interval;
+
+    int result = SAVE_OK;
+    const sMlxData* pFrame = timelapsetask_grab();
+    if (pFrame != NULL) {
+        result = timelapsetask_encode(pFrame, now);
+        mlx90640_ReleaseFrame(pFrame);
+    } else {
+        taskENTER_CRITICAL(&StatsLock);
+        Stats.failed++;
+        taskEXIT_CRITICAL(&StatsLock);
+    }
+
+    if ((result == SAVE_OK) && (Stats.pending != 0)
+        && ((Stats.pending >= TIMELAPSE_BATCH_CAPTURES) || (now - BatchStartUs >= TIMELAPSE_BATCH_MAX_S * 1000000LL)))
+        result = timelapsetask_flush();
+    timelapsetask_account(&Stats.activeUs, esp_timer_get_time() - now);
+
+    if (result != SAVE_OK)
+        timelapsetask_close(result);
+    else if ((Config.maxCaptures != 0) && (Stats.captures >= Config.maxCaptures))
+        timelapsetask_close(SAVE_OK);
+}
+
+/**
+ * @brief 浅睡眠到下次拍摄，或被按键唤醒
+ *
+ * @param us
+ */
+static void timelapsetask_sleep(int64_t us)
+{
+    esp_sleep_enable_timer_wakeup(us);
+    int64_t start = esp_timer_get_time();
+    esp_err_t err = esp_light_sleep_start();
+    int64_t end = esp_timer_get_time();
+
+    if (err != ESP_OK) {
+        // 不能睡眠：等到下次拍摄前不再尝试
+        WakeUntilUs = NextCaptureUs;
+        return;
+    }
+
+    bool button = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO;
+    if (button)
+        WakeUntilUs = end + TIMELAPSE_WAKE_GRACE_MS * 1000LL;
+
+    taskENTER_CRITICAL(&StatsLock);
+    Stats.sleepUs += end - start;
+    if (button)
+        Stats.wakeups++;
+    taskEXIT_CRITICAL(&StatsLock);
+}
+
+/**
+ * @brief 定时拍摄任务：到时间拍摄，其余时间处理命令、等待或浅睡眠
+ *
+ * @param arg
+ */
+static void timelapse_task(void* arg)
+{
+    (void)arg;
+    sTimelapseItem item;
+
+    while (1) {
+        TickType_t wait = portMAX_DELAY;
+        bool wasActive = Active;
+
+        if (wasActive) {
+            int64_t now = esp_timer_get_time();
+            if (now >= NextCaptureUs) {
+                timelapsetask_capture(now);
+                continue;
+            }
+
+            int64_t remaining = NextCaptureUs - now;
+            if (!ScreenOn && (now >= WakeUntilUs) && (remaining >= TIMELAPSE_SLEEP_MIN_MS * 1000LL)
+                && (uxQueueMessagesWaiting(Commands) == 0)) {
+                timelapsetask_sleep(remaining);
+                continue;
+            }
+
+            // 唤醒期结束后重新判断能否睡眠
+            if ((now < WakeUntilUs) && (WakeUntilUs - now < remaining))
+                remaining = WakeUntilUs - now;
+            wait = pdMS_TO_TICKS(remaining / 1000) + 1;
+        }
+
+        int64_t waitStart = esp_timer_get_time();
+        bool received = xQueueReceive(Commands, &item, wait) == pdTRUE;
+        if (wasActive)
+            timelapsetask_account(&Stats.idleUs, esp_timer_get_time() - waitStart);
+        if (!received)
+            continue;
+
+        switch (item.cmd) {
+        case TIMELAPSE_CMD_START:
+            CommandResult = timelapsetask_open(item.pConfig);
+            break;
+
+        case TIMELAPSE_CMD_STOP:
+            CommandResult = Active ? timelapsetask_close(SAVE_OK) : Stats.lastError;
+            break;
+
+        case TIMELAPSE_CMD_SCREEN:
+            break;
+        }
+
+        if (item.waiter != NULL)
+            xTaskNotifyGive(item.waiter);
+    }
+}
+
+/**
+ * @brief 分配缓冲并启动定时拍摄任务
+ *
+ * @return true 成功
+ */
+bool timelapsetask_Init(void)
+{
+    if (Commands != NULL)
+        return true;
+
+    Commands = xQueueCreate(4, sizeof(sTimelapseItem));
+    pEncoder = timelapsetask_alloc(sizeof(sRecordingEncoder));
+    pBlock = timelapsetask_alloc(TIMELAPSE_BLOCK_SIZE);
+    if (!Commands || !pEncoder || !pBlock) {
+        printf("Timelapse: out of memory\r\n");
+        return false;
+    }
+
+    return xTaskCreatePinnedToCore(timelapse_task, "timelapse", 1024 * 4, NULL, tskIDLE_PRIORITY + 1, NULL, tskNO_AFFINITY) == pdPASS;
+}
+
+/**
+ * @brief 发送命令并等待定时拍摄任务处理完
+ *
+ * @param cmd
+ * @param pConfig
+ * @return int 命令结果
+ */
+static int timelapsetask_command(eTimelapseCmd cmd, const sTimelapseConfig* pConfig)
+{
+    sTimelapseItem item = { .cmd = cmd, .pConfig = pConfig, .waiter = xTaskGetCurrentTaskHandle() };
+
+    if (Commands == NULL)
+        return SAVE_ERR_MEMORY;
+
+    ulTaskNotifyTake(pdTRUE, 0); // 清除以前残留的通知
+    xQueueSend(Commands, &item, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return CommandResult;
+}
+
+/**
+ * @brief 开始定时拍摄
+ *
+ * @param pConfig
+ * @param pIndex 输出文件序号，可以为 NULL
+ * @return int SAVE_OK / SAVE_ERR_xxx
+ */
+int timelapsetask_Start(const sTimelapseConfig* pConfig, int32_t* pIndex)
+{
+    if (Active)
+        return SAVE_ERR_BUSY;
+
+    int ret = timelapsetask_command(TIMELAPSE_CMD_START, pConfig);
+    if ((ret == SAVE_OK) && (pIndex != NULL))
+        *pIndex = Stats.fileIndex;
+    return ret;
+}
+
+/**
+ * @brief 停止定时拍摄
+ *
+ * @param pStats 输出最终统计，可以为 NULL
+ * @return int 定时拍摄结果
+ */
+int timelapsetask_Stop(sTimelapseStats* pStats)
+{
+    int ret = timelapsetask_command(TIMELAPSE_CMD_STOP, NULL);
+    if (pStats != NULL)
+        timelapsetask_GetStats(pStats);
+    return ret;
+}
+
+/**
+ * @brief 是否正在定时拍摄
+ *
+ * @return true
+ */
+bool timelapsetask_IsActive(void)
+{
+    return Active;
+}
+
+/**
+ * @brief 界面打开/关闭屏幕时调用
+ *
+ * @param on
+ */
+void timelapsetask_SetScreenOn(bool on)
+{
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&StatsLock);
+    bool changed = (ScreenOn != on);
+    if (changed && !on && Stats.active)
+        Stats.screenUs += now - ScreenSinceUs;
+    if (changed)
+        ScreenSinceUs = now;
+    ScreenOn = on;
+    taskEXIT_CRITICAL(&StatsLock);
+
+    // 屏幕关闭后任务可能正在等待，让它马上进入睡眠
+    if (changed && (Commands != NULL)) {
+        sTimelapseItem item = { .cmd = TIMELAPSE_CMD_SCREEN };
+        xQueueSend(Commands, &item, 0);
+    }
+}
+
+/**
+ * @brief 读取统计，并按各状态的时间估算能量
+ *
+ * @param pStats
+ */
+void timelapsetask_GetStats(sTimelapseStats* pStats)
+{
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&StatsLock);
+    *pStats = Stats;
+    if (Stats.active) {
+        if (ScreenOn)
+            pStats->screenUs += now - ScreenSinceUs;
+        pStats->nextMs = (NextCaptureUs > now) ? (NextCaptureUs - now) / 1000 : 0;
+    }
+    taskEXIT_CRITICAL(&StatsLock);
+
+    // 毫瓦 x 微秒 / 1000000 = 毫焦
+    pStats->energyMj = ((double)pStats->activeUs * TIMELAPSE_POWER_ACTIVE_MW + (double)pStats->idleUs * TIMELAPSE_POWER_IDLE_MW
+                           + (double)pStats->sleepUs * TIMELAPSE_POWER_SLEEP_MW + (double)pStats->screenUs * TIMELAPSE_POWER_SCREEN_MW)
+        / 1000000.0;
+    pStats->captureMj = pStats->captures ? pStats->energyMj / pStats->captures : 0.0f;
+}
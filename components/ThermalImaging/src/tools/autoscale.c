@@ -0,0 +1,156 @@
+#include "autoscale.h"
+#include <math.h>
+
+#define FRAME_PIXELS (THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT)
+
+/**
+ * @brief 清除跟踪状态
+ *
+ * @param pState
+ */
+void autoscale_Reset(sAutoScale* pState)
+{
+    pState->valid = false;
+    pState->lastSeq = 0;
+}
+
+/**
+ * @brief 一次遍历求裁掉两端各 clip 个像素后的最小/最大温度
+ *  - 只保存最冷和最热的 clip+1 个值（插入排序），clip 很小，比整帧排序快得多
+ *  - 帧直方图每桶 10 度，精度不够，这里直接用像素值
+ *
+ * @param pFrame
+ * @param clip 每端裁掉的像素数
+ * @param pLow 输出
+ * @param pHigh 输出
+ */
+static void autoscale_clipRange(const sMlxData* pFrame, uint8_t clip, float* pLow, float* pHigh)
+{
+    float low[AUTOSCALE_MAX_CLIP + 1];
+    float high[AUTOSCALE_MAX_CLIP + 1];
+    uint8_t lowCount = 0;
+    uint8_t highCount = 0;
+
+    for (uint16_t i = 0; i < FRAME_PIXELS; i++) {
+        float temp = pFrame->ThermoImage[i];
+        int8_t j;
+
+        if (!isfinite(temp))
+            continue;
+
+        // low 升序
+        if ((lowCount <= clip) || (temp < low[clip])) {
+            j = (lowCount <= clip) ? lowCount++ : clip;
+            for (; (j > 0) && (low[j - 1] > temp); j--)
+                low[j] = low[j - 1];
+            low[j] = temp;
+        }
+
+        // high 降序
+        if ((highCount <= clip) || (temp > high[clip])) {
+            j = (highCount <= clip) ? highCount++ : clip;
+            for (; (j > 0) && (high[j - 1] < temp); j--)
+                high[j] = high[j - 1];
+            high[j] = temp;
+        }
+    }
+
+    *pLow = low[lowCount - 1];
+    *pHigh = high[highCount - 1];
+}
+
+/**
+ * @brief 向目标靠近：远离中心（扩大量程）用 attack，靠近中心（缩小量程）用 decay
+ *
+ * @param current
+ * @param target
+ * @param expanding 目标方向是否扩大量程
+ * @return float
+ */
+static float autoscale_follow(float current, float target, bool expanding)
+{
+    return current + (target - current) * (expanding ? AUTOSCALE_ATTACK : AUTOSCALE_DECAY);
+}
+
+/**
+ * @brief 量化下限：扩大立即跟上，缩小要超过一步半才移动（回差），避免在边界上来回跳
+ *
+ * @param current 当前输出
+ * @param value 平滑后的值
+ * @param valid 当前输出是否有效
+ * @return float
+ */
+static float autoscale_quantLow(float current, float value, bool valid)
+{
+    float q = floorf(value / AUTOSCALE_STEP) * AUTOSCALE_STEP;
+
+    if (!valid || (q < current) || (value >= current + AUTOSCALE_STEP * 1.5f))
+        return q;
+    return current;
+}
+
+static float autoscale_quantHigh(float current, float value, bool valid)
+{
+    float q = ceilf(value / AUTOSCALE_STEP) * AUTOSCALE_STEP;
+
+    if (!valid || (q > current) || (value <= current - AUTOSCALE_STEP * 1.5f))
+        return q;
+    return current;
+}
+
+/**
+ * @brief 用一帧数据更新量程
+ *
+ * @param pState
+ * @param pFrame 已由 framestats_Calc 计算过统计
+ */
+void autoscale_Update(sAutoScale* pState, const sMlxData* pFrame)
+{
+    // 重新计算同一帧（调色板等设置改变）时量程保持不变
+    if (pState->valid && (pFrame->FrameSeq != 0) && (pFrame->FrameSeq == pState->lastSeq))
+        return;
+    pState->lastSeq = pFrame->FrameSeq;
+
+    if (pFrame->ValidCount == 0) {
+        if (!pState->valid) {
+            pState->minT = pState->smoothMin = pFrame->minT;
+            pState->maxT = pState->smoothMax = pFrame->maxT;
+        }
+        return;
+    }
+
+    uint8_t clip = (uint32_t)pFrame->ValidCount * AUTOSCALE_CLIP_PERMILLE / 1000;
+    if (clip > AUTOSCALE_MAX_CLIP)
+        clip = AUTOSCALE_MAX_CLIP;
+
+    float low, high;
+    autoscale_clipRange(pFrame, clip, &low, &high);
+
+    if (!pState->valid) {
+        pState->smoothMin = low;
+        pState->smoothMax = high;
+    } else {
+        pState->smoothMin = autoscale_follow(pState->smoothMin, low, low < pState->smoothMin);
+        pState->smoothMax = autoscale_follow(pState->smoothMax, high, high > pState->smoothMax);
+    }
+
+    // 最小量程
+    float smin = pState->smoothMin;
+    float smax = pState->smoothMax;
+    if (smax - smin < AUTOSCALE_MIN_SPAN) {
+        float center = (smin + smax) * 0.5f;
+        smin = center - AUTOSCALE_MIN_SPAN * 0.5f;
+        smax = center + AUTOSCALE_MIN_SPAN * 0.5f;
+    }
+
+    pState->minT = autoscale_quantLow(pState->minT, smin, pState->valid);
+    pState->maxT = autoscale_quantHigh(pState->maxT, smax, pState->valid);
+
+    // 限制在传感器量程内
+    if (pState->minT < MIN_TEMP)
+        pState->minT = MIN_TEMP;
+    if (pState->maxT > MAX_TEMP)
+        pState->maxT = MAX_TEMP;
+
+    pState->valid = true;
+}
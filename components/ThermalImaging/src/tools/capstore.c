@@ -0,0 +1,1495 @@
+#include "capstore.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPSTORE_SEG_MAGIC 0x47455343u // "CSEG"
+#define CAPSTORE_UNSET 0xFFFFFFFFu
+#define CAPSTORE_NO_ADDR 0xFFFFFFFFu
+
+// 记录状态：写入时为 VALID，作废时把这个字节写成 0
+#define REC_STATE_VALID 0xFE
+#define REC_STATE_DEAD 0x00
+
+// 记录类型
+#define REC_DATA 1
+#define REC_CLOSE 2
+
+// 段头（擦除后立即写入擦除次数，开始写入记录时再写段序号）
+typedef struct {
+    uint32_t Magic;
+    uint32_t EraseCount;
+    uint32_t Seq; // 分配顺序，CAPSTORE_UNSET 表示空闲段
+    uint32_t Reserved;
+} sSegHeader;
+
+// 记录头（16 字节），CRC 覆盖 Type 到 Offset 和数据，不含 State
+typedef struct {
+    uint8_t State;
+    uint8_t Type;
+    uint16_t Length; // 数据字节数
+    uint32_t FileId;
+    uint32_t Offset; // DATA：在文件中的位置；CLOSE：版本号
+    uint32_t Crc;
+} sRecHeader;
+
+// CLOSE 记录的数据
+typedef struct {
+    uint32_t Size;
+    char Name[CAPSTORE_NAME_MAX];
+} sClosePayload;
+
+#define SEG_HDR ((uint32_t)sizeof(sSegHeader))
+#define REC_HDR ((uint32_t)sizeof(sRecHeader))
+#define ALIGN4(x) (((x) + 3) & ~3u)
+#define REC_SIZE(len) (REC_HDR + ALIGN4(len))
+#define SEG_CAPACITY (CAPSTORE_SEGMENT_SIZE - SEG_HDR)
+#define SEG_OF(addr) ((addr) / CAPSTORE_SEGMENT_SIZE)
+
+// 段末尾剩余的数据空间不少于这个数时把数据块拆开填满当前段，否则直接换段
+#define MIN_SPLIT 256
+// 空闲回收只回收无效数据不少于这个数的段（反复搬运有效数据只会增加磨损）
+#define GC_MIN_DEAD (SEG_CAPACITY / 8)
+// 写入时为腾出一个空闲段最多执行的回收步数
+#define FOREGROUND_GC_MAX_STEPS 4096
+
+typedef enum {
+    SEG_FREE = 0, // 已擦除
+    SEG_OPEN, // 正在追加（写入段或回收目标段）
+    SEG_SEALED, // 写满或重新挂载后不再追加
+    SEG_DIRTY, // 段头无效，需要擦除
+} eSegState;
+
+typedef struct {
+    uint32_t EraseCount;
+    uint32_t Seq;
+    uint32_t WritePos; // 有效记录的结束位置（段内偏移）
+    uint32_t Live; // 有效记录的字节数
+    uint8_t State;
+} sSegment;
+
+// 文件的一个数据块
+typedef struct {
+    uint32_t Addr; // 记录头的地址
+    uint32_t Offset;
+    uint32_t Length;
+} sChunk;
+
+typedef struct {
+    uint32_t Id;
+    uint32_t Version;
+    uint32_t Size; // 最近一次关闭时的大小
+    uint32_t CloseAddr; // CAPSTORE_NO_ADDR：新文件，还没有关闭（不可见）
+    char Name[CAPSTORE_NAME_MAX];
+    sChunk* pChunks; // 按 Offset 排序
+    int chunkCount;
+    int chunkCapacity;
+    bool Writing;
+} sFile;
+
+typedef struct {
+    bool Used;
+    uint8_t Mode;
+    uint32_t FileId;
+    uint32_t Pos;
+    uint8_t* pBuff; // 写句柄：记录头 + CAPSTORE_CHUNK_SIZE 字节数据
+    uint32_t BuffUsed;
+} sHandle;
+
+static tCapstoreFlash Flash;
+static bool Mounted = false;
+static bool ReadError = false; // 挂载时读闪存出错（挂载失败，不能当作空白或写坏的记录处理）
+
+static sSegment Segments[CAPSTORE_MAX_SEGMENTS];
+static int SegCount = 0;
+static int ActiveSeg = -1; // 文件写入的段
+static int GcSeg = -1; // 回收复制的目标段（与新写入的数据分开，冷热分离）
+static uint32_t Capacity = 0;
+static uint32_t LiveTotal = 0;
+
+static sFile* Files = NULL;
+static int FileCount = 0;
+static int FileCapacity = 0;
+static sHandle Handles[CAPSTORE_MAX_OPEN];
+
+static uint32_t NextId = 1;
+static uint32_t NextVersion = 1;
+static uint32_t NextSeq = 1;
+
+// 正在回收的段
+static int GcVictim = -1;
+static uint32_t GcPos = 0; // 复制阶段：下一条记录的位置
+static uint32_t GcErased = 0; // 擦除阶段：已擦除的字节数（从段尾向前擦，段头所在的扇区最后擦）
+
+static uint8_t* pScratch = NULL; // 一条最大的记录
+static sCapstoreInfo Stats;
+
+static uint32_t CrcTable[256];
+
+static void capstore_crcInit(void)
+{
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++)
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        CrcTable[n] = c;
+    }
+}
+
+static uint32_t capstore_crc(uint32_t crc, const uint8_t* pData, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+        crc = CrcTable[(crc ^ pData[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+/**
+ * @brief 记录的 CRC（不含状态字节）
+ *
+ * @param pHdr
+ * @param pPayload
+ * @return uint32_t
+ */
+static uint32_t capstore_recordCrc(const sRecHeader* pHdr, const uint8_t* pPayload)
+{
+    uint32_t crc = capstore_crc(0xFFFFFFFFu, (const uint8_t*)pHdr + 1, offsetof(sRecHeader, Crc) - 1);
+    return ~capstore_crc(crc, pPayload, pHdr->Length);
+}
+
+static bool capstore_read(uint32_t addr, void* pBuff, size_t size)
+{
+    if (Flash.read(Flash.pCtx, addr, pBuff, size) == 0)
+        return true;
+    ReadError = true;
+    return false;
+}
+
+static bool capstore_write(uint32_t addr, const void* pData, size_t size)
+{
+    return Flash.write(Flash.pCtx, addr, pData, size) == 0;
+}
+
+/**
+ * @brief 按序号查找文件（包括还没有关闭的新文件）
+ *
+ * @param id
+ * @return sFile*
+ */
+static sFile* capstore_findId(uint32_t id)
+{
+    for (int i = 0; i < FileCount; i++) {
+        if (Files[i].Id == id)
+            return &Files[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief 按名字查找可见的文件（已经关闭过的）
+ *
+ * @param pName
+ * @return sFile*
+ */
+static sFile* capstore_findName(const char* pName)
+{
+    for (int i = 0; i < FileCount; i++) {
+        if ((Files[i].CloseAddr != CAPSTORE_NO_ADDR) && (strcmp(Files[i].Name, pName) == 0))
+            return &Files[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief 在索引中新建文件（可能移动 Files 数组，之前取得的 sFile 指针失效）
+ *
+ * @param id
+ * @param pName
+ * @return sFile* 内存不足时返回 NULL
+ */
+static sFile* capstore_newFile(uint32_t id, const char* pName)
+{
+    if (FileCount == FileCapacity) {
+        int capacity = FileCapacity ? FileCapacity * 2 : 32;
+        sFile* pFiles = realloc(Files, capacity * sizeof(sFile));
+        if (pFiles == NULL)
+            return NULL;
+        Files = pFiles;
+        FileCapacity = capacity;
+    }
+
+    sFile* f = &Files[FileCount++];
+    memset(f, 0, sizeof(sFile));
+    f->Id = id;
+    f->CloseAddr = CAPSTORE_NO_ADDR;
+    snprintf(f->Name, sizeof(f->Name), "%s", pName);
+    return f;
+}
+
+/**
+ * @brief 从索引中去掉文件（不写闪存）
+ *
+ * @param f
+ */
+static void capstore_dropFile(sFile* f)
+{
+    free(f->pChunks);
+    *f = Files[--FileCount];
+}
+
+/**
+ * @brief 查找数据块
+ *
+ * @param f
+ * @param pos 文件中的位置
+ * @param exact true：块必须从 pos 开始；false：块包含 pos
+ * @return int 下标，没有时返回 -1
+ */
+static int capstore_findChunk(const sFile* f, uint32_t pos, bool exact)
+{
+    int lo = 0;
+    int hi = f->chunkCount - 1;
+
+    // 最后一个 Offset <= pos 的块
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (f->pChunks[mid].Offset <= pos)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    if (hi < 0)
+        return -1;
+
+    const sChunk* c = &f->pChunks[hi];
+    if (exact)
+        return (c->Offset == pos) ? hi : -1;
+    return (pos < c->Offset + c->Length) ? hi : -1;
+}
+
+/**
+ * @brief 把数据块加入文件（按 Offset 插入，同一位置已有块时不加入）
+ *
+ * @param f
+ * @param addr
+ * @param offset
+ * @param length
+ * @return true 加入
+ */
+static bool capstore_addChunk(sFile* f, uint32_t addr, uint32_t offset, uint32_t length)
+{
+    int pos = f->chunkCount;
+
+    if ((pos > 0) && (f->pChunks[pos - 1].Offset >= offset)) {
+        // 第一个 Offset >= offset 的块
+        int lo = 0;
+        while (lo < pos) {
+            int mid = (lo + pos) / 2;
+            if (f->pChunks[mid].Offset < offset)
+                lo = mid + 1;
+            else
+                pos = mid;
+        }
+        if (f->pChunks[pos].Offset == offset)
+            return false;
+    }
+
+    if (f->chunkCount == f->chunkCapacity) {
+        int capacity = f->chunkCapacity ? f->chunkCapacity * 2 : 8;
+        sChunk* pChunks = realloc(f->pChunks, capacity * sizeof(sChunk));
+        if (pChunks == NULL)
+            return false;
+        f->pChunks = pChunks;
+        f->chunkCapacity = capacity;
+    }
+
+    memmove(&f->pChunks[pos + 1], &f->pChunks[pos], (f->chunkCount - pos) * sizeof(sChunk));
+    f->pChunks[pos].Addr = addr;
+    f->pChunks[pos].Offset = offset;
+    f->pChunks[pos].Length = length;
+    f->chunkCount++;
+    return true;
+}
+
+/**
+ * @brief 记录不再有效：从所在段的有效字节中减去
+ *
+ * @param addr
+ * @param length 数据字节数
+ */
+static void capstore_unaccount(uint32_t addr, uint32_t length)
+{
+    Segments[SEG_OF(addr)].Live -= REC_SIZE(length);
+    LiveTotal -= REC_SIZE(length);
+}
+
+/**
+ * @brief 作废一条记录：状态字节写 0（重新挂载后也不再有效）
+ *
+ * @param addr
+ * @param length
+ */
+static void capstore_kill(uint32_t addr, uint32_t length)
+{
+    uint8_t state = REC_STATE_DEAD;
+    capstore_write(addr, &state, 1);
+    capstore_unaccount(addr, length);
+}
+
+/**
+ * @brief 删除文件：作废 CLOSE 记录（数据块没有了 CLOSE 就不再属于任何文件，回收时丢弃）
+ *
+ * @param f
+ */
+static void capstore_deleteFile(sFile* f)
+{
+    if (f->CloseAddr != CAPSTORE_NO_ADDR)
+        capstore_kill(f->CloseAddr, sizeof(sClosePayload));
+    for (int i = 0; i < f->chunkCount; i++)
+        capstore_unaccount(f->pChunks[i].Addr, f->pChunks[i].Length);
+    capstore_dropFile(f);
+}
+
+static int capstore_freeCount(void)
+{
+    int count = 0;
+    for (int i = 0; i < SegCount; i++) {
+        if (Segments[i].State == SEG_FREE)
+            count++;
+    }
+    return count;
+}
+
+/**
+ * @brief 取一个空闲段开始追加：擦除次数最少的优先
+ *
+ * @param forGc 回收可以用掉留给回收的段
+ * @return int 段号，没有可用的段时返回 -1
+ */
+static int capstore_takeFree(bool forGc)
+{
+    int best = -1;
+
+    for (int i = 0; i < SegCount; i++) {
+        if ((Segments[i].State == SEG_FREE) && ((best < 0) || (Segments[i].EraseCount < Segments[best].EraseCount)))
+            best = i;
+    }
+    if ((best < 0) || (!forGc && (capstore_freeCount() <= CAPSTORE_GC_RESERVE)))
+        return -1;
+
+    sSegment* pSeg = &Segments[best];
+    uint32_t seq = NextSeq++;
+    if (!capstore_write(best * CAPSTORE_SEGMENT_SIZE + offsetof(sSegHeader, Seq), &seq, sizeof(seq))) {
+        pSeg->State = SEG_DIRTY;
+        return -1;
+    }
+    pSeg->Seq = seq;
+    pSeg->State = SEG_OPEN;
+    pSeg->WritePos = SEG_HDR;
+    pSeg->Live = 0;
+    return best;
+}
+
+static bool capstore_gcStep(bool foreground);
+
+/**
+ * @brief 确保当前段（写入段或回收目标段）还能放下 size 字节，否则换一个空闲段
+ *  - 写入时没有空闲段（只剩留给回收的段）就在这里回收，直到腾出一个段
+ *
+ * @param forGc
+ * @param size
+ * @return int 0 / -ENOSPC
+ */
+static int capstore_reserve(bool forGc, uint32_t size)
+{
+    int* pSeg = forGc ? &GcSeg : &ActiveSeg;
+
+    if ((*pSeg >= 0) && (Segments[*pSeg].WritePos + size <= CAPSTORE_SEGMENT_SIZE))
+        return 0;
+    if (*pSeg >= 0) {
+        Segments[*pSeg].State = SEG_SEALED;
+        *pSeg = -1;
+    }
+
+    int seg = capstore_takeFree(forGc);
+    if ((seg < 0) && !forGc)
+        Stats.gcStalls++;
+    for (int steps = 0; (seg < 0) && !forGc && (steps < FOREGROUND_GC_MAX_STEPS); steps++) {
+        if (!capstore_gcStep(true))
+            break;
+        Stats.foregroundGc++;
+        seg = capstore_takeFree(false);
+    }
+    if (seg < 0)
+        return -ENOSPC;
+
+    *pSeg = seg;
+    return 0;
+}
+
+/**
+ * @brief 在当前段末尾写一条记录（调用前用 capstore_reserve 确认空间）
+ *
+ * @param forGc
+ * @param pRecord 记录头 + 数据
+ * @param length 数据字节数
+ * @return uint32_t 记录地址，写闪存失败时返回 CAPSTORE_NO_ADDR
+ */
+static uint32_t capstore_put(bool forGc, const uint8_t* pRecord, uint32_t length)
+{
+    int seg = forGc ? GcSeg : ActiveSeg;
+    sSegment* pSeg = &Segments[seg];
+    uint32_t addr = seg * CAPSTORE_SEGMENT_SIZE + pSeg->WritePos;
+
+    pSeg->WritePos += REC_SIZE(length);
+    Stats.flashBytes += REC_HDR + length;
+    if (!capstore_write(addr, pRecord, REC_HDR + length)) {
+        // 写坏的记录之后不再追加
+        pSeg->State = SEG_SEALED;
+        if (forGc)
+            GcSeg = -1;
+        else
+            ActiveSeg = -1;
+        return CAPSTORE_NO_ADDR;
+    }
+
+    pSeg->Live += REC_SIZE(length);
+    LiveTotal += REC_SIZE(length);
+    return addr;
+}
+
+/**
+ * @brief 填写记录头
+ *
+ * @param pRecord 记录头 + 数据
+ * @param type
+ * @param fileId
+ * @param offset
+ * @param length
+ */
+static void capstore_header(uint8_t* pRecord, uint8_t type, uint32_t fileId, uint32_t offset, uint32_t length)
+{
+    sRecHeader hdr;
+
+    hdr.State = REC_STATE_VALID;
+    hdr.Type = type;
+    hdr.Length = length;
+    hdr.FileId = fileId;
+    hdr.Offset = offset;
+    hdr.Crc = capstore_recordCrc(&hdr, pRecord + REC_HDR);
+    memcpy(pRecord, &hdr, REC_HDR);
+}
+
+/**
+ * @brief 写 CLOSE 记录（新版本的文件名和大小）
+ *
+ * @param f
+ * @param pName
+ * @param size
+ * @return uint32_t 记录地址，失败时返回 CAPSTORE_NO_ADDR
+ */
+static uint32_t capstore_writeClose(const sFile* f, const char* pName, uint32_t size)
+{
+    uint8_t record[REC_HDR + sizeof(sClosePayload)];
+    sClosePayload payload;
+
+    // CLOSE 很小，不受容量限制（否则数据已经写入的文件会因为最后几十个字节而丢失）
+    if (capstore_reserve(false, REC_SIZE(sizeof(payload))) != 0)
+        return CAPSTORE_NO_ADDR;
+
+    memset(&payload, 0, sizeof(payload));
+    payload.Size = size;
+    snprintf(payload.Name, sizeof(payload.Name), "%s", pName);
+    memcpy(record + REC_HDR, &payload, sizeof(payload));
+    capstore_header(record, REC_CLOSE, f->Id, NextVersion++, sizeof(payload));
+    return capstore_put(false, record, sizeof(payload));
+}
+
+/**
+ * @brief 记录是否被索引引用（回收时只复制这些记录）
+ *
+ * @param addr
+ * @param pHdr
+ * @return true
+ */
+static bool capstore_isLive(uint32_t addr, const sRecHeader* pHdr)
+{
+    const sFile* f = capstore_findId(pHdr->FileId);
+    if (f == NULL)
+        return false;
+    if (pHdr->Type == REC_CLOSE)
+        return f->CloseAddr == addr;
+
+    int i = capstore_findChunk(f, pHdr->Offset, true);
+    return (i >= 0) && (f->pChunks[i].Addr == addr);
+}
+
+/**
+ * @brief 回收复制后更新索引，作废原记录
+ *
+ * @param oldAddr
+ * @param newAddr
+ * @param pHdr
+ */
+static void capstore_relocate(uint32_t oldAddr, uint32_t newAddr, const sRecHeader* pHdr)
+{
+    sFile* f = capstore_findId(pHdr->FileId);
+
+    if (pHdr->Type == REC_CLOSE) {
+        f->CloseAddr = newAddr;
+    } else {
+        int i = capstore_findChunk(f, pHdr->Offset, true);
+        f->pChunks[i].Addr = newAddr;
+    }
+    capstore_kill(oldAddr, pHdr->Length);
+}
+
+/**
+ * @brief 选择要回收的段
+ *  - 空闲时：擦除次数差超过 CAPSTORE_WEAR_DELTA 时先搬走最少擦除的段（冷数据），
+ *    然后回收无效数据不少于 GC_MIN_DEAD 的段，尽量把无效空间都变成空闲段
+ *  - 写入时：回收无效数据最多的段
+ *
+ * @param foreground
+ * @return int 段号，没有需要回收的段时返回 -1
+ */
+static int capstore_pickVictim(bool foreground)
+{
+    int freeCount = capstore_freeCount();
+
+    if (!foreground && (freeCount > CAPSTORE_GC_RESERVE)) {
+        int coldest = -1;
+        uint32_t eraseMax = 0;
+        for (int i = 0; i < SegCount; i++) {
+            if (Segments[i].EraseCount > eraseMax)
+                eraseMax = Segments[i].EraseCount;
+            if ((Segments[i].State == SEG_SEALED) && ((coldest < 0) || (Segments[i].EraseCount < Segments[coldest].EraseCount)))
+                coldest = i;
+        }
+        if ((coldest >= 0) && (eraseMax - Segments[coldest].EraseCount > CAPSTORE_WEAR_DELTA))
+            return coldest;
+    }
+
+    int best = -1;
+    uint32_t minDead = foreground ? 1 : GC_MIN_DEAD;
+    for (int i = 0; i < SegCount; i++) {
+        const sSegment* pSeg = &Segments[i];
+        if ((pSeg->State != SEG_SEALED) || (SEG_CAPACITY - pSeg->Live < minDead))
+            continue;
+        if ((best < 0) || (pSeg->Live < Segments[best].Live)
+            || ((pSeg->Live == Segments[best].Live) && (pSeg->EraseCount < Segments[best].EraseCount)))
+            best = i;
+    }
+    return best;
+}
+
+/**
+ * @brief 擦除段并写段头（擦除次数 + 1）
+ *  从段尾向前每次擦一个扇区，段头所在的扇区最后擦，中途断电时段头仍在，重新挂载时按空段回收
+ *
+ * @param seg
+ * @param pErased 已擦除的字节数，NULL 时一次擦完
+ * @return true 整段擦完
+ */
+static bool capstore_eraseSegment(int seg, uint32_t* pErased)
+{
+    uint32_t base = seg * CAPSTORE_SEGMENT_SIZE;
+    uint32_t erased = pErased ? *pErased : 0;
+
+    do {
+        erased += Flash.sectorSize;
+        Flash.erase(Flash.pCtx, base + CAPSTORE_SEGMENT_SIZE - erased, Flash.sectorSize);
+    } while ((pErased == NULL) && (erased < CAPSTORE_SEGMENT_SIZE));
+
+    if (pErased)
+        *pErased = erased;
+    if (erased < CAPSTORE_SEGMENT_SIZE)
+        return false;
+
+    sSegment* pSeg = &Segments[seg];
+    sSegHeader header = { CAPSTORE_SEG_MAGIC, pSeg->EraseCount + 1, CAPSTORE_UNSET, CAPSTORE_UNSET };
+    pSeg->EraseCount++;
+    pSeg->Seq = CAPSTORE_UNSET;
+    pSeg->WritePos = SEG_HDR;
+    pSeg->Live = 0;
+    pSeg->State = capstore_write(base, &header, sizeof(header)) ? SEG_FREE : SEG_DIRTY;
+    return true;
+}
+
+/**
+ * @brief 回收一步：复制一条有效记录，或擦除一个扇区
+ *
+ * @param foreground
+ * @return true 做了工作
+ */
+static bool capstore_gcStep(bool foreground)
+{
+    if (GcVictim < 0) {
+        GcVictim = capstore_pickVictim(foreground);
+        if (GcVictim < 0)
+            return false;
+        GcPos = SEG_HDR;
+        GcErased = 0;
+    }
+
+    sSegment* pSeg = &Segments[GcVictim];
+    uint32_t base = GcVictim * CAPSTORE_SEGMENT_SIZE;
+    while (GcPos < pSeg->WritePos) {
+        sRecHeader hdr;
+        uint32_t addr = base + GcPos;
+        if (!capstore_read(addr, &hdr, REC_HDR))
+            return false;
+        if ((hdr.State != REC_STATE_VALID) || !capstore_isLive(addr, &hdr)) {
+            GcPos += REC_SIZE(hdr.Length);
+            continue;
+        }
+
+        if (!capstore_read(addr, pScratch, REC_HDR + hdr.Length) || (capstore_reserve(true, REC_SIZE(hdr.Length)) != 0))
+            return false;
+        uint32_t newAddr = capstore_put(true, pScratch, hdr.Length);
+        if (newAddr == CAPSTORE_NO_ADDR)
+            return false;
+        capstore_relocate(addr, newAddr, &hdr);
+        GcPos += REC_SIZE(hdr.Length);
+        Stats.gcCopied++;
+        return true;
+    }
+
+    if (capstore_eraseSegment(GcVictim, &GcErased)) {
+        GcVictim = -1;
+        Stats.gcErased++;
+    }
+    return true;
+}
+
+static bool capstore_isErased(const void* pData, size_t size)
+{
+    const uint8_t* p = pData;
+    for (size_t i = 0; i < size; i++) {
+        if (p[i] != 0xFF)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 扫描段中的记录
+ *
+ * @param seg
+ * @param checkCrc 检查有效记录的 CRC（挂载的第一遍）
+ * @param fn 对每条有效记录调用，可以为 NULL
+ * @param pTorn 输出是否遇到写坏的记录
+ * @return uint32_t 有效记录的结束位置
+ */
+static uint32_t capstore_scan(int seg, bool checkCrc, void (*fn)(uint32_t addr, const sRecHeader* pHdr, const uint8_t* pPayload), bool* pTorn)
+{
+    uint32_t base = seg * CAPSTORE_SEGMENT_SIZE;
+    uint32_t pos = SEG_HDR;
+    uint32_t end = checkCrc ? CAPSTORE_SEGMENT_SIZE : Segments[seg].WritePos;
+
+    *pTorn = false;
+    while (pos + REC_HDR <= end) {
+        sRecHeader hdr;
+        if (!capstore_read(base + pos, &hdr, REC_HDR)) {
+            *pTorn = true;
+            break;
+        }
+
+        if (capstore_isErased(&hdr, REC_HDR))
+            break;
+
+        bool sane = ((hdr.State == REC_STATE_VALID) || (hdr.State == REC_STATE_DEAD))
+            && ((hdr.Type == REC_DATA) || (hdr.Type == REC_CLOSE)) && (hdr.Length <= CAPSTORE_CHUNK_SIZE)
+            && ((hdr.Type == REC_DATA) || (hdr.Length == sizeof(sClosePayload))) && (pos + REC_SIZE(hdr.Length) <= CAPSTORE_SEGMENT_SIZE);
+        if (sane && (hdr.State == REC_STATE_VALID) && (checkCrc || (hdr.Type == REC_CLOSE))) {
+            sane = capstore_read(base + pos + REC_HDR, pScratch, hdr.Length);
+            if (sane && checkCrc)
+                sane = capstore_recordCrc(&hdr, pScratch) == hdr.Crc;
+        }
+        if (!sane) {
+            *pTorn = true;
+            break;
+        }
+
+        if ((hdr.State == REC_STATE_VALID) && (fn != NULL))
+            fn(base + pos, &hdr, pScratch);
+        pos += REC_SIZE(hdr.Length);
+    }
+    return pos;
+}
+
+/**
+ * @brief 挂载第一遍：CLOSE 记录建立文件，同一文件取版本最高的
+ */
+static void capstore_loadClose(uint32_t addr, const sRecHeader* pHdr, const uint8_t* pPayload)
+{
+    if (pHdr->FileId >= NextId)
+        NextId = pHdr->FileId + 1;
+    if (pHdr->Type != REC_CLOSE)
+        return;
+    if (pHdr->Offset >= NextVersion)
+        NextVersion = pHdr->Offset + 1;
+
+    sClosePayload payload;
+    memcpy(&payload, pPayload, sizeof(payload));
+    payload.Name[CAPSTORE_NAME_MAX - 1] = '\0';
+
+    sFile* f = capstore_findId(pHdr->FileId);
+    if (f == NULL)
+        f = capstore_newFile(pHdr->FileId, payload.Name);
+    else if (pHdr->Offset <= f->Version)
+        return;
+    if (f == NULL)
+        return;
+
+    f->Version = pHdr->Offset;
+    f->Size = payload.Size;
+    f->CloseAddr = addr;
+    snprintf(f->Name, sizeof(f->Name), "%s", payload.Name);
+}
+
+/**
+ * @brief 挂载第二遍：数据块加入所属文件（文件大小之外的块是追加到一半断电留下的）
+ */
+static void capstore_loadData(uint32_t addr, const sRecHeader* pHdr, const uint8_t* pPayload)
+{
+    (void)pPayload;
+    if (pHdr->Type != REC_DATA)
+        return;
+
+    sFile* f = capstore_findId(pHdr->FileId);
+    if ((f == NULL) || (pHdr->Offset + pHdr->Length > f->Size))
+        return;
+    capstore_addChunk(f, addr, pHdr->Offset, pHdr->Length);
+}
+
+/**
+ * @brief 挂载第三遍：作废不被索引引用的记录
+ *  - 被替换的 CLOSE（否则删除文件后旧版本会复活）、同一位置重复的块（回收复制到一半断电）、
+ *    文件大小之外的块（否则下一次追加写入同一位置时无法区分）
+ *  - 已经不存在的文件的数据块不用处理，文件序号不会重复使用
+ */
+static void capstore_repair(uint32_t addr, const sRecHeader* pHdr, const uint8_t* pPayload)
+{
+    (void)pPayload;
+    if (capstore_isLive(addr, pHdr)) {
+        Segments[SEG_OF(addr)].Live += REC_SIZE(pHdr->Length);
+        LiveTotal += REC_SIZE(pHdr->Length);
+    } else if ((pHdr->Type == REC_CLOSE) || (capstore_findId(pHdr->FileId) != NULL)) {
+        uint8_t state = REC_STATE_DEAD;
+        capstore_write(addr, &state, 1);
+    }
+}
+
+/**
+ * @brief 清空内存状态
+ */
+static void capstore_reset(void)
+{
+    for (int i = 0; i < FileCount; i++)
+        free(Files[i].pChunks);
+    free(Files);
+    Files = NULL;
+    FileCount = 0;
+    FileCapacity = 0;
+
+    for (int i = 0; i < CAPSTORE_MAX_OPEN; i++) {
+        free(Handles[i].pBuff);
+        memset(&Handles[i], 0, sizeof(sHandle));
+    }
+
+    ActiveSeg = -1;
+    GcSeg = -1;
+    GcVictim = -1;
+    LiveTotal = 0;
+    NextId = 1;
+    NextVersion = 1;
+    NextSeq = 1;
+}
+
+/**
+ * @brief 擦除全部段（保留已知的擦除次数）
+ *
+ * @return true 成功
+ */
+static bool capstore_format(void)
+{
+    capstore_reset();
+    for (int i = 0; i < SegCount; i++) {
+        if (Segments[i].State == SEG_DIRTY)
+            Segments[i].EraseCount = 0;
+        capstore_eraseSegment(i, NULL);
+        if (Segments[i].State != SEG_FREE)
+            return false;
+    }
+
+    Mounted = true;
+    return true;
+}
+
+/**
+ * @brief 设置闪存区域，分配缓冲区
+ *
+ * @param pFlash
+ * @return int 0 或 -errno
+ */
+static int capstore_setup(const tCapstoreFlash* pFlash)
+{
+    capstore_Unmount();
+
+    Flash = *pFlash;
+    if ((Flash.sectorSize == 0) || (CAPSTORE_SEGMENT_SIZE % Flash.sectorSize))
+        return -EINVAL;
+    SegCount = Flash.size / CAPSTORE_SEGMENT_SIZE;
+    if (SegCount > CAPSTORE_MAX_SEGMENTS)
+        SegCount = CAPSTORE_MAX_SEGMENTS;
+    if (SegCount < CAPSTORE_GC_RESERVE + CAPSTORE_SPARE_SEGMENTS + 2)
+        return -EINVAL;
+    // 不计入容量的段保证存满时也有足够的无效空间可以回收，回收一个段不用搬运大部分数据
+    Capacity = (SegCount - CAPSTORE_GC_RESERVE - CAPSTORE_SPARE_SEGMENTS) * SEG_CAPACITY;
+
+    capstore_crcInit();
+    pScratch = malloc(REC_HDR + CAPSTORE_CHUNK_SIZE);
+    if (pScratch == NULL)
+        return -ENOMEM;
+    memset(&Stats, 0, sizeof(Stats));
+    ReadError = false;
+    return 0;
+}
+
+/**
+ * @brief 读取段头
+ *
+ * @param pEraseSum 输出有效段头的擦除次数之和
+ * @return int 有效段头的个数，或 -EIO
+ */
+static int capstore_readHeaders(uint64_t* pEraseSum)
+{
+    int valid = 0;
+    *pEraseSum = 0;
+    for (int i = 0; i < SegCount; i++) {
+        sSegHeader header;
+        sSegment* pSeg = &Segments[i];
+        memset(pSeg, 0, sizeof(sSegment));
+        pSeg->WritePos = SEG_HDR;
+        if (!capstore_read(i * CAPSTORE_SEGMENT_SIZE, &header, sizeof(header)))
+            return -EIO;
+        if (header.Magic != CAPSTORE_SEG_MAGIC) {
+            pSeg->State = SEG_DIRTY;
+            continue;
+        }
+        pSeg->EraseCount = header.EraseCount;
+        pSeg->Seq = header.Seq;
+        pSeg->State = (header.Seq == CAPSTORE_UNSET) ? SEG_FREE : SEG_SEALED;
+        if ((header.Seq != CAPSTORE_UNSET) && (header.Seq >= NextSeq))
+            NextSeq = header.Seq + 1;
+        *pEraseSum += header.EraseCount;
+        valid++;
+    }
+    return valid;
+}
+
+/**
+ * @brief 整个区域是否都是擦除状态（新芯片或刚擦除的分区）
+ *
+ * @return int 1 是，0 不是，-EIO 读出错
+ */
+static int capstore_isBlank(void)
+{
+    for (uint32_t addr = 0; addr < (uint32_t)SegCount * CAPSTORE_SEGMENT_SIZE; addr += CAPSTORE_CHUNK_SIZE) {
+        if (!capstore_read(addr, pScratch, CAPSTORE_CHUNK_SIZE))
+            return -EIO;
+        if (!capstore_isErased(pScratch, CAPSTORE_CHUNK_SIZE))
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 挂载：扫描闪存重建索引。没有有效段头时，只有整个区域都是擦除状态才格式化，
+ *        其他数据（如旧的 SPIFFS）原样保留，返回 -ENODEV 由调用者决定迁移或格式化
+ *
+ * @param pFlash
+ * @return int 0，-ENODEV 区域中是其他数据，-EIO 读闪存出错（不修改闪存），-EINVAL / -ENOMEM
+ */
+int capstore_Mount(const tCapstoreFlash* pFlash)
+{
+    int err = capstore_setup(pFlash);
+    if (err != 0) {
+        capstore_Unmount();
+        return err;
+    }
+
+    uint64_t eraseSum;
+    int valid = capstore_readHeaders(&eraseSum);
+    if (valid == 0) {
+        int blank = capstore_isBlank();
+        if (blank != 1) {
+            capstore_Unmount();
+            return (blank < 0) ? blank : -ENODEV;
+        }
+        printf("Capstore: blank region, formatting %d segments\r\n", SegCount);
+        return capstore_format() ? 0 : -EIO;
+    }
+    if (valid < 0) {
+        capstore_Unmount();
+        return valid;
+    }
+
+    // 第一遍：检查 CRC，找到每段的结束位置，建立文件
+    bool torn[CAPSTORE_MAX_SEGMENTS];
+    for (int i = 0; i < SegCount; i++) {
+        torn[i] = false;
+        if (Segments[i].State == SEG_SEALED) {
+            Segments[i].WritePos = capstore_scan(i, true, capstore_loadClose, &torn[i]);
+        } else if (Segments[i].State == SEG_FREE) {
+            // 空闲段的第一条记录位置应该是擦除状态
+            bool dirty;
+            if (capstore_scan(i, true, NULL, &dirty) != SEG_HDR || dirty)
+                Segments[i].State = SEG_DIRTY;
+        }
+    }
+
+    // 同名文件（覆盖或改名到一半断电）只保留版本最高的
+    for (int i = 0; i < FileCount; i++) {
+        for (int j = i + 1; j < FileCount; j++) {
+            if (strcmp(Files[i].Name, Files[j].Name) == 0) {
+                capstore_dropFile((Files[i].Version < Files[j].Version) ? &Files[i] : &Files[j]);
+                i = -1;
+                break;
+            }
+        }
+    }
+
+    // 第二遍：数据块，然后检查每个文件的数据是否完整
+    bool dummy;
+    for (int i = 0; (i < SegCount) && !ReadError; i++) {
+        if (Segments[i].State == SEG_SEALED)
+            capstore_scan(i, false, capstore_loadData, &dummy);
+    }
+    // 读出错时索引不完整，不能继续（下面会作废记录、擦除段），也不能当作写坏的记录丢弃
+    if (ReadError) {
+        printf("Capstore: flash read error, not mounted\r\n");
+        capstore_Unmount();
+        return -EIO;
+    }
+    for (int i = 0; i < FileCount; i++) {
+        uint32_t pos = 0;
+        for (int c = 0; (c < Files[i].chunkCount) && (Files[i].pChunks[c].Offset == pos); c++)
+            pos += Files[i].pChunks[c].Length;
+        if (pos != Files[i].Size) {
+            printf("Capstore: %s incomplete (%lu of %lu bytes), dropped\r\n", Files[i].Name, (unsigned long)pos, (unsigned long)Files[i].Size);
+            capstore_dropFile(&Files[i--]);
+        }
+    }
+
+    // 第三遍：统计有效字节，作废多余的记录
+    for (int i = 0; (i < SegCount) && !ReadError; i++) {
+        if (Segments[i].State == SEG_SEALED)
+            capstore_scan(i, false, capstore_repair, &dummy);
+    }
+    if (ReadError) {
+        printf("Capstore: flash read error, not mounted\r\n");
+        capstore_Unmount();
+        return -EIO;
+    }
+
+    // 段头无效的段（擦除到一半断电）重新擦除，擦除次数取平均值
+    for (int i = 0; i < SegCount; i++) {
+        if (Segments[i].State == SEG_DIRTY) {
+            Segments[i].EraseCount = eraseSum / valid;
+            capstore_eraseSegment(i, NULL);
+        }
+    }
+
+    // 继续在最后写入的段末尾追加
+    int last = -1;
+    for (int i = 0; i < SegCount; i++) {
+        if ((Segments[i].State == SEG_SEALED) && ((last < 0) || (Segments[i].Seq > Segments[last].Seq)))
+            last = i;
+    }
+    if ((last >= 0) && !torn[last] && (Segments[last].WritePos + REC_HDR + MIN_SPLIT <= CAPSTORE_SEGMENT_SIZE)) {
+        Segments[last].State = SEG_OPEN;
+        ActiveSeg = last;
+    }
+
+    Mounted = true;
+    printf("Capstore: %d files, %lu/%lu bytes, %d free segments\r\n", FileCount, (unsigned long)LiveTotal, (unsigned long)Capacity, capstore_freeCount());
+    return 0;
+}
+
+/**
+ * @brief 卸载
+ */
+void capstore_Unmount(void)
+{
+    capstore_reset();
+    free(pScratch);
+    pScratch = NULL;
+    Mounted = false;
+}
+
+/**
+ * @brief 格式化并挂载为空存储（区域中的数据全部丢失）
+ *
+ * @param pFlash
+ * @return true 成功
+ */
+bool capstore_Format(const tCapstoreFlash* pFlash)
+{
+    if (capstore_setup(pFlash) != 0)
+        return false;
+
+    // 段头读不出时擦除次数从 0 开始
+    uint64_t eraseSum;
+    if (capstore_readHeaders(&eraseSum) < 0) {
+        for (int i = 0; i < SegCount; i++)
+            Segments[i].State = SEG_DIRTY;
+    }
+    return capstore_format();
+}
+
+/**
+ * @brief 打开文件
+ *
+ * @param pName
+ * @param mode CAPSTORE_READ / CAPSTORE_WRITE / CAPSTORE_APPEND
+ * @return int 句柄或 -errno
+ */
+int capstore_Open(const char* pName, int mode)
+{
+    if (!Mounted)
+        return -EIO;
+    if ((pName[0] == '\0') || (strlen(pName) >= CAPSTORE_NAME_MAX))
+        return -ENAMETOOLONG;
+
+    int handle = -1;
+    for (int i = 0; i < CAPSTORE_MAX_OPEN; i++) {
+        if (!Handles[i].Used) {
+            handle = i;
+            break;
+        }
+    }
+    if (handle < 0)
+        return -EMFILE;
+
+    sHandle* h = &Handles[handle];
+    sFile* f = capstore_findName(pName);
+    // 同一文件只能有一个写句柄（正在追加的文件不能被覆盖）
+    if ((f != NULL) && f->Writing && (mode != CAPSTORE_READ))
+        return -EBUSY;
+    if (mode == CAPSTORE_READ) {
+        if (f == NULL)
+            return -ENOENT;
+        h->FileId = f->Id;
+        h->Pos = 0;
+    } else {
+        h->pBuff = malloc(REC_HDR + CAPSTORE_CHUNK_SIZE);
+        if (h->pBuff == NULL)
+            return -ENOMEM;
+
+        if ((mode == CAPSTORE_APPEND) && (f != NULL)) {
+            h->Pos = f->Size;
+        } else {
+            // 新文件关闭之前不可见，关闭时才替换同名的旧文件
+            f = capstore_newFile(NextId++, pName);
+            if (f == NULL) {
+                free(h->pBuff);
+                h->pBuff = NULL;
+                return -ENOMEM;
+            }
+            h->Pos = 0;
+        }
+        f->Writing = true;
+        h->FileId = f->Id;
+        h->BuffUsed = 0;
+    }
+
+    h->Used = true;
+    h->Mode = mode;
+    return handle;
+}
+
+static sHandle* capstore_handle(int handle)
+{
+    if (!Mounted || (handle < 0) || (handle >= CAPSTORE_MAX_OPEN) || !Handles[handle].Used)
+        return NULL;
+    return &Handles[handle];
+}
+
+/**
+ * @brief 读文件
+ *
+ * @param handle
+ * @param pBuff
+ * @param size
+ * @return int 读到的字节数或 -errno
+ */
+int capstore_Read(int handle, void* pBuff, size_t size)
+{
+    sHandle* h = capstore_handle(handle);
+    if ((h == NULL) || (h->Mode != CAPSTORE_READ))
+        return -EBADF;
+    const sFile* f = capstore_findId(h->FileId);
+    if (f == NULL)
+        return -ENOENT;
+
+    uint8_t* pOut = pBuff;
+    size_t done = 0;
+    while ((done < size) && (h->Pos < f->Size)) {
+        int i = capstore_findChunk(f, h->Pos, false);
+        if (i < 0)
+            return -EIO;
+
+        const sChunk* c = &f->pChunks[i];
+        uint32_t count = c->Offset + c->Length - h->Pos;
+        if (count > size - done)
+            count = size - done;
+        if (!capstore_read(c->Addr + REC_HDR + (h->Pos - c->Offset), pOut + done, count))
+            return -EIO;
+        done += count;
+        h->Pos += count;
+    }
+    return done;
+}
+
+/**
+ * @brief 把写缓冲写成 DATA 记录：当前段放不下时先拆出一块填满当前段
+ *
+ * @param h
+ * @return int 0 / -errno
+ */
+static int capstore_flush(sHandle* h)
+{
+    // 空闲段快用完时每块数据分摊几步回收，不等到用完再在一次写入里回收整个段（按空闲回收的规则选段，少搬有效数据）
+    if ((h->BuffUsed > 0) && (capstore_freeCount() <= CAPSTORE_GC_RESERVE + CAPSTORE_GC_AHEAD)) {
+        for (int i = 0; (i < CAPSTORE_GC_STEPS_PER_CHUNK) && capstore_gcStep(false); i++)
+            Stats.foregroundGc++;
+    }
+
+    while (h->BuffUsed > 0) {
+        uint32_t length = h->BuffUsed;
+        uint32_t room = (ActiveSeg >= 0) ? CAPSTORE_SEGMENT_SIZE - Segments[ActiveSeg].WritePos : 0;
+        if ((room < REC_SIZE(length)) && (room >= REC_HDR + MIN_SPLIT))
+            length = (room - REC_HDR) & ~3u;
+
+        if (LiveTotal + REC_SIZE(length) > Capacity)
+            return -ENOSPC;
+
+        int err = capstore_reserve(false, REC_SIZE(length));
+        if (err != 0)
+            return err;
+
+        uint32_t offset = h->Pos - h->BuffUsed;
+        capstore_header(h->pBuff, REC_DATA, h->FileId, offset, length);
+        uint32_t addr = capstore_put(false, h->pBuff, length);
+        if (addr == CAPSTORE_NO_ADDR)
+            return -EIO;
+
+        sFile* f = capstore_findId(h->FileId);
+        if (!capstore_addChunk(f, addr, offset, length)) {
+            capstore_unaccount(addr, length);
+            return -ENOMEM;
+        }
+        Stats.hostBytes += length;
+
+        h->BuffUsed -= length;
+        memmove(h->pBuff + REC_HDR, h->pBuff + REC_HDR + length, h->BuffUsed);
+    }
+    return 0;
+}
+
+/**
+ * @brief 写文件（攒满 CAPSTORE_CHUNK_SIZE 写一条 DATA 记录）
+ *
+ * @param handle
+ * @param pData
+ * @param size
+ * @return int 写入的字节数或 -errno
+ */
+int capstore_Write(int handle, const void* pData, size_t size)
+{
+    sHandle* h = capstore_handle(handle);
+    if ((h == NULL) || (h->Mode == CAPSTORE_READ))
+        return -EBADF;
+
+    const uint8_t* pIn = pData;
+    size_t done = 0;
+    while (done < size) {
+        uint32_t count = CAPSTORE_CHUNK_SIZE - h->BuffUsed;
+        if (count > size - done)
+            count = size - done;
+        memcpy(h->pBuff + REC_HDR + h->BuffUsed, pIn + done, count);
+        h->BuffUsed += count;
+        h->Pos += count;
+        done += count;
+
+        if (h->BuffUsed == CAPSTORE_CHUNK_SIZE) {
+            int err = capstore_flush(h);
+            if (err != 0)
+                return err;
+        }
+    }
+    return done;
+}
+
+/**
+ * @brief 定位
+ *
+ * @param handle
+ * @param offset
+ * @param whence SEEK_SET / SEEK_CUR / SEEK_END
+ * @return long 新位置或 -errno
+ */
+long capstore_Seek(int handle, long offset, int whence)
+{
+    sHandle* h = capstore_handle(handle);
+    if (h == NULL)
+        return -EBADF;
+
+    if (h->Mode != CAPSTORE_READ) {
+        // 写句柄总是在文件末尾
+        if ((offset == 0) && ((whence == SEEK_CUR) || (whence == SEEK_END)))
+            return h->Pos;
+        return -EINVAL;
+    }
+
+    const sFile* f = capstore_findId(h->FileId);
+    if (f == NULL)
+        return -ENOENT;
+
+    long pos = offset;
+    if (whence == SEEK_CUR)
+        pos += h->Pos;
+    else if (whence == SEEK_END)
+        pos += f->Size;
+    if ((pos < 0) || (pos > (long)f->Size))
+        return -EINVAL;
+    h->Pos = pos;
+    return pos;
+}
+
+/**
+ * @brief 文件大小
+ *
+ * @param handle
+ * @return long
+ */
+long capstore_Size(int handle)
+{
+    sHandle* h = capstore_handle(handle);
+    if (h == NULL)
+        return -EBADF;
+    if (h->Mode != CAPSTORE_READ)
+        return h->Pos;
+
+    const sFile* f = capstore_findId(h->FileId);
+    return f ? (long)f->Size : -ENOENT;
+}
+
+/**
+ * @brief 关闭文件
+ *  - 写句柄：写出剩余数据，再写 CLOSE 记录，然后作废旧版本的 CLOSE、删除同名的旧文件
+ *  - 写入出错时新文件丢弃，追加的部分丢弃
+ *
+ * @param handle
+ * @return int 0 / -errno
+ */
+int capstore_Close(int handle)
+{
+    sHandle* h = capstore_handle(handle);
+    if (h == NULL)
+        return -EBADF;
+
+    int err = 0;
+    if (h->Mode != CAPSTORE_READ) {
+        err = capstore_flush(h);
+
+        sFile* f = capstore_findId(h->FileId);
+        uint32_t addr = (err == 0) ? capstore_writeClose(f, f->Name, h->Pos) : CAPSTORE_NO_ADDR;
+        if ((err == 0) && (addr == CAPSTORE_NO_ADDR))
+            err = -EIO;
+
+        if (err == 0) {
+            if (f->CloseAddr != CAPSTORE_NO_ADDR)
+                capstore_kill(f->CloseAddr, sizeof(sClosePayload));
+            f->CloseAddr = addr;
+            f->Version = NextVersion - 1;
+            f->Size = h->Pos;
+            f->Writing = false;
+
+            for (int i = 0; i < FileCount; i++) {
+                if ((Files[i].Id != f->Id) && (Files[i].CloseAddr != CAPSTORE_NO_ADDR) && (strcmp(Files[i].Name, f->Name) == 0)) {
+                    capstore_deleteFile(&Files[i]);
+                    break;
+                }
+            }
+        } else if (f->CloseAddr == CAPSTORE_NO_ADDR) {
+            capstore_deleteFile(f);
+        } else {
+            while ((f->chunkCount > 0) && (f->pChunks[f->chunkCount - 1].Offset >= f->Size)) {
+                f->chunkCount--;
+                capstore_kill(f->pChunks[f->chunkCount].Addr, f->pChunks[f->chunkCount].Length);
+            }
+            f->Writing = false;
+        }
+        free(h->pBuff);
+    }
+
+    memset(h, 0, sizeof(sHandle));
+    return err;
+}
+
+/**
+ * @brief 删除文件
+ *
+ * @param pName
+ * @return int 0 / -errno
+ */
+int capstore_Remove(const char* pName)
+{
+    if (!Mounted)
+        return -EIO;
+
+    sFile* f = capstore_findName(pName);
+    if (f == NULL)
+        return -ENOENT;
+    if (f->Writing)
+        return -EBUSY;
+
+    capstore_deleteFile(f);
+    return 0;
+}
+
+/**
+ * @brief 改名：写新版本的 CLOSE 后作废旧的，目标存在时删除
+ *
+ * @param pFrom
+ * @param pTo
+ * @return int 0 / -errno
+ */
+int capstore_Rename(const char* pFrom, const char* pTo)
+{
+    if (!Mounted)
+        return -EIO;
+    if ((pTo[0] == '\0') || (strlen(pTo) >= CAPSTORE_NAME_MAX))
+        return -ENAMETOOLONG;
+
+    sFile* f = capstore_findName(pFrom);
+    if (f == NULL)
+        return -ENOENT;
+    const sFile* target = capstore_findName(pTo);
+    if (f->Writing || ((target != NULL) && target->Writing))
+        return -EBUSY;
+    if (strcmp(pFrom, pTo) == 0)
+        return 0;
+
+    uint32_t id = f->Id;
+    uint32_t addr = capstore_writeClose(f, pTo, f->Size);
+    if (addr == CAPSTORE_NO_ADDR)
+        return -EIO;
+    capstore_kill(f->CloseAddr, sizeof(sClosePayload));
+    f->CloseAddr = addr;
+    f->Version = NextVersion - 1;
+    snprintf(f->Name, sizeof(f->Name), "%s", pTo);
+
+    for (int i = 0; i < FileCount; i++) {
+        if ((Files[i].Id != id) && (Files[i].CloseAddr != CAPSTORE_NO_ADDR) && (strcmp(Files[i].Name, pTo) == 0)) {
+            capstore_deleteFile(&Files[i]);
+            break;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 文件是否存在
+ *
+ * @param pName
+ * @param pSize
+ * @return true
+ */
+bool capstore_Stat(const char* pName, uint32_t* pSize)
+{
+    const sFile* f = Mounted ? capstore_findName(pName) : NULL;
+    if ((f != NULL) && (pSize != NULL))
+        *pSize = f->Size;
+    return f != NULL;
+}
+
+/**
+ * @brief 按下标列出文件
+ *
+ * @param index
+ * @param pName
+ * @param nameSize
+ * @param pSize
+ * @return true 有这个文件
+ */
+bool capstore_List(int index, char* pName, size_t nameSize, uint32_t* pSize)
+{
+    if (!Mounted)
+        return false;
+
+    for (int i = 0; i < FileCount; i++) {
+        if ((Files[i].CloseAddr != CAPSTORE_NO_ADDR) && (index-- == 0)) {
+            snprintf(pName, nameSize, "%s", Files[i].Name);
+            if (pSize != NULL)
+                *pSize = Files[i].Size;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 存储状态
+ *
+ * @param pInfo
+ */
+void capstore_Info(sCapstoreInfo* pInfo)
+{
+    *pInfo = Stats;
+    pInfo->capacity = Capacity;
+    pInfo->used = LiveTotal;
+    pInfo->segments = SegCount;
+    pInfo->freeSegments = capstore_freeCount();
+    pInfo->files = 0;
+    for (int i = 0; i < FileCount; i++) {
+        if (Files[i].CloseAddr != CAPSTORE_NO_ADDR)
+            pInfo->files++;
+    }
+
+    uint64_t sum = 0;
+    pInfo->eraseMin = CAPSTORE_UNSET;
+    pInfo->eraseMax = 0;
+    for (int i = 0; i < SegCount; i++) {
+        uint32_t count = Segments[i].EraseCount;
+        sum += count;
+        if (count < pInfo->eraseMin)
+            pInfo->eraseMin = count;
+        if (count > pInfo->eraseMax)
+            pInfo->eraseMax = count;
+    }
+    pInfo->eraseAvg = SegCount ? sum / SegCount : 0;
+}
+
+/**
+ * @brief 是否有回收工作
+ *
+ * @return true
+ */
+bool capstore_NeedsGc(void)
+{
+    return Mounted && ((GcVictim >= 0) || (capstore_pickVictim(false) >= 0));
+}
+
+/**
+ * @brief 空闲时执行一步回收
+ *
+ * @return true 做了工作
+ */
+bool capstore_GcStep(void)
+{
+    return Mounted && capstore_gcStep(false);
+}
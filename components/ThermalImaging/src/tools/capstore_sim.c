@@ -0,0 +1,128 @@
+#include "capstore_sim.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int capstoresim_read(void* pCtx, uint32_t addr, void* pBuff, size_t size)
+{
+    sCapstoreSim* pSim = pCtx;
+
+    if ((addr > pSim->size) || (size > pSim->size - addr))
+        return -1;
+    memcpy(pBuff, pSim->pData + addr, size);
+    pSim->bytesRead += size;
+    pSim->timeUs += CAPSTORESIM_OP_US + size * CAPSTORESIM_BYTE_READ_US;
+    return 0;
+}
+
+static int capstoresim_write(void* pCtx, uint32_t addr, const void* pData, size_t size)
+{
+    sCapstoreSim* pSim = pCtx;
+    const uint8_t* pIn = pData;
+
+    if (pSim->failed || (addr > pSim->size) || (size > pSim->size - addr))
+        return -1;
+
+    // 断电：只写入前面的部分
+    size_t count = size;
+    if ((pSim->failAfter >= 0) && ((int64_t)count > pSim->failAfter))
+        count = pSim->failAfter;
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t* p = &pSim->pData[addr + i];
+        if (pIn[i] & ~*p)
+            pSim->violations++;
+        *p &= pIn[i];
+    }
+
+    // 按涉及的页数计编程时间
+    uint32_t pages = (addr + size - 1) / CAPSTORESIM_PAGE_SIZE - addr / CAPSTORESIM_PAGE_SIZE + 1;
+    pSim->timeUs += CAPSTORESIM_OP_US + pages * CAPSTORESIM_PAGE_PROGRAM_US + size * CAPSTORESIM_BYTE_PROGRAM_US;
+    pSim->bytesWritten += count;
+
+    if (pSim->failAfter >= 0) {
+        pSim->failAfter -= count;
+        if (count < size) {
+            pSim->failed = true;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int capstoresim_erase(void* pCtx, uint32_t addr, size_t size)
+{
+    sCapstoreSim* pSim = pCtx;
+
+    if (pSim->failed || (addr % pSim->sectorSize) || (size % pSim->sectorSize) || (addr + size > pSim->size))
+        return -1;
+
+    for (uint32_t a = addr; a < addr + size; a += pSim->sectorSize) {
+        // 擦除过程中断电：扇区只擦了一半
+        if ((pSim->failAfter >= 0) && (pSim->failAfter < pSim->sectorSize)) {
+            memset(pSim->pData + a, 0xFF, pSim->sectorSize / 2);
+            pSim->failed = true;
+            return -1;
+        }
+        if (pSim->failAfter >= 0)
+            pSim->failAfter -= pSim->sectorSize;
+        memset(pSim->pData + a, 0xFF, pSim->sectorSize);
+        pSim->pEraseCounts[a / pSim->sectorSize]++;
+        pSim->erases++;
+        pSim->timeUs += CAPSTORESIM_OP_US + CAPSTORESIM_SECTOR_ERASE_US;
+    }
+    return 0;
+}
+
+/**
+ * @brief 分配模拟闪存
+ *
+ * @param pSim
+ * @param size
+ * @param sectorSize
+ * @return true 成功
+ */
+bool capstoresim_Init(sCapstoreSim* pSim, uint32_t size, uint32_t sectorSize)
+{
+    memset(pSim, 0, sizeof(sCapstoreSim));
+    pSim->pData = malloc(size);
+    pSim->pEraseCounts = calloc(size / sectorSize, sizeof(uint32_t));
+    if (!pSim->pData || !pSim->pEraseCounts) {
+        capstoresim_Free(pSim);
+        return false;
+    }
+
+    memset(pSim->pData, 0xFF, size);
+    pSim->size = size;
+    pSim->sectorSize = sectorSize;
+    pSim->failAfter = -1;
+    return true;
+}
+
+/**
+ * @brief 释放
+ *
+ * @param pSim
+ */
+void capstoresim_Free(sCapstoreSim* pSim)
+{
+    free(pSim->pData);
+    free(pSim->pEraseCounts);
+    pSim->pData = NULL;
+    pSim->pEraseCounts = NULL;
+}
+
+/**
+ * @brief 填写 capstore 的闪存后端
+ *
+ * @param pSim
+ * @param pFlash
+ */
+void capstoresim_GetFlash(sCapstoreSim* pSim, tCapstoreFlash* pFlash)
+{
+    pFlash->size = pSim->size;
+    pFlash->sectorSize = pSim->sectorSize;
+    pFlash->read = capstoresim_read;
+    pFlash->write = capstoresim_write;
+    pFlash->erase = capstoresim_erase;
+    pFlash->pCtx = pSim;
+}
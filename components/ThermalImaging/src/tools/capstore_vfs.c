@@ -0,0 +1,451 @@
+#include "capstore_vfs.h"
+#include <dirent.h>
+#include <errno.h>
+#include <esp_heap_caps.h>
+#include <esp_partition.h>
+#include <esp_spiffs.h>
+#include <esp_vfs.h>
+#include <fcntl.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// 回收没有工作时多久再检查一次（毫秒）
+#define CAPSTORE_VFS_GC_POLL_MS 1000
+// 迁移时旧 SPIFFS 的临时挂载点
+#define CAPSTORE_VFS_MIGRATE_PATH "/oldspiffs"
+
+// opendir 返回的目录（DIR 必须在最前面，VFS 用它找到文件系统）
+typedef struct {
+    DIR Dir;
+    int Index;
+    struct dirent Entry;
+} sCapstoreDir;
+
+// 迁移中的一个文件（内容暂存在内存中）
+typedef struct {
+    char Name[CAPSTORE_NAME_MAX];
+    uint32_t Size;
+    uint8_t* pData;
+} sMigrateFile;
+
+static const esp_partition_t* pPartition = NULL;
+static SemaphoreHandle_t Lock = NULL;
+static TickType_t LastActivity = 0;
+
+static int capstorevfs_flashRead(void* pCtx, uint32_t addr, void* pBuff, size_t size)
+{
+    return esp_partition_read(pCtx, addr, pBuff, size);
+}
+
+static int capstorevfs_flashWrite(void* pCtx, uint32_t addr, const void* pData, size_t size)
+{
+    return esp_partition_write(pCtx, addr, pData, size);
+}
+
+static int capstorevfs_flashErase(void* pCtx, uint32_t addr, size_t size)
+{
+    return esp_partition_erase_range(pCtx, addr, size);
+}
+
+static void capstorevfs_lock(void)
+{
+    xSemaphoreTake(Lock, portMAX_DELAY);
+}
+
+/**
+ * @brief 解锁，记下存储最后一次使用的时间（回收任务在空闲 CAPSTORE_VFS_IDLE_MS 后才工作）
+ */
+static void capstorevfs_unlock(void)
+{
+    LastActivity = xTaskGetTickCount();
+    xSemaphoreGive(Lock);
+}
+
+/**
+ * @brief capstore 的返回值转成 VFS 的返回值（出错时设置 errno）
+ *
+ * @param ret
+ * @return int
+ */
+static int capstorevfs_result(int ret)
+{
+    if (ret >= 0)
+        return ret;
+    errno = -ret;
+    return -1;
+}
+
+// VFS 传入的路径以 '/' 开头
+static const char* capstorevfs_name(const char* pPath)
+{
+    return (pPath[0] == '/') ? pPath + 1 : pPath;
+}
+
+static int capstorevfs_open(const char* pPath, int flags, int mode)
+{
+    (void)mode;
+    const char* pName = capstorevfs_name(pPath);
+    int openMode = CAPSTORE_WRITE;
+
+    if ((flags & O_ACCMODE) == O_RDONLY)
+        openMode = CAPSTORE_READ;
+    else if (flags & O_APPEND)
+        openMode = CAPSTORE_APPEND;
+    else if ((flags & O_ACCMODE) == O_RDWR)
+        // 写句柄不能读，也不能在原有内容上修改（"r+" 会变成覆盖）
+        return capstorevfs_result(-EINVAL);
+
+    capstorevfs_lock();
+    int ret;
+    if ((flags & O_EXCL) && capstore_Stat(pName, NULL))
+        ret = -EEXIST;
+    else
+        ret = capstore_Open(pName, openMode);
+    capstorevfs_unlock();
+    return capstorevfs_result(ret);
+}
+
+static ssize_t capstorevfs_write(int fd, const void* pData, size_t size)
+{
+    capstorevfs_lock();
+    int ret = capstore_Write(fd, pData, size);
+    capstorevfs_unlock();
+    return capstorevfs_result(ret);
+}
+
+static ssize_t capstorevfs_read(int fd, void* pBuff, size_t size)
+{
+    capstorevfs_lock();
+    int ret = capstore_Read(fd, pBuff, size);
+    capstorevfs_unlock();
+    return capstorevfs_result(ret);
+}
+
+static off_t capstorevfs_lseek(int fd, off_t offset, int whence)
+{
+    capstorevfs_lock();
+    long ret = capstore_Seek(fd, offset, whence);
+    capstorevfs_unlock();
+    return capstorevfs_result(ret);
+}
+
+static int capstorevfs_close(int fd)
+{
+    capstorevfs_lock();
+    int ret = capstore_Close(fd);
+    capstorevfs_unlock();
+    return capstorevfs_result(ret);
+}
+
+static int capstorevfs_fstat(int fd, struct stat* pStat)
+{
+    capstorevfs_lock();
+    long size = capstore_Size(fd);
+    capstorevfs_unlock();
+    if (size < 0)
+        return capstorevfs_result(size);
+
+    memset(pStat, 0, sizeof(struct stat));
+    pStat->st_mode = S_IFREG | 0666;
+    pStat->st_size = size;
+    return 0;
+}
+
+static int capstorevfs_stat(const char* pPath, struct stat* pStat)
+{
+    const char* pName = capstorevfs_name(pPath);
+    uint32_t size = 0;
+
+    memset(pStat, 0, sizeof(struct stat));
+    if (pName[0] == '\0') {
+        pStat->st_mode = S_IFDIR | 0777;
+        return 0;
+    }
+
+    capstorevfs_lock();
+    bool found = capstore_Stat(pName, &size);
+    capstorevfs_unlock();
+    if (!found)
+        return capstorevfs_result(-ENOENT);
+
+    pStat->st_mode = S_IFREG | 0666;
+    pStat->st_size = size;
+    return 0;
+}
+
+static int capstorevfs_unlink(const char* pPath)
+{
+    capstorevfs_lock();
+    int ret = capstore_Remove(capstorevfs_name(pPath));
+    capstorevfs_unlock();
+    return capstorevfs_result(ret);
+}
+
+static int capstorevfs_rename(const char* pFrom, const char* pTo)
+{
+    capstorevfs_lock();
+    int ret = capstore_Rename(capstorevfs_name(pFrom), capstorevfs_name(pTo));
+    capstorevfs_unlock();
+    return capstorevfs_result(ret);
+}
+
+// 只有根目录
+static DIR* capstorevfs_opendir(const char* pPath)
+{
+    if (capstorevfs_name(pPath)[0] != '\0') {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    sCapstoreDir* pDir = calloc(1, sizeof(sCapstoreDir));
+    if (pDir == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return &pDir->Dir;
+}
+
+static struct dirent* capstorevfs_readdir(DIR* pDir)
+{
+    sCapstoreDir* d = (sCapstoreDir*)pDir;
+
+    capstorevfs_lock();
+    bool found = capstore_List(d->Index, d->Entry.d_name, sizeof(d->Entry.d_name), NULL);
+    capstorevfs_unlock();
+    if (!found)
+        return NULL;
+
+    d->Entry.d_ino = 0;
+    d->Entry.d_type = DT_REG;
+    d->Index++;
+    return &d->Entry;
+}
+
+static int capstorevfs_closedir(DIR* pDir)
+{
+    free(pDir);
+    return 0;
+}
+
+/**
+ * @brief 回收任务：存储空闲 CAPSTORE_VFS_IDLE_MS 后逐步回收，每步之后让出锁，保存时最多等一步（擦除一个扇区）
+ *
+ * @param arg
+ */
+static void capstorevfs_gcTask(void* arg)
+{
+    (void)arg;
+
+    while (1) {
+        TickType_t idle = xTaskGetTickCount() - LastActivity;
+        if (idle < pdMS_TO_TICKS(CAPSTORE_VFS_IDLE_MS)) {
+            vTaskDelay(pdMS_TO_TICKS(CAPSTORE_VFS_IDLE_MS) - idle);
+            continue;
+        }
+
+        xSemaphoreTake(Lock, portMAX_DELAY);
+        bool worked = capstore_NeedsGc() && capstore_GcStep();
+        xSemaphoreGive(Lock);
+
+        vTaskDelay(worked ? 1 : pdMS_TO_TICKS(CAPSTORE_VFS_GC_POLL_MS));
+    }
+}
+
+/**
+ * @brief 把旧的 SPIFFS 读入内存
+ *
+ * @param ppFiles 输出文件表（调用者释放）
+ * @param pCount 输出文件数
+ * @return int 0 或 -errno（文件表仍然有效）
+ */
+static int capstorevfs_readSpiffs(sMigrateFile** ppFiles, int* pCount)
+{
+    DIR* pDir = opendir(CAPSTORE_VFS_MIGRATE_PATH);
+    if (pDir == NULL)
+        return -EIO;
+
+    int err = 0;
+    int capacity = 0;
+    struct dirent* pEntry;
+    while ((err == 0) && ((pEntry = readdir(pDir)) != NULL)) {
+        char path[ESP_VFS_PATH_MAX + CAPSTORE_NAME_MAX + 2];
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", CAPSTORE_VFS_MIGRATE_PATH, pEntry->d_name);
+        if (strlen(pEntry->d_name) >= CAPSTORE_NAME_MAX) {
+            printf("Capstore: %s name too long to migrate\r\n", pEntry->d_name);
+            err = -ENAMETOOLONG;
+            break;
+        }
+        if (stat(path, &st) != 0) {
+            err = -EIO;
+            break;
+        }
+
+        if (*pCount == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            sMigrateFile* p = realloc(*ppFiles, capacity * sizeof(sMigrateFile));
+            if (p == NULL) {
+                err = -ENOMEM;
+                break;
+            }
+            *ppFiles = p;
+        }
+
+        sMigrateFile* pFile = &(*ppFiles)[*pCount];
+        snprintf(pFile->Name, sizeof(pFile->Name), "%s", pEntry->d_name);
+        pFile->Size = st.st_size;
+        pFile->pData = heap_caps_malloc(pFile->Size ? pFile->Size : 1, MALLOC_CAP_SPIRAM);
+        if (pFile->pData == NULL)
+            pFile->pData = malloc(pFile->Size ? pFile->Size : 1);
+        if (pFile->pData == NULL) {
+            err = -ENOMEM;
+            break;
+        }
+        (*pCount)++;
+
+        FILE* f = fopen(path, "rb");
+        if ((f == NULL) || (fread(pFile->pData, 1, pFile->Size, f) != pFile->Size))
+            err = -EIO;
+        if (f != NULL)
+            fclose(f);
+    }
+    closedir(pDir);
+    return err;
+}
+
+/**
+ * @brief 分区中不是 capstore 时，尝试作为旧的 SPIFFS 挂载（只读取），把文件暂存到内存（PSRAM），
+ *        然后格式化成 capstore 并写回。不是 SPIFFS、读出错或内存不够时不修改分区
+ *
+ * @param pPartitionLabel
+ * @param pFlash
+ * @return int 0 或 -errno
+ */
+static int capstorevfs_migrate(const char* pPartitionLabel, const tCapstoreFlash* pFlash)
+{
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = CAPSTORE_VFS_MIGRATE_PATH,
+        .partition_label = pPartitionLabel,
+        .max_files = 1,
+        .format_if_mount_failed = false,
+    };
+    if (esp_vfs_spiffs_register(&conf) != ESP_OK) {
+        printf("Capstore: partition %s holds unknown data, leaving it untouched\r\n", pPartitionLabel);
+        return -ENODEV;
+    }
+
+    sMigrateFile* pFiles = NULL;
+    int count = 0;
+    int err = capstorevfs_readSpiffs(&pFiles, &count);
+    esp_vfs_spiffs_unregister(pPartitionLabel);
+
+    if (err != 0) {
+        printf("Capstore: cannot stage SPIFFS files (%d), leaving SPIFFS untouched\r\n", err);
+    } else {
+        // 从这里到写完之间断电会丢失文件（文件只在内存中）
+        printf("Capstore: migrating %d files from SPIFFS\r\n", count);
+        if (!capstore_Format(pFlash))
+            err = -EIO;
+        for (int i = 0; (err == 0) && (i < count); i++) {
+            int handle = capstore_Open(pFiles[i].Name, CAPSTORE_WRITE);
+            int ret = (handle < 0) ? handle : capstore_Write(handle, pFiles[i].pData, pFiles[i].Size);
+            if (handle >= 0) {
+                int closeRet = capstore_Close(handle);
+                if (ret >= 0)
+                    ret = closeRet;
+            }
+            if (ret < 0) {
+                printf("Capstore: %s not migrated (%d)\r\n", pFiles[i].Name, ret);
+                err = ret;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+        free(pFiles[i].pData);
+    free(pFiles);
+    return err;
+}
+
+/**
+ * @brief 挂载分区（旧的 SPIFFS 先迁移），注册 VFS，启动回收任务
+ *
+ * @param pBasePath 挂载点
+ * @param pPartitionLabel 数据分区名
+ * @return true 成功；false 时分区没有被修改（迁移中途失败除外）
+ */
+bool capstorevfs_Mount(const char* pBasePath, const char* pPartitionLabel)
+{
+    pPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, pPartitionLabel);
+    if (pPartition == NULL) {
+        printf("Capstore: partition %s not found\r\n", pPartitionLabel);
+        return false;
+    }
+
+    tCapstoreFlash flash = {
+        .size = pPartition->size,
+        .sectorSize = pPartition->erase_size,
+        .read = capstorevfs_flashRead,
+        .write = capstorevfs_flashWrite,
+        .erase = capstorevfs_flashErase,
+        .pCtx = (void*)pPartition,
+    };
+    // 分区中是旧的 SPIFFS 时迁移；读出错时不挂载（不当作空分区格式化）
+    int err = capstore_Mount(&flash);
+    if (err == -ENODEV)
+        err = capstorevfs_migrate(pPartitionLabel, &flash);
+    if (err != 0) {
+        printf("Capstore: mount failed (%d)\r\n", err);
+        capstore_Unmount();
+        return false;
+    }
+
+    Lock = xSemaphoreCreateMutex();
+    if (Lock == NULL)
+        return false;
+
+    esp_vfs_t vfs = {
+        .flags = ESP_VFS_FLAG_DEFAULT,
+        .write = capstorevfs_write,
+        .lseek = capstorevfs_lseek,
+        .read = capstorevfs_read,
+        .open = capstorevfs_open,
+        .close = capstorevfs_close,
+        .fstat = capstorevfs_fstat,
+        .stat = capstorevfs_stat,
+        .unlink = capstorevfs_unlink,
+        .rename = capstorevfs_rename,
+        .opendir = capstorevfs_opendir,
+        .readdir = capstorevfs_readdir,
+        .closedir = capstorevfs_closedir,
+    };
+    if (esp_vfs_register(pBasePath, &vfs, NULL) != ESP_OK) {
+        printf("Capstore: VFS register failed\r\n");
+        return false;
+    }
+
+    LastActivity = xTaskGetTickCount();
+    return xTaskCreatePinnedToCore(capstorevfs_gcTask, "capstore_gc", 1024 * 3, NULL, tskIDLE_PRIORITY, NULL, tskNO_AFFINITY) == pdPASS;
+}
+
+/**
+ * @brief 存储状态
+ *
+ * @param pInfo
+ * @return true 已挂载
+ */
+bool capstorevfs_Info(sCapstoreInfo* pInfo)
+{
+    if (Lock == NULL)
+        return false;
+
+    capstorevfs_lock();
+    capstore_Info(pInfo);
+    xSemaphoreGive(Lock);
+    return true;
+}
@@ -0,0 +1,88 @@
+#include "framestats.h"
+#include <math.h>
+#include <string.h>
+
+#define FRAME_PIXELS (THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT)
+
+/**
+ * @brief 一次遍历计算整帧统计
+ *  - 循环体内只有比较、选择和累加，没有除法和函数调用，便于编译器展开
+ *  - 平均值和方差用相对中心温度的偏移累加，float 精度足够（避免大数相减的精度损失）
+ *
+ * @param pMlxData
+ */
+void framestats_Calc(sMlxData* pMlxData)
+{
+    const float* pThermoImage = pMlxData->ThermoImage;
+
+    // 计算屏幕中心的温度 累加中间4个像素的值
+    pMlxData->CenterTemp =
+        pThermoImage[THERMALIMAGE_RESOLUTION_WIDTH * ((THERMALIMAGE_RESOLUTION_HEIGHT >> 1) - 1) + ((THERMALIMAGE_RESOLUTION_WIDTH >> 1) - 1)] +
+        pThermoImage[THERMALIMAGE_RESOLUTION_WIDTH * ((THERMALIMAGE_RESOLUTION_HEIGHT >> 1) - 1) + (THERMALIMAGE_RESOLUTION_WIDTH >> 1)] +
+        pThermoImage[THERMALIMAGE_RESOLUTION_WIDTH * (THERMALIMAGE_RESOLUTION_HEIGHT >> 1) + ((THERMALIMAGE_RESOLUTION_WIDTH >> 1) - 1)] +
+        pThermoImage[THERMALIMAGE_RESOLUTION_WIDTH * (THERMALIMAGE_RESOLUTION_HEIGHT >> 1) + (THERMALIMAGE_RESOLUTION_WIDTH >> 1)];
+    pMlxData->CenterTemp /= 4;
+
+    const float shift = isfinite(pMlxData->CenterTemp) ? pMlxData->CenterTemp : 0.0f;
+    const float histScale = 1.0f / FRAME_HIST_STEP;
+    float minT = MAX_TEMP;
+    float maxT = MIN_TEMP;
+    uint16_t minIdx = 0;
+    uint16_t maxIdx = 0;
+    float sum = 0.0f;
+    float sumSq = 0.0f;
+    uint16_t valid = 0;
+
+    memset(pMlxData->Hist, 0, sizeof(pMlxData->Hist));
+
+    for (uint16_t i = 0; i < FRAME_PIXELS; i++) {
+        float temp = pThermoImage[i];
+
+        if (!isfinite(temp))
+            continue;
+
+        if (temp < minT) {
+            minT = temp;
+            minIdx = i;
+        }
+        if (temp > maxT) {
+            maxT = temp;
+            maxIdx = i;
+        }
+
+        float d = temp - shift;
+        sum += d;
+        sumSq += d * d;
+        valid++;
+
+        int16_t bin = (int16_t)((temp - MIN_TEMP) * histScale);
+        bin = (bin < 0) ? 0 : ((bin >= FRAME_HIST_BINS) ? (FRAME_HIST_BINS - 1) : bin);
+        pMlxData->Hist[bin]++;
+    }
+
+    // 最小/最大温度限制在传感器量程内
+    pMlxData->minT = (minT < MIN_TEMP) ? MIN_TEMP : minT;
+    pMlxData->maxT = (maxT > MAX_TEMP) ? MAX_TEMP : maxT;
+    pMlxData->minT_X = minIdx % THERMALIMAGE_RESOLUTION_WIDTH;
+    pMlxData->minT_Y = minIdx / THERMALIMAGE_RESOLUTION_WIDTH;
+    pMlxData->maxT_X = maxIdx % THERMALIMAGE_RESOLUTION_WIDTH;
+    pMlxData->maxT_Y = maxIdx / THERMALIMAGE_RESOLUTION_WIDTH;
+
+    pMlxData->ValidCount = valid;
+    pMlxData->NanCount = FRAME_PIXELS - valid;
+
+    if (valid > 0) {
+        float mean = sum / valid;
+        float var = sumSq / valid - mean * mean;
+        if (var < 0)
+            var = 0;
+
+        pMlxData->AvgT = shift + mean;
+        pMlxData->VarT = var;
+        pMlxData->StdT = sqrtf(var);
+    } else {
+        pMlxData->AvgT = 0;
+        pMlxData->VarT = 0;
+        pMlxData->StdT = 0;
+    }
+}
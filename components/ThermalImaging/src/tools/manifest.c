@@ -0,0 +1,530 @@
+#include "manifest.h"
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define MANIFEST_MAGIC "TIMF"
+#define MANIFEST_VERSION 1
+#define MANIFEST_TMP_NAME "CAPTURES.TMP"
+
+// 记录类型
+#define MANIFEST_OP_ADD 1
+#define MANIFEST_OP_REMOVE 2
+
+// 清单文件头
+typedef struct {
+    char Magic[4];
+    uint16_t Version;
+    uint16_t RecordSize;
+} sManifestHeader;
+
+// 清单记录（小端，16 字节）
+typedef struct {
+    uint32_t Id;
+    uint8_t Type;
+    uint8_t Op;
+    uint16_t Reserved;
+    uint32_t Size;
+    uint32_t Timestamp;
+} sManifestRecord;
+
+// 一种类型的文件，按序号从小到大存放
+typedef struct {
+    sManifestEntry* pItems;
+    int count;
+    int capacity;
+    uint32_t nextId;
+} sManifestList;
+
+static char Dir[32];
+static const char* const* Extensions = NULL;
+static uint8_t TypeCount = 0;
+static sManifestList Lists[MANIFEST_MAX_TYPES];
+static uint32_t RecordCount = 0; // 清单文件中的记录数
+
+/**
+ * @brief 清单目录下的文件路径
+ *
+ * @param pName
+ * @param pOut
+ * @param size
+ */
+static void manifest_path(const char* pName, char* pOut, size_t size)
+{
+    snprintf(pOut, size, "%s/%s", Dir, pName);
+}
+
+/**
+ * @brief 二分查找序号
+ *
+ * @param pList
+ * @param id
+ * @return int 找到时返回下标，否则返回 -(插入位置) - 1
+ */
+static int manifest_find(const sManifestList* pList, uint32_t id)
+{
+    int lo = 0;
+    int hi = pList->count - 1;
+
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (pList->pItems[mid].Id == id)
+            return mid;
+        if (pList->pItems[mid].Id < id)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return -lo - 1;
+}
+
+/**
+ * @brief 插入（已存在时更新），新文件的序号最大，一般直接追加到末尾
+ *
+ * @param type
+ * @param pEntry
+ * @return true 成功
+ */
+static bool manifest_insert(uint8_t type, const sManifestEntry* pEntry)
+{
+    sManifestList* pList = &Lists[type];
+    int pos = pList->count;
+
+    if ((pList->count > 0) && (pEntry->Id <= pList->pItems[pList->count - 1].Id)) {
+        pos = manifest_find(pList, pEntry->Id);
+        if (pos >= 0) {
+            pList->pItems[pos] = *pEntry;
+            return true;
+        }
+        pos = -pos - 1;
+    }
+
+    if (pList->count == pList->capacity) {
+        int capacity = pList->capacity ? pList->capacity * 2 : 16;
+        sManifestEntry* pItems = realloc(pList->pItems, capacity * sizeof(sManifestEntry));
+        if (pItems == NULL)
+            return false;
+        pList->pItems = pItems;
+        pList->capacity = capacity;
+    }
+
+    memmove(&pList->pItems[pos + 1], &pList->pItems[pos], (pList->count - pos) * sizeof(sManifestEntry));
+    pList->pItems[pos] = *pEntry;
+    pList->count++;
+    if (pEntry->Id >= pList->nextId)
+        pList->nextId = pEntry->Id + 1;
+    return true;
+}
+
+/**
+ * @brief 从内存表中删除
+ *
+ * @param type
+ * @param id
+ * @return true 找到并删除
+ */
+static bool manifest_erase(uint8_t type, uint32_t id)
+{
+    sManifestList* pList = &Lists[type];
+    int pos = manifest_find(pList, id);
+
+    if (pos < 0)
+        return false;
+    memmove(&pList->pItems[pos], &pList->pItems[pos + 1], (pList->count - pos - 1) * sizeof(sManifestEntry));
+    pList->count--;
+    return true;
+}
+
+static void manifest_clear(void)
+{
+    for (int type = 0; type < MANIFEST_MAX_TYPES; type++) {
+        Lists[type].count = 0;
+        Lists[type].nextId = 1;
+    }
+    RecordCount = 0;
+}
+
+static int manifest_liveCount(void)
+{
+    int count = 0;
+    for (int type = 0; type < TypeCount; type++)
+        count += Lists[type].count;
+    return count;
+}
+
+/**
+ * @brief 把内存表完整写成新清单（先写临时文件再改名，写到一半断电时旧清单仍然有效）
+ *
+ * @return true 成功
+ */
+static bool manifest_writeAll(void)
+{
+    char tmpPath[64];
+    char path[64];
+    manifest_path(MANIFEST_TMP_NAME, tmpPath, sizeof(tmpPath));
+    manifest_path(MANIFEST_FILE_NAME, path, sizeof(path));
+
+    FILE* f = fopen(tmpPath, "wb");
+    if (f == NULL)
+        return false;
+
+    sManifestHeader header = { .Version = MANIFEST_VERSION, .RecordSize = sizeof(sManifestRecord) };
+    memcpy(header.Magic, MANIFEST_MAGIC, sizeof(header.Magic));
+    fwrite(&header, sizeof(header), 1, f);
+
+    uint32_t records = 0;
+    for (uint8_t type = 0; type < TypeCount; type++) {
+        for (int i = 0; i < Lists[type].count; i++) {
+            const sManifestEntry* pEntry = &Lists[type].pItems[i];
+            sManifestRecord record = {
+                .Id = pEntry->Id,
+                .Type = type,
+                .Op = MANIFEST_OP_ADD,
+                .Size = pEntry->Size,
+                .Timestamp = pEntry->Timestamp,
+            };
+            fwrite(&record, sizeof(record), 1, f);
+            records++;
+        }
+    }
+
+    bool ok = !ferror(f);
+    if (fclose(f) != 0)
+        ok = false;
+    if (!ok) {
+        remove(tmpPath);
+        return false;
+    }
+
+    remove(path);
+    if (rename(tmpPath, path) != 0)
+        return false;
+    RecordCount = records;
+    return true;
+}
+
+/**
+ * @brief 追加一条记录，删除记录太多时压缩
+ *
+ * @param pRecord
+ * @return true 成功
+ */
+static bool manifest_append(const sManifestRecord* pRecord)
+{
+    if (RecordCount > (uint32_t)manifest_liveCount() + MANIFEST_COMPACT_SLACK)
+        return manifest_writeAll();
+
+    char path[64];
+    manifest_path(MANIFEST_FILE_NAME, path, sizeof(path));
+
+    FILE* f = fopen(path, "ab");
+    if (f == NULL)
+        return false;
+    bool ok = fwrite(pRecord, sizeof(*pRecord), 1, f) == 1;
+    if (fclose(f) != 0)
+        ok = false;
+
+    if (ok)
+        RecordCount++;
+    return ok;
+}
+
+/**
+ * @brief 读取并重放清单
+ *
+ * @param pNeedRewrite 末尾有不完整的记录（写入时断电），需要重建
+ * @return true 清单有效
+ */
+static bool manifest_load(bool* pNeedRewrite)
+{
+    char path[64];
+    manifest_path(MANIFEST_FILE_NAME, path, sizeof(path));
+
+    *pNeedRewrite = false;
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        return false;
+
+    sManifestHeader header;
+    if ((fread(&header, sizeof(header), 1, f) != 1) || memcmp(header.Magic, MANIFEST_MAGIC, sizeof(header.Magic))
+        || (header.Version != MANIFEST_VERSION) || (header.RecordSize != sizeof(sManifestRecord))) {
+        fclose(f);
+        return false;
+    }
+
+    bool ok = true;
+    sManifestRecord record;
+    size_t got;
+    while ((got = fread(&record, 1, sizeof(record), f)) == sizeof(record)) {
+        if (record.Type >= TypeCount) {
+            ok = false;
+            break;
+        }
+
+        if (record.Op == MANIFEST_OP_ADD) {
+            sManifestEntry entry = { .Id = record.Id, .Size = record.Size, .Timestamp = record.Timestamp };
+            if (!manifest_insert(record.Type, &entry)) {
+                ok = false;
+                break;
+            }
+        } else if (record.Op == MANIFEST_OP_REMOVE) {
+            manifest_erase(record.Type, record.Id);
+        } else {
+            ok = false;
+            break;
+        }
+        RecordCount++;
+    }
+    if (ok && (got != 0))
+        *pNeedRewrite = true;
+
+    fclose(f);
+    return ok;
+}
+
+/**
+ * @brief 快速检查清单与目录是否一致：每种类型的最新文件存在，下一个序号的文件不存在
+ *
+ * @return true 一致
+ */
+static bool manifest_verify(void)
+{
+    char path[64];
+    struct stat st;
+
+    for (uint8_t type = 0; type < TypeCount; type++) {
+        const sManifestList* pList = &Lists[type];
+
+        if (pList->count > 0) {
+            manifest_FilePath(type, pList->pItems[pList->count - 1].Id, path, sizeof(path));
+            if (stat(path, &st) != 0)
+                return false;
+        }
+        manifest_FilePath(type, manifest_NextId(type), path, sizeof(path));
+        if (stat(path, &st) == 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 文件名以扩展名结尾
+ *
+ * @param pName
+ * @param pExtension
+ * @return true
+ */
+static bool manifest_hasExtension(const char* pName, const char* pExtension)
+{
+    size_t nameLen = strlen(pName);
+    size_t extLen = strlen(pExtension);
+    return (nameLen > extLen) && (strcmp(pName + nameLen - extLen, pExtension) == 0);
+}
+
+/**
+ * @brief 打开保存目录的清单，清单无效或与目录不一致时重建
+ *
+ * @param pDir 保存目录
+ * @param pExtensions 每种类型的扩展名
+ * @param typeCount 类型数（最多 MANIFEST_MAX_TYPES）
+ * @return true 成功，false 类型数超出或目录不可用
+ */
+bool manifest_Open(const char* pDir, const char* const* pExtensions, uint8_t typeCount)
+{
+    // 截断类型数会让多出的类型没有扩展名、序号从 1 开始，互相覆盖
+    if ((typeCount == 0) || (typeCount > MANIFEST_MAX_TYPES)) {
+        printf("Manifest: %u types, at most %d\r\n", typeCount, MANIFEST_MAX_TYPES);
+        return false;
+    }
+
+    snprintf(Dir, sizeof(Dir), "%s", pDir);
+    Extensions = pExtensions;
+    TypeCount = typeCount;
+    manifest_clear();
+
+    // 末尾的记录不完整说明写这条记录时断电：记录对应的文件操作（先于记录）已经完成，
+    // 而 manifest_verify 只检查最新的文件，查不出删除了中间的文件，所以扫描目录重建
+    bool needRewrite;
+    if (!manifest_load(&needRewrite) || needRewrite || !manifest_verify()) {
+        printf("Manifest: rebuilding from %s\r\n", Dir);
+        return manifest_Rebuild();
+    }
+
+    printf("Manifest: %d files, %lu records\r\n", manifest_liveCount(), (unsigned long)RecordCount);
+    return true;
+}
+
+/**
+ * @brief 下一个文件序号
+ *
+ * @param type
+ * @return uint32_t
+ */
+uint32_t manifest_NextId(uint8_t type)
+{
+    if (type >= TypeCount)
+        return 1;
+    return Lists[type].nextId ? Lists[type].nextId : 1;
+}
+
+/**
+ * @brief 文件的完整路径，如 /spiffs/00012.BMP
+ *
+ * @param type
+ * @param id
+ * @param pOut
+ * @param size
+ */
+void manifest_FilePath(uint8_t type, uint32_t id, char* pOut, size_t size)
+{
+    snprintf(pOut, size, "%s/%05lu%s", Dir, (unsigned long)id, (type < TypeCount) ? Extensions[type] : "");
+}
+
+/**
+ * @brief 记录新文件
+ *
+ * @param type
+ * @param id
+ * @param size
+ * @param timestamp
+ * @return true 成功
+ */
+bool manifest_Add(uint8_t type, uint32_t id, uint32_t size, uint32_t timestamp)
+{
+    if (type >= TypeCount)
+        return false;
+
+    sManifestEntry entry = { .Id = id, .Size = size, .Timestamp = timestamp };
+    if (!manifest_insert(type, &entry))
+        return false;
+
+    sManifestRecord record = { .Id = id, .Type = type, .Op = MANIFEST_OP_ADD, .Size = size, .Timestamp = timestamp };
+    return manifest_append(&record);
+}
+
+/**
+ * @brief 删除文件并记录
+ *
+ * 先追加删除记录再删除文件：两步之间断电只会留下清单外的文件（下次重建时重新列出），
+ * 不会列出已经不存在的文件
+ *
+ * @param type
+ * @param id
+ * @return int remove() 的结果：0 成功，-1 失败（errno 为原因，文件不存在时为 ENOENT）
+ */
+int manifest_Remove(uint8_t type, uint32_t id)
+{
+    if (type >= TypeCount) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (manifest_erase(type, id)) {
+        sManifestRecord record = { .Id = id, .Type = type, .Op = MANIFEST_OP_REMOVE };
+        manifest_append(&record);
+    }
+
+    char path[64];
+    manifest_FilePath(type, id, path, sizeof(path));
+    return remove(path);
+}
+
+/**
+ * @brief 删除该类型的全部文件，最后重写一次清单
+ *
+ * @param type
+ * @return int 删除的文件数
+ */
+int manifest_RemoveAll(uint8_t type)
+{
+    if (type >= TypeCount)
+        return 0;
+
+    char path[64];
+    int deleted = 0;
+    sManifestList* pList = &Lists[type];
+    for (int i = 0; i < pList->count; i++) {
+        manifest_FilePath(type, pList->pItems[i].Id, path, sizeof(path));
+        if (remove(path) == 0)
+            deleted++;
+    }
+    pList->count = 0;
+
+    manifest_writeAll();
+    return deleted;
+}
+
+/**
+ * @brief 该类型的文件数
+ *
+ * @param type
+ * @return int
+ */
+int manifest_Count(uint8_t type)
+{
+    return (type < TypeCount) ? Lists[type].count : 0;
+}
+
+/**
+ * @brief 按序号从小到大取出文件
+ *
+ * @param type
+ * @param first 从第几个开始
+ * @param pOut
+ * @param maxCount
+ * @return int 取出的个数
+ */
+int manifest_List(uint8_t type, int first, sManifestEntry* pOut, int maxCount)
+{
+    if ((type >= TypeCount) || (first < 0) || (first >= Lists[type].count))
+        return 0;
+
+    int count = Lists[type].count - first;
+    if (count > maxCount)
+        count = maxCount;
+    memcpy(pOut, &Lists[type].pItems[first], count * sizeof(sManifestEntry));
+    return count;
+}
+
+/**
+ * @brief 扫描目录重建清单
+ *
+ * @return true 成功
+ */
+bool manifest_Rebuild(void)
+{
+    manifest_clear();
+
+    DIR* dr = opendir(Dir);
+    if (dr == NULL)
+        return false;
+
+    char path[300];
+    struct dirent* de;
+    while ((de = readdir(dr)) != NULL) {
+        if ((de->d_type != DT_REG) || (de->d_name[0] < '0') || (de->d_name[0] > '9'))
+            continue;
+
+        for (uint8_t type = 0; type < TypeCount; type++) {
+            if (!manifest_hasExtension(de->d_name, Extensions[type]))
+                continue;
+
+            struct stat st;
+            sManifestEntry entry = { .Id = strtoul(de->d_name, NULL, 10) };
+            manifest_path(de->d_name, path, sizeof(path));
+            if (stat(path, &st) == 0) {
+                entry.Size = st.st_size;
+                entry.Timestamp = st.st_mtime;
+            }
+            manifest_insert(type, &entry);
+            break;
+        }
+    }
+    closedir(dr);
+
+    printf("Manifest: rebuilt, %d files\r\n", manifest_liveCount());
+    return manifest_writeAll();
+}
@@ -0,0 +1,348 @@
+#include "profiler.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_timer.h"
+#else
+#include <time.h>
+#endif
+
+#define PROFILER_RING_MASK (PROFILER_RING_SIZE - 1)
+
+// 采样环中的一条采样，seq 最后写入（= 写入序号 + 1），读到的 seq 不对表示还没写完或已被覆盖
+typedef struct {
+    _Atomic uint32_t seq;
+    uint32_t us;
+    int8_t scope;
+} sProfSample;
+
+// 阶段的汇总数据
+typedef struct {
+    const char* name;
+    uint32_t count;
+    uint64_t sum;
+    uint32_t min;
+    uint32_t max;
+    uint32_t hist[PROFILER_HIST_BINS];
+} sProfScope;
+
+static sProfScope Scopes[PROFILER_MAX_SCOPES];
+static _Atomic int8_t ScopeCount = 0;
+static atomic_flag RegisterBusy = ATOMIC_FLAG_INIT;
+
+static sProfSample Ring[PROFILER_RING_SIZE];
+static _Atomic uint32_t RingHead = 0; // 下一次写入的序号
+static uint32_t RingTail = 0; // 下一次汇总的序号
+static atomic_flag CollectBusy = ATOMIC_FLAG_INIT;
+
+static int8_t FrameScope = -1;
+static uint32_t Frames = 0;
+static uint32_t OverBudget = 0;
+static uint32_t BudgetUs = 62500; // 默认 16Hz
+static uint32_t WorstUs = 0;
+static uint32_t Dropped = 0;
+
+/**
+ * @brief 返回单调递增的微秒时间
+ *
+ * @return uint32_t
+ */
+uint32_t profiler_Now(void)
+{
+#ifdef ESP_PLATFORM
+    return (uint32_t)esp_timer_get_time();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+#endif
+}
+
+/**
+ * @brief 耗时所在的直方图桶
+ *  - 0..3us 每微秒一个桶
+ *  - 之后每个 [2^k, 2^(k+1)) 区间按次高两位分成 4 个桶，相对误差不超过 25%
+ *
+ * @param us
+ * @return uint8_t
+ */
+static uint8_t profiler_bin(uint32_t us)
+{
+    if (us < 4)
+        return us;
+
+    uint8_t msb = 31 - __builtin_clz(us);
+    uint32_t bin = (msb - 1) * 4 + ((us >> (msb - 2)) & 3);
+    return (bin < PROFILER_HIST_BINS) ? bin : (PROFILER_HIST_BINS - 1);
+}
+
+/**
+ * @brief 直方图桶的上界（包含）
+ *
+ * @param bin
+ * @return uint32_t
+ */
+static uint32_t profiler_binUpper(uint8_t bin)
+{
+    if (bin < 4)
+        return bin;
+
+    uint8_t msb = bin / 4 + 1;
+    return ((5u + (bin & 3)) << (msb - 2)) - 1;
+}
+
+/**
+ * @brief 按名字注册阶段
+ *
+ * @param name 阶段名（必须是常量字符串）
+ * @return int8_t 阶段ID，已满返回 -1
+ */
+int8_t profiler_Register(const char* name)
+{
+    int8_t id = -1;
+
+    // 注册只在每个阶段第一次计时时发生，用自旋锁即可
+    while (atomic_flag_test_and_set(&RegisterBusy))
+        ;
+
+    int8_t count = atomic_load(&ScopeCount);
+    for (int8_t i = 0; i < count; i++) {
+        if (strcmp(Scopes[i].name, name) == 0) {
+            id = i;
+            break;
+        }
+    }
+
+    if ((id < 0) && (count < PROFILER_MAX_SCOPES)) {
+        // 先写好阶段再公开，汇总时只访问已公开的阶段
+        id = count;
+        Scopes[id].name = name;
+        Scopes[id].min = UINT32_MAX;
+        atomic_store(&ScopeCount, count + 1);
+    }
+
+    atomic_flag_clear(&RegisterBusy);
+    return id;
+}
+
+/**
+ * @brief 记录一次阶段耗时
+ *
+ * @param scope 阶段ID（-1 时忽略）
+ * @param us 耗时（微秒）
+ */
+void profiler_Record(int8_t scope, uint32_t us)
+{
+    if (scope < 0)
+        return;
+
+    uint32_t idx = atomic_fetch_add(&RingHead, 1);
+    sProfSample* pSample = &Ring[idx & PROFILER_RING_MASK];
+
+    pSample->us = us;
+    pSample->scope = scope;
+    atomic_store_explicit(&pSample->seq, idx + 1, memory_order_release);
+}
+
+/**
+ * @brief 把采样环中的新采样汇总到各阶段（同一时间只有一个调用者汇总，其他调用者直接返回）
+ *
+ */
+void profiler_Collect(void)
+{
+    if (atomic_flag_test_and_set(&CollectBusy))
+        return;
+
+    uint32_t head = atomic_load(&RingHead);
+
+    // 汇总得太慢，最旧的采样已被覆盖
+    if (head - RingTail > PROFILER_RING_SIZE) {
+        Dropped += head - RingTail - PROFILER_RING_SIZE;
+        RingTail = head - PROFILER_RING_SIZE;
+    }
+
+    while (RingTail != head) {
+        sProfSample* pSample = &Ring[RingTail & PROFILER_RING_MASK];
+        uint32_t seq = atomic_load_explicit(&pSample->seq, memory_order_acquire);
+
+        if (seq != RingTail + 1)
+            break; // 还没写完，下次再汇总
+
+        uint32_t us = pSample->us;
+        int8_t scope = pSample->scope;
+
+        // 读的过程中被覆盖则丢弃
+        if (atomic_load_explicit(&pSample->seq, memory_order_acquire) != seq) {
+            Dropped++;
+        } else if (scope < atomic_load(&ScopeCount)) {
+            sProfScope* pScope = &Scopes[scope];
+            pScope->count++;
+            pScope->sum += us;
+            if (us < pScope->min)
+                pScope->min = us;
+            if (us > pScope->max)
+                pScope->max = us;
+            pScope->hist[profiler_bin(us)]++;
+        }
+        RingTail++;
+    }
+
+    atomic_flag_clear(&CollectBusy);
+}
+
+/**
+ * @brief 一帧结束
+ *
+ * @param frameUs 整帧耗时（微秒）
+ */
+void profiler_FrameEnd(uint32_t frameUs)
+{
+    if (FrameScope < 0)
+        FrameScope = profiler_Register("frame");
+
+    profiler_Record(FrameScope, frameUs);
+
+    Frames++;
+    if (frameUs > BudgetUs)
+        OverBudget++;
+    if (frameUs > WorstUs)
+        WorstUs = frameUs;
+
+    profiler_Collect();
+}
+
+/**
+ * @brief 设置帧预算
+ *
+ * @param budgetUs 微秒
+ */
+void profiler_SetFrameBudget(uint32_t budgetUs)
+{
+    BudgetUs = budgetUs;
+}
+
+/**
+ * @brief 读取一个阶段的统计
+ *
+ * @param scope 阶段ID
+ * @param pStats
+ * @return true 阶段存在
+ */
+bool profiler_GetStats(int8_t scope, sProfilerStats* pStats)
+{
+    if ((scope < 0) || (scope >= atomic_load(&ScopeCount)))
+        return false;
+
+    const sProfScope* pScope = &Scopes[scope];
+
+    memset(pStats, 0, sizeof(*pStats));
+    pStats->name = pScope->name;
+    pStats->count = pScope->count;
+    if (pScope->count == 0)
+        return true;
+
+    pStats->min = pScope->min;
+    pStats->max = pScope->max;
+    pStats->avg = (uint32_t)(pScope->sum / pScope->count);
+
+    // 累计到 99% 的桶
+    uint32_t target = pScope->count - pScope->count / 100;
+    uint32_t acc = 0;
+    for (uint8_t bin = 0; bin < PROFILER_HIST_BINS; bin++) {
+        acc += pScope->hist[bin];
+        if (acc >= target) {
+            pStats->p99 = profiler_binUpper(bin);
+            break;
+        }
+    }
+    if (pStats->p99 > pStats->max)
+        pStats->p99 = pStats->max;
+    return true;
+}
+
+/**
+ * @brief 读取整帧统计
+ *
+ * @param pStats
+ */
+void profiler_GetFrameStats(sProfilerFrameStats* pStats)
+{
+    pStats->frames = Frames;
+    pStats->overBudget = OverBudget;
+    pStats->budgetUs = BudgetUs;
+    pStats->worstUs = WorstUs;
+    pStats->dropped = Dropped;
+}
+
+/**
+ * @brief 把全部统计格式化成文本表格
+ *
+ * @param pBuff 目标内存
+ * @param size 目标内存大小
+ * @return int 写入的字符数（不含结尾的 0）
+ */
+int profiler_Format(char* pBuff, size_t size)
+{
+    sProfilerStats stats;
+    size_t len = 0;
+
+    if (size == 0)
+        return 0;
+    pBuff[0] = 0;
+
+    profiler_Collect();
+
+    len += snprintf(pBuff + len, size - len, "%-12s %8s %8s %8s %8s %8s (us)\n", "scope", "count", "min", "avg", "p99", "max");
+
+    for (int8_t i = 0; (i < atomic_load(&ScopeCount)) && (len < size); i++) {
+        profiler_GetStats(i, &stats);
+        len += snprintf(pBuff + len, size - len, "%-12s %8lu %8lu %8lu %8lu %8lu\n", stats.name,
+            (unsigned long)stats.count, (unsigned long)stats.min, (unsigned long)stats.avg,
+            (unsigned long)stats.p99, (unsigned long)stats.max);
+    }
+
+    if (len < size) {
+        len += snprintf(pBuff + len, size - len, "frames %lu, over budget %lu (budget %lu us, worst %lu us), dropped %lu\n",
+            (unsigned long)Frames, (unsigned long)OverBudget, (unsigned long)BudgetUs,
+            (unsigned long)WorstUs, (unsigned long)Dropped);
+    }
+
+    return (len < size) ? (int)len : (int)(size - 1);
+}
+
+/**
+ * @brief 把全部统计打印到串口
+ *
+ */
+void profiler_Print(void)
+{
+    char buff[128 + PROFILER_MAX_SCOPES * 64];
+
+    profiler_Format(buff, sizeof(buff));
+    printf("%s", buff);
+}
+
+/**
+ * @brief 清零全部统计，已注册的阶段保留
+ *
+ */
+void profiler_Reset(void)
+{
+    profiler_Collect();
+
+    for (int8_t i = 0; i < atomic_load(&ScopeCount); i++) {
+        sProfScope* pScope = &Scopes[i];
+        pScope->count = 0;
+        pScope->sum = 0;
+        pScope->min = UINT32_MAX;
+        pScope->max = 0;
+        memset(pScope->hist, 0, sizeof(pScope->hist));
+    }
+
+    Frames = 0;
+    OverBudget = 0;
+    WorstUs = 0;
+    Dropped = 0;
+}
@@ -0,0 +1,277 @@
+#include "qoi.h"
+#include <string.h>
+
+#define QOI_OP_INDEX 0x00
+#define QOI_OP_DIFF 0x40
+#define QOI_OP_LUMA 0x80
+#define QOI_OP_RUN 0xc0
+#define QOI_OP_RGB 0xfe
+#define QOI_OP_RGBA 0xff
+#define QOI_MASK_2 0xc0
+
+// 一个游程最多 62 个像素（63、64 与 RGB/RGBA 操作码冲突）
+#define QOI_RUN_MAX 62
+
+// 初始的上一个像素：不透明黑色
+#define QOI_PREV_INIT 0xFF000000u
+
+#define QOI_R(c) (((c) >> 16) & 0xFF)
+#define QOI_G(c) (((c) >> 8) & 0xFF)
+#define QOI_B(c) ((c) & 0xFF)
+#define QOI_A(c) ((c) >> 24)
+
+static inline uint8_t qoi_hash(uint32_t c)
+{
+    return (QOI_R(c) * 3 + QOI_G(c) * 5 + QOI_B(c) * 7 + QOI_A(c) * 11) & 63;
+}
+
+// RGB565 按位复制扩展为 RGB888（截断回 RGB565 时不变）
+static inline uint32_t qoi_fromRgb565(uint16_t value)
+{
+    uint32_t r = (value >> 11) & 0x1F;
+    uint32_t g = (value >> 5) & 0x3F;
+    uint32_t b = value & 0x1F;
+
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+    return QOI_PREV_INIT | (r << 16) | (g << 8) | b;
+}
+
+static inline uint16_t qoi_toRgb565(uint32_t c)
+{
+    return ((QOI_R(c) & 0xF8) << 8) | ((QOI_G(c) & 0xFC) << 3) | (QOI_B(c) >> 3);
+}
+
+/**
+ * @brief 写文件头（3 通道，sRGB）
+ *
+ * @param pOut
+ * @param width
+ * @param height
+ * @return size_t QOI_HEADER_SIZE
+ */
+size_t qoi_EncodeHeader(uint8_t* pOut, uint32_t width, uint32_t height)
+{
+    memcpy(pOut, "qoif", 4);
+    for (int i = 0; i < 4; i++) {
+        pOut[4 + i] = width >> (24 - i * 8);
+        pOut[8 + i] = height >> (24 - i * 8);
+    }
+    pOut[12] = 3;
+    pOut[13] = 0;
+    return QOI_HEADER_SIZE;
+}
+
+/**
+ * @brief 初始化编码器
+ *
+ * @param pEncoder
+ */
+void qoi_EncoderInit(sQoiEncoder* pEncoder)
+{
+    memset(pEncoder->Index, 0, sizeof(pEncoder->Index));
+    pEncoder->Prev = QOI_PREV_INIT;
+    pEncoder->PrevRgb565 = 0;
+    pEncoder->Run = 0;
+}
+
+/**
+ * @brief 编码像素
+ *  - 与上一个像素相同时直接比较 RGB565 累计游程，不做颜色转换（界面截图大部分是这种情况）
+ *
+ * @param pEncoder
+ * @param pPixels
+ * @param count
+ * @param pOut 长度至少 QOI_MAX_ENCODED(count)
+ * @return size_t 写入的字节数
+ */
+size_t qoi_EncodeRgb565(sQoiEncoder* pEncoder, const uint16_t* pPixels, uint32_t count, uint8_t* pOut)
+{
+    uint8_t* p = pOut;
+    uint16_t prevRgb565 = pEncoder->PrevRgb565;
+    uint32_t prev = pEncoder->Prev;
+    uint8_t run = pEncoder->Run;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t value = pPixels[i];
+
+        if (value == prevRgb565) {
+            if (++run == QOI_RUN_MAX) {
+                *(p++) = QOI_OP_RUN | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+        if (run) {
+            *(p++) = QOI_OP_RUN | (run - 1);
+            run = 0;
+        }
+
+        uint32_t c = qoi_fromRgb565(value);
+        uint8_t hash = qoi_hash(c);
+        if (pEncoder->Index[hash] == c) {
+            *(p++) = QOI_OP_INDEX | hash;
+        } else {
+            pEncoder->Index[hash] = c;
+
+            int8_t dr = (int8_t)(QOI_R(c) - QOI_R(prev));
+            int8_t dg = (int8_t)(QOI_G(c) - QOI_G(prev));
+            int8_t db = (int8_t)(QOI_B(c) - QOI_B(prev));
+            int8_t drDg = (int8_t)(dr - dg);
+            int8_t dbDg = (int8_t)(db - dg);
+
+            if ((dr >= -2) && (dr <= 1) && (dg >= -2) && (dg <= 1) && (db >= -2) && (db <= 1)) {
+                *(p++) = QOI_OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2);
+            } else if ((dg >= -32) && (dg <= 31) && (drDg >= -8) && (drDg <= 7) && (dbDg >= -8) && (dbDg <= 7)) {
+                *(p++) = QOI_OP_LUMA | (dg + 32);
+                *(p++) = ((drDg + 8) << 4) | (dbDg + 8);
+            } else {
+                *(p++) = QOI_OP_RGB;
+                *(p++) = QOI_R(c);
+                *(p++) = QOI_G(c);
+                *(p++) = QOI_B(c);
+            }
+        }
+
+        prev = c;
+        prevRgb565 = value;
+    }
+
+    pEncoder->PrevRgb565 = prevRgb565;
+    pEncoder->Prev = prev;
+    pEncoder->Run = run;
+    return p - pOut;
+}
+
+/**
+ * @brief 结束编码
+ *
+ * @param pEncoder
+ * @param pOut
+ * @return size_t 写入的字节数
+ */
+size_t qoi_EncodeEnd(sQoiEncoder* pEncoder, uint8_t* pOut)
+{
+    uint8_t* p = pOut;
+
+    if (pEncoder->Run) {
+        *(p++) = QOI_OP_RUN | (pEncoder->Run - 1);
+        pEncoder->Run = 0;
+    }
+    memset(p, 0, QOI_END_SIZE - 1);
+    p[QOI_END_SIZE - 1] = 1;
+    return (p - pOut) + QOI_END_SIZE;
+}
+
+/**
+ * @brief 读一个字节
+ *
+ * @param pDecoder
+ * @return int 数据结束时返回 -1
+ */
+static int qoi_readByte(sQoiDecoder* pDecoder)
+{
+    if (pDecoder->Pos >= pDecoder->Len) {
+        pDecoder->Len = pDecoder->Read(pDecoder->pCtx, pDecoder->Buff, sizeof(pDecoder->Buff));
+        pDecoder->Pos = 0;
+        if (pDecoder->Len == 0)
+            return -1;
+    }
+    return pDecoder->Buff[pDecoder->Pos++];
+}
+
+/**
+ * @brief 读取并检查文件头
+ *
+ * @param pDecoder
+ * @param read
+ * @param pCtx
+ * @param pWidth
+ * @param pHeight
+ * @return true 是 QOI 图片
+ */
+bool qoi_DecoderInit(sQoiDecoder* pDecoder, tQoiRead read, void* pCtx, uint32_t* pWidth, uint32_t* pHeight)
+{
+    uint8_t header[QOI_HEADER_SIZE];
+
+    memset(pDecoder->Index, 0, sizeof(pDecoder->Index));
+    pDecoder->Prev = QOI_PREV_INIT;
+    pDecoder->Run = 0;
+    pDecoder->Read = read;
+    pDecoder->pCtx = pCtx;
+    pDecoder->Pos = 0;
+    pDecoder->Len = 0;
+
+    for (int i = 0; i < QOI_HEADER_SIZE; i++) {
+        int value = qoi_readByte(pDecoder);
+        if (value < 0)
+            return false;
+        header[i] = value;
+    }
+    if (memcmp(header, "qoif", 4) || (header[12] < 3) || (header[12] > 4))
+        return false;
+
+    *pWidth = ((uint32_t)header[4] << 24) | (header[5] << 16) | (header[6] << 8) | header[7];
+    *pHeight = ((uint32_t)header[8] << 24) | (header[9] << 16) | (header[10] << 8) | header[11];
+    return true;
+}
+
+/**
+ * @brief 解码像素
+ *
+ * @param pDecoder
+ * @param pOut
+ * @param count
+ * @return uint32_t 解码的像素数
+ */
+uint32_t qoi_DecodeRgb565(sQoiDecoder* pDecoder, uint16_t* pOut, uint32_t count)
+{
+    uint32_t c = pDecoder->Prev;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (pDecoder->Run) {
+            pDecoder->Run--;
+            pOut[i] = qoi_toRgb565(c);
+            continue;
+        }
+
+        int op = qoi_readByte(pDecoder);
+        if (op < 0)
+            return i;
+
+        uint8_t r = QOI_R(c), g = QOI_G(c), b = QOI_B(c), a = QOI_A(c);
+        if ((op == QOI_OP_RGB) || (op == QOI_OP_RGBA)) {
+            int v[4] = { r, g, b, a };
+            for (int n = 0; n < ((op == QOI_OP_RGB) ? 3 : 4); n++) {
+                v[n] = qoi_readByte(pDecoder);
+                if (v[n] < 0)
+                    return i;
+            }
+            r = v[0], g = v[1], b = v[2], a = v[3];
+        } else if ((op & QOI_MASK_2) == QOI_OP_INDEX) {
+            c = pDecoder->Index[op];
+            r = QOI_R(c), g = QOI_G(c), b = QOI_B(c), a = QOI_A(c);
+        } else if ((op & QOI_MASK_2) == QOI_OP_DIFF) {
+            r += ((op >> 4) & 3) - 2;
+            g += ((op >> 2) & 3) - 2;
+            b += (op & 3) - 2;
+        } else if ((op & QOI_MASK_2) == QOI_OP_LUMA) {
+            int op2 = qoi_readByte(pDecoder);
+            if (op2 < 0)
+                return i;
+            int dg = (op & 0x3F) - 32;
+            r += dg - 8 + ((op2 >> 4) & 0x0F);
+            g += dg;
+            b += dg - 8 + (op2 & 0x0F);
+        } else {
+            pDecoder->Run = op & 0x3F;
+        }
+
+        c = ((uint32_t)a << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+        pDecoder->Index[qoi_hash(c)] = c;
+        pDecoder->Prev = c;
+        pOut[i] = qoi_toRgb565(c);
+    }
+    return count;
+}
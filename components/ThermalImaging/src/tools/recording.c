@@ -0,0 +1,189 @@
+#include "recording.h"
+#include <string.h>
+
+// Rice 参数的自适应计数器上限，达到后减半（适应温度场的变化）
+#define RICE_RESET 64
+// 每帧开始时残差均值的初值（约 0.16 度）
+#define RICE_A_INIT 32
+
+// 位写入器（高位在前）
+typedef struct {
+    uint8_t* pOut;
+    uint8_t* pEnd;
+    uint32_t acc;  // 还没有写出的位
+    uint8_t count; // acc 中的位数
+    bool overflow;
+} sBitWriter;
+
+/**
+ * @brief 写入低 bits 位（bits <= 24）
+ *
+ * @param pWriter
+ * @param value
+ * @param bits
+ */
+static inline void bits_Put(sBitWriter* pWriter, uint32_t value, uint8_t bits)
+{
+    pWriter->acc = (pWriter->acc << bits) | (value & ((1u << bits) - 1));
+    pWriter->count += bits;
+
+    while (pWriter->count >= 8) {
+        pWriter->count -= 8;
+        if (pWriter->pOut < pWriter->pEnd)
+            *(pWriter->pOut++) = pWriter->acc >> pWriter->count;
+        else
+            pWriter->overflow = true;
+    }
+}
+
+/**
+ * @brief 写入 count 个 1（count <= RECORDING_RICE_ESCAPE）
+ *
+ * @param pWriter
+ * @param count
+ */
+static inline void bits_PutOnes(sBitWriter* pWriter, uint8_t count)
+{
+    if (count > 16) {
+        bits_Put(pWriter, 0xFFFF, 16);
+        count -= 16;
+    }
+    if (count)
+        bits_Put(pWriter, 0xFFFF, count);
+}
+
+/**
+ * @brief 补齐最后一个字节
+ *
+ * @param pWriter
+ */
+static void bits_Flush(sBitWriter* pWriter)
+{
+    if (pWriter->count)
+        bits_Put(pWriter, 0, 8 - pWriter->count);
+}
+
+/**
+ * @brief 填写录像文件头的固定字段
+ *
+ * @param pHeader
+ * @param width
+ * @param height
+ */
+void recording_InitHeader(sSnapshotHeader* pHeader, uint8_t width, uint8_t height)
+{
+    snapshot_InitHeader(pHeader, width, height, false);
+    memcpy(pHeader->Magic, RECORDING_MAGIC, sizeof(pHeader->Magic));
+    pHeader->Version = RECORDING_VERSION;
+}
+
+/**
+ * @brief 初始化编码器
+ *
+ * @param pEncoder
+ * @param width
+ * @param height
+ * @param keyInterval 关键帧间隔（帧），0 表示只有第一帧是关键帧
+ */
+void recording_EncoderInit(sRecordingEncoder* pEncoder, uint8_t width, uint8_t height, uint16_t keyInterval)
+{
+    if ((uint16_t)width * height > RECORDING_MAX_PIXELS)
+        height = RECORDING_MAX_PIXELS / width;
+
+    pEncoder->Width = width;
+    pEncoder->Height = height;
+    pEncoder->KeyInterval = keyInterval;
+    pEncoder->Frames = 0;
+}
+
+/**
+ * @brief 编码一帧
+ *  - 残差 e 映射为 u = zigzag(e)，Rice 参数 k 取满足 N << k >= A 的最小值（A 为 u 的累计和，N 为个数）
+ *  - 码字为 (u >> k) 个 1、一个 0、u 的低 k 位；商太大时为 RECORDING_RICE_ESCAPE 个 1 加原始值
+ *
+ * @param pEncoder
+ * @param pTemps 温度（Width * Height 个）
+ * @param frameSeq 帧序号
+ * @param timeMs 相对录像开始的时间
+ * @param ta 环境温度
+ * @param pOut
+ * @param outSize
+ * @return size_t 写入的字节数，pOut 太小时返回 0
+ */
+size_t recording_EncodeFrame(sRecordingEncoder* pEncoder, const float* pTemps, uint32_t frameSeq, uint32_t timeMs, float ta,
+    uint8_t* pOut, size_t outSize)
+{
+    uint8_t width = pEncoder->Width;
+    uint16_t pixels = (uint16_t)width * pEncoder->Height;
+    bool key = (pEncoder->Frames == 0) || (pEncoder->KeyInterval && ((pEncoder->Frames % pEncoder->KeyInterval) == 0));
+
+    if (outSize < sizeof(sRecordingFrameHeader))
+        return 0;
+
+    int16_t* pCur = pEncoder->Cur;
+    const int16_t* pPrev = pEncoder->Prev;
+    snapshot_Quantize(pTemps, pixels, SNAPSHOT_TEMP_SCALE, pCur);
+
+    sBitWriter writer = {
+        .pOut = pOut + sizeof(sRecordingFrameHeader),
+        .pEnd = pOut + outSize,
+    };
+    uint32_t a = RICE_A_INIT;
+    uint32_t n = 1;
+
+    for (uint16_t i = 0; i < pixels; i++) {
+        int32_t pred;
+        if (!key)
+            pred = pPrev[i];
+        else if (i % width)
+            pred = pCur[i - 1];
+        else if (i)
+            pred = pCur[i - width];
+        else
+            pred = 0;
+
+        int32_t e = pCur[i] - pred;
+        uint32_t u = (e >= 0) ? ((uint32_t)e << 1) : (((uint32_t)(-e) << 1) - 1);
+
+        uint8_t k = 0;
+        while ((n << k) < a)
+            k++;
+
+        uint32_t q = u >> k;
+        if (q < RECORDING_RICE_ESCAPE) {
+            bits_PutOnes(&writer, q);
+            bits_Put(&writer, 0, 1);
+            if (k)
+                bits_Put(&writer, u, k);
+        } else {
+            bits_PutOnes(&writer, RECORDING_RICE_ESCAPE);
+            bits_Put(&writer, u, RECORDING_RICE_RAW_BITS);
+        }
+
+        a += u;
+        if (++n >= RICE_RESET) {
+            a >>= 1;
+            n >>= 1;
+        }
+    }
+    bits_Flush(&writer);
+    if (writer.overflow)
+        return 0;
+
+    size_t payload = writer.pOut - (pOut + sizeof(sRecordingFrameHeader));
+    sRecordingFrameHeader header = {
+        .Sync = RECORDING_SYNC,
+        .Type = key ? RECORDING_FRAME_KEY : RECORDING_FRAME_DELTA,
+        .PayloadSize = payload,
+        .FrameSeq = frameSeq,
+        .TimeMs = timeMs,
+        .Ta = ta,
+    };
+    memcpy(pOut, &header, sizeof(header));
+
+    // 当前帧成为下一帧的参考
+    memcpy(pEncoder->Prev, pCur, pixels * sizeof(int16_t));
+    pEncoder->Frames++;
+
+    return sizeof(header) + payload;
+}
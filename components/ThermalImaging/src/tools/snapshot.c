@@ -0,0 +1,91 @@
+#include "snapshot.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief 快照文件的字节数
+ *
+ * @param pHeader
+ * @return size_t
+ */
+size_t snapshot_Size(const sSnapshotHeader* pHeader)
+{
+    size_t pixels = (size_t)pHeader->Width * pHeader->Height;
+    size_t size = sizeof(sSnapshotHeader) + pixels * sizeof(int16_t);
+
+    if (pHeader->Flags & SNAPSHOT_FLAG_FLOAT)
+        size += pixels * sizeof(float);
+    return size;
+}
+
+/**
+ * @brief 填写文件头的固定字段，其余字段清零
+ *
+ * @param pHeader
+ * @param width
+ * @param height
+ * @param withFloat 是否附带原始 float 温度块
+ */
+void snapshot_InitHeader(sSnapshotHeader* pHeader, uint8_t width, uint8_t height, bool withFloat)
+{
+    memset(pHeader, 0, sizeof(*pHeader));
+    memcpy(pHeader->Magic, SNAPSHOT_MAGIC, sizeof(pHeader->Magic));
+    pHeader->Version = SNAPSHOT_VERSION;
+    pHeader->HeaderSize = sizeof(sSnapshotHeader);
+    pHeader->Flags = withFloat ? SNAPSHOT_FLAG_FLOAT : 0;
+    pHeader->Width = width;
+    pHeader->Height = height;
+    pHeader->TempScale = SNAPSHOT_TEMP_SCALE;
+}
+
+/**
+ * @brief 温度量化为 int16（快照和录像共用）
+ *
+ * @param pTemps
+ * @param pixels
+ * @param scale 放大倍数
+ * @param pOut
+ */
+void snapshot_Quantize(const float* pTemps, size_t pixels, uint16_t scale, int16_t* pOut)
+{
+    for (size_t i = 0; i < pixels; i++) {
+        float value = pTemps[i] * scale;
+
+        if (!isfinite(pTemps[i]))
+            pOut[i] = SNAPSHOT_INVALID;
+        else if (value >= INT16_MAX)
+            pOut[i] = INT16_MAX;
+        else if (value <= INT16_MIN + 1)
+            pOut[i] = INT16_MIN + 1;
+        else
+            pOut[i] = (int16_t)lrintf(value);
+    }
+}
+
+/**
+ * @brief 编码快照：文件头、int16 温度块、可选的 float 温度块
+ *  - 目标平台和主机都是小端，文件头按结构体原样复制
+ *
+ * @param pHeader
+ * @param pTemps 温度（Width * Height 个）
+ * @param pOut
+ * @param outSize
+ * @return size_t 写入的字节数，pOut 太小时返回 0
+ */
+size_t snapshot_Encode(const sSnapshotHeader* pHeader, const float* pTemps, uint8_t* pOut, size_t outSize)
+{
+    size_t size = snapshot_Size(pHeader);
+    size_t pixels = (size_t)pHeader->Width * pHeader->Height;
+
+    if (outSize < size)
+        return 0;
+
+    memcpy(pOut, pHeader, sizeof(sSnapshotHeader));
+
+    snapshot_Quantize(pTemps, pixels, pHeader->TempScale, (int16_t*)(pOut + sizeof(sSnapshotHeader)));
+
+    if (pHeader->Flags & SNAPSHOT_FLAG_FLOAT)
+        memcpy(pOut + sizeof(sSnapshotHeader) + pixels * sizeof(int16_t), pTemps, pixels * sizeof(float));
+
+    return size;
+}
@@ -0,0 +1,66 @@
+#include "thumbnail.h"
+#include <string.h>
+
+/**
+ * @brief 把一屏 RGB565 缩小成缩略图
+ *  - 每 THUMB_SCALE x THUMB_SCALE 个像素取各分量的平均值，细线和文字缩小后仍然可见
+ *  - 屏幕尺寸不是 THUMB_SCALE 的倍数时丢弃右侧和下方不足一块的像素
+ *
+ * @param pScreen 整屏数据（按行存放）
+ * @param width
+ * @param height
+ * @param pThumb
+ * @return size_t 文件字节数，屏幕太大时返回 0
+ */
+size_t thumbnail_Build(const uint16_t* pScreen, uint16_t width, uint16_t height, sThumbnail* pThumb)
+{
+    uint16_t thumbWidth = width / THUMB_SCALE;
+    uint16_t thumbHeight = height / THUMB_SCALE;
+
+    if ((thumbWidth == 0) || (thumbHeight == 0) || (thumbWidth > THUMB_MAX_WIDTH) || (thumbHeight > THUMB_MAX_HEIGHT))
+        return 0;
+
+    memcpy(pThumb->Header.Magic, THUMB_MAGIC, 4);
+    pThumb->Header.Width = thumbWidth;
+    pThumb->Header.Height = thumbHeight;
+
+    uint16_t* pOut = pThumb->Pixels;
+    for (int ty = 0; ty < thumbHeight; ty++) {
+        const uint16_t* pRow = &pScreen[ty * THUMB_SCALE * width];
+        for (int tx = 0; tx < thumbWidth; tx++) {
+            uint32_t r = 0, g = 0, b = 0;
+            for (int y = 0; y < THUMB_SCALE; y++) {
+                const uint16_t* p = &pRow[y * width + tx * THUMB_SCALE];
+                for (int x = 0; x < THUMB_SCALE; x++) {
+                    r += p[x] >> 11;
+                    g += (p[x] >> 5) & 0x3F;
+                    b += p[x] & 0x1F;
+                }
+            }
+            r /= THUMB_SCALE * THUMB_SCALE;
+            g /= THUMB_SCALE * THUMB_SCALE;
+            b /= THUMB_SCALE * THUMB_SCALE;
+            *(pOut++) = (r << 11) | (g << 5) | b;
+        }
+    }
+
+    return THUMB_FILE_SIZE(thumbWidth, thumbHeight);
+}
+
+/**
+ * @brief 检查读入的缩略图文件
+ *
+ * @param pThumb
+ * @param size 读到的字节数
+ * @return true 文件头有效且像素完整
+ */
+bool thumbnail_Check(const sThumbnail* pThumb, size_t size)
+{
+    const sThumbHeader* pHeader = &pThumb->Header;
+
+    if ((size < sizeof(sThumbHeader)) || memcmp(pHeader->Magic, THUMB_MAGIC, 4))
+        return false;
+    if ((pHeader->Width == 0) || (pHeader->Width > THUMB_MAX_WIDTH) || (pHeader->Height == 0) || (pHeader->Height > THUMB_MAX_HEIGHT))
+        return false;
+    return size >= THUMB_FILE_SIZE(pHeader->Width, pHeader->Height);
+}
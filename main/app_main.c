@@ -8,7 +8,6 @@
 #include "driver/gpio.h"
 #include "wheel.h"
 #include "siq02.h"
-#include "esp_spiffs.h"
 
 EventGroupHandle_t pHandleEventGroup = NULL;
 SemaphoreHandle_t pSPIMutex = NULL;
@@ -37,20 +36,9 @@ void app_main()
 
     gpio_hold_dis(GPIO_NUM_5);
 
-    // 初始化 SPIFFS 文件系统
-    esp_vfs_spiffs_conf_t spiffs_conf = {
-        .base_path = "/spiffs",
-        .partition_label = "storage",
-        .max_files = 5,
-        .format_if_mount_failed = true
-    };
-    esp_err_t spiffs_ret = esp_vfs_spiffs_register(&spiffs_conf);
-    if (spiffs_ret == ESP_OK) {
-        size_t total = 0, used = 0;
-        esp_spiffs_info(spiffs_conf.partition_label, &total, &used);
-        printf("SPIFFS mounted: total=%d bytes, used=%d bytes\n", (int)total, (int)used);
-    } else {
-        printf("Failed to mount SPIFFS (error %d)\n", spiffs_ret);
+    // 挂载内置存储分区（保存的截图、温度图和录像）
+    if (!save_Mount()) {
+        printf("save_Mount failed\n");
     }
 
     // 初始化显示
@@ -71,6 +59,24 @@ void app_main()
     // 设置LCD背光
     dispcolor_SetBrightness(settingsParms.LcdBrightness);
 
+    // 读取保存文件清单，启动存储任务（截图和温度图在后台写入内置存储）
+    if (!save_Init()) {
+        printf("save_Init failed\n");
+    }
+    if (!savetask_Init()) {
+        printf("savetask_Init failed\n");
+    }
+    if (!recordtask_Init()) {
+        printf("recordtask_Init failed\n");
+    }
+    if (!timelapsetask_Init()) {
+        printf("timelapsetask_Init failed\n");
+    }
+#ifdef CONFIG_ESP32_SPI_SDCARD
+    // 挂载 SD 卡并监视插拔（插着卡时录像写在卡上）
+    sdcard_task(NULL);
+#endif
+
     // 创建任务
     pHandleEventGroup = xEventGroupCreate();
 
@@ -0,0 +1,362 @@
+/*
+ * BMP 截图保存方式的基准（主机上运行，模拟闪存）
+ *
+ * 在 capstore_sim 上把同一屏 240x240 RGB565 分别按两种方式写成 BMP（15 位和 32 位）：
+ *  - 原来的方式：文件头逐个字段 fwrite，每行逐像素转换后 fwrite 一次，经过 stdio 默认缓冲
+ *    （缓冲大小取决于 newlib 的配置，分别按 128 和 1024 字节模拟）
+ *  - 现在的方式（save_WriteBmp）：文件头和尽量多的整行转换到 16KB 块缓冲，整块写入，不经过 stdio 缓冲
+ * 统计：
+ *  - 转换和写入调用的 CPU 时间（主机实测，写入到内存中的 capstore 模拟闪存）
+ *  - 文件系统写调用次数和模拟闪存的写入时间
+ * 两种方式写出的文件逐字节比较。设备上每次文件系统调用还有 VFS 和加锁的开销，这里只统计调用次数。
+ * 转换函数与 save.c 相同（原来的逐行转换取自改动前的 save.c）。
+ *
+ * 编译（在仓库根目录）：
+ *   C=components/ThermalImaging
+ *   gcc -O2 -o bmp_bench tools/bmp_bench.c $C/src/tools/capstore.c $C/src/tools/capstore_sim.c \
+ *       -I$C/include/tools -lm
+ *
+ * 用法：
+ *   ./bmp_bench [-n 重复次数]
+ */
+#include "capstore.h"
+#include "capstore_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FLASH_SIZE 0xA0000
+#define BENCH_SECTOR_SIZE 4096
+#define BENCH_W 240
+#define BENCH_H 240
+#define SAVE_BMP_BLOCK_SIZE (16 * 1024)
+#define BMP_HEADER_MAX (14 + 40)
+#define BENCH_MAX_FILE (BMP_HEADER_MAX + BENCH_W * BENCH_H * 4)
+
+// 模拟的 stdio 缓冲
+typedef struct {
+    int handle;
+    uint8_t Buff[1024];
+    size_t size;
+    size_t used;
+} sBenchFile;
+
+static sCapstoreSim Sim;
+static tCapstoreFlash Flash;
+static uint16_t Screen[BENCH_W * BENCH_H];
+static uint8_t Block[SAVE_BMP_BLOCK_SIZE];
+static uint8_t FileA[BENCH_MAX_FILE];
+static uint8_t FileB[BENCH_MAX_FILE];
+static uint32_t Calls = 0;
+
+static double bench_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench_write(int handle, const void* pData, size_t size)
+{
+    capstore_Write(handle, pData, size);
+    Calls++;
+}
+
+static void bench_flush(sBenchFile* f)
+{
+    if (f->used > 0)
+        bench_write(f->handle, f->Buff, f->used);
+    f->used = 0;
+}
+
+// fwrite 经过 stdio 缓冲：缓冲满时整块写出
+static void bench_fwrite(sBenchFile* f, const void* pData, size_t size)
+{
+    const uint8_t* p = pData;
+    while (size > 0) {
+        size_t n = f->size - f->used;
+        if (n > size)
+            n = size;
+        memcpy(f->Buff + f->used, p, n);
+        f->used += n;
+        p += n;
+        size -= n;
+        if (f->used == f->size)
+            bench_flush(f);
+    }
+}
+
+/* ---------- 原来的方式（改动前的 save.c） ---------- */
+
+static void bench_put(sBenchFile* f, uint32_t value, size_t size)
+{
+    bench_fwrite(f, &value, size);
+}
+
+static void OldBmpHeader16(sBenchFile* f, uint16_t width, uint16_t height)
+{
+    uint32_t pixelDataOffset = 14 + 40;
+    bench_put(f, 0x4D42, 2);
+    bench_put(f, (pixelDataOffset + width * height) * 2, 4);
+    bench_put(f, 0, 2);
+    bench_put(f, 0, 2);
+    bench_put(f, pixelDataOffset, 4);
+    bench_put(f, 40, 4);
+    bench_put(f, width, 4);
+    bench_put(f, height, 4);
+    bench_put(f, 1, 2);
+    bench_put(f, 16, 2);
+    for (int i = 0; i < 6; i++)
+        bench_put(f, 0, 4);
+}
+
+static void OldBmpHeader24(sBenchFile* f, uint16_t width, uint16_t height)
+{
+    uint32_t pixelDataOffset = 14 + 12;
+    bench_put(f, 0x4D42, 2);
+    bench_put(f, (pixelDataOffset + width * height) * 4, 4);
+    bench_put(f, 0, 2);
+    bench_put(f, 0, 2);
+    bench_put(f, pixelDataOffset, 4);
+    bench_put(f, 12, 4);
+    bench_put(f, width, 2);
+    bench_put(f, height, 2);
+    bench_put(f, 1, 2);
+    bench_put(f, 32, 2);
+}
+
+static void OldBmpRow15(sBenchFile* f, uint16_t width, const uint16_t* pRgb565, uint8_t* pRowBytes)
+{
+    uint16_t* pOut = (uint16_t*)pRowBytes;
+    for (int col = 0; col < width; col++) {
+        uint16_t v = *(pRgb565++);
+        uint16_t r = v >> 11, g = (v >> 5) & 0x3F, b = v & 0x1F;
+        *(pOut++) = b | ((g >> 1) << 5) | (r << 10);
+    }
+    bench_fwrite(f, pRowBytes, width * 2);
+}
+
+static void OldBmpRow24(sBenchFile* f, uint16_t width, const uint16_t* pRgb565, uint8_t* pRowBytes)
+{
+    uint32_t* pOut = (uint32_t*)pRowBytes;
+    for (int col = 0; col < width; col++) {
+        uint32_t v = *(pRgb565++);
+        uint32_t r = v >> 11, g = (v >> 5) & 0x3F, b = v & 0x1F;
+        *(pOut++) = (b << 3) | ((g << 8) << 2) | ((r << 16) << 3);
+    }
+    bench_fwrite(f, pRowBytes, width * 4);
+}
+
+static void bench_saveOld(const char* pName, bool is16, size_t bufSize)
+{
+    static uint32_t rowBytes[BENCH_W];
+    static sBenchFile f;
+    f.handle = capstore_Open(pName, CAPSTORE_WRITE);
+    f.size = bufSize;
+    f.used = 0;
+
+    if (is16)
+        OldBmpHeader16(&f, BENCH_W, BENCH_H);
+    else
+        OldBmpHeader24(&f, BENCH_W, BENCH_H);
+    for (int row = BENCH_H - 1; row >= 0; row--) {
+        if (is16)
+            OldBmpRow15(&f, BENCH_W, &Screen[row * BENCH_W], (uint8_t*)rowBytes);
+        else
+            OldBmpRow24(&f, BENCH_W, &Screen[row * BENCH_W], (uint8_t*)rowBytes);
+    }
+    bench_flush(&f);
+    capstore_Close(f.handle);
+}
+
+/* ---------- 现在的方式（save.c save_WriteBmp） ---------- */
+
+static uint8_t* bmp_Put16(uint8_t* p, uint16_t value)
+{
+    *(p++) = value;
+    *(p++) = value >> 8;
+    return p;
+}
+
+static uint8_t* bmp_Put32(uint8_t* p, uint32_t value)
+{
+    p = bmp_Put16(p, value);
+    return bmp_Put16(p, value >> 16);
+}
+
+static size_t WriteBmpFileHeaderCore24Bit(uint8_t* pOut, uint16_t width, uint16_t height)
+{
+    uint32_t pixelDataOffset = 14 + 12;
+    uint8_t* p = pOut;
+    p = bmp_Put16(p, 0x4D42);
+    p = bmp_Put32(p, (pixelDataOffset + width * height) * 4);
+    p = bmp_Put16(p, 0);
+    p = bmp_Put16(p, 0);
+    p = bmp_Put32(p, pixelDataOffset);
+    p = bmp_Put32(p, 12);
+    p = bmp_Put16(p, width);
+    p = bmp_Put16(p, height);
+    p = bmp_Put16(p, 1);
+    p = bmp_Put16(p, 32);
+    return p - pOut;
+}
+
+static size_t WriteBmpFileHeaderCore16Bit(uint8_t* pOut, uint16_t width, uint16_t height)
+{
+    uint32_t pixelDataOffset = 14 + 40;
+    uint8_t* p = pOut;
+    p = bmp_Put16(p, 0x4D42);
+    p = bmp_Put32(p, (pixelDataOffset + width * height) * 2);
+    p = bmp_Put16(p, 0);
+    p = bmp_Put16(p, 0);
+    p = bmp_Put32(p, pixelDataOffset);
+    p = bmp_Put32(p, 40);
+    p = bmp_Put32(p, width);
+    p = bmp_Put32(p, height);
+    p = bmp_Put16(p, 1);
+    p = bmp_Put16(p, 16);
+    for (int i = 0; i < 6; i++)
+        p = bmp_Put32(p, 0);
+    return p - pOut;
+}
+
+static size_t ConvertBmpRows_15bit(uint8_t* pOut, const uint16_t* pRow, uint16_t width, int rows)
+{
+    uint8_t* p = pOut;
+    for (int row = 0; row < rows; row++, pRow -= width) {
+        int col = 0;
+        for (; col + 2 <= width; col += 2, p += 4) {
+            uint32_t pair;
+            memcpy(&pair, &pRow[col], 4);
+            pair = ((pair >> 1) & 0x7FE07FE0) | (pair & 0x001F001F);
+            memcpy(p, &pair, 4);
+        }
+        if (col < width) {
+            uint16_t value = pRow[col];
+            value = ((value >> 1) & 0x7FE0) | (value & 0x001F);
+            memcpy(p, &value, 2);
+            p += 2;
+        }
+    }
+    return p - pOut;
+}
+
+static size_t ConvertBmpRows_24bit(uint8_t* pOut, const uint16_t* pRow, uint16_t width, int rows)
+{
+    uint8_t* p = pOut;
+    for (int row = 0; row < rows; row++, pRow -= width) {
+        for (int col = 0; col < width; col++, p += 4) {
+            uint32_t value = pRow[col];
+            value = ((value & 0x001F) << 3) | ((value & 0x07E0) << 5) | ((value & 0xF800) << 8);
+            memcpy(p, &value, 4);
+        }
+    }
+    return p - pOut;
+}
+
+static void bench_saveBlock(const char* pName, bool is16)
+{
+    int handle = capstore_Open(pName, CAPSTORE_WRITE);
+    size_t rowBytes = BENCH_W * (is16 ? 2 : 4);
+    size_t used = is16 ? WriteBmpFileHeaderCore16Bit(Block, BENCH_W, BENCH_H) : WriteBmpFileHeaderCore24Bit(Block, BENCH_W, BENCH_H);
+    int row = BENCH_H - 1;
+
+    while (row >= 0) {
+        int rows = (SAVE_BMP_BLOCK_SIZE - used) / rowBytes;
+        if (rows > row + 1)
+            rows = row + 1;
+        if (is16)
+            used += ConvertBmpRows_15bit(Block + used, &Screen[row * BENCH_W], BENCH_W, rows);
+        else
+            used += ConvertBmpRows_24bit(Block + used, &Screen[row * BENCH_W], BENCH_W, rows);
+        row -= rows;
+        bench_write(handle, Block, used);
+        used = 0;
+    }
+    capstore_Close(handle);
+}
+
+/* ---------- 测量 ---------- */
+
+static size_t bench_readBack(const char* pName, uint8_t* pOut)
+{
+    int handle = capstore_Open(pName, CAPSTORE_READ);
+    int size = (handle >= 0) ? capstore_Read(handle, pOut, BENCH_MAX_FILE) : 0;
+    capstore_Close(handle);
+    return (size > 0) ? size : 0;
+}
+
+/**
+ * @brief 保存 n 次（每次先删除上一次的文件），输出平均的 CPU 时间、写调用次数和模拟闪存时间
+ */
+static void bench_run(const char* pLabel, bool is16, size_t bufSize, int n)
+{
+    double cpu = 0;
+    double flashUs = 0;
+    Calls = 0;
+    for (int i = 0; i < n; i++) {
+        capstore_Remove("BENCH.BMP");
+        while (capstore_NeedsGc() && capstore_GcStep())
+            ;
+        double simStart = Sim.timeUs;
+        double start = bench_Now();
+        if (bufSize)
+            bench_saveOld("BENCH.BMP", is16, bufSize);
+        else
+            bench_saveBlock("BENCH.BMP", is16);
+        cpu += bench_Now() - start;
+        flashUs += Sim.timeUs - simStart;
+    }
+
+    printf("  %-26s %6.1f us cpu, %4lu write calls, flash %6.1f ms\n", pLabel, cpu * 1e6 / n, (unsigned long)(Calls / n),
+        flashUs / 1000 / n);
+}
+
+int main(int argc, char** argv)
+{
+    int n = 50;
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+            n = atoi(argv[++i]);
+    }
+    if (n <= 0)
+        n = 1;
+
+    // 热图界面状的画面
+    for (int y = 0; y < BENCH_H; y++)
+        for (int x = 0; x < BENCH_W; x++)
+            Screen[y * BENCH_W + x] = (x * 37 + y * 11 + (x * y >> 4)) * 2654435761u >> 16;
+
+    capstoresim_Init(&Sim, BENCH_FLASH_SIZE, BENCH_SECTOR_SIZE);
+    capstoresim_GetFlash(&Sim, &Flash);
+    if (capstore_Mount(&Flash) != 0) {
+        printf("mount failed\n");
+        return 1;
+    }
+
+    int errors = 0;
+    for (int bits = 15; bits <= 24; bits += 9) {
+        bool is16 = bits == 15;
+        printf("%d-bit BMP %dx%d, %d saves\n", bits, BENCH_W, BENCH_H, n);
+        bench_run("per-row, 128 B stdio", is16, 128, n);
+        bench_run("per-row, 1024 B stdio", is16, 1024, n);
+        bench_run("16 KB blocks, unbuffered", is16, 0, n);
+
+        // 32 位的文件放不下两个，逐个写出读回
+        bench_saveOld("BENCH.BMP", is16, 128);
+        size_t a = bench_readBack("BENCH.BMP", FileA);
+        capstore_Remove("BENCH.BMP");
+        bench_saveBlock("BENCH.BMP", is16);
+        size_t b = bench_readBack("BENCH.BMP", FileB);
+        capstore_Remove("BENCH.BMP");
+        bool same = (a == b) && (a > 0) && !memcmp(FileA, FileB, a);
+        printf("  files %s (%zu / %zu bytes)\n", same ? "identical" : "DIFFER", a, b);
+        if (!same)
+            errors++;
+    }
+
+    capstore_Unmount();
+    capstoresim_Free(&Sim);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,710 @@
+/*
+ * 保存文件存储（capstore）基准和断电测试（主机上运行）
+ *
+ * 在模拟 NOR 闪存（capstore_sim，大小与 storage 分区相同）上按设备的保存习惯写入：
+ * QOI / BMP 截图和缩略图、辐射快照、清单文件追加和压缩（写临时文件后改名），
+ * 空间不足时删除最早的保存文件。统计每次写调用的延迟（模拟时间）、保存一个文件的耗时、
+ * 写放大和擦除次数分布，分别比较空闲时回收（设备上的回收任务）和只在写入时回收两种情况。
+ * stalls 是空闲段用完、写入时必须一次回收出整个段的次数（分摊的回收跟上时为 0）。
+ *
+ * 编译（在仓库根目录）：
+ *   C=components/ThermalImaging
+ *   gcc -O2 -o capstore_bench tools/capstore_bench.c $C/src/tools/capstore.c $C/src/tools/capstore_sim.c \
+ *       -I$C/include/tools -lm
+ *
+ * 用法：
+ *   ./capstore_bench [-n 保存次数] [-s 随机种子] [-i 两次保存之间的空闲毫秒数] [-c 断电次数]
+ *   -c 时在随机位置模拟断电（包括写到一半的记录和擦除到一半的扇区），重新挂载后检查每个文件的内容，
+ *   断电时正在写入、删除或改名的文件允许是旧内容或新内容
+ * 每次运行前先做挂载检查：空白区域格式化，其他数据（旧的 SPIFFS）和读闪存出错时挂载失败且不修改闪存
+ */
+#include "capstore.h"
+#include "capstore_sim.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// storage 分区大小
+#define BENCH_FLASH_SIZE 0xA0000
+#define BENCH_SECTOR_SIZE 4096
+#define BENCH_WRITE_SIZE 4096 // 每次写调用的字节数（与 stdio 缓冲一致）
+#define BENCH_MAX_FILES 512
+#define BENCH_MAX_SAMPLES (1 << 20)
+
+#define MANIFEST_NAME "CAPTURES.IDX"
+#define MANIFEST_TMP "CAPTURES.TMP"
+#define MANIFEST_RECORD 16
+#define MANIFEST_COMPACT 48 // 追加多少条后压缩
+
+#define THUMB_SIZE 7208 // 60x60 缩略图
+#define BMP_SIZE 115254 // 240x240 RGB565 + 文件头
+#define SNAPSHOT_SIZE 3172
+
+// 文件模型：名字、内容种子、大小
+typedef struct {
+    char Name[CAPSTORE_NAME_MAX];
+    uint32_t Key;
+    uint32_t Size;
+    bool Used;
+} sModelFile;
+
+typedef struct {
+    double* pLatency; // 每次写调用（含关闭）的延迟，us
+    int latencyCount;
+    double* pSave; // 保存一个文件（打开到关闭）的耗时，us
+    int saveCount;
+    uint64_t hostBytes;
+    int saves;
+    int evictions;
+    int failures;
+    int crashes;
+    int verifyErrors;
+} sBenchStats;
+
+static sCapstoreSim Sim;
+static tCapstoreFlash Flash;
+static sModelFile Model[BENCH_MAX_FILES];
+static sBenchStats Stats;
+static uint32_t Rng = 1;
+static uint32_t NextKey = 1;
+static int CaptureIndex = 0;
+static int ManifestRecords = 0;
+
+// 按保存顺序的截图和快照（删除时先删最早的）
+static char Queue[BENCH_MAX_FILES][CAPSTORE_NAME_MAX];
+static int QueueHead = 0;
+static int QueueCount = 0;
+
+static uint32_t bench_rand(void)
+{
+    Rng ^= Rng << 13;
+    Rng ^= Rng >> 17;
+    Rng ^= Rng << 5;
+    return Rng;
+}
+
+static uint8_t bench_byte(uint32_t key, uint32_t offset)
+{
+    uint32_t x = key * 2654435761u + offset * 40503u;
+    return (x >> 13) ^ (x >> 24) ^ offset;
+}
+
+static sModelFile* bench_find(const char* pName)
+{
+    for (int i = 0; i < BENCH_MAX_FILES; i++) {
+        if (Model[i].Used && (strcmp(Model[i].Name, pName) == 0))
+            return &Model[i];
+    }
+    return NULL;
+}
+
+static void bench_set(const char* pName, uint32_t key, uint32_t size)
+{
+    sModelFile* m = bench_find(pName);
+    for (int i = 0; (m == NULL) && (i < BENCH_MAX_FILES); i++) {
+        if (!Model[i].Used)
+            m = &Model[i];
+    }
+    if (m == NULL)
+        return;
+    snprintf(m->Name, sizeof(m->Name), "%s", pName);
+    m->Key = key;
+    m->Size = size;
+    m->Used = true;
+}
+
+static void bench_unset(const char* pName)
+{
+    sModelFile* m = bench_find(pName);
+    if (m != NULL)
+        m->Used = false;
+}
+
+static void bench_sample(double** ppSamples, int* pCount, double value)
+{
+    if (*pCount < BENCH_MAX_SAMPLES)
+        (*ppSamples)[(*pCount)++] = value;
+}
+
+/**
+ * @brief 写文件内容（从 start 到 start + size），统计每次写调用的延迟
+ *
+ * @param handle
+ * @param key
+ * @param start
+ * @param size
+ * @return int 0 / -errno
+ */
+static int bench_fill(int handle, uint32_t key, uint32_t start, uint32_t size)
+{
+    uint8_t buff[BENCH_WRITE_SIZE];
+
+    for (uint32_t pos = 0; pos < size;) {
+        uint32_t count = size - pos;
+        if (count > sizeof(buff))
+            count = sizeof(buff);
+        for (uint32_t i = 0; i < count; i++)
+            buff[i] = bench_byte(key, start + pos + i);
+
+        double t = Sim.timeUs;
+        int ret = capstore_Write(handle, buff, count);
+        bench_sample(&Stats.pLatency, &Stats.latencyCount, Sim.timeUs - t);
+        if (ret < 0)
+            return ret;
+        pos += count;
+    }
+    return 0;
+}
+
+static int bench_close(int handle)
+{
+    double t = Sim.timeUs;
+    int ret = capstore_Close(handle);
+    bench_sample(&Stats.pLatency, &Stats.latencyCount, Sim.timeUs - t);
+    return ret;
+}
+
+/**
+ * @brief 写一个文件（覆盖或追加）
+ *
+ * @param pName
+ * @param size 写入的字节数
+ * @param append
+ * @return int 0 / -errno
+ */
+static int bench_writeFile(const char* pName, uint32_t size, bool append)
+{
+    const sModelFile* m = bench_find(pName);
+    uint32_t key = (append && m) ? m->Key : NextKey++;
+    uint32_t start = (append && m) ? m->Size : 0;
+    double t = Sim.timeUs;
+
+    int handle = capstore_Open(pName, append ? CAPSTORE_APPEND : CAPSTORE_WRITE);
+    if (handle < 0)
+        return handle;
+    int err = bench_fill(handle, key, start, size);
+    int closeErr = bench_close(handle);
+    if (err == 0)
+        err = closeErr;
+    if (err != 0)
+        return err;
+
+    bench_sample(&Stats.pSave, &Stats.saveCount, Sim.timeUs - t);
+    Stats.hostBytes += size;
+    bench_set(pName, key, start + size);
+    return 0;
+}
+
+/**
+ * @brief 删除最早的一次保存
+ *
+ * @return true 删除了
+ */
+static bool bench_evict(void)
+{
+    if (QueueCount == 0)
+        return false;
+
+    const char* pName = Queue[QueueHead];
+    capstore_Remove(pName);
+    bench_unset(pName);
+
+    // 截图同时删除缩略图
+    char thumb[CAPSTORE_NAME_MAX];
+    snprintf(thumb, sizeof(thumb), "%.*s.TH", (int)strcspn(pName, "."), pName);
+    if (capstore_Remove(thumb) == 0)
+        bench_unset(thumb);
+
+    QueueHead = (QueueHead + 1) % BENCH_MAX_FILES;
+    QueueCount--;
+    Stats.evictions++;
+    return true;
+}
+
+/**
+ * @brief 写文件，空间不足时删除最早的保存后重试
+ */
+static int bench_save(const char* pName, uint32_t size, bool append)
+{
+    sCapstoreInfo info;
+
+    capstore_Info(&info);
+    while ((info.used + size + size / 8 + 4096 > info.capacity) && bench_evict())
+        capstore_Info(&info);
+
+    int err;
+    while (((err = bench_writeFile(pName, size, append)) == -ENOSPC) && !Sim.failed && bench_evict())
+        ;
+    return err;
+}
+
+/**
+ * @brief 清单追加一条记录，攒够后压缩（写临时文件再改名）
+ */
+static int bench_manifest(void)
+{
+    int err = bench_save(MANIFEST_NAME, MANIFEST_RECORD, true);
+    if ((err != 0) || (++ManifestRecords < MANIFEST_COMPACT))
+        return err;
+
+    ManifestRecords = 0;
+    err = bench_save(MANIFEST_TMP, (QueueCount + 1) * MANIFEST_RECORD, false);
+    if (err != 0)
+        return err;
+    err = capstore_Rename(MANIFEST_TMP, MANIFEST_NAME);
+    if (err == 0) {
+        sModelFile* m = bench_find(MANIFEST_TMP);
+        bench_set(MANIFEST_NAME, m->Key, m->Size);
+        bench_unset(MANIFEST_TMP);
+    }
+    return err;
+}
+
+/**
+ * @brief 一次保存：截图（加缩略图）或快照，然后追加清单
+ *
+ * @return int 0 / -errno
+ */
+static int bench_capture(void)
+{
+    char name[CAPSTORE_NAME_MAX];
+    uint32_t r = bench_rand() % 100;
+    int err;
+
+    CaptureIndex++;
+    if (r < 50) {
+        snprintf(name, sizeof(name), "SCR%05d.QOI", CaptureIndex);
+        err = bench_save(name, 20000 + bench_rand() % 40000, false);
+    } else if (r < 65) {
+        snprintf(name, sizeof(name), "SCR%05d.BMP", CaptureIndex);
+        err = bench_save(name, BMP_SIZE, false);
+    } else {
+        snprintf(name, sizeof(name), "TIR%05d.TIR", CaptureIndex);
+        err = bench_save(name, SNAPSHOT_SIZE, false);
+    }
+    if (err != 0)
+        return err;
+
+    snprintf(Queue[(QueueHead + QueueCount) % BENCH_MAX_FILES], CAPSTORE_NAME_MAX, "%s", name);
+    QueueCount++;
+    Stats.saves++;
+
+    if (r < 65) {
+        char thumb[CAPSTORE_NAME_MAX];
+        snprintf(thumb, sizeof(thumb), "SCR%05d.TH", CaptureIndex);
+        err = bench_save(thumb, THUMB_SIZE, false);
+        if (err != 0)
+            return err;
+    }
+    return bench_manifest();
+}
+
+/**
+ * @brief 检查一个文件的内容
+ *
+ * @param m
+ * @return true 内容正确
+ */
+static bool bench_check(const sModelFile* m)
+{
+    uint8_t buff[BENCH_WRITE_SIZE];
+    uint32_t size;
+
+    if (!capstore_Stat(m->Name, &size) || (size != m->Size))
+        return false;
+
+    int handle = capstore_Open(m->Name, CAPSTORE_READ);
+    if (handle < 0)
+        return false;
+    bool ok = true;
+    for (uint32_t pos = 0; ok && (pos < size);) {
+        int count = capstore_Read(handle, buff, sizeof(buff));
+        ok = count > 0;
+        for (int i = 0; ok && (i < count); i++)
+            ok = buff[i] == bench_byte(m->Key, pos + i);
+        pos += count;
+    }
+    capstore_Close(handle);
+    return ok;
+}
+
+/**
+ * @brief 文件是否处于模型中的状态（pState 不是这个名字时应该不存在）
+ *
+ * @param pState
+ * @param pName
+ * @return true
+ */
+static bool bench_matches(const sModelFile* pState, const char* pName)
+{
+    if (pState->Used && (strcmp(pState->Name, pName) == 0))
+        return bench_check(pState);
+    return !capstore_Stat(pName, NULL);
+}
+
+/**
+ * @brief 重新挂载后检查全部文件
+ *  - pOld：断电前一次保存开始时的模型，和当前模型相同的文件必须完整
+ *  - 断电时正在写入、删除或改名的文件可以是修改前或修改后的状态，检查后把模型改成实际的状态
+ *
+ * @param pOld
+ * @return int 错误数
+ */
+static int bench_verify(const sModelFile* pOld)
+{
+    static sModelFile now[BENCH_MAX_FILES];
+    int errors = 0;
+
+    memcpy(now, Model, sizeof(now));
+    for (int i = 0; i < BENCH_MAX_FILES; i++) {
+        const sModelFile* n = &now[i];
+        const sModelFile* o = &pOld[i];
+        bool same = (n->Used == o->Used) && (!n->Used || ((strcmp(n->Name, o->Name) == 0) && (n->Key == o->Key) && (n->Size == o->Size)));
+
+        if (same) {
+            if (n->Used && !bench_check(n)) {
+                printf("  lost %s (%lu bytes)\r\n", n->Name, (unsigned long)n->Size);
+                errors++;
+            }
+            continue;
+        }
+
+        // 修改中的文件：新状态或旧状态
+        for (int k = 0; k < 2; k++) {
+            const sModelFile* pState = k ? o : n;
+            if (!pState->Used || ((k == 1) && n->Used && (strcmp(n->Name, o->Name) == 0)))
+                continue;
+            const char* pName = pState->Name;
+            if (bench_matches(n, pName)) {
+                // 新状态，模型不变
+            } else if (bench_matches(o, pName)) {
+                if (o->Used && (strcmp(o->Name, pName) == 0))
+                    bench_set(pName, o->Key, o->Size);
+                else
+                    bench_unset(pName);
+            } else {
+                printf("  %s is neither old nor new\r\n", pName);
+                bench_unset(pName);
+                errors++;
+            }
+        }
+    }
+
+    // 不应该有模型之外的文件（断电时的临时文件除外）
+    char name[CAPSTORE_NAME_MAX];
+    for (int i = 0; capstore_List(i, name, sizeof(name), NULL); i++) {
+        if (bench_find(name) != NULL)
+            continue;
+        bool wasOld = false;
+        for (int j = 0; j < BENCH_MAX_FILES; j++)
+            wasOld |= pOld[j].Used && (strcmp(pOld[j].Name, name) == 0);
+        if (!wasOld && (strcmp(name, MANIFEST_TMP) != 0)) {
+            printf("  unexpected file %s\r\n", name);
+            errors++;
+        }
+    }
+    return errors;
+}
+
+static int bench_compare(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double bench_percentile(double* pSamples, int count, double p)
+{
+    if (count == 0)
+        return 0;
+    return pSamples[(int)((count - 1) * p)];
+}
+
+/**
+ * @brief 运行一遍工作负载
+ *
+ * @param saves 保存次数
+ * @param idleMs 两次保存之间的空闲时间（0：不在空闲时回收）
+ * @param crashes 模拟断电次数
+ * @param seed
+ */
+static void bench_run(int saves, int idleMs, int crashes, uint32_t seed)
+{
+    memset(Model, 0, sizeof(Model));
+    Stats.latencyCount = 0;
+    Stats.saveCount = 0;
+    Stats.hostBytes = 0;
+    Stats.saves = Stats.evictions = Stats.failures = Stats.crashes = Stats.verifyErrors = 0;
+    Rng = seed ? seed : 1;
+    NextKey = 1;
+    CaptureIndex = 0;
+    ManifestRecords = 0;
+    QueueHead = QueueCount = 0;
+
+    capstoresim_Init(&Sim, BENCH_FLASH_SIZE, BENCH_SECTOR_SIZE);
+    capstoresim_GetFlash(&Sim, &Flash);
+    if (capstore_Mount(&Flash) != 0) {
+        printf("mount failed\r\n");
+        return;
+    }
+
+    // 断电点在总写入量中均匀分布
+    uint64_t crashEvery = crashes ? (uint64_t)saves * 40000 / crashes : 0;
+    static sModelFile old[BENCH_MAX_FILES];
+
+    while (Stats.saves < saves) {
+        if (crashEvery && (Sim.failAfter < 0) && (Stats.crashes < crashes))
+            Sim.failAfter = bench_rand() % (crashEvery * 2);
+
+        memcpy(old, Model, sizeof(old));
+        int err = bench_capture();
+
+        // 空闲时回收，最多用掉空闲时间
+        double idleEnd = Sim.timeUs + idleMs * 1000.0;
+        while (!Sim.failed && idleMs && (Sim.timeUs < idleEnd) && capstore_NeedsGc())
+            capstore_GcStep();
+
+        if (Sim.failed) {
+            // 断电：重新上电挂载，检查文件
+            Stats.crashes++;
+            Sim.failed = false;
+            Sim.failAfter = -1;
+            if (capstore_Mount(&Flash) != 0) {
+                printf("remount failed after crash %d\r\n", Stats.crashes);
+                Stats.verifyErrors++;
+                break;
+            }
+            Stats.verifyErrors += bench_verify(old);
+            // 删除队列中已经不存在的文件
+            while ((QueueCount > 0) && !capstore_Stat(Queue[QueueHead], NULL)) {
+                QueueHead = (QueueHead + 1) % BENCH_MAX_FILES;
+                QueueCount--;
+            }
+            continue;
+        }
+        if (err != 0) {
+            Stats.failures++;
+            if (Stats.failures > 100) {
+                printf("too many failures (%d)\r\n", err);
+                break;
+            }
+        }
+    }
+
+    // 正常卸载后重新挂载，检查全部文件
+    if (crashes) {
+        capstore_Mount(&Flash);
+        Stats.verifyErrors += bench_verify(Model);
+    }
+}
+
+// 挂载检查：第 ReadsLeft 次读闪存时返回错误（< 0 时不出错）
+static int (*SimRead)(void* pCtx, uint32_t addr, void* pBuff, size_t size);
+static int ReadsLeft = -1;
+static int ReadCount = 0;
+
+static int bench_failRead(void* pCtx, uint32_t addr, void* pBuff, size_t size)
+{
+    ReadCount++;
+    if (ReadsLeft == 0)
+        return -1;
+    if (ReadsLeft > 0)
+        ReadsLeft--;
+    return SimRead(pCtx, addr, pBuff, size);
+}
+
+/**
+ * @brief 在第 failAt 次读时出错的情况下挂载，出错时必须返回 -EIO 且不修改闪存
+ *
+ * @param pFlash 读函数为 bench_failRead 的后端
+ * @param pCopy 挂载前的闪存内容
+ * @param failAt
+ * @return int 挂载结果
+ */
+static int bench_mountWithReadError(const tCapstoreFlash* pFlash, const uint8_t* pCopy, int failAt, int* pErrors)
+{
+    ReadsLeft = failAt;
+    int ret = capstore_Mount(pFlash);
+    bool failed = ReadsLeft == 0;
+    ReadsLeft = -1;
+
+    if (failed && ((ret != -EIO) || memcmp(Sim.pData, pCopy, Sim.size))) {
+        printf("  read error at read %d: mount returned %d, flash %s\r\n", failAt, ret,
+            memcmp(Sim.pData, pCopy, Sim.size) ? "modified" : "unchanged");
+        (*pErrors)++;
+    }
+    return ret;
+}
+
+/**
+ * @brief 挂载检查：
+ *  - 空白区域格式化
+ *  - 其他数据（模拟旧的 SPIFFS 映像）返回 -ENODEV，闪存不变；capstore_Format 之后为空存储
+ *  - 挂载时任意一次读闪存出错都返回 -EIO，闪存不变，之后正常挂载时文件完整
+ *
+ * @return int 错误数
+ */
+static int bench_mountChecks(void)
+{
+    int errors = 0;
+    uint8_t* pCopy = malloc(BENCH_FLASH_SIZE);
+    if (pCopy == NULL)
+        return 1;
+
+    capstoresim_Init(&Sim, BENCH_FLASH_SIZE, BENCH_SECTOR_SIZE);
+    capstoresim_GetFlash(&Sim, &Flash);
+    tCapstoreFlash failing = Flash;
+    SimRead = Flash.read;
+    failing.read = bench_failRead;
+
+    // 空白区域：读段头或检查空白时出错不能格式化
+    memcpy(pCopy, Sim.pData, Sim.size);
+    for (int failAt = 0; failAt < BENCH_FLASH_SIZE / CAPSTORE_SEGMENT_SIZE + 4; failAt += 3)
+        bench_mountWithReadError(&failing, pCopy, failAt, &errors);
+    if (capstore_Mount(&Flash) != 0) {
+        printf("  blank region not formatted\r\n");
+        errors++;
+    }
+
+    // 写一些文件后卸载，在每个读位置模拟读出错
+    memset(Model, 0, sizeof(Model));
+    NextKey = 1;
+    char name[CAPSTORE_NAME_MAX];
+    for (int i = 0; i < 20; i++) {
+        snprintf(name, sizeof(name), "%05d.QOI", i);
+        if (bench_writeFile(name, 1000 + bench_rand() % 15000, false) != 0)
+            errors++;
+    }
+    capstore_Unmount();
+    memcpy(pCopy, Sim.pData, Sim.size);
+
+    ReadCount = 0;
+    capstore_Mount(&failing);
+    capstore_Unmount();
+    int reads = ReadCount;
+    int points = 0;
+    for (int failAt = 0; failAt < reads; failAt += (reads > 400) ? reads / 400 : 1, points++)
+        bench_mountWithReadError(&failing, pCopy, failAt, &errors);
+    if ((capstore_Mount(&Flash) != 0) || (bench_verify(Model) != 0)) {
+        printf("  files lost after read errors\r\n");
+        errors++;
+    }
+    capstore_Unmount();
+
+    // 其他数据：旧的 SPIFFS 映像（前半部分写满不是段头的页）
+    memset(Sim.pData, 0xFF, Sim.size);
+    for (uint32_t i = 0; i < Sim.size / 2; i++)
+        Sim.pData[i] = bench_rand();
+    memcpy(pCopy, Sim.pData, Sim.size);
+    int ret = capstore_Mount(&Flash);
+    if ((ret != -ENODEV) || memcmp(Sim.pData, pCopy, Sim.size)) {
+        printf("  foreign data: mount returned %d, flash %s\r\n", ret, memcmp(Sim.pData, pCopy, Sim.size) ? "modified" : "unchanged");
+        errors++;
+    }
+    sCapstoreInfo info;
+    memset(Model, 0, sizeof(Model));
+    if (!capstore_Format(&Flash) || (bench_writeFile("00001.BMP", 50000, false) != 0) || (capstore_Mount(&Flash) != 0)) {
+        printf("  format failed\r\n");
+        errors++;
+    }
+    capstore_Info(&info);
+    if ((info.files != 1) || (bench_verify(Model) != 0)) {
+        printf("  %d files after format\r\n", info.files);
+        errors++;
+    }
+
+    printf("mount checks: blank formatted, foreign data kept, %d read error points (of %d reads) kept flash unchanged, format: %s\r\n",
+        points, reads, errors ? "FAILED" : "OK");
+    capstore_Unmount();
+    capstoresim_Free(&Sim);
+    memset(Model, 0, sizeof(Model));
+    free(pCopy);
+    return errors;
+}
+
+static void bench_report(const char* pLabel, int idleMs)
+{
+    sCapstoreInfo info;
+    capstore_Info(&info);
+
+    qsort(Stats.pLatency, Stats.latencyCount, sizeof(double), bench_compare);
+    qsort(Stats.pSave, Stats.saveCount, sizeof(double), bench_compare);
+
+    uint32_t sectors = Sim.size / Sim.sectorSize;
+    uint32_t eraseMin = Sim.pEraseCounts[0], eraseMax = 0;
+    uint64_t eraseSum = 0;
+    for (uint32_t i = 0; i < sectors; i++) {
+        uint32_t count = Sim.pEraseCounts[i];
+        eraseSum += count;
+        if (count < eraseMin)
+            eraseMin = count;
+        if (count > eraseMax)
+            eraseMax = count;
+    }
+
+    printf("%s (idle %d ms between saves)\r\n", pLabel, idleMs);
+    printf("  saves %d, evicted %d, failed %d, files %d, used %lu/%lu bytes\r\n", Stats.saves, Stats.evictions, Stats.failures,
+        info.files, (unsigned long)info.used, (unsigned long)info.capacity);
+    printf("  write call latency (ms): p50 %.2f  p99 %.2f  max %.2f\r\n", bench_percentile(Stats.pLatency, Stats.latencyCount, 0.5) / 1000,
+        bench_percentile(Stats.pLatency, Stats.latencyCount, 0.99) / 1000, bench_percentile(Stats.pLatency, Stats.latencyCount, 1.0) / 1000);
+    printf("  file save time (ms):     p50 %.1f  p99 %.1f  max %.1f\r\n", bench_percentile(Stats.pSave, Stats.saveCount, 0.5) / 1000,
+        bench_percentile(Stats.pSave, Stats.saveCount, 0.99) / 1000, bench_percentile(Stats.pSave, Stats.saveCount, 1.0) / 1000);
+    printf("  write amplification %.2f (host %llu, flash %llu bytes), foreground gc steps %lu, stalls %lu\r\n",
+        Stats.hostBytes ? (double)Sim.bytesWritten / Stats.hostBytes : 0, (unsigned long long)Stats.hostBytes,
+        (unsigned long long)Sim.bytesWritten, (unsigned long)info.foregroundGc, (unsigned long)info.gcStalls);
+    printf("  sector erases min %lu avg %.1f max %lu, program violations %lu\r\n", (unsigned long)eraseMin, (double)eraseSum / sectors,
+        (unsigned long)eraseMax, (unsigned long)Sim.violations);
+    if (Stats.crashes || Stats.verifyErrors)
+        printf("  crashes %d, verify errors %d\r\n", Stats.crashes, Stats.verifyErrors);
+}
+
+int main(int argc, char** argv)
+{
+    int saves = 2000;
+    int idleMs = 1000;
+    int crashes = 0;
+    uint32_t seed = 12345;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+            saves = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+            seed = strtoul(argv[++i], NULL, 0);
+        else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc))
+            idleMs = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc))
+            crashes = atoi(argv[++i]);
+        else {
+            printf("usage: %s [-n saves] [-s seed] [-i idle_ms] [-c crashes]\r\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Stats.pLatency = malloc(BENCH_MAX_SAMPLES * sizeof(double));
+    Stats.pSave = malloc(BENCH_MAX_SAMPLES * sizeof(double));
+    if (!Stats.pLatency || !Stats.pSave)
+        return 1;
+
+    printf("flash %d KB, segment %d KB, %d saves\r\n", BENCH_FLASH_SIZE / 1024, CAPSTORE_SEGMENT_SIZE / 1024, saves);
+    int errors = bench_mountChecks();
+    if (crashes) {
+        bench_run(saves, idleMs, crashes, seed);
+        bench_report("power-fail", idleMs);
+        errors += Stats.verifyErrors;
+    } else {
+        bench_run(saves, idleMs, 0, seed);
+        bench_report("idle gc", idleMs);
+        capstore_Unmount();
+        capstoresim_Free(&Sim);
+
+        bench_run(saves, 0, 0, seed);
+        bench_report("foreground gc only", 0);
+    }
+
+    capstore_Unmount();
+    capstoresim_Free(&Sim);
+    free(Stats.pLatency);
+    free(Stats.pSave);
+    return errors ? 2 : 0;
+}
@@ -0,0 +1,312 @@
+/*
+ * 压缩字体检查和文字绘制计时（主机上运行）
+ *
+ * 检查：
+ *  - 源码中字符串常量用到的每个字符（含 CELSIUS_SYMBOL / FAHRENHEIT_SYMBOL 的 0xB0），
+ *    压缩表 f6x8m_rle / f10x16f_rle 都能解码，且与原始点阵表逐字节一致
+ *  - 压缩表收录的全部字符与原始点阵表逐字节一致
+ * 计时：在内存帧缓冲（hostfb）上按主界面每帧的写法画文字，走完整的 dispcolor 路径
+ * （dispcolor_getStrWidth 每个字符查一次字体表，dispcolor_printf 经过字符串缓存和字形缓存），
+ * 数值每帧变化，字符串缓存会不断失效。字体表由 font.h 中的 FONT_STORAGE 选择，
+ * 用 -DFONT_STORAGE=FONT_STORAGE_RAW 重新编译得到原始表的对比数据。
+ *
+ * 编译（在仓库根目录）：
+ *   C=components/ThermalImaging
+ *   gcc -O2 -o font_check tools/font_check.c $C/src/lcd/dispcolor.c $C/src/lcd/hostfb.c \
+ *       $C/src/lcd/compositor.c $C/src/lcd/textcache.c $C/src/lcd/font/f*.c \
+ *       -I$C/include -I$C/include/lcd -I$C/include/tasks -I$C/include/tools -I$C/include/iic -lm
+ *
+ * 用法：
+ *   ./font_check [-n 帧数] [源文件...]
+ * 不给源文件时扫描 components/ThermalImaging 下 src 和 include 中的 .c / .h（字体表本身除外）。
+ * 有字符解码不出来或与原始表不一致时返回 1。
+ */
+#include "CelsiusSymbol.h"
+#include "dispbackend.h"
+#include "dispcolor.h"
+#include "f16f.h"
+#include "f6x8m.h"
+#include "font.h"
+#include "hostfb.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK_ROOT "components/ThermalImaging"
+
+typedef struct {
+    const char* pName;
+    uint8_t* (*pRaw)(uint8_t Char);
+    uint8_t* (*pRle)(uint8_t Char);
+    uint8_t bytesPerRow;
+} sCheckFont;
+
+static const sCheckFont Fonts[] = {
+    { "f6x8m", f6x8m_GetCharTable, f6x8m_rle_GetCharTable, 1 },
+    { "f16f", f10x16f_GetCharTable, f10x16f_rle_GetCharTable, 2 },
+};
+#define FONT_COUNT (sizeof(Fonts) / sizeof(Fonts[0]))
+
+// 每个字符第一次出现的位置
+static char Where[256][96];
+static int Errors = 0;
+static volatile uint32_t Sink;
+
+static double check_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void check_Use(uint8_t c, const char* pPath, int line)
+{
+    if ((c < 0x20) || (c == 0x7F) || Where[c][0])
+        return;
+    snprintf(Where[c], sizeof(Where[c]), "%s:%d", pPath, line);
+}
+
+/**
+ * @brief 取出文件中所有字符串常量的字符（跳过注释和字符常量，处理转义）
+ */
+static void check_ScanFile(const char* pPath)
+{
+    FILE* f = fopen(pPath, "rb");
+    if (f == NULL) {
+        printf("cannot open %s\n", pPath);
+        Errors++;
+        return;
+    }
+
+    int line = 1;
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        if (c == '\n') {
+            line++;
+        } else if (c == '/') {
+            int next = fgetc(f);
+            if (next == '/') {
+                while (((c = fgetc(f)) != EOF) && (c != '\n'))
+                    ;
+                line++;
+            } else if (next == '*') {
+                int prev = 0;
+                while (((c = fgetc(f)) != EOF) && !((prev == '*') && (c == '/'))) {
+                    if (c == '\n')
+                        line++;
+                    prev = c;
+                }
+            } else if (next != EOF) {
+                ungetc(next, f);
+            }
+        } else if (c == '\'') {
+            while (((c = fgetc(f)) != EOF) && (c != '\'')) {
+                if (c == '\\')
+                    fgetc(f);
+            }
+        } else if (c == '"') {
+            while (((c = fgetc(f)) != EOF) && (c != '"') && (c != '\n')) {
+                if (c != '\\') {
+                    check_Use(c, pPath, line);
+                    continue;
+                }
+
+                c = fgetc(f);
+                if (c == 'x') {
+                    unsigned value = 0;
+                    int digit;
+                    while (((digit = fgetc(f)) != EOF) && strchr("0123456789abcdefABCDEF", digit))
+                        value = value * 16 + ((digit <= '9') ? (digit - '0') : ((digit | 0x20) - 'a' + 10));
+                    ungetc(digit, f);
+                    check_Use(value, pPath, line);
+                } else if ((c >= '0') && (c <= '7')) {
+                    unsigned value = c - '0';
+                    for (int i = 0; i < 2; i++) {
+                        int digit = fgetc(f);
+                        if ((digit < '0') || (digit > '7')) {
+                            ungetc(digit, f);
+                            break;
+                        }
+                        value = value * 8 + (digit - '0');
+                    }
+                    check_Use(value, pPath, line);
+                } else if ((c == '\\') || (c == '"') || (c == '\'') || (c == '?')) {
+                    check_Use(c, pPath, line);
+                } else if (c == '\n') {
+                    line++;
+                }
+            }
+            if (c == '\n')
+                line++;
+        }
+    }
+    fclose(f);
+}
+
+static void check_ScanDir(const char* pDir)
+{
+    DIR* pD = opendir(pDir);
+    if (pD == NULL) {
+        printf("cannot open %s (run from the repository root)\n", pDir);
+        Errors++;
+        return;
+    }
+
+    struct dirent* pEntry;
+    while ((pEntry = readdir(pD)) != NULL) {
+        char path[512];
+        size_t len = strlen(pEntry->d_name);
+        if (pEntry->d_name[0] == '.')
+            continue;
+        snprintf(path, sizeof(path), "%s/%s", pDir, pEntry->d_name);
+
+        if ((len > 2) && (!strcmp(pEntry->d_name + len - 2, ".c") || !strcmp(pEntry->d_name + len - 2, ".h"))) {
+            check_ScanFile(path);
+        } else if (strchr(pEntry->d_name, '.') == NULL) {
+            // 字体表只有点阵，不含界面字符串
+            if (strcmp(pEntry->d_name, "font") != 0)
+                check_ScanDir(path);
+        }
+    }
+    closedir(pD);
+}
+
+/**
+ * @brief 压缩表解码结果与原始表比较，返回 0 一致，1 解码不出来，2 不一致
+ */
+static int check_Glyph(const sCheckFont* pFont, uint8_t c)
+{
+    uint8_t* pRaw = pFont->pRaw(c);
+    uint8_t* pRle = pFont->pRle(c);
+
+    if (pRle == NULL)
+        return 1;
+    if ((pRaw == NULL) || memcmp(pRaw, pRle, 2 + pRaw[1] * pFont->bytesPerRow))
+        return 2;
+    return 0;
+}
+
+static int check_Strings(void)
+{
+    int used = 0;
+    int failed = 0;
+
+    for (int c = 0; c < 256; c++) {
+        if (!Where[c][0])
+            continue;
+        used++;
+        for (unsigned i = 0; i < FONT_COUNT; i++) {
+            int ret = check_Glyph(&Fonts[i], c);
+            if (ret != 0) {
+                printf("%s: 0x%02X from %s %s\n", Fonts[i].pName, c, Where[c], (ret == 1) ? "is missing" : "differs from the raw table");
+                failed++;
+            }
+        }
+    }
+    printf("strings: %d distinct characters, %d missing or wrong glyphs\n", used, failed);
+    return failed;
+}
+
+static int check_Tables(void)
+{
+    int failed = 0;
+
+    for (unsigned i = 0; i < FONT_COUNT; i++) {
+        int count = 0;
+        for (int c = 0; c < 256; c++) {
+            int ret = check_Glyph(&Fonts[i], c);
+            if (ret == 1)
+                continue;
+            count++;
+            if (ret != 0) {
+                printf("%s: 0x%02X differs from the raw table\n", Fonts[i].pName, c);
+                failed++;
+            }
+        }
+        printf("%s: %d glyphs in the compressed table match the raw table\n", Fonts[i].pName, count);
+    }
+    return failed;
+}
+
+/**
+ * @brief 主界面一帧的文字（scene.c 的标题、数据栏和十字光标读数）
+ */
+static void check_DrawFrame(int frame)
+{
+    float t = 20.0f + (frame % 200) * 0.1f;
+    char buf[32];
+
+    Sink += dispcolor_getStrWidth(FONTID_16F, "Palette 5");
+    Sink += dispcolor_getStrWidth(FONTID_16F, CELSIUS_SYMBOL);
+    snprintf(buf, sizeof(buf), "%.1f%s", t + 5.0f, CELSIUS_SYMBOL);
+    Sink += dispcolor_getStrWidth(FONTID_16F, buf);
+    dispcolor_printf(120 - (Sink & 7), 2, FONTID_16F, WHITE, "%s", buf);
+    dispcolor_printf(10, 2, FONTID_16F, WHITE, "Palette %d", frame % 8);
+
+    dispcolor_printf(10, 190, FONTID_6X8M, WHITE, "std:%.2f%s", t * 0.1f, CELSIUS_SYMBOL);
+    dispcolor_printf(10, 200, FONTID_6X8M, WHITE, "max:%.1f%s", t + 10.0f, CELSIUS_SYMBOL);
+    dispcolor_printf(10, 210, FONTID_6X8M, WHITE, "min:%.1f%s", t - 10.0f, CELSIUS_SYMBOL);
+    dispcolor_printf(10, 220, FONTID_6X8M, WHITE, "avg:%.2f%s", t, CELSIUS_SYMBOL);
+    dispcolor_printf(170, 190, FONTID_6X8M, WHITE, "Chan:%c", (frame & 1) ? 'Y' : 'X');
+    dispcolor_printf(170, 210, FONTID_6X8M, WHITE, "Hi:%.1f", t + 10.0f);
+    dispcolor_printf(170, 230, FONTID_6X8M, WHITE, "Lo:%.1f", t - 10.0f);
+    dispcolor_printf(200, 170, FONTID_6X8M, WHITE, "%d FPS", 16 + (frame & 3));
+}
+
+static void check_Time(int n)
+{
+    dispcolor_SetBackend(&dispbackend_hostfb);
+    dispcolor_Init();
+
+    check_DrawFrame(0); // 预热：字形缓存
+    double start = check_Now();
+    for (int i = 0; i < n; i++)
+        check_DrawFrame(i);
+    double s = check_Now() - start;
+
+    double widthStart = check_Now();
+    for (int i = 0; i < n; i++) {
+        Sink += dispcolor_getStrWidth(FONTID_16F, "Palette 5");
+        Sink += dispcolor_getStrWidth(FONTID_6X8M, "avg:25.31" CELSIUS_SYMBOL);
+    }
+    double widthS = check_Now() - widthStart;
+
+    printf("text draw (%s tables): %.2f us/frame, getStrWidth %.1f ns/char, %d frames\n",
+        (FONT_STORAGE == FONT_STORAGE_RLE) ? "compressed" : "raw", s * 1e6 / n, widthS * 1e9 / (n * 19.0), n);
+}
+
+int main(int argc, char* argv[])
+{
+    int n = 20000;
+    int files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && (i + 1 < argc)) {
+            n = atoi(argv[++i]);
+        } else {
+            check_ScanFile(argv[i]);
+            files++;
+        }
+    }
+    if (n <= 0)
+        n = 1;
+
+    if (files == 0) {
+        check_ScanDir(CHECK_ROOT "/src");
+        check_ScanDir(CHECK_ROOT "/include");
+    }
+    // 温度单位一定要能显示（扫描范围不含 CelsiusSymbol.h 时也检查）
+    check_Use(CELSIUS_SYMBOL[0], "CelsiusSymbol.h", 0);
+
+    int failed = check_Strings() + check_Tables();
+    check_Time(n);
+
+    if (failed || Errors) {
+        printf("FAILED\n");
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
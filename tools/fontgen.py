@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+点阵字体压缩生成器
+
+从 components/ThermalImaging/src/lcd/font 下的原始点阵表（f6x8m.c / f16f.c 等）
+生成压缩字体表 <name>_rle.c，供 font.c 在 FONT_STORAGE == FONT_STORAGE_RLE 时使用。
+
+压缩格式（与 font.c 中的 font_rle_Decode 对应）：
+  - 只保留 --first ~ --last 范围内的字符，以及 --extra 和 ALWAYS_EXTRA 中的字符（字形接在范围内的字形后面），
+    其余字符返回 NULL
+  - 每个字形裁剪到墨迹框（box_x, box_y, box_w, box_h），记录原始前进宽度
+  - 墨迹框内的像素按行展开为位流，取以下两种编码中较短的一种：
+      FONT_RLE_BITS : 按位紧凑存放，高位在前
+      FONT_RLE_RUNS : 背景/前景交替的游程，从背景开始，每个游程用半字节表示，
+                      0~14 为长度，15 表示长度加 15 且下一个半字节继续累加
+用法：
+  python3 tools/fontgen.py f6x8m
+  python3 tools/fontgen.py f16f --first 0x20 --last 0x7e --extra 0xA7
+生成后用 tools/font_check.c 检查界面字符串用到的字符都在表中
+"""
+
+import argparse
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+FONT_DIR = os.path.join(ROOT, "components", "ThermalImaging", "src", "lcd", "font")
+INCLUDE_DIR = os.path.join(ROOT, "components", "ThermalImaging", "include", "lcd")
+
+FONT_RLE_BITS = 0
+FONT_RLE_RUNS = 1
+
+# 范围外总是收录的字符：CELSIUS_SYMBOL / FAHRENHEIT_SYMBOL 中的度数符号（cp1251 的 0xB0）
+ALWAYS_EXTRA = [0xB0]
+
+# 字体文件名 -> (表名, C 前缀, 解码后每行字节数)
+FONTS = {
+    "f6x8m": ("f6x8m_table", "f6x8m", 1),
+    "f16f": ("f10x16f_table", "f10x16f", 2),
+    "f24f": ("f24f_table", "f24f", 2),
+    "f32f": ("f32f_table", "f32f", 2),
+}
+
+
+def read_defines(header):
+    defines = {}
+    with open(header, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            m = re.match(r"\s*#define\s+(\w+)\s+(\d+)", line)
+            if m:
+                defines[m.group(1)] = int(m.group(2))
+    return defines
+
+
+def parse_table(path, table, defines):
+    """返回 [(width, height, [row_bits...]), ...]，row_bits 为高位在前的整数"""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        src = f.read()
+
+    start = src.index(table)
+    body = src[src.index("=", start) + 1:src.index("};", start)]
+    body = re.sub(r"//[^\n]*", "", body)
+
+    glyphs = []
+    for block in re.findall(r"\{([^{}]*)\}", body):
+        tokens = [t.strip() for t in block.split(",") if t.strip()]
+        values = []
+        for t in tokens:
+            if re.fullmatch(r"[_X]{8}", t):
+                values.append(int(t.replace("_", "0").replace("X", "1"), 2))
+            elif t in defines:
+                values.append(defines[t])
+            else:
+                values.append(int(t, 0))
+        glyphs.append(values)
+    return glyphs
+
+
+def glyph_rows(values, bytes_per_row):
+    width, height, data = values[0], values[1], values[2:]
+    data = data + [0] * (height * bytes_per_row - len(data))  # 与 C 一样，省略的行补零
+    rows = []
+    for r in range(height):
+        bits = 0
+        for b in range(bytes_per_row):
+            bits = (bits << 8) | data[r * bytes_per_row + b]
+        rows.append(bits)
+    return width, height, rows
+
+
+def ink_box(width, height, rows, row_bits):
+    xs, ys = [], []
+    for y, bits in enumerate(rows):
+        for x in range(width):
+            if bits & (1 << (row_bits - 1 - x)):
+                xs.append(x)
+                ys.append(y)
+    if not xs:
+        return 0, 0, 0, 0
+    return min(xs), min(ys), max(xs) - min(xs) + 1, max(ys) - min(ys) + 1
+
+
+def encode_bits(pixels):
+    out = bytearray((len(pixels) + 7) // 8)
+    for i, p in enumerate(pixels):
+        if p:
+            out[i >> 3] |= 0x80 >> (i & 7)
+    return bytes(out)
+
+
+def encode_runs(pixels):
+    nibbles = []
+    current, run = 0, 0
+    runs = []
+    for p in pixels:
+        if p == current:
+            run += 1
+        else:
+            runs.append(run)
+            current, run = p, 1
+    runs.append(run)
+
+    for run in runs:
+        while run >= 15:
+            nibbles.append(15)
+            run -= 15
+        nibbles.append(run)
+
+    out = bytearray((len(nibbles) + 1) // 2)
+    for i, n in enumerate(nibbles):
+        out[i >> 1] |= n << (4 if (i & 1) == 0 else 0)
+    return bytes(out)
+
+
+def decode_runs(data, count):
+    """与 C 解码器一致的参考实现，用于自检"""
+    pixels = []
+    value, i = 0, 0
+    while len(pixels) < count:
+        run = 0
+        while True:
+            n = (data[i >> 1] >> (4 if (i & 1) == 0 else 0)) & 0x0F
+            i += 1
+            run += n
+            if n != 15:
+                break
+        pixels.extend([value] * run)
+        value ^= 1
+    return pixels[:count]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="生成压缩点阵字体表")
+    parser.add_argument("font", choices=sorted(FONTS.keys()))
+    parser.add_argument("--first", type=lambda v: int(v, 0), default=0x20, help="第一个字符（默认 0x20）")
+    parser.add_argument("--last", type=lambda v: int(v, 0), default=0x7E, help="最后一个字符（默认 0x7E）")
+    parser.add_argument("--extra", type=lambda v: [int(c, 0) for c in v.split(",") if c], default=[],
+                        help="范围外另外收录的字符，逗号分隔（总是包含 0xB0）")
+    parser.add_argument("-o", "--output", help="输出文件（默认 src/lcd/font/<font>_rle.c）")
+    args = parser.parse_args()
+
+    table, prefix, bytes_per_row = FONTS[args.font]
+    defines = read_defines(os.path.join(INCLUDE_DIR, args.font + ".h"))
+    glyphs = parse_table(os.path.join(FONT_DIR, args.font + ".c"), table, defines)
+
+    # f24f/f32f 只包含数字，表从 0x30 开始
+    table_first = 0x30 if args.font in ("f24f", "f32f") else 0
+    first = max(args.first, table_first)
+    last = min(args.last, table_first + len(glyphs) - 1)
+    if first > last:
+        sys.exit("empty character range")
+
+    extra = sorted(set(ALWAYS_EXTRA + args.extra))
+    if any(ch < table_first or ch >= table_first + len(glyphs) or ch > 0xFF for ch in extra):
+        sys.exit("extra character outside the font table")
+    extra = [ch for ch in extra if not first <= ch <= last]
+
+    raw_size = len(glyphs) * (2 + glyphs[0][1] * bytes_per_row)
+    height = glyphs[0][1]
+    row_bits = bytes_per_row * 8
+
+    index, data = [], bytearray()
+    for ch in list(range(first, last + 1)) + extra:
+        width, h, rows = glyph_rows(glyphs[ch - table_first], bytes_per_row)
+        bx, by, bw, bh = ink_box(width, h, rows, row_bits)
+        pixels = []
+        for y in range(by, by + bh):
+            for x in range(bx, bx + bw):
+                pixels.append(1 if rows[y] & (1 << (row_bits - 1 - x)) else 0)
+
+        bits = encode_bits(pixels)
+        runs = encode_runs(pixels) if pixels else b""
+        if pixels and len(runs) < len(bits):
+            assert decode_runs(runs, len(pixels)) == pixels
+            kind, blob = FONT_RLE_RUNS, runs
+        else:
+            kind, blob = FONT_RLE_BITS, bits
+
+        index.append((len(data), width, bx, by, bw, bh, kind, ch))
+        data += blob
+
+    index_size = len(index) * 8  # sizeof(tFontRleGlyph)
+    packed_size = index_size + len(data) + len(extra)
+    extra_text = "、".join("0x%02X" % ch for ch in extra)
+
+    out_path = args.output or os.path.join(FONT_DIR, args.font + "_rle.c")
+    with open(out_path, "w", encoding="utf-8", newline="\n") as f:
+        f.write("//------------------------------------------------------------------------------\n")
+        f.write("// 由 tools/fontgen.py 从 %s.c 生成，请勿手工修改\n" % args.font)
+        f.write("// 字符范围 0x%02X ~ 0x%02X%s，原始表 %d 字节，压缩后 %d 字节（索引 %d + 数据 %d）\n"
+                % (first, last, ("，另加 " + extra_text) if extra else "", raw_size, packed_size, index_size,
+                   len(data) + len(extra)))
+        f.write("//------------------------------------------------------------------------------\n")
+        f.write('#include "%s.h"\n#include "font.h"\n\n' % args.font)
+
+        f.write("static const uint8_t %s_rle_data[%d] = {\n" % (prefix, max(len(data), 1)))
+        for i in range(0, max(len(data), 1), 16):
+            chunk = data[i:i + 16] or b"\x00"
+            f.write("    " + ", ".join("0x%02X" % b for b in chunk) + ",\n")
+        f.write("};\n\n")
+
+        f.write("static const tFontRleGlyph %s_rle_glyphs[%d] = {\n" % (prefix, len(index)))
+        for off, width, bx, by, bw, bh, kind, ch in index:
+            shown = chr(ch) if 0x20 < ch < 0x7F and chr(ch) not in "\\'" else " "
+            if ch >= 0x80:
+                shown = bytes([ch]).decode("cp1251", errors="replace")
+            f.write("    { %4d, %2d, %2d, %2d, %2d, %2d, %s }, // 0x%02X %s\n"
+                    % (off, width, bx, by, bw, bh, "FONT_RLE_RUNS" if kind == FONT_RLE_RUNS else "FONT_RLE_BITS", ch, shown))
+        f.write("};\n\n")
+
+        if extra:
+            f.write("static const uint8_t %s_rle_extra[%d] = { %s };\n\n"
+                    % (prefix, len(extra), ", ".join("0x%02X" % ch for ch in extra)))
+
+        f.write("const tFontRle %s_rle = {\n" % prefix)
+        f.write("    .height = %d,\n" % height)
+        f.write("    .bytesPerRow = %d,\n" % bytes_per_row)
+        f.write("    .first = 0x%02X,\n" % first)
+        f.write("    .last = 0x%02X,\n" % last)
+        if extra:
+            f.write("    .extraCount = %d,\n" % len(extra))
+        f.write("    .pGlyphs = %s_rle_glyphs,\n" % prefix)
+        f.write("    .pData = %s_rle_data,\n" % prefix)
+        if extra:
+            f.write("    .pExtra = %s_rle_extra,\n" % prefix)
+        f.write("};\n\n")
+
+        f.write("static tFontRleSlot %s_rle_slot = { .Char = -1 };\n\n" % prefix)
+        f.write("//==============================================================================\n")
+        f.write("// 该函数返回一个指向 Char 子表的指针（解码到本字体的解码槽，下次调用前有效）\n")
+        f.write("//==============================================================================\n")
+        f.write("uint8_t* %s_rle_GetCharTable(uint8_t Char)\n{\n" % prefix)
+        f.write("    return font_rle_Decode(&%s_rle, Char, &%s_rle_slot);\n}\n" % (prefix, prefix))
+        f.write("//==============================================================================\n")
+
+    print("%s: raw %d bytes -> %d bytes (index %d + data %d), chars 0x%02X-0x%02X%s"
+          % (args.font, raw_size, packed_size, index_size, len(data) + len(extra), first, last,
+             "".join(" 0x%02X" % ch for ch in extra)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,404 @@
+/*
+ * 保存文件清单（manifest）的断电重放检查（主机上运行）
+ *
+ * 在临时目录里按设备的习惯随机添加（先写文件再追加记录）和删除（manifest_Remove：先追加记录再删文件）保存文件，
+ * 中间穿插整类删除和压缩（重写清单）。每一步之后模拟写清单时断电：
+ *  - 追加记录：清单停在旧内容后面 0..15 字节（记录写了一半）
+ *  - 重写清单：临时文件写了一半；旧清单已删除、临时文件还没改名
+ * 重新打开清单后检查内存表与目录中的文件（序号、大小）一致，清单文件由完整的记录组成。
+ * 类型数超过 MANIFEST_MAX_TYPES 时 manifest_Open 必须失败。
+ * 追加删除记录之后、删除文件之前断电时目录里允许多出被删除的那一个文件（不在清单中），
+ * 清单里不允许有目录中没有的文件。
+ *
+ * 编译（在仓库根目录）：
+ *   C=components/ThermalImaging
+ *   gcc -O2 -o manifest_check tools/manifest_check.c $C/src/tools/manifest.c -I$C/include/tools
+ *
+ * 用法：
+ *   ./manifest_check [-n 操作次数] [-s 随机种子] [-d 临时目录]
+ */
+#include "manifest.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CHECK_TYPES 3
+#define CHECK_MAX_FILES 256
+#define CHECK_RECORD_SIZE 16
+#define CHECK_HEADER_SIZE 8
+#define CHECK_MAX_MANIFEST (1024 * 1024)
+// 与 manifest.c 的临时文件名一致
+#define CHECK_TMP_NAME "CAPTURES.TMP"
+
+static const char* const Extensions[CHECK_TYPES] = { ".BMP", ".QOI", ".TIS" };
+
+// 目录中的一个文件
+typedef struct {
+    uint8_t Type;
+    uint32_t Id;
+    uint32_t Size;
+} sCheckFile;
+
+static char Dir[256];
+static uint32_t Rng = 1;
+static uint8_t OldManifest[CHECK_MAX_MANIFEST];
+static uint8_t NewManifest[CHECK_MAX_MANIFEST];
+static int Checks = 0;
+static int Errors = 0;
+static int OrphansAccepted = 0;
+static uint8_t Content[64 * 1024];
+
+static uint32_t check_rand(void)
+{
+    Rng ^= Rng << 13;
+    Rng ^= Rng >> 17;
+    Rng ^= Rng << 5;
+    return Rng;
+}
+
+static void check_path(const char* pName, char* pOut, size_t size)
+{
+    snprintf(pOut, size, "%s/%s", Dir, pName);
+}
+
+static long check_readFile(const char* pName, uint8_t* pOut, size_t size)
+{
+    char path[300];
+    check_path(pName, path, sizeof(path));
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        return -1;
+    long len = fread(pOut, 1, size, f);
+    fclose(f);
+    return len;
+}
+
+static void check_writeFile(const char* pName, const uint8_t* pData, size_t size)
+{
+    char path[300];
+    check_path(pName, path, sizeof(path));
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        perror(path);
+        exit(1);
+    }
+    fwrite(pData, 1, size, f);
+    fclose(f);
+}
+
+static void check_removeFile(const char* pName)
+{
+    char path[300];
+    check_path(pName, path, sizeof(path));
+    remove(path);
+}
+
+/**
+ * @brief 打开清单，不输出清单模块的提示
+ */
+static bool check_open(void)
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+
+    bool ok = manifest_Open(Dir, Extensions, CHECK_TYPES);
+
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    return ok;
+}
+
+/**
+ * @brief 扫描目录（与清单的命名规则相同），返回文件数
+ */
+static int check_scanDir(sCheckFile* pOut)
+{
+    int count = 0;
+    DIR* dr = opendir(Dir);
+    struct dirent* de;
+
+    while ((dr != NULL) && ((de = readdir(dr)) != NULL) && (count < CHECK_MAX_FILES)) {
+        if ((de->d_name[0] < '0') || (de->d_name[0] > '9'))
+            continue;
+        for (uint8_t type = 0; type < CHECK_TYPES; type++) {
+            size_t len = strlen(de->d_name);
+            size_t extLen = strlen(Extensions[type]);
+            if ((len <= extLen) || strcmp(de->d_name + len - extLen, Extensions[type]))
+                continue;
+
+            char path[300];
+            struct stat st;
+            check_path(de->d_name, path, sizeof(path));
+            stat(path, &st);
+            pOut[count].Type = type;
+            pOut[count].Id = strtoul(de->d_name, NULL, 10);
+            pOut[count].Size = st.st_size;
+            count++;
+            break;
+        }
+    }
+    if (dr != NULL)
+        closedir(dr);
+    return count;
+}
+
+static bool check_inDir(const sCheckFile* pFiles, int count, uint8_t type, const sManifestEntry* pEntry)
+{
+    for (int i = 0; i < count; i++) {
+        if ((pFiles[i].Type == type) && (pFiles[i].Id == pEntry->Id))
+            return pFiles[i].Size == pEntry->Size;
+    }
+    return false;
+}
+
+/**
+ * @brief 检查内存表与目录一致，pOrphan 不为 NULL 时允许目录中多出这一个不在清单中的文件
+ */
+static void check_consistent(const char* pWhat, const sCheckFile* pOrphan)
+{
+    static sCheckFile files[CHECK_MAX_FILES];
+    static sManifestEntry entries[CHECK_MAX_FILES];
+    int fileCount = check_scanDir(files);
+    int listed = 0;
+    bool orphan = false;
+    bool ok = true;
+
+    Checks++;
+    for (uint8_t type = 0; type < CHECK_TYPES; type++) {
+        int count = manifest_List(type, 0, entries, CHECK_MAX_FILES);
+        for (int i = 0; i < count; i++) {
+            if (check_inDir(files, fileCount, type, &entries[i])) {
+                listed++;
+            } else {
+                printf("%s: %05lu%s listed but not on disk (or wrong size)\n", pWhat, (unsigned long)entries[i].Id, Extensions[type]);
+                ok = false;
+            }
+        }
+        if ((count > 0) && (manifest_NextId(type) <= entries[count - 1].Id)) {
+            printf("%s: next id %lu not above %05lu%s\n", pWhat, (unsigned long)manifest_NextId(type),
+                (unsigned long)entries[count - 1].Id, Extensions[type]);
+            ok = false;
+        }
+    }
+    if ((pOrphan != NULL) && (listed == fileCount - 1)) {
+        sManifestEntry entry = { .Id = pOrphan->Id, .Size = pOrphan->Size };
+        orphan = check_inDir(files, fileCount, pOrphan->Type, &entry);
+    }
+    if ((listed != fileCount) && !orphan) {
+        printf("%s: %d files on disk, %d listed\n", pWhat, fileCount, listed);
+        ok = false;
+    }
+
+    long len = check_readFile(MANIFEST_FILE_NAME, NewManifest, sizeof(NewManifest));
+    if ((len < CHECK_HEADER_SIZE) || ((len - CHECK_HEADER_SIZE) % CHECK_RECORD_SIZE)) {
+        printf("%s: manifest length %ld is not whole records\n", pWhat, len);
+        ok = false;
+    }
+
+    if (orphan)
+        OrphansAccepted++;
+    if (!ok)
+        Errors++;
+}
+
+static void check_fileName(const sCheckFile* pFile, char* pOut, size_t size)
+{
+    snprintf(pOut, size, "%05lu%s", (unsigned long)pFile->Id, Extensions[pFile->Type]);
+}
+
+/**
+ * @brief 断电后重新打开并检查，然后恢复断电前完整的清单继续
+ *
+ * @param pWhat 断电位置
+ * @param pRemoved 删除的文件，断电时还没有删除（添加时为 NULL）
+ * @param recorded 删除记录已经完整写入（允许目录中多出 pRemoved）
+ * @param pFinal 完整的清单
+ * @param finalLen
+ */
+static void check_reopen(const char* pWhat, const sCheckFile* pRemoved, bool recorded, const uint8_t* pFinal, long finalLen)
+{
+    char name[32];
+    if (pRemoved != NULL) {
+        check_fileName(pRemoved, name, sizeof(name));
+        check_writeFile(name, Content, pRemoved->Size);
+    }
+
+    if (!check_open()) {
+        printf("%s: manifest_Open failed\n", pWhat);
+        Errors++;
+    } else {
+        check_consistent(pWhat, recorded ? pRemoved : NULL);
+    }
+
+    if (pRemoved != NULL)
+        check_removeFile(name);
+    check_removeFile(CHECK_TMP_NAME);
+    check_writeFile(MANIFEST_FILE_NAME, pFinal, finalLen);
+    check_open();
+}
+
+/**
+ * @brief 一次操作之后模拟写清单时断电的各种状态
+ *
+ * @param pOp 操作名
+ * @param pRemoved 删除的文件（添加时为 NULL）：记录写完之前断电时文件还在
+ * @param oldLen 操作前的清单长度
+ */
+static void check_crashes(const char* pOp, const sCheckFile* pRemoved, long oldLen)
+{
+    char what[96];
+    long newLen = check_readFile(MANIFEST_FILE_NAME, NewManifest, sizeof(NewManifest));
+    static uint8_t final[CHECK_MAX_MANIFEST];
+    memcpy(final, NewManifest, newLen);
+
+    if ((newLen == oldLen + CHECK_RECORD_SIZE) && !memcmp(OldManifest, final, oldLen)) {
+        // 追加了一条记录：停在记录的每个字节
+        for (int cut = 0; cut < CHECK_RECORD_SIZE; cut++) {
+            snprintf(what, sizeof(what), "%s, append cut at %d", pOp, cut);
+            memcpy(NewManifest, OldManifest, oldLen);
+            memcpy(NewManifest + oldLen, final + oldLen, cut);
+            check_writeFile(MANIFEST_FILE_NAME, NewManifest, oldLen + cut);
+            check_reopen(what, pRemoved, false, final, newLen);
+        }
+    } else {
+        // 重写了清单：临时文件写了一半（旧清单还在）
+        snprintf(what, sizeof(what), "%s, rewrite torn", pOp);
+        check_writeFile(MANIFEST_FILE_NAME, OldManifest, oldLen);
+        check_writeFile(CHECK_TMP_NAME, final, newLen / 2);
+        check_reopen(what, pRemoved, false, final, newLen);
+
+        // 旧清单已删除，临时文件还没改名
+        snprintf(what, sizeof(what), "%s, rewrite before rename", pOp);
+        check_removeFile(MANIFEST_FILE_NAME);
+        check_writeFile(CHECK_TMP_NAME, final, newLen);
+        check_reopen(what, pRemoved, true, final, newLen);
+    }
+
+    // 删除记录已经写完，文件还没删除
+    if (pRemoved != NULL) {
+        snprintf(what, sizeof(what), "%s, recorded before delete", pOp);
+        check_reopen(what, pRemoved, true, final, newLen);
+    }
+}
+
+/**
+ * @brief 随机选一个清单里的文件
+ */
+static bool check_pick(sCheckFile* pOut)
+{
+    static sManifestEntry entries[CHECK_MAX_FILES];
+    int total = 0;
+    for (uint8_t type = 0; type < CHECK_TYPES; type++)
+        total += manifest_Count(type);
+    if (total == 0)
+        return false;
+
+    int n = check_rand() % total;
+    for (uint8_t type = 0; type < CHECK_TYPES; type++) {
+        int count = manifest_List(type, 0, entries, CHECK_MAX_FILES);
+        if (n < count) {
+            pOut->Type = type;
+            pOut->Id = entries[n].Id;
+            pOut->Size = entries[n].Size;
+            return true;
+        }
+        n -= count;
+    }
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    int ops = 400;
+    uint32_t seed = 12345;
+    const char* pDir = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+            ops = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+            seed = strtoul(argv[++i], NULL, 0);
+        else if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc))
+            pDir = argv[++i];
+        else {
+            printf("usage: %s [-n ops] [-s seed] [-d dir]\n", argv[0]);
+            return 1;
+        }
+    }
+    Rng = seed ? seed : 1;
+
+    if (pDir != NULL) {
+        snprintf(Dir, sizeof(Dir), "%s", pDir);
+        mkdir(Dir, 0755);
+    } else {
+        snprintf(Dir, sizeof(Dir), "/tmp/manifest_checkXXXXXX");
+        if (mkdtemp(Dir) == NULL) {
+            perror("mkdtemp");
+            return 1;
+        }
+    }
+
+    // 类型数超出时必须失败，不能截断
+    static const char* const tooMany[MANIFEST_MAX_TYPES + 1] = { 0 };
+    if (manifest_Open(Dir, tooMany, MANIFEST_MAX_TYPES + 1)) {
+        printf("%s: manifest_Open accepted %d types\n", Dir, MANIFEST_MAX_TYPES + 1);
+        Errors++;
+    }
+
+    if (!check_open()) {
+        printf("%s: manifest_Open failed\n", Dir);
+        return 1;
+    }
+
+    int adds = 0, removes = 0, removeAlls = 0;
+    for (int op = 0; op < ops; op++) {
+        long oldLen = check_readFile(MANIFEST_FILE_NAME, OldManifest, sizeof(OldManifest));
+        uint32_t r = check_rand() % 100;
+        sCheckFile file;
+        char name[32];
+        char what[64];
+
+        if ((r < 2) && (op > ops / 2)) {
+            // 整类删除（删除文件后重写清单）
+            uint8_t type = check_rand() % CHECK_TYPES;
+            manifest_RemoveAll(type);
+            removeAlls++;
+            snprintf(what, sizeof(what), "op %d remove all %s", op, Extensions[type]);
+            check_crashes(what, NULL, oldLen);
+        } else if ((r < 40) && check_pick(&file)) {
+            check_fileName(&file, name, sizeof(name));
+            if (manifest_Remove(file.Type, file.Id) != 0) {
+                printf("op %d: manifest_Remove %s failed\n", op, name);
+                Errors++;
+            }
+            removes++;
+            snprintf(what, sizeof(what), "op %d remove %s", op, name);
+            check_crashes(what, &file, oldLen);
+        } else {
+            file.Type = check_rand() % CHECK_TYPES;
+            file.Id = manifest_NextId(file.Type);
+            file.Size = 1 + check_rand() % sizeof(Content);
+            check_fileName(&file, name, sizeof(name));
+            check_writeFile(name, Content, file.Size);
+            manifest_Add(file.Type, file.Id, file.Size, 1700000000 + op);
+            adds++;
+            snprintf(what, sizeof(what), "op %d add %s", op, name);
+            check_crashes(what, NULL, oldLen);
+        }
+
+        check_consistent("after reopen", NULL);
+    }
+
+    printf("%d ops (%d add, %d remove, %d remove all), %d crash states checked, %d unlisted files left by a delete cut short\n",
+        ops, adds, removes, removeAlls, Checks, OrphansAccepted);
+    printf("%s\n", Errors ? "FAILED" : "OK");
+    return Errors ? 1 : 0;
+}
@@ -0,0 +1,263 @@
+/*
+ * QOI 编码/解码检查（主机上运行）
+ *
+ * 用设备上的 qoi.c 把合成的 RGB565 图片按行编码（与 save.c 保存截图相同），然后：
+ *  - 用 qoi.c 的流式解码器解回 RGB565，每次读回调只给 1 / 7 / 512 字节，每次解码不同的像素数，必须与原图一致
+ *  - 用按 qoiformat.org 规范写的独立解码器解成 RGB888，必须是原图按位复制扩展的结果（PC 上的软件看到的颜色）
+ *  - 数据在任意位置截断时解码器返回较少的像素，已解出的像素与原图一致
+ * 最后输出每种图片的压缩率。
+ *
+ * 编译（在仓库根目录）：
+ *   C=components/ThermalImaging
+ *   gcc -O2 -o qoi_check tools/qoi_check.c $C/src/tools/qoi.c -I$C/include/tools
+ *
+ * 用法：
+ *   ./qoi_check
+ */
+#include "qoi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK_MAX_W 240
+#define CHECK_MAX_H 240
+#define CHECK_MAX_PIXELS (CHECK_MAX_W * CHECK_MAX_H)
+#define CHECK_MAX_FILE (QOI_HEADER_SIZE + QOI_MAX_ENCODED(CHECK_MAX_PIXELS) + QOI_END_SIZE + 1)
+
+// 解码器的数据来源：内存中的文件，每次最多给 Chunk 字节
+typedef struct {
+    const uint8_t* pData;
+    size_t size;
+    size_t pos;
+    size_t chunk;
+} sCheckSource;
+
+static uint16_t Image[CHECK_MAX_PIXELS];
+static uint16_t Decoded[CHECK_MAX_PIXELS];
+static uint8_t File[CHECK_MAX_FILE];
+static sQoiEncoder Encoder;
+static sQoiDecoder Decoder;
+static uint32_t Rng = 1;
+static int Errors = 0;
+
+static uint32_t check_rand(void)
+{
+    Rng ^= Rng << 13;
+    Rng ^= Rng >> 17;
+    Rng ^= Rng << 5;
+    return Rng;
+}
+
+static uint16_t check_rgb565(int r, int g, int b)
+{
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | ((b & 0xFF) >> 3);
+}
+
+static size_t check_read(void* pCtx, uint8_t* pBuff, size_t size)
+{
+    sCheckSource* pSource = pCtx;
+    size_t n = pSource->size - pSource->pos;
+    if (n > size)
+        n = size;
+    if (n > pSource->chunk)
+        n = pSource->chunk;
+    memcpy(pBuff, pSource->pData + pSource->pos, n);
+    pSource->pos += n;
+    return n;
+}
+
+/**
+ * @brief 按行编码，返回文件长度
+ */
+static size_t check_encode(uint32_t w, uint32_t h)
+{
+    size_t len = qoi_EncodeHeader(File, w, h);
+    qoi_EncoderInit(&Encoder);
+    for (uint32_t y = 0; y < h; y++)
+        len += qoi_EncodeRgb565(&Encoder, Image + y * w, w, File + len);
+    len += qoi_EncodeEnd(&Encoder, File + len);
+    return len;
+}
+
+/**
+ * @brief 用 qoi.c 解码 size 字节，每次读 chunk 字节、解码 step 个像素，返回解码的像素数
+ */
+static uint32_t check_decode(size_t size, size_t chunk, uint32_t step, uint32_t* pWidth, uint32_t* pHeight)
+{
+    sCheckSource source = { .pData = File, .size = size, .chunk = chunk };
+    if (!qoi_DecoderInit(&Decoder, check_read, &source, pWidth, pHeight))
+        return 0;
+
+    uint32_t total = *pWidth * *pHeight;
+    uint32_t done = 0;
+    while (done < total) {
+        uint32_t n = (total - done < step) ? total - done : step;
+        uint32_t got = qoi_DecodeRgb565(&Decoder, Decoded + done, n);
+        done += got;
+        if (got < n)
+            break;
+    }
+    return done;
+}
+
+static uint32_t check_expand(uint16_t value)
+{
+    uint32_t r = (value >> 11) & 0x1F;
+    uint32_t g = (value >> 5) & 0x3F;
+    uint32_t b = value & 0x1F;
+    return (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+}
+
+/**
+ * @brief 按 qoiformat.org 规范解码 RGB888 并与原图的扩展比较，返回不一致的像素数（格式错误返回 -1）
+ */
+static int check_reference(size_t size, uint32_t w, uint32_t h)
+{
+    static const uint8_t endMark[QOI_END_SIZE] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    if ((size < QOI_HEADER_SIZE + QOI_END_SIZE) || memcmp(File, "qoif", 4) || (File[12] != 3) || (File[13] > 1)
+        || memcmp(File + size - QOI_END_SIZE, endMark, QOI_END_SIZE))
+        return -1;
+    uint32_t fw = (File[4] << 24) | (File[5] << 16) | (File[6] << 8) | File[7];
+    uint32_t fh = (File[8] << 24) | (File[9] << 16) | (File[10] << 8) | File[11];
+    if ((fw != w) || (fh != h))
+        return -1;
+
+    uint8_t index[64][4];
+    uint8_t px[4] = { 0, 0, 0, 255 };
+    int run = 0;
+    int bad = 0;
+    size_t p = QOI_HEADER_SIZE;
+    size_t end = size - QOI_END_SIZE;
+    memset(index, 0, sizeof(index));
+
+    for (uint32_t i = 0; i < w * h; i++) {
+        if (run > 0) {
+            run--;
+        } else if (p < end) {
+            uint8_t b1 = File[p++];
+            if (b1 == 0xFE) {
+                px[0] = File[p++];
+                px[1] = File[p++];
+                px[2] = File[p++];
+            } else if (b1 == 0xFF) {
+                px[0] = File[p++];
+                px[1] = File[p++];
+                px[2] = File[p++];
+                px[3] = File[p++];
+            } else if ((b1 & 0xC0) == 0x00) {
+                memcpy(px, index[b1], 4);
+            } else if ((b1 & 0xC0) == 0x40) {
+                px[0] += ((b1 >> 4) & 3) - 2;
+                px[1] += ((b1 >> 2) & 3) - 2;
+                px[2] += (b1 & 3) - 2;
+            } else if ((b1 & 0xC0) == 0x80) {
+                uint8_t b2 = File[p++];
+                int vg = (b1 & 0x3F) - 32;
+                px[0] += vg - 8 + ((b2 >> 4) & 0x0F);
+                px[1] += vg;
+                px[2] += vg - 8 + (b2 & 0x0F);
+            } else {
+                run = b1 & 0x3F;
+            }
+            memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) & 63], px, 4);
+        } else {
+            return -1;
+        }
+
+        uint32_t c = (px[0] << 16) | (px[1] << 8) | px[2];
+        if ((c != check_expand(Image[i])) || (px[3] != 255))
+            bad++;
+    }
+    return (p == end) ? bad : -1;
+}
+
+/**
+ * @brief 检查一幅图，输出压缩率
+ */
+static void check_image(const char* pName, uint32_t w, uint32_t h)
+{
+    static const size_t chunks[] = { 1, 7, QOI_READ_BUFF_SIZE };
+    static const uint32_t steps[] = { 1, 13, CHECK_MAX_W, CHECK_MAX_PIXELS };
+    uint32_t pixels = w * h;
+    size_t size = check_encode(w, h);
+    bool ok = true;
+
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        for (size_t s = 0; s < sizeof(steps) / sizeof(steps[0]); s++) {
+            uint32_t dw, dh;
+            memset(Decoded, 0, sizeof(Decoded));
+            uint32_t got = check_decode(size, chunks[c], steps[s], &dw, &dh);
+            if ((dw != w) || (dh != h) || (got != pixels) || memcmp(Decoded, Image, pixels * sizeof(uint16_t))) {
+                printf("%s: decode (read %zu, step %u) got %u of %u pixels, mismatch\n", pName, chunks[c], steps[s], got, pixels);
+                ok = false;
+            }
+        }
+    }
+
+    int bad = check_reference(size, w, h);
+    if (bad != 0) {
+        printf("%s: reference decoder %s\n", pName, (bad < 0) ? "rejected the file" : "found wrong colors");
+        ok = false;
+    }
+
+    // 截断：文件头之后的每个位置（大图抽样）
+    size_t stride = (size > 4096) ? size / 997 : 1;
+    for (size_t cut = QOI_HEADER_SIZE; cut < size - QOI_END_SIZE; cut += stride) {
+        uint32_t dw, dh;
+        uint32_t got = check_decode(cut, QOI_READ_BUFF_SIZE, CHECK_MAX_W, &dw, &dh);
+        if ((got > pixels) || memcmp(Decoded, Image, got * sizeof(uint16_t))) {
+            printf("%s: truncated at %zu decoded %u pixels, mismatch\n", pName, cut, got);
+            ok = false;
+            break;
+        }
+    }
+
+    printf("%-10s %3ux%-3u %7zu bytes  %5.2f bytes/px  %5.1f%% of raw RGB565  %s\n", pName, w, h, size,
+        (double)size / pixels, 100.0 * size / (pixels * 2), ok ? "OK" : "FAILED");
+    if (!ok)
+        Errors++;
+}
+
+int main(void)
+{
+    uint32_t w = CHECK_MAX_W;
+    uint32_t h = CHECK_MAX_H;
+
+    // 纯色（长游程）
+    for (uint32_t i = 0; i < w * h; i++)
+        Image[i] = 0x0000;
+    check_image("flat", w, h);
+
+    // 渐变（DIFF/LUMA）
+    for (uint32_t y = 0; y < h; y++)
+        for (uint32_t x = 0; x < w; x++)
+            Image[y * w + x] = check_rgb565(x, y, (x + y) / 2);
+    check_image("gradient", w, h);
+
+    // 热图界面：调色板色块、状态栏和文字状的细线（INDEX/RUN）
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            int t = ((x / 8) * 7 + (y / 8) * 5 + (x * y) / 300) & 0xFF;
+            uint16_t c = check_rgb565(t, (t * 3) & 0xFF, 255 - t);
+            if ((y < 20) || (y >= 200))
+                c = ((x % 9 < 2) && (y % 20 > 5) && (y % 20 < 15)) ? 0xFFFF : 0x0000;
+            Image[y * w + x] = c;
+        }
+    }
+    check_image("thermal", w, h);
+
+    // 噪声（RGB，最差情况）
+    for (uint32_t i = 0; i < w * h; i++)
+        Image[i] = check_rand();
+    check_image("noise", w, h);
+
+    // 小尺寸和奇数尺寸
+    for (uint32_t i = 0; i < 7 * 3; i++)
+        Image[i] = check_rand() & 0x0841;
+    check_image("7x3", 7, 3);
+    Image[0] = 0xF81F;
+    check_image("1x1", 1, 1);
+
+    printf("%s\n", Errors ? "FAILED" : "OK");
+    return Errors ? 1 : 0;
+}
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+温度录像转换器
+
+把设备录制的温度录像（*.TIV，格式见 components/ThermalImaging/include/tools/recording.h）
+解码并导出为图片序列：
+  - PNG：每帧一张（00000.png、00001.png ...），着色与 tools/snapconv.py 相同，可直接交给
+    ffmpeg 合成视频，例如 ffmpeg -framerate 16 -i out/%05d.png -pix_fmt yuv420p rec.mp4
+  - CSV：每帧一个，格式与 snapconv.py 相同（--csv）
+录像中断时末尾不完整的帧被丢弃；帧序号不连续说明设备上丢了帧。
+
+用法：
+  python3 tools/recconv.py 00001.TIV --info           # 打印文件头和帧统计
+  python3 tools/recconv.py 00001.TIV -o out            # 导出 out/00000.png ...
+  python3 tools/recconv.py 00001.TIV -o out --csv --min 20 --max 40
+"""
+
+import argparse
+import math
+import os
+import struct
+import sys
+
+import snapconv
+
+MAGIC = b"TIRV"
+SYNC = 0x5246
+FRAME_KEY = 0
+FRAME_HEADER = "<HBBHHIIf"
+FRAME_HEADER_SIZE = struct.calcsize(FRAME_HEADER)
+
+# 与 recording.c 一致
+RICE_ESCAPE = 24
+RICE_RAW_BITS = 18
+RICE_RESET = 64
+RICE_A_INIT = 32
+
+
+class BitReader:
+    def __init__(self, data):
+        self.value = int.from_bytes(data, "big")
+        self.pos = len(data) * 8
+
+    def bit(self):
+        self.pos -= 1
+        if self.pos < 0:
+            raise ValueError("payload truncated")
+        return (self.value >> self.pos) & 1
+
+    def bits(self, count):
+        self.pos -= count
+        if self.pos < 0:
+            raise ValueError("payload truncated")
+        return (self.value >> self.pos) & ((1 << count) - 1)
+
+
+def decode_payload(payload, pixels, width, key, prev):
+    """返回量化后的温度列表（int16）"""
+    reader = BitReader(payload)
+    cur = [0] * pixels
+    a, n = RICE_A_INIT, 1
+    for i in range(pixels):
+        k = 0
+        while (n << k) < a:
+            k += 1
+
+        q = 0
+        while q < RICE_ESCAPE and reader.bit():
+            q += 1
+        if q < RICE_ESCAPE:
+            u = (q << k) | (reader.bits(k) if k else 0)
+        else:
+            u = reader.bits(RICE_RAW_BITS)
+
+        e = (u >> 1) if not (u & 1) else -((u + 1) >> 1)
+        if not key:
+            pred = prev[i]
+        elif i % width:
+            pred = cur[i - 1]
+        elif i:
+            pred = cur[i - width]
+        else:
+            pred = 0
+        cur[i] = pred + e
+
+        a += u
+        n += 1
+        if n >= RICE_RESET:
+            a >>= 1
+            n >>= 1
+    return cur
+
+
+def read_recording(path):
+    """返回 (header dict, [(frame header dict, 温度列表), ...])，无效像素为 NaN"""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    base = struct.calcsize(snapconv.HEADER_FORMAT)
+    if len(data) < base or data[:4] != MAGIC:
+        raise ValueError("%s: not a thermal recording" % path)
+    header = dict(zip(snapconv.HEADER_FIELDS, struct.unpack_from(snapconv.HEADER_FORMAT, data)))
+
+    width, pixels = header["Width"], header["Width"] * header["Height"]
+    scale = header["TempScale"] or 1
+    offset = header["HeaderSize"]
+    frames = []
+    prev = None
+    while offset + FRAME_HEADER_SIZE <= len(data):
+        sync, kind, _, size, _, seq, time_ms, ta = struct.unpack_from(FRAME_HEADER, data, offset)
+        if sync != SYNC:
+            raise ValueError("%s: bad frame sync at offset %d" % (path, offset))
+        payload = data[offset + FRAME_HEADER_SIZE:offset + FRAME_HEADER_SIZE + size]
+        if len(payload) < size:
+            break  # 录像中断，最后一帧不完整
+        offset += FRAME_HEADER_SIZE + size
+
+        key = kind == FRAME_KEY
+        if not key and prev is None:
+            continue  # 还没有遇到关键帧
+        prev = decode_payload(payload, pixels, width, key, prev)
+        temps = [math.nan if v == snapconv.INVALID else v / scale for v in prev]
+        frames.append(({"Type": kind, "FrameSeq": seq, "TimeMs": time_ms, "Ta": ta, "Bytes": size}, temps))
+    return header, frames
+
+
+def print_info(path, header, frames):
+    snapconv.print_info(path, header)
+    if not frames:
+        print("  no frames")
+        return
+
+    first, last = frames[0][0], frames[-1][0]
+    duration = (last["TimeMs"] - first["TimeMs"]) / 1000.0
+    total = sum(f[0]["Bytes"] + FRAME_HEADER_SIZE for f in frames)
+    dropped = (last["FrameSeq"] - first["FrameSeq"] + 1) - len(frames)
+    keys = sum(1 for f in frames if f[0]["Type"] == FRAME_KEY)
+    print("  %-20s %d (%d key)" % ("Frames", len(frames), keys))
+    print("  %-20s %d" % ("Dropped", dropped))
+    print("  %-20s %.2f s" % ("Duration", duration))
+    if duration > 0:
+        print("  %-20s %.2f" % ("FPS", (len(frames) - 1) / duration))
+    print("  %-20s %.1f (raw int16 %d)" % ("Bytes/frame", total / len(frames),
+                                          header["Width"] * header["Height"] * 2))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="把温度录像导出为图片序列")
+    parser.add_argument("file", help="*.TIV 录像文件")
+    parser.add_argument("-o", "--output-dir", help="输出目录（默认为录像文件名）")
+    parser.add_argument("--info", action="store_true", help="只打印文件头和帧统计")
+    parser.add_argument("--csv", action="store_true", help="同时导出每帧的 CSV")
+    parser.add_argument("--png-scale", type=int, default=8, help="PNG 放大倍数（默认 8）")
+    parser.add_argument("--min", type=float, help="量程下限（默认取文件头）")
+    parser.add_argument("--max", type=float, help="量程上限（默认取文件头）")
+    parser.add_argument("--auto", action="store_true", help="每帧按该帧的最小/最大温度着色")
+    args = parser.parse_args()
+
+    try:
+        header, frames = read_recording(args.file)
+    except (OSError, ValueError) as e:
+        sys.exit(str(e))
+
+    if args.info:
+        print_info(args.file, header, frames)
+        return
+
+    out_dir = args.output_dir or os.path.splitext(args.file)[0]
+    os.makedirs(out_dir, exist_ok=True)
+    palettes = snapconv.parse_palettes()
+    for index, (_, temps) in enumerate(frames):
+        lo, hi = args.min, args.max
+        if args.auto:
+            valid = [t for t in temps if math.isfinite(t)]
+            lo, hi = (min(valid), max(valid)) if valid else (lo, hi)
+        stem = os.path.join(out_dir, "%05d" % index)
+        snapconv.render_preview(stem + ".png", header, temps, palettes, max(args.png_scale, 1), lo, hi)
+        if args.csv:
+            snapconv.write_csv(stem + ".csv", header, temps)
+    print("%s -> %s (%d frames)" % (args.file, out_dir, len(frames)))
+
+
+if __name__ == "__main__":
+    main()
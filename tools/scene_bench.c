@@ -0,0 +1,236 @@
+/*
+ * 实时界面合成基准（主机上运行）
+ *
+ * 用内存帧缓冲（hostfb）驱动 scene_Compute / scene_ComposeFrame，对每种
+ * 插值模式 x 调色板 x 叠加元素（中心温度、十字线、提示消息）的组合统计
+ * 帧率和各阶段耗时。帧数据可以是温度图 CSV（tools/snapconv.py 从快照转换，24 行 x 32 列，
+ * 逗号分隔），多个文件按顺序循环播放；不指定时使用合成的移动热点。
+ *
+ * 编译（在仓库根目录）：
+ *   C=components/ThermalImaging
+ *   gcc -O2 -o scene_bench tools/scene_bench.c $C/src/scene.c \
+ *       $C/src/lcd/dispcolor.c $C/src/lcd/hostfb.c $C/src/lcd/compositor.c $C/src/lcd/textcache.c \
+ *       $C/src/lcd/font/f*.c $C/src/interpolation/palette.c $C/src/interpolation/Gauss.c \
+ *       $C/src/interpolation/Bilinear.c $C/src/tools/profiler.c $C/src/tools/framestats.c $C/src/tools/autoscale.c \
+ *       -I$C/include -I$C/include/lcd -I$C/include/tasks -I$C/include/tools -I$C/include/iic -lm
+ *
+ * 用法：
+ *   ./scene_bench [-n 帧数] [-o 输出目录] [温度图.csv ...]
+ *   -o 时把每种组合的最后一帧保存为 PNG，便于和设备截图比对
+ */
+#include "scene.h"
+#include "dispcolor.h"
+#include "dispbackend.h"
+#include "hostfb.h"
+#include "framestats.h"
+#include "profiler.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_MAX_FRAMES 256
+#define BENCH_PIXELS (THERMALIMAGE_RESOLUTION_WIDTH * THERMALIMAGE_RESOLUTION_HEIGHT)
+
+// 与 render_task 的布局一致
+#define BENCH_TOP_BAR_H 20
+#define BENCH_BOTTOM_BAR_H 55
+
+static sMlxData Frames[BENCH_MAX_FRAMES];
+static int FrameCount = 0;
+
+/**
+ * @brief 读取温度图 CSV
+ *
+ * @param pPath
+ * @param pFrame
+ * @return int 0 成功
+ */
+static int bench_loadCsv(const char* pPath, sMlxData* pFrame)
+{
+    FILE* f = fopen(pPath, "r");
+    if (f == NULL)
+        return -1;
+
+    int count = 0;
+    while ((count < BENCH_PIXELS) && (fscanf(f, " %f ,", &pFrame->ThermoImage[count]) == 1))
+        count++;
+    fclose(f);
+
+    return (count == BENCH_PIXELS) ? 0 : -1;
+}
+
+/**
+ * @brief 合成帧：25 度背景上一个沿椭圆移动的热点，加少量确定性噪声
+ *
+ * @param idx 帧号
+ * @param pFrame
+ */
+static void bench_synthFrame(int idx, sMlxData* pFrame)
+{
+    float cx = 16.0f + 10.0f * cosf(idx * 0.2f);
+    float cy = 12.0f + 7.0f * sinf(idx * 0.2f);
+    uint32_t seed = 12345u + idx;
+
+    for (int y = 0; y < THERMALIMAGE_RESOLUTION_HEIGHT; y++) {
+        for (int x = 0; x < THERMALIMAGE_RESOLUTION_WIDTH; x++) {
+            float d2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+            seed = seed * 1103515245u + 12345u;
+            float noise = ((seed >> 16) & 0xFF) / 255.0f - 0.5f;
+            pFrame->ThermoImage[y * THERMALIMAGE_RESOLUTION_WIDTH + x] = 25.0f + 40.0f * expf(-d2 / 18.0f) + noise * 0.4f;
+        }
+    }
+}
+
+// 一种组合的统计
+typedef struct {
+    uint32_t computeUs;
+    uint32_t composeUs;
+    uint32_t updateUs;
+    uint64_t bytes;
+} sBenchResult;
+
+/**
+ * @brief 跑一种组合
+ *
+ * @param pUi
+ * @param pFrame 计算结果缓冲区
+ * @param pScratch
+ * @param pTarget
+ * @param frames 帧数
+ * @param pResult
+ */
+static void bench_run(const sSceneUiState* pUi, sSceneFrame* pFrame, sSceneScratch* pScratch, sSceneTarget* pTarget,
+                      int frames, sBenchResult* pResult)
+{
+    sHostFbStats fbStats;
+
+    memset(pResult, 0, sizeof(*pResult));
+
+    // 整屏重绘一次，让每种组合从相同的状态开始
+    compositor_InvalidateAll();
+    scene_ComposeFrame(NULL, pUi, pTarget);
+    dispcolor_Update();
+    hostfb_ResetStats();
+
+    for (int i = 0; i < frames; i++) {
+        pFrame->frame = Frames[i % FrameCount];
+        pFrame->frame.FrameSeq = i + 1;
+
+        uint32_t t0 = profiler_Now();
+        scene_Compute(pFrame, pUi, pScratch);
+        uint32_t t1 = profiler_Now();
+        scene_ComposeFrame(pFrame, pUi, pTarget);
+        uint32_t t2 = profiler_Now();
+        dispcolor_Update();
+        uint32_t t3 = profiler_Now();
+
+        pResult->computeUs += t1 - t0;
+        pResult->composeUs += t2 - t1;
+        pResult->updateUs += t3 - t2;
+        profiler_FrameEnd(t3 - t0);
+    }
+
+    hostfb_GetStats(&fbStats);
+    pResult->bytes = fbStats.totalBytes;
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 200;
+    const char* pOutDir = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc)) {
+            frames = atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc)) {
+            pOutDir = argv[++i];
+        } else if (FrameCount < BENCH_MAX_FRAMES) {
+            if (bench_loadCsv(argv[i], &Frames[FrameCount]) != 0) {
+                fprintf(stderr, "bad thermal map: %s\n", argv[i]);
+                return 1;
+            }
+            FrameCount++;
+        }
+    }
+
+    if (FrameCount == 0) {
+        for (; FrameCount < 64; FrameCount++)
+            bench_synthFrame(FrameCount, &Frames[FrameCount]);
+    }
+    for (int i = 0; i < FrameCount; i++)
+        framestats_Calc(&Frames[i]);
+    if (frames <= 0)
+        frames = 1;
+
+    dispcolor_SetBackend(&dispbackend_hostfb);
+    dispcolor_Init();
+
+    const sSceneLayout layout = {
+        .top_bar_h = BENCH_TOP_BAR_H,
+        .bottom_bar_h = BENCH_BOTTOM_BAR_H,
+        .img_x = 10,
+        .img_y = BENCH_TOP_BAR_H,
+        .img_w = dispcolor_getWidth() - 20,
+        .img_h = dispcolor_getHeight() - BENCH_TOP_BAR_H - BENCH_BOTTOM_BAR_H,
+    };
+    static sSceneTarget target;
+    static sSceneFrame frame;
+    static sSceneScratch scratch;
+
+    if (!scene_InitTarget(&target, &layout) || !scene_AllocFrame(&frame, layout.img_w, layout.img_h) || !scene_AllocScratch(&scratch)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    sSceneUiState ui = {
+        .paletteCenterPercent = PALETTE_CENTER_DEFAULT,
+        .autoScale = true,
+        .manualMin = SCALE_DEFAULT_MIN,
+        .manualMax = SCALE_DEFAULT_MAX,
+        .focus = SECTION_IMAGE,
+        .crossX = THERMALIMAGE_RESOLUTION_WIDTH >> 1,
+        .crossY = THERMALIMAGE_RESOLUTION_HEIGHT >> 1,
+        .realTimeAnalysis = true,
+        .overlayLine1 = "Crosshair mode: X",
+        .overlayLine2 = "Enc:move  Right:axis  Left:exit",
+        .fps = 16,
+    };
+
+    printf("%d frames per run, %d source frame(s)\n", frames, FrameCount);
+    printf("%-8s %-8s %-8s %8s %10s %10s %10s %10s\n", "quality", "palette", "overlay", "fps", "compute", "compose", "update", "bytes/f");
+
+    for (int quality = 0; quality < 2; quality++) {
+        for (int palette = 0; palette < COLOR_MAX; palette++) {
+            for (int overlay = 0; overlay < 2; overlay++) {
+                sBenchResult result;
+
+                ui.lowQuality = quality;
+                ui.colorScale = palette;
+                ui.tempMarkers = overlay;
+                ui.showCrosshair = overlay;
+                ui.overlayActive = overlay;
+                ui.overlayId++;
+
+                bench_run(&ui, &frame, &scratch, &target, frames, &result);
+
+                uint32_t totalUs = result.computeUs + result.composeUs + result.updateUs;
+                printf("%-8s %-8d %-8s %8.1f %8luus %8luus %8luus %10llu\n",
+                    quality ? "low" : "high", palette, overlay ? "on" : "off",
+                    totalUs ? frames * 1000000.0 / totalUs : 0.0,
+                    (unsigned long)(result.computeUs / frames), (unsigned long)(result.composeUs / frames),
+                    (unsigned long)(result.updateUs / frames), (unsigned long long)(result.bytes / frames));
+
+                if (pOutDir != NULL) {
+                    char path[256];
+                    snprintf(path, sizeof(path), "%s/scene_%s_p%d_%s.png", pOutDir, quality ? "low" : "high", palette, overlay ? "on" : "off");
+                    hostfb_SavePNG(path);
+                }
+            }
+        }
+    }
+
+    // 全部组合的各阶段分布
+    profiler_Print();
+    return 0;
+}
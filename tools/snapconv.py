@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+辐射快照转换器
+
+把设备保存的温度图快照（*.TIR，格式见 components/ThermalImaging/include/tools/snapshot.h）
+转换为 CSV 和 PNG 预览：
+  - CSV：24 行 x 32 列，逗号分隔，tools/scene_bench.c 可直接读取
+  - PNG：按文件头中的调色板、量程和调色板中心百分比着色，与液晶一样水平镜像，最近邻放大
+调色板从 src/interpolation/palette.c 的 KeyColors 表解析，与设备保持一致。
+
+用法：
+  python3 tools/snapconv.py 00001.TIR                 # 生成 00001.csv 和 00001.png
+  python3 tools/snapconv.py 00001.TIR --info          # 只打印文件头
+  python3 tools/snapconv.py *.TIR --png-scale 4 --min 20 --max 40
+"""
+
+import argparse
+import math
+import os
+import re
+import struct
+import sys
+import zlib
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+COMPONENT = os.path.join(ROOT, "components", "ThermalImaging")
+PALETTE_C = os.path.join(COMPONENT, "src", "interpolation", "palette.c")
+SETTINGS_H = os.path.join(COMPONENT, "include", "settings.h")
+
+MAGIC = b"TIRS"
+FLAG_FLOAT = 0x0001
+INVALID = -32768
+
+# 与 sSnapshotHeader 一致
+HEADER_FORMAT = "<4sHHHBBIIffffBBBBB3sHHffff"
+HEADER_FIELDS = (
+    "Magic", "Version", "HeaderSize", "Flags", "Width", "Height", "Timestamp", "FrameSeq",
+    "Emissivity", "Ta", "Vdd", "RefreshRate", "AdcResolution", "ScaleMode", "ColorScale",
+    "AutoScale", "PaletteCenterPercent", "Reserved", "TempScale", "Reserved2",
+    "ScaleMin", "ScaleMax", "MinT", "MaxT",
+)
+
+PALETTE_STEPS = 256
+
+
+def read_snapshot(path, prefer_float=True):
+    """返回 (header dict, 温度列表)，无效像素为 NaN"""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    base = struct.calcsize(HEADER_FORMAT)
+    if len(data) < base or data[:4] != MAGIC:
+        raise ValueError("%s: not a thermal snapshot" % path)
+    header = dict(zip(HEADER_FIELDS, struct.unpack_from(HEADER_FORMAT, data)))
+
+    # 新版本只在文件头末尾追加字段，按 HeaderSize 跳过
+    pixels = header["Width"] * header["Height"]
+    offset = header["HeaderSize"]
+    if len(data) < offset + pixels * 2:
+        raise ValueError("%s: truncated" % path)
+
+    if prefer_float and (header["Flags"] & FLAG_FLOAT) and len(data) >= offset + pixels * 6:
+        temps = list(struct.unpack_from("<%df" % pixels, data, offset + pixels * 2))
+    else:
+        scale = header["TempScale"] or 1
+        temps = [math.nan if v == INVALID else v / scale
+                 for v in struct.unpack_from("<%dh" % pixels, data, offset)]
+    return header, temps
+
+
+def write_csv(path, header, temps):
+    width = header["Width"]
+    with open(path, "w", newline="") as f:
+        for row in range(header["Height"]):
+            values = temps[row * width:(row + 1) * width]
+            f.write(", ".join("%f" % v for v in values) + "\r\n")
+
+
+def parse_palettes():
+    """从 settings.h 和 palette.c 解析 {eColorScale 值: [(r, g, b), ...]}"""
+    with open(SETTINGS_H, encoding="utf-8", errors="replace") as f:
+        settings = f.read()
+    enum = re.search(r"typedef\s+enum\s*\{([^}]*)\}\s*eColorScale\s*;", settings).group(1)
+    enum = re.sub(r"//[^\n]*", "", enum)
+    names = [n.split("=")[0].strip() for n in enum.split(",") if n.strip()]
+
+    with open(PALETTE_C, encoding="utf-8", errors="replace") as f:
+        src = re.sub(r"//[^\n]*", "", f.read())
+
+    palettes = {}
+    for name, body in re.findall(r"case\s+(\w+)\s*:\s*\{(.*?)\}\s*break\s*;", src, re.S):
+        colors = [tuple(int(v, 0) for v in c) for c in
+                  re.findall(r"\{\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*\}", body)]
+        if name in names and colors:
+            palettes[names.index(name)] = colors
+    return palettes
+
+
+def build_palette(colors, steps):
+    """与 palette.c 的 buildManyColorPalette 相同（两色调色板结果一致）"""
+    parts = len(colors) - 1
+    total = steps
+    if steps % parts:
+        total = (steps // parts) * parts + parts
+    part_size = total // parts
+
+    out = []
+    for part in range(parts):
+        for step in range(part_size):
+            n = step / (part_size - 1) if part_size > 1 else 0.0
+            out.append(tuple(int(colors[part][i] * (1.0 - n) + colors[part + 1][i] * n) for i in range(3)))
+            if len(out) >= steps:
+                return out
+    return out
+
+
+def palette_index(t, lo, hi, center_percent, steps):
+    """与 scene.c 的 BuildCoordLut 相同的中心百分比映射，返回 0..steps-1"""
+    if not math.isfinite(t):
+        return 0
+    span = max(hi - lo, 0.001)
+    coord = min(max((t - lo) / span, 0.0), 1.0)
+    center = center_percent / 100.0
+    mid = steps // 2
+    if center <= 0.0 or center >= 1.0:
+        idx = int(coord * (steps - 1))
+    elif coord <= center:
+        idx = int(coord / center * mid)
+    else:
+        idx = mid + int((coord - center) / (1.0 - center) * (steps - mid))
+    return min(max(idx, 0), steps - 1)
+
+
+def write_png(path, width, height, rgb_rows):
+    def chunk(kind, payload):
+        body = kind + payload
+        return struct.pack(">I", len(payload)) + body + struct.pack(">I", zlib.crc32(body) & 0xFFFFFFFF)
+
+    raw = b"".join(b"\x00" + bytes(row) for row in rgb_rows)
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(raw, 9)))
+        f.write(chunk(b"IEND", b""))
+
+
+def render_preview(path, header, temps, palettes, scale, lo=None, hi=None):
+    width, height = header["Width"], header["Height"]
+    lo = header["ScaleMin"] if lo is None else lo
+    hi = header["ScaleMax"] if hi is None else hi
+    colors = palettes.get(header["ColorScale"]) or palettes[0]
+    palette = build_palette(colors, PALETTE_STEPS)
+
+    rows = []
+    for y in range(height):
+        row = bytearray()
+        for x in range(width):
+            # 液晶上水平镜像；高温取调色板的前端（与设备的反向映射一致）
+            t = temps[y * width + (width - 1 - x)]
+            idx = palette_index(t, lo, hi, header["PaletteCenterPercent"], len(palette))
+            row += bytes(palette[len(palette) - 1 - idx]) * scale
+        rows.extend([row] * scale)
+    write_png(path, width * scale, height * scale, rows)
+
+
+def print_info(path, header):
+    print(path)
+    for name in HEADER_FIELDS:
+        if name.startswith("Reserved"):
+            continue
+        value = header[name]
+        if isinstance(value, float):
+            value = "%.3f" % value
+        print("  %-20s %s" % (name, value))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="把辐射快照转换为 CSV 和 PNG 预览")
+    parser.add_argument("files", nargs="+", help="*.TIR 快照文件")
+    parser.add_argument("-o", "--output-dir", help="输出目录（默认与输入文件相同）")
+    parser.add_argument("--info", action="store_true", help="只打印文件头")
+    parser.add_argument("--no-csv", action="store_true", help="不生成 CSV")
+    parser.add_argument("--no-png", action="store_true", help="不生成 PNG")
+    parser.add_argument("--int16", action="store_true", help="有 float 块时也使用 int16 温度")
+    parser.add_argument("--png-scale", type=int, default=8, help="PNG 放大倍数（默认 8）")
+    parser.add_argument("--min", type=float, help="PNG 量程下限（默认取文件头）")
+    parser.add_argument("--max", type=float, help="PNG 量程上限（默认取文件头）")
+    args = parser.parse_args()
+
+    palettes = None if (args.info or args.no_png) else parse_palettes()
+
+    for path in args.files:
+        try:
+            header, temps = read_snapshot(path, prefer_float=not args.int16)
+        except (OSError, ValueError) as e:
+            sys.exit(str(e))
+
+        if args.info:
+            print_info(path, header)
+            continue
+
+        stem = os.path.splitext(os.path.basename(path))[0]
+        out_dir = args.output_dir or os.path.dirname(path) or "."
+        if not args.no_csv:
+            write_csv(os.path.join(out_dir, stem + ".csv"), header, temps)
+        if not args.no_png:
+            render_preview(os.path.join(out_dir, stem + ".png"), header, temps, palettes,
+                           max(args.png_scale, 1), args.min, args.max)
+        print("%s -> %s" % (path, os.path.join(out_dir, stem)))
+
+
+if __name__ == "__main__":
+    main()
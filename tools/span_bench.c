@@ -0,0 +1,152 @@
+/*
+ * 逐像素绘图和行段（span）/ 块复制绘图的吞吐量基准（主机上运行）
+ *
+ * 通过 dispcolor 在内存帧缓冲（hostfb）上画同样的内容，比较：
+ *  - 热图区域：逐像素查调色板后 dispcolor_DrawPixel（原来 DrawHQImage 的写法），
+ *    和每行转换到行缓冲后 dispcolor_WriteSpan（含水平镜像）、整块 dispcolor_BlitRect
+ *  - 整屏填充：逐像素 dispcolor_DrawPixel 和 dispcolor_FillRect
+ * 主机帧缓冲不做字节交换，设备上两种写法每像素都多一次交换，逐像素写法还多一次后端调用和边界检查。
+ *
+ * 编译（在仓库根目录）：
+ *   C=components/ThermalImaging
+ *   gcc -O2 -o span_bench tools/span_bench.c $C/src/lcd/dispcolor.c $C/src/lcd/hostfb.c \
+ *       $C/src/lcd/compositor.c $C/src/lcd/textcache.c $C/src/lcd/font/f*.c \
+ *       -I$C/include -I$C/include/lcd -I$C/include/tasks -I$C/include/tools -I$C/include/iic -lm
+ *
+ * 用法：
+ *   ./span_bench [-n 重复次数]
+ */
+#include "dispcolor.h"
+#include "dispbackend.h"
+#include "hostfb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// 与 render_task 的热图区域一致：240 x 180（32 x 24 插值放大）
+#define BENCH_IMAGE_X 0
+#define BENCH_IMAGE_Y 20
+#define BENCH_IMAGE_W 240
+#define BENCH_IMAGE_H 180
+#define BENCH_LUT_SIZE 1024
+
+static int16_t Values[BENCH_IMAGE_W * BENCH_IMAGE_H];
+static uint16_t Lut[BENCH_LUT_SIZE];
+static uint16_t Image[BENCH_IMAGE_W * BENCH_IMAGE_H];
+static uint16_t RowBuff[BENCH_IMAGE_W];
+static volatile uint32_t Sink;
+
+static double bench_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench_PixelImage(void)
+{
+    const int16_t* pValue = Values;
+    for (int16_t y = 0; y < BENCH_IMAGE_H; y++)
+        for (int16_t x = 0; x < BENCH_IMAGE_W; x++)
+            dispcolor_DrawPixel(BENCH_IMAGE_X + x, BENCH_IMAGE_Y + y, Lut[*(pValue++)]);
+}
+
+static void bench_SpanImage(bool mirror)
+{
+    const int16_t* pValue = Values;
+    for (int16_t y = 0; y < BENCH_IMAGE_H; y++) {
+        for (int16_t x = 0; x < BENCH_IMAGE_W; x++)
+            RowBuff[x] = Lut[*(pValue++)];
+        dispcolor_WriteSpan(BENCH_IMAGE_X, BENCH_IMAGE_Y + y, RowBuff, BENCH_IMAGE_W, mirror);
+    }
+}
+
+static void bench_SpanImageNoMirror(void)
+{
+    bench_SpanImage(false);
+}
+
+static void bench_SpanImageMirror(void)
+{
+    bench_SpanImage(true);
+}
+
+static void bench_BlitImage(void)
+{
+    dispcolor_BlitRect(BENCH_IMAGE_X, BENCH_IMAGE_Y, BENCH_IMAGE_W, BENCH_IMAGE_H, Image, BENCH_IMAGE_W, false);
+}
+
+static void bench_PixelFill(void)
+{
+    uint16_t w = dispcolor_getWidth();
+    uint16_t h = dispcolor_getHeight();
+    for (int16_t y = 0; y < h; y++)
+        for (int16_t x = 0; x < w; x++)
+            dispcolor_DrawPixel(x, y, 0x1234);
+}
+
+static void bench_RectFill(void)
+{
+    dispcolor_FillRect(0, 0, dispcolor_getWidth(), dispcolor_getHeight(), 0x1234);
+}
+
+/**
+ * @brief 运行一种写法 n 次，输出每像素耗时和吞吐量，返回每像素纳秒数
+ */
+static double bench_Run(const char* pName, void (*pFunc)(void), uint32_t pixels, int n)
+{
+    pFunc(); // 预热
+    hostfb_ResetStats();
+    double start = bench_Now();
+    for (int i = 0; i < n; i++)
+        pFunc();
+    double s = bench_Now() - start;
+    Sink += hostfb_GetBuffer()[1000];
+
+    double ns = s * 1e9 / ((double)pixels * n);
+    printf("%-22s %8.2f ns/px %9.1f Mpx/s %8.1f us/frame\n", pName, ns, 1e3 / ns, s * 1e6 / n);
+    return ns;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = 500;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && (i + 1 < argc))
+            n = atoi(argv[++i]);
+    }
+    if (n <= 0)
+        n = 1;
+
+    dispcolor_SetBackend(&dispbackend_hostfb);
+    dispcolor_Init();
+
+    // 合成的温度值和调色板
+    for (int i = 0; i < BENCH_LUT_SIZE; i++) {
+        int r = i >> 2;
+        int g = (i * 7) & 0xFF;
+        int b = 255 - r;
+        Lut[i] = RGB565(r, g, b);
+    }
+    srand(1);
+    for (int i = 0; i < BENCH_IMAGE_W * BENCH_IMAGE_H; i++) {
+        Values[i] = (i % BENCH_IMAGE_W + i / BENCH_IMAGE_W * 3 + rand() % 16) % BENCH_LUT_SIZE;
+        Image[i] = Lut[Values[i]];
+    }
+
+    uint32_t imagePixels = BENCH_IMAGE_W * BENCH_IMAGE_H;
+    uint32_t screenPixels = dispcolor_getWidth() * dispcolor_getHeight();
+    printf("image %dx%d, screen %ux%u, %d runs\n", BENCH_IMAGE_W, BENCH_IMAGE_H, dispcolor_getWidth(), dispcolor_getHeight(), n);
+
+    double pixel = bench_Run("image DrawPixel", bench_PixelImage, imagePixels, n);
+    double span = bench_Run("image WriteSpan", bench_SpanImageNoMirror, imagePixels, n);
+    double mirror = bench_Run("image WriteSpan mirror", bench_SpanImageMirror, imagePixels, n);
+    double blit = bench_Run("image BlitRect", bench_BlitImage, imagePixels, n);
+    double pixelFill = bench_Run("fill DrawPixel", bench_PixelFill, screenPixels, n);
+    double rectFill = bench_Run("fill FillRect", bench_RectFill, screenPixels, n);
+
+    printf("speedup: span %.1fx, span mirror %.1fx, blit %.1fx, fill %.1fx\n",
+        pixel / span, pixel / mirror, pixel / blit, pixelFill / rectFill);
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * 录像写入内置存储的基准（主机上运行，模拟闪存）
+ *
+ * 没有插 SD 卡时录像写在内置存储（capstore）。这里在 capstore_sim 上按录像任务的方式写文件，统计模拟时间：
+ *  - 原始帧：64Hz 的温度帧（32x24 个 float，3KB）每帧写一次，写调用必须在帧周期（15.6ms）内返回，
+ *    平均速度必须达到 192KB/s
+ *  - 编码后的录像：每帧约 913 字节（tools/tiv_check.c 测得的平均值），攒成 8KB 的块再写，
+ *    一块必须在下一块攒满之前写完（录像任务有两块）
+ * 分别在空的存储和写满后删除一半文件（需要回收）的存储上测试。
+ * SD 卡一侧（sdstream_task）需要硬件，不在这里模拟。
+ *
+ * 编译（在仓库根目录）：
+ *   C=components/ThermalImaging
+ *   gcc -O2 -o stream_bench tools/stream_bench.c $C/src/tools/capstore.c $C/src/tools/capstore_sim.c \
+ *       -I$C/include/tools -lm
+ *
+ * 用法：
+ *   ./stream_bench
+ */
+#include "capstore.h"
+#include "capstore_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// storage 分区大小
+#define BENCH_FLASH_SIZE 0xA0000
+#define BENCH_SECTOR_SIZE 4096
+#define BENCH_FRAME_RATE 64
+#define BENCH_RAW_FRAME_SIZE (32 * 24 * 4)
+#define BENCH_TIV_FRAME_SIZE 913
+#define BENCH_BLOCK_SIZE (8 * 1024)
+#define BENCH_RAW_SIZE (128 * 1024)
+#define BENCH_TIV_SIZE (192 * 1024)
+
+static sCapstoreSim Sim;
+static tCapstoreFlash Flash;
+static uint8_t Data[BENCH_BLOCK_SIZE];
+
+/**
+ * @brief 写满存储后删除一半文件，留下需要回收的无效空间
+ */
+static void bench_fragment(void)
+{
+    char name[CAPSTORE_NAME_MAX];
+    int count = 0;
+
+    while (1) {
+        snprintf(name, sizeof(name), "%05d.BMP", count);
+        int handle = capstore_Open(name, CAPSTORE_WRITE);
+        if (handle < 0)
+            break;
+        int ret = capstore_Write(handle, Data, sizeof(Data));
+        if ((capstore_Close(handle) != 0) || (ret < 0))
+            break;
+        count++;
+    }
+    capstore_Remove(name);
+    for (int i = 0; i < count; i += 2) {
+        snprintf(name, sizeof(name), "%05d.BMP", i);
+        capstore_Remove(name);
+    }
+}
+
+/**
+ * @brief 写 total 字节，每次写 callSize 字节
+ *
+ * @param pLabel
+ * @param callSize 每次写调用的字节数
+ * @param total
+ * @param budgetUs 每次写调用允许的时间
+ * @param needRate 需要的平均速度（字节/秒）
+ */
+static void bench_stream(const char* pLabel, uint32_t callSize, uint32_t total, double budgetUs, double needRate)
+{
+    int handle = capstore_Open("00001.TIV", CAPSTORE_WRITE);
+    if (handle < 0) {
+        printf("%-24s cannot create (%d)\n", pLabel, handle);
+        return;
+    }
+
+    double maxCallUs = 0;
+    int late = 0;
+    uint32_t done = 0;
+    double start = Sim.timeUs;
+    while (done < total) {
+        double t = Sim.timeUs;
+        if (capstore_Write(handle, Data, callSize) < 0)
+            break;
+        t = Sim.timeUs - t;
+        if (t > maxCallUs)
+            maxCallUs = t;
+        if (t > budgetUs)
+            late++;
+        done += callSize;
+    }
+    bool ok = (capstore_Close(handle) == 0) && (done >= total);
+    double us = Sim.timeUs - start;
+    double rate = us ? done * 1e6 / us : 0;
+
+    printf("%-24s %s %4lu KB in %6.1f ms: %5.0f KB/s (need %3.0f), slowest call %6.1f ms (budget %5.1f), %d late -> %s\n", pLabel,
+        ok ? "ok " : "ERR", (unsigned long)(done / 1024), us / 1000, rate / 1024, needRate / 1024, maxCallUs / 1000,
+        budgetUs / 1000, late, (ok && (rate >= needRate) && !late) ? "sustained" : "NOT sustained");
+    capstore_Remove("00001.TIV");
+}
+
+static void bench_run(bool fragmented)
+{
+    capstoresim_Init(&Sim, BENCH_FLASH_SIZE, BENCH_SECTOR_SIZE);
+    capstoresim_GetFlash(&Sim, &Flash);
+    if (capstore_Mount(&Flash) != 0) {
+        printf("mount failed\n");
+        return;
+    }
+    if (fragmented)
+        bench_fragment();
+
+    sCapstoreInfo info;
+    capstore_Info(&info);
+    printf("%s store: %lu/%lu bytes used, %u free segments\n", fragmented ? "fragmented" : "empty", (unsigned long)info.used,
+        (unsigned long)info.capacity, info.freeSegments);
+
+    double framePeriodUs = 1e6 / BENCH_FRAME_RATE;
+    bench_stream("  raw frames", BENCH_RAW_FRAME_SIZE, BENCH_RAW_SIZE, framePeriodUs, BENCH_RAW_FRAME_SIZE * BENCH_FRAME_RATE);
+    bench_stream("  encoded, 8 KB blocks", BENCH_BLOCK_SIZE, BENCH_TIV_SIZE, framePeriodUs * BENCH_BLOCK_SIZE / BENCH_TIV_FRAME_SIZE,
+        BENCH_TIV_FRAME_SIZE * BENCH_FRAME_RATE);
+
+    capstore_Unmount();
+    capstoresim_Free(&Sim);
+}
+
+int main(void)
+{
+    for (int i = 0; i < BENCH_BLOCK_SIZE; i++)
+        Data[i] = i * 7;
+
+    bench_run(false);
+    bench_run(true);
+    return 0;
+}
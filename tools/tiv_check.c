@@ -0,0 +1,165 @@
+/*
+ * 温度录像编码检查：生成录像和参考数据（主机上运行），由 tools/tiv_check.py 用 recconv.py 解码后比较
+ *
+ * 用设备上的 recording.c 编码合成的 32x24 温度帧：
+ *  - 移动的热点、缓慢变化的背景和噪声
+ *  - 无效像素（NaN/Inf）、整帧无效
+ *  - 超出 int16 范围的温度（饱和）和逐像素交替的极端温度（Rice 码溢出）
+ *  - 帧数超过关键帧间隔，帧序号有跳跃（丢帧）
+ * 输出：
+ *  <前缀>.TIV      完整的录像
+ *  <前缀>_CUT.TIV  最后一帧只写了一半的录像（录像中断）
+ *  <前缀>.REF      每帧的帧序号、时间、环境温度和量化后的温度（与设备保存的值相同）
+ *
+ * 编译和运行（在仓库根目录）：
+ *   C=components/ThermalImaging
+ *   gcc -O2 -o tiv_check tools/tiv_check.c $C/src/tools/recording.c $C/src/tools/snapshot.c -I$C/include/tools -lm
+ *   ./tiv_check /tmp/tiv [-n 帧数] && python3 tools/tiv_check.py /tmp/tiv
+ */
+#include "recording.h"
+#include "snapshot.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK_WIDTH 32
+#define CHECK_HEIGHT 24
+#define CHECK_PIXELS (CHECK_WIDTH * CHECK_HEIGHT)
+
+static sRecordingEncoder Encoder;
+static float Temps[CHECK_PIXELS];
+static int16_t Quantized[CHECK_PIXELS];
+static uint8_t FrameBuff[RECORDING_MAX_FRAME_SIZE(CHECK_PIXELS)];
+static uint32_t Rng = 1;
+
+static uint32_t check_rand(void)
+{
+    Rng ^= Rng << 13;
+    Rng ^= Rng >> 17;
+    Rng ^= Rng << 5;
+    return Rng;
+}
+
+/**
+ * @brief 生成第 n 帧的温度
+ */
+static void check_makeFrame(int n, int frames)
+{
+    float spotX = (n * 3) % CHECK_WIDTH;
+    float spotY = CHECK_HEIGHT / 2 + 8 * sinf(n * 0.2f);
+
+    for (int y = 0; y < CHECK_HEIGHT; y++) {
+        for (int x = 0; x < CHECK_WIDTH; x++) {
+            float d2 = (x - spotX) * (x - spotX) + (y - spotY) * (y - spotY);
+            float noise = (int)(check_rand() % 101 - 50) * 0.004f;
+            Temps[y * CHECK_WIDTH + x] = 22.0f + 0.05f * x + 0.02f * n + 40.0f * expf(-d2 / 8.0f) + noise;
+        }
+    }
+
+    if (n % 7 == 3) {
+        // 坏点
+        Temps[check_rand() % CHECK_PIXELS] = NAN;
+        Temps[check_rand() % CHECK_PIXELS] = INFINITY;
+    }
+    if (n == frames / 3) {
+        // 整帧无效
+        for (int i = 0; i < CHECK_PIXELS; i++)
+            Temps[i] = NAN;
+    }
+    if (n == frames / 2) {
+        // 极端和超范围的温度
+        Temps[0] = -40.0f;
+        Temps[1] = 300.0f;
+        Temps[2] = 1000.0f;
+        Temps[3] = -1000.0f;
+        Temps[CHECK_PIXELS - 1] = -INFINITY;
+    }
+    if (n == frames / 2 + 1) {
+        // 逐像素交替的极端温度
+        for (int i = 0; i < CHECK_PIXELS; i++)
+            Temps[i] = (i & 1) ? 300.0f : -40.0f;
+    }
+}
+
+static FILE* check_create(const char* pPrefix, const char* pSuffix)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s%s", pPrefix, pSuffix);
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        perror(path);
+        exit(1);
+    }
+    return f;
+}
+
+int main(int argc, char** argv)
+{
+    const char* pPrefix = NULL;
+    int frames = 100;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+            frames = atoi(argv[++i]);
+        else
+            pPrefix = argv[i];
+    }
+    if ((pPrefix == NULL) || (frames < 4)) {
+        printf("usage: %s prefix [-n frames]\n", argv[0]);
+        return 1;
+    }
+
+    sSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    recording_InitHeader(&header, CHECK_WIDTH, CHECK_HEIGHT);
+    header.Timestamp = 1700000000;
+    header.Emissivity = 0.95f;
+    header.RefreshRate = 16.0f;
+    header.ScaleMin = 20.0f;
+    header.ScaleMax = 60.0f;
+
+    FILE* pTiv = check_create(pPrefix, ".TIV");
+    FILE* pCut = check_create(pPrefix, "_CUT.TIV");
+    FILE* pRef = check_create(pPrefix, ".REF");
+    fwrite(&header, sizeof(header), 1, pTiv);
+    fwrite(&header, sizeof(header), 1, pCut);
+
+    recording_EncoderInit(&Encoder, CHECK_WIDTH, CHECK_HEIGHT, RECORDING_KEY_INTERVAL);
+
+    uint32_t seq = 100;
+    size_t total = 0;
+    size_t maxFrame = 0;
+    for (int n = 0; n < frames; n++) {
+        check_makeFrame(n, frames);
+        seq += (n % 11 == 10) ? 3 : 1; // 丢帧
+        uint32_t timeMs = n * 62;
+        float ta = 30.0f + n * 0.01f;
+
+        size_t size = recording_EncodeFrame(&Encoder, Temps, seq, timeMs, ta, FrameBuff, sizeof(FrameBuff));
+        if (size == 0) {
+            printf("frame %d: encode failed\n", n);
+            return 1;
+        }
+        total += size;
+        if (size > maxFrame)
+            maxFrame = size;
+
+        fwrite(FrameBuff, 1, size, pTiv);
+        // 最后一帧只写一半
+        fwrite(FrameBuff, 1, (n == frames - 1) ? size / 2 : size, pCut);
+
+        snapshot_Quantize(Temps, CHECK_PIXELS, header.TempScale, Quantized);
+        fwrite(&seq, sizeof(seq), 1, pRef);
+        fwrite(&timeMs, sizeof(timeMs), 1, pRef);
+        fwrite(&ta, sizeof(ta), 1, pRef);
+        fwrite(Quantized, sizeof(Quantized), 1, pRef);
+    }
+
+    fclose(pTiv);
+    fclose(pCut);
+    fclose(pRef);
+    printf("%d frames, %.1f bytes/frame (max %zu, raw int16 %zu)\n", frames, (double)total / frames, maxFrame,
+        sizeof(Quantized));
+    return 0;
+}
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+温度录像编码检查
+
+用 recconv.py 解码 tools/tiv_check.c 生成的录像，与参考数据逐帧逐像素比较：
+  - <前缀>.TIV：全部帧都能解出，帧序号、时间、环境温度和温度与参考一致
+  - <前缀>_CUT.TIV：最后一帧不完整，被丢弃，其余帧一致
+
+用法：
+  python3 tools/tiv_check.py /tmp/tiv
+"""
+
+import math
+import struct
+import sys
+
+import recconv
+
+REF_HEADER = "<IIf"
+# 与 tiv_check.c 一致
+PIXELS = 32 * 24
+
+
+def read_reference(path):
+    """返回 [(帧序号, 时间, 环境温度, 量化后的温度), ...]"""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    frames = []
+    offset = 0
+    while offset < len(data):
+        seq, time_ms, ta = struct.unpack_from(REF_HEADER, data, offset)
+        offset += struct.calcsize(REF_HEADER)
+        values = struct.unpack_from("<%dh" % PIXELS, data, offset)
+        offset += PIXELS * 2
+        frames.append((seq, time_ms, ta, values))
+    return frames
+
+
+def compare(path, reference):
+    """返回错误数"""
+    header, frames = recconv.read_recording(path)
+    scale = header["TempScale"]
+    errors = 0
+    if len(frames) != len(reference):
+        print("%s: %d frames decoded, %d expected" % (path, len(frames), len(reference)))
+        errors += 1
+
+    for index, ((info, temps), (seq, time_ms, ta, values)) in enumerate(zip(frames, reference)):
+        if (info["FrameSeq"], info["TimeMs"]) != (seq, time_ms) or info["Ta"] != ta:
+            print("%s: frame %d header %s, expected seq %d time %d ta %g" % (path, index, info, seq, time_ms, ta))
+            errors += 1
+        bad = 0
+        for t, v in zip(temps, values):
+            if v == recconv.snapconv.INVALID:
+                bad += not math.isnan(t)
+            else:
+                bad += round(t * scale) != v
+        if bad:
+            print("%s: frame %d has %d wrong pixels" % (path, index, bad))
+            errors += 1
+    keys = sum(1 for info, _ in frames if info["Type"] == recconv.FRAME_KEY)
+    print("%s: %d frames (%d key), %d errors" % (path, len(frames), keys, errors))
+    return errors
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: %s prefix" % sys.argv[0])
+
+    prefix = sys.argv[1]
+    reference = read_reference(prefix + ".REF")
+    errors = compare(prefix + ".TIV", reference)
+    errors += compare(prefix + "_CUT.TIV", reference[:-1])
+    print("FAILED" if errors else "OK")
+    sys.exit(1 if errors else 0)
+
+
+if __name__ == "__main__":
+    main()